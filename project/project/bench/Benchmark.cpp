@@ -0,0 +1,176 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <thread>
+
+// Every heap allocation of the benchmark executable goes through these, so suites can check that a steady state
+// frame does not allocate. The array forms forward to them
+static std::atomic<uint64_t> s_NumHeapAllocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+	++s_NumHeapAllocations;
+	if (void* pMemory = std::malloc(size > 0 ? size : 1))
+		return pMemory;
+	throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	++s_NumHeapAllocations;
+	const size_t alignmentSize = static_cast<size_t>(alignment);
+#if defined(_MSC_VER)
+	if (void* pMemory = _aligned_malloc(size > 0 ? size : 1, alignmentSize))
+#else
+	if (void* pMemory = std::aligned_alloc(alignmentSize, (std::max<size_t>(size, 1) + alignmentSize - 1) / alignmentSize * alignmentSize))
+#endif
+		return pMemory;
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::align_val_t) noexcept
+{
+#if defined(_MSC_VER)
+	_aligned_free(pMemory);
+#else
+	std::free(pMemory);
+#endif
+}
+
+void operator delete(void* pMemory, std::size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(pMemory, alignment);
+}
+
+namespace dae
+{
+	namespace Bench
+	{
+		static Settings s_Settings{};
+		static std::vector<Result> s_Results{};
+		static bool s_HasFailures{ false };
+
+		void SetSettings(const Settings& settings)
+		{
+			s_Settings = settings;
+		}
+
+		const Settings& GetSettings()
+		{
+			return s_Settings;
+		}
+
+		bool IsEnabled(const std::string& name)
+		{
+			return s_Settings.filter.empty() || name.find(s_Settings.filter) != std::string::npos;
+		}
+
+		void AddResult(const Result& result)
+		{
+			s_Results.push_back(result);
+			std::printf("%-48s %12.3f ns/item %16.0f items/s\n", result.name.c_str(), result.nsPerItem, result.itemsPerSecond);
+		}
+
+		const std::vector<Result>& GetResults()
+		{
+			return s_Results;
+		}
+
+		void Check(bool condition, const std::string& what)
+		{
+			if (condition)
+				return;
+
+			s_HasFailures = true;
+			std::printf("CHECK FAILED: %s\n", what.c_str());
+		}
+
+		bool HasFailures()
+		{
+			return s_HasFailures;
+		}
+
+		uint64_t GetNumHeapAllocations()
+		{
+			return s_NumHeapAllocations.load();
+		}
+
+		static std::string EscapeJson(const std::string& text)
+		{
+			std::string escaped{};
+			for (const char c : text)
+			{
+				if (c == '"' || c == '\\')
+					escaped += '\\';
+				escaped += c;
+			}
+			return escaped;
+		}
+
+		bool WriteJson(const std::string& path)
+		{
+			std::ofstream file(path);
+			if (!file)
+				return false;
+
+#if defined(_MSC_VER)
+			const std::string compiler = "msvc " + std::to_string(_MSC_VER);
+#elif defined(__clang__)
+			const std::string compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+			const std::string compiler = "gcc " __VERSION__;
+#else
+			const std::string compiler = "unknown";
+#endif
+#if defined(__AVX2__)
+			const char* simd = "avx2";
+#else
+			const char* simd = "sse2";
+#endif
+#if defined(NDEBUG)
+			const char* build = "release";
+#else
+			const char* build = "debug";
+#endif
+
+			file << "{\n";
+			file << "  \"context\": {\n";
+			file << "    \"compiler\": \"" << EscapeJson(compiler) << "\",\n";
+			file << "    \"build\": \"" << build << "\",\n";
+			file << "    \"simd\": \"" << simd << "\",\n";
+			file << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+			file << "    \"min_seconds\": " << s_Settings.minSeconds << "\n";
+			file << "  },\n";
+			file << "  \"failed_checks\": " << (s_HasFailures ? "true" : "false") << ",\n";
+			file << "  \"benchmarks\": [\n";
+			for (size_t i{ 0 }; i < s_Results.size(); ++i)
+			{
+				const Result& result = s_Results[i];
+				file << "    { \"name\": \"" << EscapeJson(result.name) << "\""
+					<< ", \"items\": " << result.items
+					<< ", \"ns_per_item\": " << result.nsPerItem
+					<< ", \"items_per_second\": " << result.itemsPerSecond
+					<< " }" << (i + 1 < s_Results.size() ? ",\n" : "\n");
+			}
+			file << "  ]\n";
+			file << "}\n";
+
+			return static_cast<bool>(file);
+		}
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+//Standard includes
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	namespace Bench
+	{
+		struct Result
+		{
+			std::string name{};
+			uint64_t items{};		// total items processed while timing
+			double nsPerItem{};
+			double itemsPerSecond{};
+		};
+
+		//Keeps the optimizer from throwing away a computed value
+		template<typename T>
+		inline void DoNotOptimize(const T& value)
+		{
+#if defined(_MSC_VER)
+			const volatile char sink = *reinterpret_cast<const volatile char*>(&value);
+			(void)sink;
+			_ReadWriteBarrier();
+#else
+			asm volatile("" : : "r,m"(value) : "memory");
+#endif
+		}
+
+		struct Settings
+		{
+			std::string filter{};		// only run benchmarks whose name contains this
+			double minSeconds{ 0.2 };	// minimum timed duration per benchmark
+		};
+
+		void SetSettings(const Settings& settings);
+		const Settings& GetSettings();
+		bool IsEnabled(const std::string& name);
+
+		void AddResult(const Result& result);
+		const std::vector<Result>& GetResults();
+
+		//Machine readable results for tracking runs over time, returns false when the file can't be written
+		bool WriteJson(const std::string& path);
+
+		//Suites compare their fast paths against a reference before timing them, a failed check fails the run
+		void Check(bool condition, const std::string& what);
+		bool HasFailures();
+
+		//operator new calls since the start, checks compare it around steady state frames
+		uint64_t GetNumHeapAllocations();
+
+		//Calls function() (which processes itemsPerCall items) until at least Settings::minSeconds have passed,
+		//records ns/item and items/s under name
+		template<typename Function>
+		Result Run(const std::string& name, uint64_t itemsPerCall, Function&& function)
+		{
+			using Clock = std::chrono::steady_clock;
+
+			if (!IsEnabled(name))
+				return {};
+
+			const double minSeconds = GetSettings().minSeconds;
+
+			//Warm up caches and branch predictors
+			function();
+
+			uint64_t calls{ 1 };
+			double elapsed{};
+			while (true)
+			{
+				const auto start = Clock::now();
+				for (uint64_t i{ 0 }; i < calls; ++i)
+					function();
+				elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+				if (elapsed >= minSeconds)
+					break;
+
+				calls *= 2;
+			}
+
+			Result result{};
+			result.name = name;
+			result.items = calls * itemsPerCall;
+			result.nsPerItem = elapsed * 1e9 / static_cast<double>(result.items);
+			result.itemsPerSecond = static_cast<double>(result.items) / elapsed;
+
+			AddResult(result);
+			return result;
+		}
+	}
+
+	//Suites
+	void RunMathBenchmarks();
+	void RunQuaternionBenchmarks();
+	void RunFrustumBenchmarks();
+	void RunFastMathBenchmarks();
+	void RunColorBenchmarks();
+	void RunTextureBenchmarks();
+	void RunClipBenchmarks();
+	void RunRasterBenchmarks();
+	void RunOcclusionBenchmarks();
+	void RunSoftwareRendererBenchmarks();
+	void RunVisibilityBufferBenchmarks();
+	void RunTransparencyBenchmarks();
+	void RunJobSystemBenchmarks();
+	void RunTransformBenchmarks();
+	void RunDrawListBenchmarks();
+	void RunInstancingBenchmarks();
+	void RunSubmissionBenchmarks();
+	void RunFramePipelineBenchmarks();
+	void RunFrameAllocatorBenchmarks();
+	void RunConstantBufferBenchmarks();
+	void RunFrameGraphBenchmarks();
+	void RunTransparencySortBenchmarks();
+}
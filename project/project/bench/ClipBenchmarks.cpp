@@ -0,0 +1,212 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "ClipKernels.h"
+#include "Math.h"
+#include "SoftwareRenderer.h"
+#include "TestScene.h"
+
+namespace dae
+{
+	using namespace ClipKernels;
+
+	static float GetPlaneDistance(const Vector4& position, uint8_t plane, const ClipBounds& bounds)
+	{
+		switch (plane)
+		{
+		case NearPlane: return position.z;
+		case FarPlane: return position.w - position.z;
+		case LeftPlane: return position.x + bounds.guardBandX * position.w;
+		case RightPlane: return bounds.guardBandX * position.w - position.x;
+		case BottomPlane: return position.y + bounds.guardBandY * position.w;
+		default: return bounds.guardBandY * position.w - position.y;
+		}
+	}
+
+	static Matrix CreateViewProjection(const Vector3& origin, const Vector3& forward)
+	{
+		const float fov = tanf((45.f * TO_RADIANS) / 2.f);
+		return Matrix::Inverse(Matrix::CreateLookAtLH(origin, forward, Vector3::UnitY)) * Matrix::CreatePerspectiveFovLH(fov, 640.f / 480.f, 0.1f, 100.f);
+	}
+
+	// Camera paths through the test scene (vehicle at z = 50): origin and forward per step
+	static constexpr int s_NumPathSteps{ 32 };
+
+	static std::pair<Vector3, Vector3> GetOrbitCamera(int step)
+	{
+		const float angle = PI_2 * step / s_NumPathSteps;
+		const Vector3 origin{ 30.f * sinf(angle), 0.f, 50.f - 30.f * cosf(angle) };
+		return { origin, (Vector3{ 0.f, 0.f, 50.f } - origin).Normalized() };
+	}
+
+	static std::pair<Vector3, Vector3> GetFlyThroughCamera(int step)
+	{
+		return { Vector3{ 1.f, 0.5f, 20.f + 60.f * step / s_NumPathSteps }, Vector3::UnitZ };
+	}
+
+	void RunClipBenchmarks()
+	{
+		std::mt19937 rng{ 37 };
+		const ClipBounds bounds{ 4.f, 3.f };
+
+		// Random clip space triangles around the view volume, some crossing every plane
+		std::uniform_real_distribution<float> coordinateDist{ -6.f, 6.f };
+		std::uniform_real_distribution<float> wDist{ -1.f, 3.f };
+		auto createPosition = [&]
+			{
+				const float w = wDist(rng);
+				return Vector4{ coordinateDist(rng) * std::abs(w), coordinateDist(rng) * std::abs(w), coordinateDist(rng) * 0.3f * w, w };
+			};
+
+		// SIMD classification against the scalar reference, with a tail that is not a whole batch
+		// ------
+		{
+			std::vector<Vector4> positions(2'001);
+			for (Vector4& position : positions)
+				position = createPosition();
+			std::vector<uint32_t> indices(3 * 9'999);
+			std::uniform_int_distribution<uint32_t> indexDist{ 0, uint32_t(positions.size() - 1) };
+			for (uint32_t& index : indices)
+				index = indexDist(rng);
+
+			std::vector<ClipCodes> simd(indices.size() / 3), reference(indices.size() / 3);
+			ClassifyTriangles(positions, indices, bounds, simd);
+			ClassifyTrianglesReference(positions, indices, bounds, reference);
+			bool isSame{ true };
+			uint32_t numCrossing{};
+			for (size_t i{ 0 }; i < simd.size(); ++i)
+			{
+				isSame &= simd[i].orCode == reference[i].orCode && simd[i].andCode == reference[i].andCode;
+				numCrossing += reference[i].orCode != 0 && reference[i].andCode == 0;
+			}
+			Bench::Check(isSame && numCrossing > 0, "ClipKernels::ClassifyTriangles matches the scalar reference");
+		}
+
+		// Clipped polygons lie inside every clipped plane and on the input triangle
+		// ------
+		{
+			bool isInside{ true }, isOnTriangle{ true }, isUntouched{ true };
+			for (int t{ 0 }; t < 20'000; ++t)
+			{
+				const Vector4 corners[3]{ createPosition(), createPosition(), createPosition() };
+				const uint8_t codes[3]{ ComputeClipCode(corners[0], bounds), ComputeClipCode(corners[1], bounds), ComputeClipCode(corners[2], bounds) };
+				const uint8_t orCode = codes[0] | codes[1] | codes[2];
+
+				ClipVertex polygon[MaxClipVertices];
+				const int count = ClipTriangle(corners, orCode, bounds, polygon);
+				if (orCode == 0)
+					isUntouched &= count == 3 && polygon[0].position.x == corners[0].x && polygon[2].position.w == corners[2].w;
+
+				for (int v{ 0 }; v < count; ++v)
+				{
+					const Vector4& position = polygon[v].position;
+					const float scale = std::max({ std::abs(corners[0].w), std::abs(corners[1].w), std::abs(corners[2].w), 1.f });
+					for (int plane{ 0 }; plane < NumPlanes; ++plane)
+						if (orCode & (1 << plane))
+							isInside &= GetPlaneDistance(position, uint8_t(1 << plane), bounds) >= -1e-4f * scale * 8.f;
+
+					const float* pWeights = polygon[v].weights;
+					const Vector4 rebuilt = corners[0] * pWeights[0] + corners[1] * pWeights[1] + corners[2] * pWeights[2];
+					isOnTriangle &= std::abs(pWeights[0] + pWeights[1] + pWeights[2] - 1.f) <= 1e-5f;
+					isOnTriangle &= std::abs(rebuilt.x - position.x) <= 1e-4f * scale * 8.f && std::abs(rebuilt.w - position.w) <= 1e-4f * scale;
+				}
+			}
+			Bench::Check(isInside, "ClipKernels::ClipTriangle output is inside the clipped planes");
+			Bench::Check(isOnTriangle, "ClipKernels::ClipTriangle output weights rebuild the positions");
+			Bench::Check(isUntouched, "ClipKernels::ClipTriangle leaves triangles without clip codes alone");
+
+			// Two triangles sharing an edge through the near plane clip it to the same point, whichever way it is walked
+			const Vector4 a{ -1.f, 0.f, -0.5f, 0.5f }, b{ 0.f, 1.f, 0.5f, 1.5f }, c{ 1.f, 0.f, 2.f, 3.f }, d{ 0.f, -1.f, 1.f, 2.f };
+			const Vector4 first[3]{ a, b, c }, second[3]{ a, c, d };
+			ClipVertex firstPolygon[MaxClipVertices], secondPolygon[MaxClipVertices];
+			const int firstCount = ClipTriangle(first, NearPlane, bounds, firstPolygon);
+			const int secondCount = ClipTriangle(second, NearPlane, bounds, secondPolygon);
+			bool isShared{ false };
+			for (int i{ 0 }; i < firstCount; ++i)
+				for (int j{ 0 }; j < secondCount; ++j)
+					isShared |= firstPolygon[i].position.z == 0.f && firstPolygon[i].weights[1] == 0.f && secondPolygon[j].weights[2] == 0.f
+						&& firstPolygon[i].position.x == secondPolygon[j].position.x && firstPolygon[i].position.y == secondPolygon[j].position.y
+						&& firstPolygon[i].position.w == secondPolygon[j].position.w;
+			Bench::Check(firstCount == 4 && secondCount == 4 && isShared, "ClipKernels::ClipTriangle cuts a shared edge at one point");
+		}
+
+		// A floor running under the camera: its triangles start behind the eye, so without a clipper it disappears.
+		// Clipped, every pixel below its far edge is covered exactly like a floor seen from above
+		// ------
+		{
+			std::vector<Vertex_In> vertices{};
+			std::vector<uint32_t> indices{};
+			AppendQuad({ 0.f, -1.f, 0.f }, { 60.f, 0.f, 0.f }, { 0.f, 0.f, 50.f }, vertices, indices);
+			for (Vertex_In& vertex : vertices)
+				vertex.normal = Vector3::UnitY;
+
+			SoftwareRenderer renderer{ 640, 480, 2 };
+			renderer.BeginFrame(colors::Black);
+			renderer.Draw({ vertices, indices, false }, {}, CreateViewProjection({}, Vector3::UnitZ), {}, FilteringMethod::Point);
+			const SoftwareRenderer::FrameStats& stats = renderer.EndFrame();
+
+			// The far edge (z = 50) is just below the horizon, around row 252
+			bool isCovered{ true };
+			for (int y{ 260 }; y < 480; ++y)
+				for (int x{ 0 }; x < 640; ++x)
+					isCovered &= renderer.GetColorBuffer()[size_t(y) * 640 + x].r > 0.f;
+			Bench::Check(stats.numClipped == 2 && stats.numRasterized >= 2 && isCovered, "SoftwareRenderer clips a floor crossing the near plane without gaps");
+		}
+
+		// Classification of the vehicle stand-in from inside it (items = triangles)
+		// ------
+		TestScene scene{};
+		CreateTestScene(scene);
+		{
+			const Matrix viewProjection = CreateViewProjection({ 0.f, 0.f, 45.f }, Vector3::UnitZ);
+			std::vector<Vector4> positions(scene.vehicleVertices.size());
+			for (size_t i{ 0 }; i < positions.size(); ++i)
+				positions[i] = viewProjection.TransformPoint(Vector4{ scene.vehicleVertices[i].position + Vector3{ 0.f, 0.f, 50.f }, 1.f });
+
+			std::vector<ClipCodes> codes(scene.vehicleIndices.size() / 3);
+			Bench::Run("Clip/Classify/Scalar", codes.size(), [&]
+				{
+					ClassifyTrianglesReference(positions, scene.vehicleIndices, bounds, codes);
+					Bench::DoNotOptimize(codes.back());
+				});
+			Bench::Run("Clip/Classify/SIMD", codes.size(), [&]
+				{
+					ClassifyTriangles(positions, scene.vehicleIndices, bounds, codes);
+					Bench::DoNotOptimize(codes.back());
+				});
+		}
+
+		// Whole camera paths (items = frames), with the share of triangles that needed clipping.
+		// Orbit: circles the scene at 30 units, nothing crosses the near plane. FlyThrough: flies straight through the vehicle
+		// ------
+		SoftwareRenderer renderer{ 640, 480 };
+		for (const auto& [name, getCamera] : { std::pair{ "Orbit", &GetOrbitCamera }, std::pair{ "FlyThrough", &GetFlyThroughCamera } })
+		{
+			uint64_t numSubmitted{}, numClipped{};
+			const Bench::Result result = Bench::Run(std::string{ "Clip/Path/" } + name, s_NumPathSteps, [&]
+				{
+					numSubmitted = numClipped = 0;
+					for (int step{ 0 }; step < s_NumPathSteps; ++step)
+					{
+						const auto [origin, forward] = getCamera(step);
+						const Matrix world = Matrix::CreateTranslation(0.f, 0.f, 50.f);
+						const Matrix worldViewProjection = world * CreateViewProjection(origin, forward);
+						renderer.BeginFrame(colors::Black);
+						renderer.Draw(scene.GetVehicleMesh(), world, worldViewProjection, origin, FilteringMethod::Linear);
+						renderer.Draw(scene.GetFireMesh(), world, worldViewProjection, origin, FilteringMethod::Linear);
+						const SoftwareRenderer::FrameStats& stats = renderer.EndFrame();
+						numSubmitted += stats.numTriangles;
+						numClipped += stats.numClipped;
+					}
+				});
+			if (result.items > 0)
+				std::printf("  %.3f%% of the triangles clipped\n", 100.0 * numClipped / std::max<uint64_t>(numSubmitted, 1));
+		}
+	}
+}
@@ -0,0 +1,176 @@
+#include "Benchmark.h"
+
+#include <cstring>
+#include <random>
+
+#include "ColorKernels.h"
+
+namespace dae
+{
+	// Largest per channel difference between two packed RGBA8 pixels
+	static int MaxChannelDifference(uint32_t a, uint32_t b)
+	{
+		int maxDifference{};
+		for (int shift{ 0 }; shift < 32; shift += 8)
+			maxDifference = std::max(maxDifference, std::abs(int((a >> shift) & 0xFF) - int((b >> shift) & 0xFF)));
+		return maxDifference;
+	}
+
+	static float MaxDifference(const std::vector<ColorRGB>& a, const std::vector<ColorRGB>& b)
+	{
+		float maxDifference{};
+		for (size_t i{ 0 }; i < a.size(); ++i)
+		{
+			maxDifference = std::max(maxDifference, std::abs(a[i].r - b[i].r));
+			maxDifference = std::max(maxDifference, std::abs(a[i].g - b[i].g));
+			maxDifference = std::max(maxDifference, std::abs(a[i].b - b[i].b));
+		}
+		return maxDifference;
+	}
+
+	void RunColorBenchmarks()
+	{
+		// Batch kernels against the scalar operators
+		// Odd count so every kernel also runs its scalar tail
+		// ------
+		constexpr size_t checkCount{ 10'007 };
+		std::mt19937 rng{ 11 };
+		std::uniform_real_distribution<float> hdr{ -0.5f, 4.f };
+		std::vector<ColorRGB> source(checkCount), other(checkCount);
+		for (size_t i{ 0 }; i < checkCount; ++i)
+		{
+			source[i] = { hdr(rng), hdr(rng), hdr(rng) };
+			other[i] = { hdr(rng), hdr(rng), hdr(rng) };
+		}
+
+		std::vector<ColorRGB> batch{ source }, reference{ source };
+		ColorKernels::MultiplyAdd(batch, other, other);
+		for (size_t i{ 0 }; i < checkCount; ++i)
+			reference[i] += other[i] * other[i];
+		Bench::Check(MaxDifference(batch, reference) <= 1e-6f, "ColorKernels::MultiplyAdd matches operators");
+
+		batch = reference = source;
+		ColorKernels::MultiplyAdd(batch, other, 0.25f);
+		for (size_t i{ 0 }; i < checkCount; ++i)
+			reference[i] += other[i] * 0.25f;
+		Bench::Check(MaxDifference(batch, reference) <= 1e-6f, "ColorKernels::MultiplyAdd (scale) matches operators");
+
+		batch = reference = source;
+		ColorKernels::Clamp(batch);
+		for (ColorRGB& color : reference)
+			color = { Saturate(color.r), Saturate(color.g), Saturate(color.b) };
+		Bench::Check(MaxDifference(batch, reference) == 0.f, "ColorKernels::Clamp bit exact");
+
+		batch = reference = source;
+		ColorKernels::MaxToOne(batch);
+		for (ColorRGB& color : reference)
+			color.MaxToOne();
+		Bench::Check(std::memcmp(batch.data(), reference.data(), checkCount * sizeof(ColorRGB)) == 0, "ColorKernels::MaxToOne bit exact");
+
+		batch = reference = source;
+		ColorKernels::ToneMapReinhard(std::span<ColorRGB>{ batch }, 1.5f);
+		for (ColorRGB& color : reference)
+			color = ColorKernels::ToneMapReinhard(color, 1.5f);
+		Bench::Check(MaxDifference(batch, reference) <= 1e-6f, "ColorKernels::ToneMapReinhard matches scalar");
+
+		batch = reference = source;
+		ColorKernels::ToneMapACES(std::span<ColorRGB>{ batch }, 1.5f);
+		for (ColorRGB& color : reference)
+			color = ColorKernels::ToneMapACES(color, 1.5f);
+		Bench::Check(MaxDifference(batch, reference) <= 1e-6f, "ColorKernels::ToneMapACES matches scalar");
+
+		// Packing, the sRGB batch goes through a table so it gets one step of slack
+		std::vector<uint32_t> pixels(checkCount);
+		int maxLinearError{}, maxSRGBError{};
+		ColorKernels::PackRGBA8(source, pixels, false);
+		for (size_t i{ 0 }; i < checkCount; ++i)
+			maxLinearError = std::max(maxLinearError, MaxChannelDifference(pixels[i], ColorKernels::PackRGBA8(source[i], false)));
+		ColorKernels::PackRGBA8(source, pixels, true);
+		for (size_t i{ 0 }; i < checkCount; ++i)
+			maxSRGBError = std::max(maxSRGBError, MaxChannelDifference(pixels[i], ColorKernels::PackRGBA8(source[i], true)));
+		Bench::Check(maxLinearError == 0, "ColorKernels::PackRGBA8 (linear) bit exact");
+		Bench::Check(maxSRGBError <= 1, "ColorKernels::PackRGBA8 (sRGB) within 1/255");
+
+		// Throughput, scalar operators vs batch kernels on full frames
+		// ------
+		for (const size_t count : { size_t{ 640 * 480 }, size_t{ 3840 * 2160 } })
+		{
+			const std::string suffix = "/" + std::to_string(count);
+
+			std::vector<ColorRGB> frame(count), light(count), work(count);
+			for (size_t i{ 0 }; i < count; ++i)
+			{
+				frame[i] = { hdr(rng), hdr(rng), hdr(rng) };
+				light[i] = { hdr(rng), hdr(rng), hdr(rng) };
+			}
+			std::vector<uint32_t> output(count);
+
+			Bench::Run("Color/MultiplyAdd/Scalar" + suffix, count, [&]
+				{
+					for (size_t i{ 0 }; i < count; ++i)
+						work[i] += frame[i] * light[i];
+					Bench::DoNotOptimize(work.front());
+				});
+
+			Bench::Run("Color/MultiplyAdd/Batch" + suffix, count, [&]
+				{
+					ColorKernels::MultiplyAdd(work, frame, light);
+					Bench::DoNotOptimize(work.front());
+				});
+
+			Bench::Run("Color/MaxToOne/Scalar" + suffix, count, [&]
+				{
+					std::copy(frame.begin(), frame.end(), work.begin());
+					for (ColorRGB& color : work)
+						color.MaxToOne();
+					Bench::DoNotOptimize(work.front());
+				});
+
+			Bench::Run("Color/MaxToOne/Batch" + suffix, count, [&]
+				{
+					std::copy(frame.begin(), frame.end(), work.begin());
+					ColorKernels::MaxToOne(work);
+					Bench::DoNotOptimize(work.front());
+				});
+
+			Bench::Run("Color/ACES/Scalar" + suffix, count, [&]
+				{
+					for (size_t i{ 0 }; i < count; ++i)
+						work[i] = ColorKernels::ToneMapACES(frame[i]);
+					Bench::DoNotOptimize(work.front());
+				});
+
+			Bench::Run("Color/ACES/Batch" + suffix, count, [&]
+				{
+					std::copy(frame.begin(), frame.end(), work.begin());
+					ColorKernels::ToneMapACES(std::span<ColorRGB>{ work });
+					Bench::DoNotOptimize(work.front());
+				});
+
+			Bench::Run("Color/Reinhard/Batch" + suffix, count, [&]
+				{
+					std::copy(frame.begin(), frame.end(), work.begin());
+					ColorKernels::ToneMapReinhard(std::span<ColorRGB>{ work });
+					Bench::DoNotOptimize(work.front());
+				});
+
+			for (const bool sRGB : { false, true })
+			{
+				const std::string name = sRGB ? "Color/PackSRGB" : "Color/PackLinear";
+
+				Bench::Run(name + "/Scalar" + suffix, count, [&]
+					{
+						for (size_t i{ 0 }; i < count; ++i)
+							output[i] = ColorKernels::PackRGBA8(frame[i], sRGB);
+						Bench::DoNotOptimize(output.front());
+					});
+
+				Bench::Run(name + "/Batch" + suffix, count, [&]
+					{
+						ColorKernels::PackRGBA8(frame, output, sRGB);
+						Bench::DoNotOptimize(output.front());
+					});
+			}
+		}
+	}
+}
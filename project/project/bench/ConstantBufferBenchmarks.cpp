@@ -0,0 +1,217 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "ConstantBufferRing.h"
+#include "DrawList.h"
+#include "Math.h"
+#include "Mesh.h"
+#include "NullRenderDevice.h"
+#include "StateCache.h"
+#include "TestScene.h"
+
+namespace dae
+{
+	// A block the simulated GPU may still read until its frame's fence completed (fence 0: frame still recording)
+	struct WrittenBlock
+	{
+		uint32_t byteOffset{};
+		uint32_t byteSize{};
+		uint64_t fence{};
+		BufferHandle buffer{};
+	};
+
+	void RunConstantBufferBenchmarks()
+	{
+		// Random block sizes and counts per frame against a GPU 3 fences behind: no block is ever written over
+		// while its frame is in flight, and every block is aligned for a range bind
+		// ------
+		{
+			NullRenderDevice device{};
+			device.SetFenceLatency(3);
+			ICommandContext& context = device.GetImmediateContext();
+			ConstantBufferRing ring{ device, 4096 };
+
+			std::mt19937 rng{ 48 };
+			std::uniform_int_distribution<uint32_t> sizeDist{ 16, 600 };
+			std::uniform_int_distribution<uint32_t> countDist{ 0, 6 };
+			const uint8_t data[600]{};
+
+			std::vector<WrittenBlock> blocks{};
+			bool isExpected{ true };
+			for (int frame{ 0 }; frame < 1000; ++frame)
+			{
+				const uint32_t numBlocks = countDist(rng);
+				for (uint32_t block{ 0 }; block < numBlocks; ++block)
+				{
+					const ConstantBufferRange range = ring.Write(context, data, sizeDist(rng));
+					const uint64_t completedFence = device.GetCompletedFence();
+					isExpected &= range.byteOffset % ConstantBufferRing::s_Alignment == 0 && range.byteOffset + range.byteSize <= ring.GetSize();
+					for (const WrittenBlock& written : blocks)
+					{
+						const bool isInUse = written.fence == 0 || written.fence > completedFence;
+						const bool overlaps = written.buffer == range.buffer && range.byteOffset < written.byteOffset + written.byteSize && written.byteOffset < range.byteOffset + range.byteSize;
+						isExpected &= !(isInUse && overlaps);
+					}
+					blocks.push_back({ range.byteOffset, range.byteSize, 0, range.buffer });
+				}
+
+				ring.EndFrame(context);
+				for (WrittenBlock& written : blocks)
+					if (written.fence == 0)
+						written.fence = device.GetLastSignaledFence();
+				const uint64_t completedFence = device.GetCompletedFence();
+				std::erase_if(blocks, [&](const WrittenBlock& written) { return written.fence <= completedFence; });
+			}
+			isExpected &= ring.GetUsedSize() <= ring.GetSize() && ring.GetNumFramesInFlight() <= 3;
+			Bench::Check(isExpected, "ConstantBufferRing never writes over a block the GPU may still read");
+			Bench::Check(ring.GetNumStalls() > 0 && ring.GetNumStalls() == device.GetNumFenceWaits(), "ConstantBufferRing waits for the GPU when it is full");
+		}
+
+		// A frame bigger than the whole ring grows it; the old buffer is only destroyed once that frame's fence passed
+		// ------
+		{
+			NullRenderDevice device{};
+			device.SetFenceLatency(1);
+			ICommandContext& context = device.GetImmediateContext();
+			ConstantBufferRing ring{ device, 1024 };
+			const BufferHandle firstBuffer = ring.GetBuffer();
+			const PerObjectConstants constants{};
+
+			for (int block{ 0 }; block < 5; ++block)
+				ring.Write(context, constants);
+			bool isExpected = ring.GetNumGrows() == 1 && ring.GetSize() >= 2048 && !(ring.GetBuffer() == firstBuffer);
+			isExpected &= device.GetLiveResourceCount() == 2;
+
+			ring.EndFrame(context);
+			isExpected &= device.GetLiveResourceCount() == 2;	// the GPU is one fence behind
+			ring.EndFrame(context);
+			isExpected &= device.GetLiveResourceCount() == 1 && ring.GetNumStalls() == 0;
+			Bench::Check(isExpected, "ConstantBufferRing grows for oversized frames and keeps the old buffer until the GPU is done");
+		}
+
+		// Steady state frames neither wait nor allocate
+		// ------
+		{
+			NullRenderDevice device{};
+			device.SetFenceLatency(2);
+			ICommandContext& context = device.GetImmediateContext();
+			ConstantBufferRing ring{ device, 16 * 1024 };
+			const PerObjectConstants constants{};
+
+			const auto renderFrame = [&]
+				{
+					ring.Write(context, PerFrameConstants{});
+					for (int draw{ 0 }; draw < 10; ++draw)
+						ring.Write(context, constants);
+					ring.EndFrame(context);
+				};
+			for (int frame{ 0 }; frame < 8; ++frame)
+				renderFrame();
+			const uint64_t numAllocationsBefore = Bench::GetNumHeapAllocations();
+			for (int frame{ 0 }; frame < 100; ++frame)
+				renderFrame();
+			const bool isExpected = Bench::GetNumHeapAllocations() == numAllocationsBefore && ring.GetNumStalls() == 0 && ring.GetNumGrows() == 0;
+			Bench::Check(isExpected && ring.GetNumFramesInFlight() == 2, "Steady state ConstantBufferRing frames don't wait or allocate");
+		}
+
+		TestScene scene{};
+		CreateTestScene(scene);
+
+		NullRenderDevice device{};
+		device.SetFenceLatency(2);
+		ICommandContext& context = device.GetImmediateContext();
+		StateCache stateCache{ context };
+
+		GpuTestScene gpuScene{};
+		CreateGpuTestScene(scene, device, gpuScene);
+		auto pConstants = std::make_unique<ConstantBufferRing>(device, 1024 * 1024);
+
+		const Matrix world = Matrix::CreateTranslation(0.f, 0.f, 50.f);
+		const Matrix viewProjection = Matrix::CreatePerspectiveFovLH(tanf((45.f * TO_RADIANS) / 2.f), 640.f / 480.f, 0.1f, 100.f);
+
+		// Both meshes from the ring: per draw one block write and one range bind replace 2 matrices + the camera,
+		// the frame's camera block is written once and binding it again for the second mesh is skipped
+		// ------
+		{
+			device.ResetCounters();
+			const ConstantBufferRange frameRange = pConstants->Write(stateCache, PerFrameConstants{ viewProjection, {} });
+			for (Mesh* pMesh : { gpuScene.pVehicle.get(), gpuScene.pFire.get() })
+			{
+				stateCache.SetConstantBuffer(PerFrameConstants::Slot, frameRange.buffer, frameRange.byteOffset, frameRange.byteSize);
+				pMesh->Render(stateCache, pConstants->Write(stateCache, PerObjectConstants{ world * viewProjection, world }), FilteringMethod::Linear);
+			}
+			stateCache.Present();
+			pConstants->EndFrame(stateCache);
+
+			bool isExpected = device.GetCallCount(RenderCall::SetEffectMatrix) == 0 && device.GetCallCount(RenderCall::SetEffectVector) == 0;
+			isExpected &= device.GetCallCount(RenderCall::WriteBuffer) == 3 && device.GetCallCount(RenderCall::SetConstantBuffer) == 3;
+			isExpected &= stateCache.GetLastFrameStats().numSkippedConstantBuffers == 1;
+			isExpected &= device.GetCallCount(RenderCall::DrawIndexed) == 2 && device.GetCallCount(RenderCall::SignalFence) == 1;
+			Bench::Check(isExpected, "Mesh::Render with a ring binds constant ranges instead of setting effect variables");
+		}
+
+		// Effect variables, a range and the same effect variables again: the cache skips the unchanged matrices,
+		// but releasing the range still has to re-apply the pass, which binds the effect's own cbuffer again
+		// ------
+		{
+			stateCache.Invalidate();
+			gpuScene.pVehicle->Render(stateCache, world, world * viewProjection, {}, FilteringMethod::Linear);
+			gpuScene.pVehicle->Render(stateCache, pConstants->Write(stateCache, PerObjectConstants{ world * viewProjection, world }), FilteringMethod::Linear);
+			device.ResetCounters();
+			gpuScene.pVehicle->Render(stateCache, world, world * viewProjection, {}, FilteringMethod::Linear);
+			stateCache.Present();
+			pConstants->EndFrame(stateCache);
+
+			bool isExpected = device.GetCallCount(RenderCall::SetConstantBuffer) == 1 && device.GetCallCount(RenderCall::SetEffectMatrix) == 0;
+			isExpected &= device.GetCallCount(RenderCall::ApplyTechnique) == 1;
+			Bench::Check(isExpected, "StateCache re-applies the pass after a constant buffer slot was released");
+		}
+
+		// 1000 draws alternating between the meshes through the state cache (items = draws), every draw with its own
+		// world matrix: 2 matrices + the camera as effect variables against a range bind (all blocks in one write)
+		// ------
+		constexpr uint32_t numDraws{ 1000 };
+		DrawList drawList{};
+		for (uint32_t i{ 0 }; i < numDraws; ++i)
+		{
+			Mesh& mesh = (i % 2 == 0) ? *gpuScene.pVehicle : *gpuScene.pFire;
+			const Matrix drawWorld = Matrix::CreateTranslation(0.1f * i, 0.f, 50.f);
+			drawList.Submit(mesh.GetSortKey(0, 0.5f, FilteringMethod::Linear), { &mesh, drawWorld, drawWorld * viewProjection, {}, FilteringMethod::Linear });
+		}
+		drawList.Sort();
+
+		device.ResetCounters();
+		const Bench::Result variables = Bench::Run("Constants/StateCache/EffectVariables/1000", numDraws, [&]
+			{
+				drawList.Execute(stateCache);
+				stateCache.Present();
+			});
+		if (variables.items > 0)
+			std::printf("  %.1f context calls per draw\n", double(device.GetContextCallCount()) / double(device.GetCallCount(RenderCall::DrawIndexed)));
+
+		device.ResetCounters();
+		const Bench::Result ring = Bench::Run("Constants/StateCache/ConstantRing/1000", numDraws, [&]
+			{
+				pConstants->Bind(stateCache, PerFrameConstants{ viewProjection, {} });
+				drawList.Execute(stateCache, *pConstants);
+				stateCache.Present();
+				pConstants->EndFrame(stateCache);
+			});
+		if (ring.items > 0)
+		{
+			std::printf("  %.1f context calls per draw, ring high watermark %u of %u bytes\n",
+				double(device.GetContextCallCount()) / double(device.GetCallCount(RenderCall::DrawIndexed)), pConstants->GetHighWatermark(), pConstants->GetSize());
+			if (variables.items > 0)
+				std::printf("  %.2fx the effect variable submission rate\n", variables.nsPerItem / ring.nsPerItem);
+			Bench::Check(pConstants->GetNumStalls() == 0 && pConstants->GetNumGrows() == 0, "1000 draws per frame fit the ring without waiting for the GPU");
+		}
+
+		pConstants.reset();
+		gpuScene.Release();
+		Bench::Check(device.GetLiveResourceCount() == 0, "ConstantBufferRing releases its buffers");
+	}
+}
@@ -0,0 +1,165 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "DrawList.h"
+#include "Math.h"
+#include "Mesh.h"
+#include "NullRenderDevice.h"
+#include "TestScene.h"
+
+namespace dae
+{
+	static constexpr uint32_t s_NumPackets{ 100'000 };
+
+	// Key fields of one packet, drawn from a handful of effects/techniques/texture sets like a real scene
+	struct KeyFields
+	{
+		uint32_t layer{};
+		uint32_t effect{};
+		uint32_t technique{};
+		uint32_t textureSet{};
+		float depth{};
+		bool isTranslucent{};
+	};
+
+	static std::vector<KeyFields> CreateKeyFields(uint32_t count)
+	{
+		std::mt19937 rng{ 41 };
+		std::uniform_int_distribution<uint32_t> layerDist{ 0, 2 };
+		std::uniform_int_distribution<uint32_t> effectDist{ 1, 8 };
+		std::uniform_int_distribution<uint32_t> techniqueDist{ 1, 3 };
+		std::uniform_int_distribution<uint32_t> textureSetDist{ 1, 200 };
+		std::uniform_real_distribution<float> depthDist{ 0.f, 1.f };
+		std::bernoulli_distribution translucentDist{ 0.2 };
+
+		std::vector<KeyFields> fields(count);
+		for (KeyFields& field : fields)
+			field = { layerDist(rng), effectDist(rng), techniqueDist(rng), textureSetDist(rng), depthDist(rng), translucentDist(rng) };
+		return fields;
+	}
+
+	static uint64_t MakeKey(const KeyFields& field)
+	{
+		return field.isTranslucent
+			? DrawKey::MakeTranslucent(field.layer, field.effect, field.technique, field.textureSet, field.depth)
+			: DrawKey::MakeOpaque(field.layer, field.effect, field.technique, field.textureSet, field.depth);
+	}
+
+	void RunDrawListBenchmarks()
+	{
+		const std::vector<KeyFields> fields = CreateKeyFields(s_NumPackets);
+		std::vector<DrawList::SortItem> unsorted(s_NumPackets);
+		for (uint32_t i{ 0 }; i < s_NumPackets; ++i)
+			unsorted[i] = { MakeKey(fields[i]), i };
+
+		// The radix sort is stable: same order as std::stable_sort on the key
+		// ------
+		std::vector<DrawList::SortItem> items = unsorted;
+		std::vector<DrawList::SortItem> scratch{};
+		DrawList::RadixSort(items, scratch);
+		{
+			std::vector<DrawList::SortItem> expected = unsorted;
+			std::stable_sort(expected.begin(), expected.end(), [](const DrawList::SortItem& a, const DrawList::SortItem& b) { return a.key < b.key; });
+			bool isSame{ true };
+			for (uint32_t i{ 0 }; i < s_NumPackets; ++i)
+				isSame &= items[i].key == expected[i].key && items[i].packetIndex == expected[i].packetIndex;
+			Bench::Check(isSame, "DrawList::RadixSort matches std::stable_sort");
+		}
+
+		// Layers in order, opaque before translucent, opaque front to back per state and translucent back to front
+		// ------
+		{
+			bool isOrdered{ true };
+			for (uint32_t i{ 1 }; i < s_NumPackets; ++i)
+			{
+				const KeyFields& previous = fields[items[i - 1].packetIndex];
+				const KeyFields& current = fields[items[i].packetIndex];
+				if (previous.layer != current.layer)
+				{
+					isOrdered &= previous.layer < current.layer;
+					continue;
+				}
+				if (previous.isTranslucent != current.isTranslucent)
+				{
+					isOrdered &= !previous.isTranslucent;
+					continue;
+				}
+				// Depths are compared as quantized into the key
+				const uint32_t previousDepth = DrawKey::QuantizeDepth(previous.depth);
+				const uint32_t currentDepth = DrawKey::QuantizeDepth(current.depth);
+				if (current.isTranslucent)
+					isOrdered &= previousDepth >= currentDepth;
+				else if (previous.effect == current.effect && previous.technique == current.technique && previous.textureSet == current.textureSet)
+					isOrdered &= previousDepth <= currentDepth;
+			}
+			Bench::Check(isOrdered, "DrawList keys order layers, opaque front to back and translucent back to front");
+		}
+
+		// Execute replays in key order: the fire submitted first still draws after the vehicle
+		// ------
+		TestScene scene{};
+		CreateTestScene(scene);
+		NullRenderDevice device{};
+		GpuTestScene gpuScene{};
+		CreateGpuTestScene(scene, device, gpuScene);
+		Mesh& vehicle = *gpuScene.pVehicle;
+		Mesh& fire = *gpuScene.pFire;
+
+		const Matrix world = Matrix::CreateTranslation(0.f, 0.f, 50.f);
+		DrawList drawList{};
+		{
+			drawList.Submit(fire.GetSortKey(0, 0.4f, FilteringMethod::Linear), { &fire, world, world, {}, FilteringMethod::Linear });
+			drawList.Submit(vehicle.GetSortKey(0, 0.5f, FilteringMethod::Linear), { &vehicle, world, world, {}, FilteringMethod::Linear });
+			drawList.Sort();
+
+			device.SetRecording(true);
+			drawList.Execute(device.GetImmediateContext());
+			device.SetRecording(false);
+
+			std::vector<uint32_t> drawnIndexCounts{};
+			for (const NullRenderDevice::RecordedCall& call : device.GetRecordedCalls())
+				if (call.call == RenderCall::DrawIndexed)
+					drawnIndexCounts.push_back(call.value);
+			Bench::Check(drawnIndexCounts == std::vector<uint32_t>{ uint32_t(scene.vehicleIndices.size()), uint32_t(scene.fireIndices.size()) },
+				"DrawList::Execute draws opaque meshes before blended ones");
+		}
+
+		// Key packing and sorting at 100k packets (items = packets). Both sorts copy the unsorted keys in first
+		// ------
+		std::vector<uint64_t> keys(s_NumPackets);
+		Bench::Run("DrawList/PackKeys/100k", s_NumPackets, [&]
+			{
+				for (uint32_t i{ 0 }; i < s_NumPackets; ++i)
+					keys[i] = MakeKey(fields[i]);
+				Bench::DoNotOptimize(keys.back());
+			});
+
+		Bench::Run("DrawList/RadixSort/100k", s_NumPackets, [&]
+			{
+				std::copy(unsorted.begin(), unsorted.end(), items.begin());
+				DrawList::RadixSort(items, scratch);
+				Bench::DoNotOptimize(items.front());
+			});
+
+		Bench::Run("DrawList/StdSort/100k", s_NumPackets, [&]
+			{
+				std::copy(unsorted.begin(), unsorted.end(), items.begin());
+				std::sort(items.begin(), items.end(), [](const DrawList::SortItem& a, const DrawList::SortItem& b) { return a.key < b.key; });
+				Bench::DoNotOptimize(items.front());
+			});
+
+		// A whole frame's list: submit packets (keys packed on the way in) and sort them, without drawing
+		// ------
+		Bench::Run("DrawList/SubmitAndSort/100k", s_NumPackets, [&]
+			{
+				drawList.Clear();
+				for (uint32_t i{ 0 }; i < s_NumPackets; ++i)
+					drawList.Submit(MakeKey(fields[i]), { fields[i].isTranslucent ? &fire : &vehicle, world, world, {}, FilteringMethod::Point });
+				drawList.Sort();
+				Bench::DoNotOptimize(drawList.GetSortedItems().front());
+			});
+	}
+}
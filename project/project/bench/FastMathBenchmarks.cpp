@@ -0,0 +1,144 @@
+#include "Benchmark.h"
+
+#include <random>
+
+#include "Math.h"
+#include "Utils.h"
+#include "TestScene.h"
+
+namespace dae
+{
+	void RunFastMathBenchmarks()
+	{
+		// Error bounds documented in FastMath.h
+		// ------
+		double maxRSqrtError{}, maxRcpError{}, maxSinError{}, maxCosError{};
+		for (double x{ 1e-30 }; x < 1e30; x *= 1.0001)
+		{
+			const float value = static_cast<float>(x);
+			maxRSqrtError = std::max(maxRSqrtError, std::abs(FastMath::RSqrt(value) * std::sqrt(double(value)) - 1.0));
+			maxRcpError = std::max(maxRcpError, std::abs(FastMath::Rcp(value) * double(value) - 1.0));
+		}
+		for (double x{ -100 * PI }; x < 100 * PI; x += 1e-4)
+		{
+			const float value = static_cast<float>(x);
+			maxSinError = std::max(maxSinError, std::abs(FastMath::Sin(value) - std::sin(double(value))));
+			maxCosError = std::max(maxCosError, std::abs(FastMath::Cos(value) - std::cos(double(value))));
+		}
+		std::printf("FastMath max error: RSqrt %.3g (rel), Rcp %.3g (rel), Sin %.3g, Cos %.3g\n", maxRSqrtError, maxRcpError, maxSinError, maxCosError);
+		Bench::Check(maxRSqrtError <= 3.0e-7, "FastMath::RSqrt within documented error");
+		Bench::Check(maxRcpError <= 2.5e-7, "FastMath::Rcp within documented error");
+		Bench::Check(maxSinError <= 2.4e-7, "FastMath::Sin within documented error");
+		Bench::Check(maxCosError <= 2.4e-7, "FastMath::Cos within documented error");
+
+		// Normalization
+		// ------
+		constexpr size_t count{ 1'000'000 };
+		std::mt19937 rng{ 7 };
+		std::uniform_real_distribution<float> dist{ -100.f, 100.f };
+		std::vector<Vector3> source(count);
+		for (Vector3& v : source)
+			v = { dist(rng), dist(rng), dist(rng) };
+
+		std::vector<Vector3> exact{ source }, fast{ source };
+		Vector3::Normalize(exact.data(), count, MathPrecision::Exact);
+		Vector3::Normalize(fast.data(), count, MathPrecision::Fast);
+		float maxBatchError{};
+		size_t exactMismatches{};
+		for (size_t i{ 0 }; i < count; ++i)
+		{
+			const Vector3 reference = source[i].Normalized();
+			exactMismatches += (exact[i] - reference).SqrMagnitude() > 1e-12f;
+			maxBatchError = std::max(maxBatchError, (fast[i] - reference).Magnitude());
+		}
+		Bench::Check(exactMismatches == 0, "Vector3::Normalize batch (exact) matches Normalized()");
+		Bench::Check(maxBatchError < 1e-6f, "Vector3::Normalize batch (fast) within RSqrt error");
+
+		Bench::Run("Normalize/Normalized", count, [&]
+			{
+				Vector3 sum{};
+				for (const Vector3& v : source)
+					sum += v.Normalized();
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Normalize/NormalizedFast", count, [&]
+			{
+				Vector3 sum{};
+				for (const Vector3& v : source)
+					sum += v.NormalizedFast();
+				Bench::DoNotOptimize(sum);
+			});
+
+		std::vector<Vector3> work(count);
+		Bench::Run("Normalize/BatchExact", count, [&]
+			{
+				std::copy(source.begin(), source.end(), work.begin());
+				Vector3::Normalize(work.data(), count, MathPrecision::Exact);
+				Bench::DoNotOptimize(work.front());
+			});
+
+		Bench::Run("Normalize/BatchFast", count, [&]
+			{
+				std::copy(source.begin(), source.end(), work.begin());
+				Vector3::Normalize(work.data(), count, MathPrecision::Fast);
+				Bench::DoNotOptimize(work.front());
+			});
+
+		// Trig
+		// ------
+		std::vector<float> angles(4096);
+		for (float& angle : angles)
+			angle = dist(rng);
+
+		Bench::Run("Trig/sinf+cosf", angles.size(), [&]
+			{
+				float sum{};
+				for (const float angle : angles)
+					sum += sinf(angle) + cosf(angle);
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Trig/FastMath::Sin+Cos", angles.size(), [&]
+			{
+				float sum{};
+				for (const float angle : angles)
+					sum += FastMath::Sin(angle) + FastMath::Cos(angle);
+				Bench::DoNotOptimize(sum);
+			});
+
+		// Import time tangent generation (ParseOBJ minus the file parsing)
+		// ------
+		std::vector<Vertex_In> sphereVertices{};
+		std::vector<uint32_t> sphereIndices{};
+		CreateSphere(256, 256, 2.f, sphereVertices, sphereIndices);
+
+		std::vector<Vertex_In> exactTangents{ sphereVertices }, fastTangents{ sphereVertices };
+		Utils::ComputeTangents(exactTangents, sphereIndices, MathPrecision::Exact);
+		Utils::ComputeTangents(fastTangents, sphereIndices, MathPrecision::Fast);
+		float maxTangentError{};
+		for (size_t i{ 0 }; i < exactTangents.size(); ++i)
+		{
+			// Pole vertices have degenerate uv triangles, both paths produce NaN there
+			if (std::isfinite(exactTangents[i].tangent.x))
+				maxTangentError = std::max(maxTangentError, (exactTangents[i].tangent - fastTangents[i].tangent).Magnitude());
+		}
+		std::printf("ComputeTangents fast vs exact max error: %.3g\n", maxTangentError);
+		Bench::Check(maxTangentError < 1e-5f, "Utils::ComputeTangents fast close to exact");
+
+		std::vector<Vertex_In> tangentWork{};
+		Bench::Run("Tangents/Exact", sphereVertices.size(), [&]
+			{
+				tangentWork = sphereVertices;
+				Utils::ComputeTangents(tangentWork, sphereIndices, MathPrecision::Exact);
+				Bench::DoNotOptimize(tangentWork.front());
+			});
+
+		Bench::Run("Tangents/Fast", sphereVertices.size(), [&]
+			{
+				tangentWork = sphereVertices;
+				Utils::ComputeTangents(tangentWork, sphereIndices, MathPrecision::Fast);
+				Bench::DoNotOptimize(tangentWork.front());
+			});
+	}
+}
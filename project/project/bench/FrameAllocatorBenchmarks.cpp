@@ -0,0 +1,213 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "ConstantBufferRing.h"
+#include "DrawList.h"
+#include "FrameAllocator.h"
+#include "Frustum.h"
+#include "InstanceBuffer.h"
+#include "Math.h"
+#include "Mesh.h"
+#include "NullRenderDevice.h"
+#include "OcclusionCuller.h"
+#include "StateCache.h"
+#include "TestScene.h"
+
+namespace dae
+{
+	static constexpr uint32_t s_NumParkedVehicles{ 10'000 };
+
+	// What Renderer::Render needs besides the device
+	struct RenderObjects
+	{
+		Mesh* pVehicle{};
+		Mesh* pFire{};
+		ConstantBufferRing* pConstants{};
+		std::vector<Vector3> occluderPositions{};
+		std::span<const uint32_t> occluderIndices{};
+		std::vector<Matrix> parkingLot{};
+		OcclusionCuller occlusionCuller{ 320, 240 };
+		DrawList drawList{};
+		FrameAllocator frameAllocator{ 2, 256 * 1024 };
+	};
+
+	// Renderer::Render: cull, sort and draw both meshes, then the parking lot culled into frame memory
+	static void RenderFrame(ICommandContext& context, InstanceBuffer& parkingLot, RenderObjects& objects, const Matrix& world, const Matrix& viewProjection)
+	{
+		objects.frameAllocator.BeginFrame();
+		context.ClearRenderTarget({ .39f,.59f,.93f });
+		context.ClearDepthStencil(1.f, 0);
+
+		const Matrix worldViewProjection = world * viewProjection;
+		const Frustum frustum{ worldViewProjection };
+		objects.drawList.Clear();
+		objects.occlusionCuller.BeginFrame();
+		if (frustum.IsVisible(objects.pVehicle->GetBounds()))
+		{
+			objects.drawList.Submit(objects.pVehicle->GetSortKey(0, 0.5f, FilteringMethod::Linear), { objects.pVehicle, world, worldViewProjection, {}, FilteringMethod::Linear });
+			objects.occlusionCuller.RenderOccluder(objects.occluderPositions, objects.occluderIndices, worldViewProjection);
+		}
+		if (frustum.IsVisible(objects.pFire->GetBounds()) && objects.occlusionCuller.IsVisible(objects.pFire->GetBounds(), worldViewProjection))
+			objects.drawList.Submit(objects.pFire->GetSortKey(0, 0.5f, FilteringMethod::Linear), { objects.pFire, world, worldViewProjection, {}, FilteringMethod::Linear });
+		objects.drawList.Sort();
+		objects.drawList.Execute(context);
+
+		const Frustum worldFrustum{ viewProjection };
+		const std::span<uint32_t> visible = objects.frameAllocator.AllocateSpan<uint32_t>(objects.parkingLot.size());
+		uint32_t numVisible{};
+		for (uint32_t i{ 0 }; i < visible.size(); ++i)
+			if (worldFrustum.IsVisible(objects.pVehicle->GetBounds().Transform(objects.parkingLot[i])))
+				visible[numVisible++] = i;
+		parkingLot.Build(numVisible, [&](uint32_t begin, uint32_t end, InstanceData* pInstances)
+			{
+				for (uint32_t i{ begin }; i < end; ++i, ++pInstances)
+					pInstances->worldMatrix = objects.parkingLot[visible[i]];
+			});
+		parkingLot.Upload(context);
+		objects.pConstants->Bind(context, PerFrameConstants{ viewProjection, {} });
+		objects.pVehicle->RenderInstanced(context, parkingLot, FilteringMethod::Linear);
+		context.Present();
+		objects.pConstants->EndFrame(context);
+	}
+
+	void RunFrameAllocatorBenchmarks()
+	{
+		// Typed spans, copies and double buffering: a frame's data survives the next frame, the one after reuses it
+		// ------
+		{
+			FrameAllocator allocator{ 2, 4096 };
+			allocator.BeginFrame();
+			const std::span<Matrix> matrices = allocator.AllocateSpan<Matrix>(4);
+			const std::span<uint8_t> bytes = allocator.AllocateSpan<uint8_t>(3);
+			const std::span<double> doubles = allocator.AllocateSpan<double>(5);
+			bool isExpected = reinterpret_cast<uintptr_t>(matrices.data()) % alignof(Matrix) == 0 && reinterpret_cast<uintptr_t>(doubles.data()) % alignof(double) == 0;
+			isExpected &= reinterpret_cast<std::byte*>(bytes.data()) >= reinterpret_cast<std::byte*>(matrices.data() + matrices.size());
+
+			const uint32_t values[]{ 1, 2, 3, 4 };
+			const std::span<uint32_t> copy = allocator.AllocateCopy<uint32_t>(values);
+			isExpected &= copy.size() == 4 && std::memcmp(copy.data(), values, sizeof(values)) == 0;
+
+			allocator.BeginFrame();
+			const std::span<uint32_t> nextFrame = allocator.AllocateSpan<uint32_t>(256);
+			std::memset(nextFrame.data(), 0xAB, nextFrame.size_bytes());
+			isExpected &= std::memcmp(copy.data(), values, sizeof(values)) == 0;
+
+			allocator.BeginFrame();
+			isExpected &= allocator.AllocateSpan<Matrix>(4).data() == matrices.data() && allocator.GetFrameIndex() == 3;
+			Bench::Check(isExpected, "FrameAllocator spans are aligned and stay valid for the frames in flight");
+		}
+
+		// Frames bigger than the capacity still work, are counted and raise the high watermark
+		// ------
+		{
+			FrameAllocator allocator{ 3, 1024 };
+			allocator.BeginFrame();
+			allocator.AllocateSpan<uint8_t>(600);
+			allocator.BeginFrame();
+			allocator.AllocateSpan<uint8_t>(5000);
+			allocator.BeginFrame();
+			allocator.AllocateSpan<uint8_t>(100);
+			bool isExpected = allocator.GetNumOverflows() == 1 && allocator.GetHighWatermark() >= 5000 && allocator.GetHighWatermark() < 6000;
+			isExpected &= allocator.GetUsedSize() >= 100 && allocator.GetUsedSize() < 1024;
+			Bench::Check(isExpected, "FrameAllocator counts frames over capacity and tracks the high watermark");
+		}
+
+#if DAE_FRAME_ALLOCATOR_CHECKS
+		// Debug builds: writing one element past a span trips its guard
+		// ------
+		{
+			FrameAllocator allocator{ 2, 1024 };
+			allocator.BeginFrame();
+			const std::span<uint32_t> values = allocator.AllocateSpan<uint32_t>(8);
+			allocator.AllocateSpan<uint32_t>(8);
+			bool isExpected = allocator.CountCorruptedGuards() == 0;
+			values.data()[values.size()] = 0;
+			isExpected &= allocator.CountCorruptedGuards() == 1;
+			std::memset(values.data() + values.size(), 0xFD, sizeof(uint32_t));
+			Bench::Check(isExpected, "FrameAllocator guards catch writes past the end of a span");
+		}
+#endif
+
+		TestScene scene{};
+		CreateTestScene(scene);
+
+		NullRenderDevice device{};
+		StateCache stateCache{ device.GetImmediateContext() };
+
+		GpuTestScene gpuScene{};
+		CreateGpuTestScene(scene, device, gpuScene);
+		auto pParkingLot = std::make_unique<InstanceBuffer>(device, 16);
+		auto pConstants = std::make_unique<ConstantBufferRing>(device);
+
+		auto pObjects = std::make_unique<RenderObjects>();
+		pObjects->pVehicle = gpuScene.pVehicle.get();
+		pObjects->pFire = gpuScene.pFire.get();
+		pObjects->pConstants = pConstants.get();
+		for (const Vertex_In& vertex : scene.vehicleVertices)
+			pObjects->occluderPositions.push_back(vertex.position);
+		pObjects->occluderIndices = scene.vehicleIndices;
+		for (uint32_t i{ 0 }; i < s_NumParkedVehicles; ++i)
+			pObjects->parkingLot.push_back(Matrix::CreateTranslation(15.f * (i % 100) - 750.f, 0.f, 15.f * (i / 100 + 1)));
+
+		const Matrix world = Matrix::CreateTranslation(0.f, 0.f, 50.f);
+		const Matrix viewProjection = Matrix::CreatePerspectiveFovLH(tanf((45.f * TO_RADIANS) / 2.f), 640.f / 480.f, 0.1f, 100.f);
+
+		// The whole render side of a frame (culling, draw list, instances, state cache, frame memory) against the
+		// null device: once the first frames grew every buffer, no frame allocates
+		// ------
+		{
+			for (int frame{ 0 }; frame < 8; ++frame)
+				RenderFrame(stateCache, *pParkingLot, *pObjects, world, viewProjection);
+
+			const uint64_t numAllocationsBefore = Bench::GetNumHeapAllocations();
+			for (int frame{ 0 }; frame < 100; ++frame)
+				RenderFrame(stateCache, *pParkingLot, *pObjects, world, viewProjection);
+			const uint64_t numAllocations = Bench::GetNumHeapAllocations() - numAllocationsBefore;
+
+			std::printf("Steady state frame: %llu heap allocations in 100 frames, %u of %u parked vehicles drawn, frame memory high watermark %zu bytes\n",
+				static_cast<unsigned long long>(numAllocations), pParkingLot->GetCount(), s_NumParkedVehicles, pObjects->frameAllocator.GetHighWatermark());
+			Bench::Check(numAllocations == 0, "A steady state render frame makes no heap allocations");
+			Bench::Check(pObjects->frameAllocator.GetNumOverflows() == 0, "The render frame fits the frame memory");
+		}
+
+		// Per frame scratch arrays (items = arrays): 64 arrays of 256 floats, from frame memory against a std::vector each
+		// ------
+		{
+			constexpr uint32_t numArrays{ 64 };
+			FrameAllocator allocator{ 2, 128 * 1024 };
+			Bench::Run("FrameAllocator/AllocateSpan/64x256", numArrays, [&]
+				{
+					allocator.BeginFrame();
+					for (uint32_t array{ 0 }; array < numArrays; ++array)
+					{
+						const std::span<float> values = allocator.AllocateSpan<float>(256);
+						values[array] = 1.f;
+						Bench::DoNotOptimize(values.data());
+					}
+				});
+			Bench::Run("FrameAllocator/StdVector/64x256", numArrays, [&]
+				{
+					for (uint32_t array{ 0 }; array < numArrays; ++array)
+					{
+						std::vector<float> values(256);
+						values[array] = 1.f;
+						Bench::DoNotOptimize(values.data());
+					}
+				});
+		}
+
+		Bench::Run("FrameAllocator/NullDevice/RenderFrame", 1, [&]
+			{
+				RenderFrame(stateCache, *pParkingLot, *pObjects, world, viewProjection);
+			});
+
+		pObjects.reset();
+		pConstants.reset();
+		pParkingLot.reset();
+		gpuScene.Release();
+	}
+}
@@ -0,0 +1,356 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "FrameGraph.h"
+#include "NullRenderDevice.h"
+
+namespace dae
+{
+	using ResourceId = FrameGraph::ResourceId;
+
+	// What a test graph's pass declared, to check the compiled graph against
+	struct DeclaredAccess
+	{
+		uint32_t pass{};
+		ResourceId resource{};
+		ResourceState state{};
+	};
+
+	static bool IsWrite(ResourceState state)
+	{
+		return state == ResourceState::RenderTarget || state == ResourceState::DepthWrite;
+	}
+
+	// Scene into an HDR target, numEffects post effects each reading the previous target into a new one, tone
+	// mapping into the back buffer: every target is only alive for two passes
+	static void AddPostChain(FrameGraph& graph, TextureHandle backBuffer, uint32_t numEffects, std::vector<ResourceId>& targets)
+	{
+		const TextureDesc hdr{ 1280, 720, Format::R16G16B16A16_Float };
+		const ResourceId output = graph.ImportTexture("BackBuffer", backBuffer, { 1280, 720, Format::R8G8B8A8_UNorm, false, true, false }, ResourceState::Present);
+		const ResourceId depth = graph.CreateTexture("SceneDepth", { 1280, 720, Format::D24_UNorm_S8_UInt });
+
+		targets.clear();
+		targets.push_back(graph.CreateTexture("SceneColor", hdr));
+		graph.AddPass("Scene", [&](FrameGraph::PassBuilder& builder)
+			{
+				builder.ClearRenderTarget(targets[0], {});
+				builder.ClearDepth(depth, 1.f);
+			}, [](ICommandContext&, const FrameGraph&) {});
+
+		for (uint32_t effect{ 0 }; effect < numEffects; ++effect)
+		{
+			targets.push_back(graph.CreateTexture("Effect", hdr));
+			graph.AddPass("Effect", [&](FrameGraph::PassBuilder& builder)
+				{
+					builder.ReadTexture(targets[effect]);
+					builder.WriteRenderTarget(targets[effect + 1]);
+				}, [](ICommandContext&, const FrameGraph&) {});
+		}
+
+		graph.AddPass("ToneMap", [&](FrameGraph::PassBuilder& builder)
+			{
+				builder.ReadTexture(targets.back());
+				builder.WriteRenderTarget(output);
+			}, [](ICommandContext&, const FrameGraph&) {});
+	}
+
+	void RunFrameGraphBenchmarks()
+	{
+		const TextureDesc colorDesc{ 640, 480, Format::R8G8B8A8_UNorm };
+
+		// Passes whose outputs nobody reads are culled, also when that only shows after culling their readers
+		// ------
+		{
+			NullRenderDevice device{};
+			FrameGraph graph{ device };
+			const ResourceId backBuffer = graph.ImportTexture("BackBuffer", device.GetBackBuffer(), { 640, 480, Format::R8G8B8A8_UNorm, false, true, false }, ResourceState::Present);
+			const ResourceId gBuffer = graph.CreateTexture("GBuffer", colorDesc);
+			const ResourceId debugView = graph.CreateTexture("DebugView", colorDesc);
+			const ResourceId shadowMap = graph.CreateTexture("ShadowMap", { 1024, 1024, Format::D24_UNorm_S8_UInt });
+			const ResourceId shadowMask = graph.CreateTexture("ShadowMask", colorDesc);
+
+			const uint32_t gBufferPass = graph.AddPass("GBuffer", [&](FrameGraph::PassBuilder& builder) { builder.ClearRenderTarget(gBuffer, {}); }, {});
+			const uint32_t debugPass = graph.AddPass("Debug", [&](FrameGraph::PassBuilder& builder)
+				{
+					builder.ReadTexture(gBuffer);
+					builder.WriteRenderTarget(debugView);
+				}, {});
+			const uint32_t shadowPass = graph.AddPass("Shadows", [&](FrameGraph::PassBuilder& builder) { builder.ClearDepth(shadowMap, 1.f); }, {});
+			const uint32_t maskPass = graph.AddPass("ShadowMask", [&](FrameGraph::PassBuilder& builder)
+				{
+					builder.ReadTexture(gBuffer);
+					builder.ReadDepth(shadowMap);
+					builder.WriteRenderTarget(shadowMask);
+				}, {});
+			const uint32_t lightingPass = graph.AddPass("Lighting", [&](FrameGraph::PassBuilder& builder)
+				{
+					builder.ReadTexture(gBuffer);
+					builder.WriteRenderTarget(backBuffer);
+				}, {});
+			graph.Compile();
+
+			bool isExpected = !graph.IsCulled(gBufferPass) && !graph.IsCulled(lightingPass);
+			isExpected &= graph.IsCulled(debugPass) && graph.IsCulled(maskPass) && graph.IsCulled(shadowPass);
+			isExpected &= graph.GetStats().numCulledPasses == 3 && graph.GetStats().numTransientTextures == 1;
+			isExpected &= !graph.GetTexture(shadowMap).IsValid() && graph.GetTexture(gBuffer).IsValid();
+			isExpected &= device.GetCallCount(RenderCall::CreateTexture) == 1;
+			Bench::Check(isExpected, "FrameGraph culls passes that nothing imported depends on");
+		}
+
+		// A post processing chain: targets two passes apart share a texture, so three textures become two.
+		// Compiling the same graph again takes the textures from the pool and executing allocates nothing
+		// ------
+		{
+			NullRenderDevice device{};
+			FrameGraph graph{ device };
+			std::vector<ResourceId> targets{};
+			AddPostChain(graph, device.GetBackBuffer(), 2, targets);
+			graph.Compile();
+
+			const FrameGraph::Stats& stats = graph.GetStats();
+			const uint64_t hdrBytes = 1280ull * 720 * 8;
+			bool isExpected = graph.GetTexture(targets[0]) == graph.GetTexture(targets[2]) && !(graph.GetTexture(targets[0]) == graph.GetTexture(targets[1]));
+			isExpected &= stats.numTransientTextures == 4 && stats.numTextures == 3 && stats.GetSavedBytes() == hdrBytes;
+			isExpected &= stats.numCreatedTextures == 3 && device.GetLiveResourceCount() == 3;
+
+			device.SetRecording(true);
+			graph.Execute(device.GetImmediateContext());
+			isExpected &= device.GetCallCount(RenderCall::SetRenderTargets) == 4 && device.GetCallCount(RenderCall::Transition) == stats.numBarriers;
+			isExpected &= device.GetCallCount(RenderCall::ClearRenderTarget) == 1 && device.GetCallCount(RenderCall::ClearDepthStencil) == 1;
+
+			graph.Reset();
+			AddPostChain(graph, device.GetBackBuffer(), 2, targets);
+			graph.Compile();
+			isExpected &= graph.GetStats().numCreatedTextures == 0 && device.GetCallCount(RenderCall::CreateTexture) == 3 && device.GetLiveResourceCount() == 3;
+
+			device.SetRecording(false);
+			const uint64_t numAllocationsBefore = Bench::GetNumHeapAllocations();
+			for (int frame{ 0 }; frame < 10; ++frame)
+				graph.Execute(device.GetImmediateContext());
+			const uint64_t numAllocations = Bench::GetNumHeapAllocations() - numAllocationsBefore;
+			Bench::Check(isExpected, "FrameGraph aliases transient textures with disjoint lifetimes and pools them across compiles");
+			Bench::Check(numAllocations == 0, "FrameGraph::Execute makes no heap allocations");
+		}
+
+		// The Renderer's frame: opaque pass clears the back buffer and the transient depth, the blended pass reads
+		// the depth. Transitions come before the targets are bound, the back buffer goes back to Present
+		// ------
+		{
+			NullRenderDevice device{};
+			FrameGraph graph{ device };
+			const ResourceId backBuffer = graph.ImportTexture("BackBuffer", device.GetBackBuffer(), { 640, 480, Format::R8G8B8A8_UNorm, false, true, false }, ResourceState::Present);
+			const ResourceId sceneDepth = graph.CreateTexture("SceneDepth", { 640, 480, Format::D24_UNorm_S8_UInt });
+			graph.AddPass("Opaque", [&](FrameGraph::PassBuilder& builder)
+				{
+					builder.ClearRenderTarget(backBuffer, { .39f,.59f,.93f });
+					builder.ClearDepth(sceneDepth, 1.f);
+				},
+				[](ICommandContext& context, const FrameGraph&) { context.DrawIndexed(3, 0, 0); });
+			graph.AddPass("Transparent", [&](FrameGraph::PassBuilder& builder)
+				{
+					builder.WriteRenderTarget(backBuffer);
+					builder.ReadDepth(sceneDepth);
+				},
+				[](ICommandContext& context, const FrameGraph&) { context.DrawIndexed(6, 0, 0); });
+			graph.Compile();
+
+			device.SetRecording(true);
+			graph.Execute(device.GetImmediateContext());
+			std::vector<RenderCall> calls{};
+			for (const NullRenderDevice::RecordedCall& call : device.GetRecordedCalls())
+				calls.push_back(call.call);
+
+			const std::vector<RenderCall> expectedCalls{
+				RenderCall::Transition, RenderCall::Transition, RenderCall::SetRenderTargets, RenderCall::ClearRenderTarget, RenderCall::ClearDepthStencil, RenderCall::DrawIndexed,
+				RenderCall::Transition, RenderCall::SetRenderTargets, RenderCall::DrawIndexed,
+				RenderCall::Transition };
+			const std::vector<NullRenderDevice::RecordedCall>& recorded = device.GetRecordedCalls();
+			bool isExpected = calls == expectedCalls;
+			if (isExpected)
+			{
+				isExpected &= recorded[0].handle == device.GetBackBuffer().id && recorded[0].value == static_cast<uint32_t>(ResourceState::RenderTarget);
+				isExpected &= recorded[6].handle == graph.GetTexture(sceneDepth).id && recorded[6].value == static_cast<uint32_t>(ResourceState::DepthRead);
+				isExpected &= recorded[9].value == static_cast<uint32_t>(ResourceState::Present);
+			}
+			Bench::Check(isExpected, "FrameGraph records transitions, target binds and clears in pass order");
+		}
+
+		// Random graphs: textures sharing a texture never live at the same time and have the same size and
+		// format, culled passes write nothing a live pass reads, and replaying the barriers puts every texture in
+		// the state each access declared, ending the frame where the next one starts
+		// ------
+		{
+			std::mt19937 rng{ 49 };
+			const TextureDesc descs[]{ { 64, 64, Format::R8G8B8A8_UNorm }, { 64, 64, Format::R16G16B16A16_Float }, { 32, 32, Format::R8G8B8A8_UNorm } };
+			bool isExpected{ true };
+			uint64_t savedBytes{};
+
+			for (int test{ 0 }; test < 300; ++test)
+			{
+				NullRenderDevice device{};
+				FrameGraph graph{ device };
+				const ResourceId backBuffer = graph.ImportTexture("BackBuffer", device.GetBackBuffer(), { 64, 64, Format::R8G8B8A8_UNorm, false, true, false }, ResourceState::Present);
+				std::vector<ResourceId> transients{};
+				std::vector<uint32_t> transientDescs(1, 0);	// per resource id, the back buffer's unused
+				std::vector<ResourceId> written{};
+				std::vector<DeclaredAccess> accesses{};
+
+				const uint32_t numPasses = std::uniform_int_distribution<uint32_t>{ 2, 24 }(rng);
+				for (uint32_t pass{ 0 }; pass < numPasses; ++pass)
+				{
+					std::vector<DeclaredAccess> passAccesses{};
+					const uint32_t numReads = written.empty() ? 0 : std::uniform_int_distribution<uint32_t>{ 0, 2 }(rng);
+					for (uint32_t read{ 0 }; read < numReads; ++read)
+					{
+						const ResourceId resource = written[std::uniform_int_distribution<size_t>{ 0, written.size() - 1 }(rng)];
+						if (std::none_of(passAccesses.begin(), passAccesses.end(), [&](const DeclaredAccess& access) { return access.resource == resource; }))
+							passAccesses.push_back({ pass, resource, ResourceState::ShaderResource });
+					}
+
+					const uint32_t choice = std::uniform_int_distribution<uint32_t>{ 0, 9 }(rng);
+					ResourceId target{};
+					if (choice < 2 || pass + 1 == numPasses)
+					{
+						target = backBuffer;
+					}
+					else if (choice < 4 && !written.empty())
+					{
+						target = written[std::uniform_int_distribution<size_t>{ 0, written.size() - 1 }(rng)];
+					}
+					else
+					{
+						const uint32_t desc = std::uniform_int_distribution<uint32_t>{ 0, 2 }(rng);
+						target = graph.CreateTexture("Transient", descs[desc]);
+						transientDescs.push_back(desc);
+						transients.push_back(target);
+					}
+					if (std::none_of(passAccesses.begin(), passAccesses.end(), [&](const DeclaredAccess& access) { return access.resource == target; }))
+					{
+						passAccesses.push_back({ pass, target, ResourceState::RenderTarget });
+						if (target != backBuffer && std::find(written.begin(), written.end(), target) == written.end())
+							written.push_back(target);
+					}
+
+					graph.AddPass("Pass", [&](FrameGraph::PassBuilder& builder)
+						{
+							for (const DeclaredAccess& access : passAccesses)
+							{
+								if (access.state == ResourceState::ShaderResource)
+									builder.ReadTexture(access.resource);
+								else
+									builder.WriteRenderTarget(access.resource);
+							}
+						}, {});
+					accesses.insert(accesses.end(), passAccesses.begin(), passAccesses.end());
+				}
+				graph.Compile();
+				savedBytes += graph.GetStats().GetSavedBytes();
+
+				// Aliasing
+				for (size_t a{ 0 }; a < transients.size(); ++a)
+				{
+					for (size_t b{ a + 1 }; b < transients.size(); ++b)
+					{
+						const TextureHandle texture = graph.GetTexture(transients[a]);
+						if (!texture.IsValid() || !(texture == graph.GetTexture(transients[b])))
+							continue;
+						const FrameGraph::Lifetime first = graph.GetLifetime(transients[a]);
+						const FrameGraph::Lifetime second = graph.GetLifetime(transients[b]);
+						isExpected &= first.lastPass < second.firstPass || second.lastPass < first.firstPass;
+						const TextureDesc& descA = descs[transientDescs[transients[a]]];
+						const TextureDesc& descB = descs[transientDescs[transients[b]]];
+						isExpected &= descA.width == descB.width && descA.height == descB.height && descA.format == descB.format;
+					}
+				}
+
+				// Culling and lifetimes
+				for (const DeclaredAccess& access : accesses)
+				{
+					if (graph.IsCulled(access.pass))
+					{
+						if (!IsWrite(access.state))
+							continue;
+						isExpected &= access.resource != backBuffer;
+						for (const DeclaredAccess& reader : accesses)
+							isExpected &= !(reader.resource == access.resource && !IsWrite(reader.state) && !graph.IsCulled(reader.pass));
+					}
+					else
+					{
+						const FrameGraph::Lifetime lifetime = graph.GetLifetime(access.resource);
+						isExpected &= lifetime.firstPass <= access.pass && access.pass <= lifetime.lastPass && graph.GetTexture(access.resource).IsValid();
+					}
+				}
+
+				// Barriers, replayed pass by pass: a texture's state is learnt from its first barrier, or its first
+				// access when it never changes state
+				std::unordered_map<uint32_t, ResourceState> states{};
+				std::unordered_map<uint32_t, ResourceState> startStates{};
+				states[device.GetBackBuffer().id] = ResourceState::Present;
+				const std::span<const FrameGraph::Barrier> barriers = graph.GetBarriers();
+				size_t barrier{ 0 };
+				for (uint32_t pass{ 0 }; pass <= numPasses; ++pass)
+				{
+					for (; barrier < barriers.size() && barriers[barrier].pass == pass; ++barrier)
+					{
+						const FrameGraph::Barrier& transition = barriers[barrier];
+						const auto state = states.find(transition.texture.id);
+						if (state == states.end())
+							startStates[transition.texture.id] = transition.before;
+						else
+							isExpected &= state->second == transition.before;
+						isExpected &= transition.before != transition.after;
+						states[transition.texture.id] = transition.after;
+					}
+					if (pass == numPasses || graph.IsCulled(pass))
+						continue;
+					for (const DeclaredAccess& access : accesses)
+					{
+						if (access.pass != pass)
+							continue;
+						const uint32_t texture = graph.GetTexture(access.resource).id;
+						const auto state = states.find(texture);
+						if (state == states.end())
+							startStates[texture] = states[texture] = access.state;
+						else
+							isExpected &= state->second == access.state;
+					}
+				}
+				isExpected &= barrier == barriers.size() && states[device.GetBackBuffer().id] == ResourceState::Present;
+				for (const auto& [texture, startState] : startStates)
+					isExpected &= states[texture] == startState;
+			}
+			std::printf("FrameGraph: 300 random graphs, %.1f MB saved by aliasing\n", double(savedBytes) / (1024.0 * 1024.0));
+			Bench::Check(isExpected, "FrameGraph aliasing, culling and barriers hold on random graphs");
+		}
+
+		// A 1280x720 HDR chain of 64 post effects (items = passes): recompiling it and executing it. Aliasing keeps
+		// it at two HDR textures however long the chain gets
+		// ------
+		{
+			constexpr uint32_t numEffects{ 62 };
+			NullRenderDevice device{};
+			FrameGraph graph{ device };
+			std::vector<ResourceId> targets{};
+			Bench::Run("FrameGraph/Compile/64", numEffects + 2, [&]
+				{
+					graph.Reset();
+					AddPostChain(graph, device.GetBackBuffer(), numEffects, targets);
+					graph.Compile();
+				});
+			Bench::Run("FrameGraph/Execute/64", numEffects + 2, [&]
+				{
+					graph.Execute(device.GetImmediateContext());
+				});
+
+			const FrameGraph::Stats& stats = graph.GetStats();
+			if (stats.numPasses > 0)
+				std::printf("  %u transient textures in %u, %.1f of %.1f MB saved by aliasing, %u barriers\n", stats.numTransientTextures, stats.numTextures,
+					double(stats.GetSavedBytes()) / (1024.0 * 1024.0), double(stats.transientBytes) / (1024.0 * 1024.0), stats.numBarriers);
+		}
+	}
+}
@@ -0,0 +1,212 @@
+#include "Benchmark.h"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#include "ConstantBufferRing.h"
+#include "FrameSnapshot.h"
+#include "InstanceBuffer.h"
+#include "Math.h"
+#include "Mesh.h"
+#include "NullRenderDevice.h"
+#include "TestScene.h"
+#include "TransformStore.h"
+#include "TripleBuffer.h"
+
+namespace dae
+{
+	static constexpr uint32_t s_NumParkedVehicles{ 10'000 };
+
+	// Renderer::Update without SDL: turn every vehicle, update the store and publish the frame
+	static void Simulate(TransformStore& transforms, TripleBuffer<FrameSnapshot>& snapshots, uint64_t frameIndex)
+	{
+		FrameSnapshot& snapshot = snapshots.GetWriteBuffer();
+		snapshot.inputTime = std::chrono::steady_clock::now();
+
+		const Quaternion rotation = Quaternion::CreateRotationY(0.01f * frameIndex);
+		for (TransformStore::EntityId entity{ 0 }; entity < transforms.GetCount(); ++entity)
+			transforms.SetRotation(entity, rotation);
+		transforms.Update();
+
+		const std::span<const Matrix> worldMatrices = transforms.GetWorldMatrices();
+		snapshot.frameIndex = frameIndex;
+		snapshot.viewMatrix = Matrix::CreateTranslation(0.f, -5.f, 10.f);
+		snapshot.projectionMatrix = Matrix::CreatePerspectiveFovLH(tanf((45.f * TO_RADIANS) / 2.f), 640.f / 480.f, 0.1f, 100.f);
+		snapshot.farPlane = 100.f;
+		snapshot.vehicleWorldMatrix = worldMatrices[0];
+		snapshot.filteringMethod = FilteringMethod::Linear;
+		snapshot.parkingLotWorldMatrices.assign(worldMatrices.begin() + 1, worldMatrices.end());
+		snapshots.Publish();
+	}
+
+	// Renderer::Render without culling and sorting: both meshes plus the instanced parking lot from the snapshot
+	static void Submit(ICommandContext& context, ConstantBufferRing& constants, Mesh& vehicle, Mesh& fire, InstanceBuffer& parkingLot, const FrameSnapshot& snapshot)
+	{
+		const Matrix viewProjection = snapshot.viewMatrix * snapshot.projectionMatrix;
+		const Matrix worldViewProjection = snapshot.vehicleWorldMatrix * viewProjection;
+
+		context.ClearRenderTarget({ .39f,.59f,.93f });
+		context.ClearDepthStencil(1.f, 0);
+		vehicle.Render(context, snapshot.vehicleWorldMatrix, worldViewProjection, snapshot.cameraPosition, snapshot.filteringMethod);
+		fire.Render(context, snapshot.vehicleWorldMatrix, worldViewProjection, snapshot.cameraPosition, snapshot.filteringMethod);
+		parkingLot.Build(static_cast<uint32_t>(snapshot.parkingLotWorldMatrices.size()), [&snapshot](uint32_t begin, uint32_t end, InstanceData* pInstances)
+			{
+				for (uint32_t i{ begin }; i < end; ++i, ++pInstances)
+					pInstances->worldMatrix = snapshot.parkingLotWorldMatrices[i];
+			}, 1);
+		parkingLot.Upload(context);
+		constants.Bind(context, PerFrameConstants{ viewProjection, snapshot.cameraPosition });
+		vehicle.RenderInstanced(context, parkingLot, snapshot.filteringMethod);
+		context.Present();
+		constants.EndFrame(context);
+	}
+
+	static void PrintLatency(const FrameLatencyStats& stats)
+	{
+		std::printf("  input to submit: %.3f ms avg, %.3f ms max over %u frames, %u repeated, %u snapshots skipped\n",
+			stats.GetAverageMs(), stats.maxMs, stats.numFrames, stats.numRepeatedFrames, stats.numSkippedSnapshots);
+	}
+
+	void RunFramePipelineBenchmarks()
+	{
+		// The hand over: nothing before the first publish, only the newest afterwards, never the writer's buffer
+		// ------
+		{
+			TripleBuffer<uint64_t> buffer{};
+			bool isExpected = !buffer.Acquire();
+			for (uint64_t value{ 1 }; value <= 3; ++value)
+			{
+				buffer.GetWriteBuffer() = value;
+				buffer.Publish();
+			}
+			isExpected &= buffer.Acquire() && buffer.GetReadBuffer() == 3 && !buffer.Acquire() && buffer.GetReadBuffer() == 3;
+			isExpected &= &buffer.GetWriteBuffer() != &buffer.GetReadBuffer();
+			Bench::Check(isExpected, "TripleBuffer hands over the newest published value");
+		}
+
+		// Across threads: every acquired buffer is complete (all words written by the same publish) and newer
+		// than the last one
+		// ------
+		{
+			struct Payload
+			{
+				uint64_t words[32]{};
+			};
+			TripleBuffer<Payload> buffer{};
+			constexpr uint64_t numPublishes{ 200'000 };
+			std::thread writer{ [&]
+				{
+					for (uint64_t value{ 1 }; value <= numPublishes; ++value)
+					{
+						for (uint64_t& word : buffer.GetWriteBuffer().words)
+							word = value;
+						buffer.Publish();
+					}
+				} };
+
+			bool isExpected{ true };
+			uint64_t lastValue{};
+			while (lastValue < numPublishes)
+			{
+				if (!buffer.Acquire())
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				const Payload& payload = buffer.GetReadBuffer();
+				for (const uint64_t word : payload.words)
+					isExpected &= word == payload.words[0];
+				isExpected &= payload.words[0] > lastValue;
+				lastValue = payload.words[0];
+			}
+			writer.join();
+			Bench::Check(isExpected, "TripleBuffer never hands over a torn or older buffer across threads");
+		}
+
+		TestScene scene{};
+		CreateTestScene(scene);
+
+		NullRenderDevice device{};
+		ICommandContext& context = device.GetImmediateContext();
+
+		GpuTestScene gpuScene{};
+		CreateGpuTestScene(scene, device, gpuScene);
+		auto pParkingLot = std::make_unique<InstanceBuffer>(device, s_NumParkedVehicles);
+		auto pConstants = std::make_unique<ConstantBufferRing>(device);
+
+		// The vehicle and the parking lot, like the Renderer
+		TransformStore transforms{};
+		transforms.Reserve(1 + s_NumParkedVehicles);
+		transforms.Create(TransformStore::InvalidEntity, { 0.f, 0.f, 50.f });
+		for (uint32_t i{ 0 }; i < s_NumParkedVehicles; ++i)
+			transforms.Create(TransformStore::InvalidEntity, { 15.f * (i % 100), 0.f, 15.f * (i / 100 + 1) });
+
+		// Frames with a new snapshot (items = frames), against the null device: simulate + submit on one thread,
+		// against the simulation on its own thread with this one only submitting. The simulation builds at most one
+		// frame ahead of what was submitted (the app's simulation runs free and the render side skips snapshots),
+		// so the decoupled rate is the slower side's instead of the sum of both
+		// ------
+		TripleBuffer<FrameSnapshot> snapshots{};
+		uint64_t frameIndex{};
+		uint64_t submittedFrameIndex{};
+		FrameLatencyStats stats{};
+		const Bench::Result serialized = Bench::Run("FramePipeline/NullDevice/Serialized", 1, [&]
+			{
+				Simulate(transforms, snapshots, ++frameIndex);
+				const bool isNew = snapshots.Acquire();
+				const FrameSnapshot& snapshot = snapshots.GetReadBuffer();
+				Submit(context, *pConstants, *gpuScene.pVehicle, *gpuScene.pFire, *pParkingLot, snapshot);
+				stats.Record(snapshot, isNew, submittedFrameIndex, std::chrono::steady_clock::now());
+				submittedFrameIndex = snapshot.frameIndex;
+			});
+		if (serialized.items > 0)
+			PrintLatency(stats);
+
+		{
+			std::atomic<bool> isSimulating{ true };
+			std::atomic<uint64_t> consumedFrameIndex{ frameIndex };
+			std::thread simulation{ [&]
+				{
+					while (isSimulating)
+					{
+						if (frameIndex > consumedFrameIndex)
+						{
+							std::this_thread::yield();
+							continue;
+						}
+						Simulate(transforms, snapshots, ++frameIndex);
+					}
+				} };
+
+			stats = {};
+			bool isOrdered{ true };
+			const Bench::Result decoupled = Bench::Run("FramePipeline/NullDevice/Decoupled", 1, [&]
+				{
+					while (!snapshots.Acquire())
+						std::this_thread::yield();
+					const FrameSnapshot& snapshot = snapshots.GetReadBuffer();
+					isOrdered &= snapshot.frameIndex > submittedFrameIndex;
+					consumedFrameIndex = snapshot.frameIndex;
+					Submit(context, *pConstants, *gpuScene.pVehicle, *gpuScene.pFire, *pParkingLot, snapshot);
+					stats.Record(snapshot, true, submittedFrameIndex, std::chrono::steady_clock::now());
+					submittedFrameIndex = snapshot.frameIndex;
+				});
+
+			isSimulating = false;
+			simulation.join();
+			if (decoupled.items > 0)
+			{
+				PrintLatency(stats);
+				if (serialized.items > 0)
+					std::printf("  %.2fx the serialized frame rate\n", serialized.nsPerItem / decoupled.nsPerItem);
+				Bench::Check(isOrdered, "The render side only ever submits newer snapshots");
+			}
+		}
+
+		pConstants.reset();
+		pParkingLot.reset();
+		gpuScene.Release();
+	}
+}
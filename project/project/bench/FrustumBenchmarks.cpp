@@ -0,0 +1,86 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+#include "Math.h"
+#include "Frustum.h"
+
+namespace dae
+{
+	void RunFrustumBenchmarks()
+	{
+		// Same projection the renderer uses (45 degrees, 640x480)
+		const float fov = tanf((45.f * TO_RADIANS) / 2.f);
+		const Matrix view = Matrix::Inverse(Matrix::CreateLookAtLH({ 0.f, 0.f, 0.f }, Vector3::UnitZ, Vector3::UnitY));
+		const Matrix projection = Matrix::CreatePerspectiveFovLH(fov, 640.f / 480.f, 0.1f, 100.f);
+		const Frustum frustum{ view * projection };
+
+		const uint32_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+		std::mt19937 rng{ 42 };
+		std::uniform_real_distribution<float> positionDist{ -150.f, 150.f };
+		std::uniform_real_distribution<float> sizeDist{ 0.1f, 4.f };
+
+		for (const size_t count : { size_t{ 10'000 }, size_t{ 100'000 }, size_t{ 1'000'000 } })
+		{
+			AABBBatch boxes{};
+			SphereBatch spheres{};
+			for (size_t i{ 0 }; i < count; ++i)
+			{
+				const Vector3 center{ positionDist(rng), positionDist(rng), positionDist(rng) };
+				const Vector3 extents{ sizeDist(rng), sizeDist(rng), sizeDist(rng) };
+				boxes.Add({ center, extents });
+				spheres.Add({ center, extents.Magnitude() });
+			}
+
+			const std::string suffix = "/" + std::to_string(count);
+
+			// Batch results must match the one-at-a-time tests bit for bit
+			const std::vector<uint64_t> boxMask = frustum.Cull(boxes);
+			const std::vector<uint64_t> sphereMask = frustum.Cull(spheres);
+			const std::vector<uint64_t> boxMaskThreaded = frustum.Cull(boxes, numThreads);
+			size_t boxMismatches{}, sphereMismatches{};
+			for (size_t i{ 0 }; i < count; ++i)
+			{
+				boxMismatches += Frustum::IsVisible(boxMask, i) != frustum.IsVisible(boxes.Get(i));
+				sphereMismatches += Frustum::IsVisible(sphereMask, i) != frustum.IsVisible(spheres.Get(i));
+			}
+			Bench::Check(boxMismatches == 0, "Frustum AABB batch matches scalar" + suffix);
+			Bench::Check(sphereMismatches == 0, "Frustum sphere batch matches scalar" + suffix);
+			Bench::Check(boxMask == boxMaskThreaded, "Frustum AABB threaded matches single thread" + suffix);
+
+			Bench::Run("Frustum/AABBScalar" + suffix, count, [&]
+				{
+					size_t visible{};
+					for (size_t i{ 0 }; i < count; ++i)
+						visible += frustum.IsVisible(boxes.Get(i));
+					Bench::DoNotOptimize(visible);
+				});
+
+			std::vector<uint64_t> mask(Frustum::GetMaskSize(count));
+			Bench::Run("Frustum/AABBBatch" + suffix, count, [&]
+				{
+					frustum.Cull(boxes, mask.data(), 0, count);
+					Bench::DoNotOptimize(mask.front());
+				});
+
+			Bench::Run("Frustum/SphereBatch" + suffix, count, [&]
+				{
+					frustum.Cull(spheres, mask.data(), 0, count);
+					Bench::DoNotOptimize(mask.front());
+				});
+
+			// Thread start-up only pays off for the bigger batches
+			if (count >= 100'000)
+			{
+				Bench::Run("Frustum/AABBBatchThreaded" + suffix, count, [&]
+					{
+						const std::vector<uint64_t> threadedMask = frustum.Cull(boxes, numThreads);
+						Bench::DoNotOptimize(threadedMask.front());
+					});
+			}
+		}
+	}
+}
@@ -0,0 +1,164 @@
+#include "GoldenImage.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+
+namespace dae
+{
+	namespace Golden
+	{
+		// Next header token, skipping whitespace and # comments
+		static bool ReadToken(std::istream& stream, std::string& token)
+		{
+			token.clear();
+			while (stream)
+			{
+				const int c = stream.get();
+				if (c == '#')
+				{
+					while (stream && stream.get() != '\n') {}
+					continue;
+				}
+				if (c == EOF)
+					break;
+				if (std::isspace(c))
+				{
+					if (!token.empty())
+						return true;
+					continue;
+				}
+				token += static_cast<char>(c);
+			}
+			return !token.empty();
+		}
+
+		bool ReadPPM(const std::string& path, Image& image)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file)
+				return false;
+
+			// The single whitespace after maxval is eaten by ReadToken, the texels follow
+			std::string magic{}, width{}, height{}, maxValue{};
+			if (!ReadToken(file, magic) || magic != "P6" || !ReadToken(file, width) || !ReadToken(file, height)
+				|| !ReadToken(file, maxValue) || maxValue != "255")
+				return false;
+
+			image.width = std::atoi(width.c_str());
+			image.height = std::atoi(height.c_str());
+			if (image.width <= 0 || image.height <= 0)
+				return false;
+
+			image.rgb.resize(size_t(image.width) * image.height * 3);
+			file.read(reinterpret_cast<char*>(image.rgb.data()), std::streamsize(image.rgb.size()));
+			return static_cast<bool>(file);
+		}
+
+		bool WritePPM(const std::string& path, const Image& image)
+		{
+			std::ofstream file(path, std::ios::binary);
+			if (!file)
+				return false;
+
+			file << "P6\n" << image.width << ' ' << image.height << "\n255\n";
+			file.write(reinterpret_cast<const char*>(image.rgb.data()), std::streamsize(image.rgb.size()));
+			return static_cast<bool>(file);
+		}
+
+		static bool IsSameSize(const Image& a, const Image& b)
+		{
+			return a.width == b.width && a.height == b.height && a.rgb.size() == b.rgb.size() && !a.rgb.empty();
+		}
+
+		double ComputePSNR(const Image& a, const Image& b)
+		{
+			if (!IsSameSize(a, b))
+				return 0.0;
+
+			double sum{};
+			for (size_t i{ 0 }; i < a.rgb.size(); ++i)
+			{
+				const double difference = double(a.rgb[i]) - double(b.rgb[i]);
+				sum += difference * difference;
+			}
+			if (sum == 0.0)
+				return std::numeric_limits<double>::infinity();
+
+			const double meanSquaredError = sum / double(a.rgb.size());
+			return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+		}
+
+		static std::vector<float> ToLuma(const Image& image)
+		{
+			std::vector<float> luma(size_t(image.width) * image.height);
+			for (size_t i{ 0 }; i < luma.size(); ++i)
+				luma[i] = 0.299f * image.rgb[i * 3] + 0.587f * image.rgb[i * 3 + 1] + 0.114f * image.rgb[i * 3 + 2];
+			return luma;
+		}
+
+		double ComputeSSIM(const Image& a, const Image& b)
+		{
+			if (!IsSameSize(a, b))
+				return 0.0;
+
+			// Wang et al. 2004 constants for 8 bit values, plain (unweighted) windows
+			constexpr int windowSize{ 8 }, stride{ 4 };
+			constexpr double c1{ (0.01 * 255.0) * (0.01 * 255.0) };
+			constexpr double c2{ (0.03 * 255.0) * (0.03 * 255.0) };
+			const std::vector<float> lumaA = ToLuma(a);
+			const std::vector<float> lumaB = ToLuma(b);
+
+			// Images smaller than a window are one window
+			const int windowWidth = std::min(windowSize, a.width);
+			const int windowHeight = std::min(windowSize, a.height);
+
+			double sum{};
+			int numWindows{};
+			for (int top{ 0 }; top + windowHeight <= a.height; top += stride)
+			{
+				for (int left{ 0 }; left + windowWidth <= a.width; left += stride)
+				{
+					double sumA{}, sumB{}, sumAA{}, sumBB{}, sumAB{};
+					for (int y{ top }; y < top + windowHeight; ++y)
+					{
+						for (int x{ left }; x < left + windowWidth; ++x)
+						{
+							const double valueA = lumaA[size_t(y) * a.width + x];
+							const double valueB = lumaB[size_t(y) * a.width + x];
+							sumA += valueA;
+							sumB += valueB;
+							sumAA += valueA * valueA;
+							sumBB += valueB * valueB;
+							sumAB += valueA * valueB;
+						}
+					}
+
+					const double count = double(windowWidth * windowHeight);
+					const double meanA = sumA / count, meanB = sumB / count;
+					const double varianceA = sumAA / count - meanA * meanA;
+					const double varianceB = sumBB / count - meanB * meanB;
+					const double covariance = sumAB / count - meanA * meanB;
+					sum += ((2.0 * meanA * meanB + c1) * (2.0 * covariance + c2))
+						/ ((meanA * meanA + meanB * meanB + c1) * (varianceA + varianceB + c2));
+					++numWindows;
+				}
+			}
+			return sum / numWindows;
+		}
+
+		Image CreateDiffImage(const Image& a, const Image& b, int scale)
+		{
+			Image diff{ a.width, a.height, std::vector<uint8_t>(a.rgb.size()) };
+			if (!IsSameSize(a, b))
+				return diff;
+
+			for (size_t i{ 0 }; i < a.rgb.size(); ++i)
+				diff.rgb[i] = static_cast<uint8_t>(std::min(255, std::abs(int(a.rgb[i]) - int(b.rgb[i])) * scale));
+			return diff;
+		}
+	}
+}
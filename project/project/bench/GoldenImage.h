@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	// Images and image metrics for the golden-image harness (GoldenMain.cpp)
+	namespace Golden
+	{
+		// 8 bit RGB, row major, top row first
+		struct Image
+		{
+			int width{};
+			int height{};
+			std::vector<uint8_t> rgb{};
+		};
+
+		// Binary PPM (P6, maxval 255): no dependencies and every image viewer opens it. Return false on IO or format errors
+		bool ReadPPM(const std::string& path, Image& image);
+		bool WritePPM(const std::string& path, const Image& image);
+
+		// Over all channels, in dB. Identical images give infinity, different sizes 0
+		double ComputePSNR(const Image& a, const Image& b);
+		// Mean SSIM of the luma over 8x8 windows (stride 4), 1 = identical. Different sizes give 0
+		double ComputeSSIM(const Image& a, const Image& b);
+
+		// |a - b| per channel times scale, so small differences stay visible
+		Image CreateDiffImage(const Image& a, const Image& b, int scale = 8);
+	}
+}
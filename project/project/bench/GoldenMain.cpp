@@ -0,0 +1,355 @@
+// Golden-image regression harness: renders scripted frames of the vehicle + fire scene through the headless
+// SoftwareRenderer, compares them with the reference images in bench/golden and times every frame.
+// Fails (exit code 1) when a frame drops below the PSNR/SSIM thresholds or goes over its CPU time budget
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GoldenImage.h"
+#include "Math.h"
+#include "SoftwareRenderer.h"
+#include "TestScene.h"
+
+using namespace dae;
+
+namespace
+{
+	// Small enough to keep the references in the repository, same aspect ratio as the app
+	constexpr int s_Width{ 160 };
+	constexpr int s_Height{ 120 };
+	constexpr ColorRGB s_ClearColor{ 0.39f, 0.59f, 0.93f };
+
+	// Every filtering method plays the same script: rotation (PI/2 per second, like Renderer::Update) is toggled at
+	// s_ToggleTimes and a frame is captured at each of s_FrameTimes: still, rotating, stopped again
+	constexpr float s_ToggleTimes[]{ 0.25f, 0.75f };
+	constexpr float s_FrameTimes[]{ 0.f, 0.5f, 1.f };
+
+	struct Settings
+	{
+		std::string referenceDir{ GOLDEN_REFERENCE_DIR };
+		std::string outputDir{ "golden_output" };
+		std::string baselinePath{};		// an earlier report.json to compare the timings with
+		bool isUpdate{ false };			// write the references instead of comparing
+		double minPSNR{ 40.0 };
+		double minSSIM{ 0.99 };
+		double frameBudgetMs{ 0.0 };	// 0 = no absolute budget
+		double maxSlowdown{ 1.25 };		// against the baseline
+		int repeat{ 5 };
+		uint32_t numThreads{ 1 };
+	};
+
+	struct FrameResult
+	{
+		std::string name{};
+		double psnr{};
+		double ssim{};
+		double cpuMs{};					// median over Settings::repeat renders
+		double minCpuMs{};
+		double baselineMs{};			// 0 = no baseline
+		bool hasReference{};
+		bool isVisualPass{ true };
+		bool isTimingPass{ true };
+	};
+
+	const char* GetFilteringName(FilteringMethod filteringMethod)
+	{
+		switch (filteringMethod)
+		{
+		case FilteringMethod::Point: return "Point";
+		case FilteringMethod::Linear: return "Linear";
+		default: return "Anisotropic";
+		}
+	}
+
+	// Seconds spent rotating up to time
+	float GetRotatingTime(float time)
+	{
+		float rotating{};
+		bool isRotating{ false };
+		float start{};
+		for (const float toggle : s_ToggleTimes)
+		{
+			if (toggle > time)
+				break;
+			if (isRotating)
+				rotating += toggle - start;
+			isRotating = !isRotating;
+			start = toggle;
+		}
+		if (isRotating)
+			rotating += time - start;
+		return rotating;
+	}
+
+	// Same camera and world matrix as Renderer: camera at the origin looking down +z, vehicle at z = 50
+	void RenderFrame(SoftwareRenderer& renderer, const TestScene& scene, float rotation, FilteringMethod filteringMethod)
+	{
+		const float fov = tanf((45.f * TO_RADIANS) / 2.f);
+		const Vector3 cameraPos{ 0.f, 0.f, 0.f };
+		const Matrix view = Matrix::Inverse(Matrix::CreateLookAtLH(cameraPos, Vector3::UnitZ, Vector3::UnitY));
+		const Matrix projection = Matrix::CreatePerspectiveFovLH(fov, renderer.GetWidth() / float(renderer.GetHeight()), 0.1f, 100.f);
+		const Matrix world = Matrix::CreateRotationY(rotation) * Matrix::CreateTranslation(0.f, 0.f, 50.f);
+		const Matrix worldViewProjection = world * view * projection;
+
+		renderer.BeginFrame(s_ClearColor);
+		renderer.Draw(scene.GetVehicleMesh(), world, worldViewProjection, cameraPos, filteringMethod);
+		renderer.Draw(scene.GetFireMesh(), world, worldViewProjection, cameraPos, filteringMethod);
+		renderer.EndFrame();
+	}
+
+	Golden::Image CaptureImage(const SoftwareRenderer& renderer)
+	{
+		std::vector<uint32_t> pixels(size_t(renderer.GetWidth()) * renderer.GetHeight());
+		renderer.Resolve(pixels);
+
+		Golden::Image image{ renderer.GetWidth(), renderer.GetHeight(), std::vector<uint8_t>(pixels.size() * 3) };
+		for (size_t i{ 0 }; i < pixels.size(); ++i)
+		{
+			image.rgb[i * 3] = uint8_t(pixels[i]);
+			image.rgb[i * 3 + 1] = uint8_t(pixels[i] >> 8);
+			image.rgb[i * 3 + 2] = uint8_t(pixels[i] >> 16);
+		}
+		return image;
+	}
+
+	// cpu_ms per frame name from a report written by WriteReport (one frame per line)
+	bool ReadBaseline(const std::string& path, std::map<std::string, double>& timings)
+	{
+		std::ifstream file(path);
+		if (!file)
+			return false;
+
+		std::string line{};
+		while (std::getline(file, line))
+		{
+			const size_t name = line.find("\"name\": \"");
+			const size_t cpuMs = line.find("\"cpu_ms\": ");
+			if (name == std::string::npos || cpuMs == std::string::npos)
+				continue;
+
+			const size_t nameBegin = name + std::strlen("\"name\": \"");
+			const size_t nameEnd = line.find('"', nameBegin);
+			timings[line.substr(nameBegin, nameEnd - nameBegin)] = std::atof(line.c_str() + cpuMs + std::strlen("\"cpu_ms\": "));
+		}
+		return true;
+	}
+
+	// JSON has no infinity: identical images report a PSNR of 999
+	double ToJsonPSNR(double psnr)
+	{
+		return std::isinf(psnr) ? 999.0 : psnr;
+	}
+
+	bool WriteReport(const std::string& path, const Settings& settings, const std::vector<FrameResult>& results, bool isPass)
+	{
+		std::ofstream file(path);
+		if (!file)
+			return false;
+
+#if defined(__AVX2__)
+		const char* simd = "avx2";
+#else
+		const char* simd = "sse2";
+#endif
+
+		file << "{\n";
+		file << "  \"context\": {\n";
+		file << "    \"simd\": \"" << simd << "\",\n";
+		file << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+		file << "    \"threads\": " << settings.numThreads << ",\n";
+		file << "    \"width\": " << s_Width << ",\n";
+		file << "    \"height\": " << s_Height << ",\n";
+		file << "    \"repeat\": " << settings.repeat << ",\n";
+		file << "    \"min_psnr\": " << settings.minPSNR << ",\n";
+		file << "    \"min_ssim\": " << settings.minSSIM << ",\n";
+		file << "    \"frame_budget_ms\": " << settings.frameBudgetMs << ",\n";
+		file << "    \"max_slowdown\": " << settings.maxSlowdown << "\n";
+		file << "  },\n";
+		file << "  \"pass\": " << (isPass ? "true" : "false") << ",\n";
+		file << "  \"frames\": [\n";
+		for (size_t i{ 0 }; i < results.size(); ++i)
+		{
+			const FrameResult& result = results[i];
+			file << "    { \"name\": \"" << result.name << "\""
+				<< ", \"cpu_ms\": " << result.cpuMs
+				<< ", \"min_cpu_ms\": " << result.minCpuMs
+				<< ", \"baseline_ms\": " << result.baselineMs
+				<< ", \"has_reference\": " << (result.hasReference ? "true" : "false")
+				<< ", \"psnr\": " << ToJsonPSNR(result.psnr)
+				<< ", \"ssim\": " << result.ssim
+				<< ", \"visual_pass\": " << (result.isVisualPass ? "true" : "false")
+				<< ", \"timing_pass\": " << (result.isTimingPass ? "true" : "false")
+				<< " }" << (i + 1 < results.size() ? ",\n" : "\n");
+		}
+		file << "  ]\n";
+		file << "}\n";
+
+		return static_cast<bool>(file);
+	}
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: GP1_DirectX_Golden [--reference <dir>] [--output <dir>] [--update] [--min-psnr <dB>] [--min-ssim <value>]\n"
+			"                          [--frame-budget <ms>] [--baseline <report.json>] [--max-slowdown <ratio>]\n"
+			"                          [--repeat <count>] [--threads <count>]\n"
+			"  --reference     reference images (default: bench/golden in the source tree)\n"
+			"  --output        report.json, diff images and the failing frames go here (default golden_output)\n"
+			"  --update        render the references instead of comparing with them\n"
+			"  --min-psnr      fail below this PSNR (default 40)\n"
+			"  --min-ssim      fail below this SSIM (default 0.99)\n"
+			"  --frame-budget  fail when a frame's median CPU time is over this many ms (default 0 = off)\n"
+			"  --baseline      report.json of an earlier run on the same machine to compare the timings with\n"
+			"  --max-slowdown  fail when a frame is this much slower than in the baseline (default 1.25)\n"
+			"  --repeat        timed renders per frame, the median counts (default 5)\n"
+			"  --threads       SoftwareRenderer threads, 0 = hardware threads (default 1)\n");
+	}
+}
+
+int main(int argc, char* args[])
+{
+	Settings settings{};
+	for (int i{ 1 }; i < argc; ++i)
+	{
+		const bool hasValue = i + 1 < argc;
+		if (std::strcmp(args[i], "--reference") == 0 && hasValue)
+			settings.referenceDir = args[++i];
+		else if (std::strcmp(args[i], "--output") == 0 && hasValue)
+			settings.outputDir = args[++i];
+		else if (std::strcmp(args[i], "--update") == 0)
+			settings.isUpdate = true;
+		else if (std::strcmp(args[i], "--min-psnr") == 0 && hasValue)
+			settings.minPSNR = std::atof(args[++i]);
+		else if (std::strcmp(args[i], "--min-ssim") == 0 && hasValue)
+			settings.minSSIM = std::atof(args[++i]);
+		else if (std::strcmp(args[i], "--frame-budget") == 0 && hasValue)
+			settings.frameBudgetMs = std::atof(args[++i]);
+		else if (std::strcmp(args[i], "--baseline") == 0 && hasValue)
+			settings.baselinePath = args[++i];
+		else if (std::strcmp(args[i], "--max-slowdown") == 0 && hasValue)
+			settings.maxSlowdown = std::atof(args[++i]);
+		else if (std::strcmp(args[i], "--repeat") == 0 && hasValue)
+			settings.repeat = std::max(1, std::atoi(args[++i]));
+		else if (std::strcmp(args[i], "--threads") == 0 && hasValue)
+			settings.numThreads = uint32_t(std::max(0, std::atoi(args[++i])));
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+
+	std::map<std::string, double> baseline{};
+	if (!settings.baselinePath.empty() && !ReadBaseline(settings.baselinePath, baseline))
+	{
+		std::printf("Could not read %s\n", settings.baselinePath.c_str());
+		return 2;
+	}
+
+	std::error_code error{};
+	const std::filesystem::path outputDir{ settings.outputDir };
+	const std::filesystem::path referenceDir{ settings.referenceDir };
+	std::filesystem::create_directories(outputDir, error);
+	if (settings.isUpdate)
+		std::filesystem::create_directories(referenceDir, error);
+
+	TestScene scene{};
+	CreateTestScene(scene);
+	SoftwareRenderer renderer{ s_Width, s_Height, settings.numThreads };
+
+	std::vector<FrameResult> results{};
+	bool isPass{ true };
+	for (const FilteringMethod filteringMethod : { FilteringMethod::Point, FilteringMethod::Linear, FilteringMethod::Anisotropic })
+	{
+		for (size_t frame{ 0 }; frame < std::size(s_FrameTimes); ++frame)
+		{
+			FrameResult result{};
+			result.name = std::string{ GetFilteringName(filteringMethod) } + "/Frame" + std::to_string(frame);
+			const std::string fileName = std::string{ GetFilteringName(filteringMethod) } + "_Frame" + std::to_string(frame);
+			const float rotation = PI_DIV_2 * GetRotatingTime(s_FrameTimes[frame]);
+
+			// Timing: one warm-up render, the median of the rest
+			RenderFrame(renderer, scene, rotation, filteringMethod);
+			std::vector<double> timings(settings.repeat);
+			for (double& timing : timings)
+			{
+				const auto start = std::chrono::steady_clock::now();
+				RenderFrame(renderer, scene, rotation, filteringMethod);
+				timing = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			}
+			std::sort(timings.begin(), timings.end());
+			result.cpuMs = timings[timings.size() / 2];
+			result.minCpuMs = timings.front();
+
+			if (settings.frameBudgetMs > 0.0 && result.cpuMs > settings.frameBudgetMs)
+				result.isTimingPass = false;
+			if (const auto it = baseline.find(result.name); it != baseline.end())
+			{
+				result.baselineMs = it->second;
+				if (result.cpuMs > it->second * settings.maxSlowdown)
+					result.isTimingPass = false;
+			}
+
+			// Image
+			const Golden::Image image = CaptureImage(renderer);
+			const std::string referencePath = (referenceDir / (fileName + ".ppm")).string();
+			if (settings.isUpdate)
+			{
+				if (!Golden::WritePPM(referencePath, image))
+				{
+					std::printf("Could not write %s\n", referencePath.c_str());
+					return 2;
+				}
+				result.hasReference = true;
+				result.psnr = std::numeric_limits<double>::infinity();
+				result.ssim = 1.0;
+			}
+			else
+			{
+				Golden::Image reference{};
+				result.hasReference = Golden::ReadPPM(referencePath, reference);
+				if (result.hasReference)
+				{
+					result.psnr = Golden::ComputePSNR(image, reference);
+					result.ssim = Golden::ComputeSSIM(image, reference);
+					Golden::WritePPM((outputDir / (fileName + "_diff.ppm")).string(), Golden::CreateDiffImage(image, reference));
+				}
+				result.isVisualPass = result.hasReference && result.psnr >= settings.minPSNR && result.ssim >= settings.minSSIM;
+				if (!result.isVisualPass)
+					Golden::WritePPM((outputDir / (fileName + ".ppm")).string(), image);
+			}
+
+			std::printf("%-24s %9.3f ms (min %.3f)", result.name.c_str(), result.cpuMs, result.minCpuMs);
+			if (result.baselineMs > 0.0)
+				std::printf(" baseline %.3f ms", result.baselineMs);
+			if (!result.hasReference)
+				std::printf("  no reference (run with --update)");
+			else
+				std::printf("  PSNR %7.2f dB  SSIM %.4f", ToJsonPSNR(result.psnr), result.ssim);
+			std::printf("%s%s\n", result.isVisualPass ? "" : "  VISUAL REGRESSION", result.isTimingPass ? "" : "  TIMING REGRESSION");
+
+			isPass &= result.isVisualPass && result.isTimingPass;
+			results.push_back(result);
+		}
+	}
+
+	const std::string reportPath = (outputDir / "report.json").string();
+	if (!WriteReport(reportPath, settings, results, isPass))
+	{
+		std::printf("Could not write %s\n", reportPath.c_str());
+		return 2;
+	}
+
+	std::printf("%zu frames %s, report in %s\n", results.size(), isPass ? "passed" : "FAILED", reportPath.c_str());
+	return isPass ? 0 : 1;
+}
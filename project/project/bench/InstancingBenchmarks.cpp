@@ -0,0 +1,130 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "ConstantBufferRing.h"
+#include "InstanceBuffer.h"
+#include "Math.h"
+#include "Mesh.h"
+#include "NullRenderDevice.h"
+#include "TestScene.h"
+
+namespace dae
+{
+	// Vehicles on a 100 wide grid, each turned a bit further, with a tint from its index
+	static void FillGrid(uint32_t begin, uint32_t end, InstanceData* pInstances)
+	{
+		for (uint32_t i{ begin }; i < end; ++i, ++pInstances)
+		{
+			const float sine = sinf(0.01f * i);
+			const float cosine = cosf(0.01f * i);
+			pInstances->worldMatrix = { { cosine, 0.f, -sine, 0.f }, { 0.f, 1.f, 0.f, 0.f }, { sine, 0.f, cosine, 0.f }, { 15.f * (i % 100), 0.f, 15.f * (i / 100), 1.f } };
+			pInstances->tint = { 0.5f + 0.5f * ((i >> 0) & 1), 0.5f + 0.5f * ((i >> 1) & 1), 0.5f + 0.5f * ((i >> 2) & 1) };
+		}
+	}
+
+	void RunInstancingBenchmarks()
+	{
+		TestScene scene{};
+		CreateTestScene(scene);
+
+		NullRenderDevice device{};
+		ICommandContext& context = device.GetImmediateContext();
+
+		GpuTestScene gpuScene{};
+		CreateGpuTestScene(scene, device, gpuScene);
+		auto pConstants = std::make_unique<ConstantBufferRing>(device);
+
+		const Matrix viewProjection = Matrix::CreatePerspectiveFovLH(tanf((45.f * TO_RADIANS) / 2.f), 640.f / 480.f, 0.1f, 100.f);
+		const uint32_t numHardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+		// The threads only split the work: same instances as one thread
+		// ------
+		{
+			InstanceBuffer single{ device };
+			InstanceBuffer threaded{ device };
+			single.Build(100'000, FillGrid, 1);
+			threaded.Build(100'000, FillGrid, 8);
+			Bench::Check(std::memcmp(single.GetInstances().data(), threaded.GetInstances().data(), single.GetCount() * sizeof(InstanceData)) == 0,
+				"InstanceBuffer::Build on 8 threads matches one thread");
+		}
+
+		// One upload and one instanced draw for all of them, the instances in slot 1 and the camera in cbPerFrame
+		// ------
+		{
+			InstanceBuffer instances{ device, 16 };
+			instances.Build(10'000, FillGrid);
+
+			device.ResetCounters();
+			device.SetRecording(true);
+			instances.Upload(context);
+			pConstants->Bind(context, PerFrameConstants{ viewProjection, {} });
+			gpuScene.pVehicle->RenderInstanced(context, instances, FilteringMethod::Linear);
+			device.SetRecording(false);
+			pConstants->EndFrame(context);
+
+			bool isExpected = instances.GetCapacity() >= 10'000 && device.GetCallCount(RenderCall::CreateBuffer) == 1;
+			isExpected &= device.GetCallCount(RenderCall::UpdateBuffer) == 1 && device.GetCallCount(RenderCall::DrawIndexed) == 0;
+			isExpected &= device.GetCallCount(RenderCall::DrawIndexedInstanced) == 1 && device.GetCallCount(RenderCall::SetEffectMatrix) == 0;
+			isExpected &= device.GetCallCount(RenderCall::SetConstantBuffer) == 1;
+			for (const NullRenderDevice::RecordedCall& call : device.GetRecordedCalls())
+			{
+				if (call.call == RenderCall::UpdateBuffer)
+					isExpected &= call.handle == instances.GetBuffer().id && call.value == 10'000 * sizeof(InstanceData);
+				else if (call.call == RenderCall::SetVertexBuffer && call.value == 1)
+					isExpected &= call.handle == instances.GetBuffer().id;
+				else if (call.call == RenderCall::DrawIndexedInstanced)
+					isExpected &= call.value == scene.vehicleIndices.size() && call.instanceCount == 10'000;
+			}
+			Bench::Check(isExpected, "Mesh::RenderInstanced uploads once and draws every instance in one call");
+		}
+
+		// Filling the instance data (items = instances), on one thread and on all of them
+		// ------
+		for (const uint32_t numInstances : { 10'000u, 100'000u })
+		{
+			InstanceBuffer instances{ device, numInstances };
+			for (const uint32_t numThreads : { 1u, numHardwareThreads })
+			{
+				Bench::Run("Instancing/Build/" + std::to_string(numInstances / 1000) + "k/" + std::to_string(numThreads) + "t", numInstances, [&]
+					{
+						instances.Build(numInstances, FillGrid, numThreads);
+						Bench::DoNotOptimize(instances.GetInstances().back());
+					});
+
+				if (numHardwareThreads == 1)
+					break;
+			}
+		}
+
+		// Submitting 10k vehicles (items = vehicles): a Mesh::Render each against build + upload + one instanced draw
+		// ------
+		{
+			constexpr uint32_t numInstances{ 10'000 };
+			InstanceBuffer instances{ device, numInstances };
+			instances.Build(numInstances, FillGrid);
+			Bench::Run("Instancing/NullDevice/PerMeshRender/10k", numInstances, [&]
+				{
+					for (const InstanceData& instance : instances.GetInstances())
+						gpuScene.pVehicle->Render(context, instance.worldMatrix, instance.worldMatrix * viewProjection, {}, FilteringMethod::Linear);
+				});
+			Bench::Run("Instancing/NullDevice/Instanced/10k", numInstances, [&]
+				{
+					instances.Build(numInstances, FillGrid);
+					instances.Upload(context);
+					pConstants->Bind(context, PerFrameConstants{ viewProjection, {} });
+					gpuScene.pVehicle->RenderInstanced(context, instances, FilteringMethod::Linear);
+					pConstants->EndFrame(context);
+				});
+		}
+
+		pConstants.reset();
+		gpuScene.Release();
+		Bench::Check(device.GetLiveResourceCount() == 0, "InstanceBuffer and the instanced layout release their device resources");
+	}
+}
@@ -0,0 +1,122 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "JobSystem.h"
+
+namespace dae
+{
+	// CPU-bound, no memory traffic: 64 dependent square roots and multiply-adds per item
+	static float Kernel(size_t index)
+	{
+		float value = static_cast<float>(index & 1023) * 0.001f;
+		for (int i{ 0 }; i < 64; ++i)
+			value = value * 0.999f + std::sqrt(value + 1.f) * 0.001f;
+		return value;
+	}
+
+	void RunJobSystemBenchmarks()
+	{
+		const uint32_t numHardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+		// Checked on a pool of 4 workers, whatever the machine has: every index once, dependencies respected
+		// ------
+		{
+			JobSystem jobSystem{ 4 };
+
+			std::vector<std::atomic<uint32_t>> visits(100'000);
+			jobSystem.ParallelFor(visits.size(), 1000, [&](size_t begin, size_t end)
+				{
+					// Nested: the inner loop queues more jobs from inside a job
+					jobSystem.ParallelFor(end - begin, 100, [&](size_t innerBegin, size_t innerEnd)
+						{
+							for (size_t i{ begin + innerBegin }; i < begin + innerEnd; ++i)
+								++visits[i];
+						});
+				});
+			Bench::Check(std::all_of(visits.begin(), visits.end(), [](const std::atomic<uint32_t>& count) { return count.load() == 1; }),
+				"JobSystem::ParallelFor visits every index once, also nested");
+
+			// 64 producers fill a buffer, every consumer only runs once all of them finished
+			std::vector<uint32_t> produced(64);
+			std::atomic<uint32_t> numConsumersSeeingAll{ 0 };
+			JobSystem::Counter producers{};
+			JobSystem::Counter consumers{};
+			for (uint32_t& value : produced)
+				jobSystem.Run([&value] { value = 1; }, &producers);
+			for (uint32_t consumer{ 0 }; consumer < 16; ++consumer)
+				jobSystem.Run([&]
+					{
+						numConsumersSeeingAll += std::all_of(produced.begin(), produced.end(), [](uint32_t value) { return value == 1; });
+					}, &consumers, &producers);
+			jobSystem.Wait(consumers);
+			jobSystem.Wait(producers);
+			Bench::Check(numConsumersSeeingAll == 16, "JobSystem runs dependent jobs only after their dependency finished");
+
+			// A dependency that already finished queues right away
+			JobSystem::Counter done{};
+			JobSystem::Counter late{};
+			bool hasRun{ false };
+			jobSystem.Run([&] { hasRun = true; }, &late, &done);
+			jobSystem.Wait(late);
+			Bench::Check(hasRun, "JobSystem runs jobs whose dependency is already done");
+		}
+
+		// Scheduling cost (items = jobs): queue and wait for 10k empty jobs from outside the pool,
+		// without workers (the waiting thread runs them all) and with one per other hardware thread
+		// ------
+		for (const uint32_t numWorkers : { 0u, numHardwareThreads - 1 })
+		{
+			JobSystem jobSystem{ numWorkers };
+			constexpr uint32_t numJobs{ 10'000 };
+			Bench::Run("Jobs/EmptyJob/" + std::to_string(numWorkers) + "workers", numJobs, [&]
+				{
+					JobSystem::Counter counter{};
+					for (uint32_t job{ 0 }; job < numJobs; ++job)
+						jobSystem.Run([] {}, &counter);
+					jobSystem.Wait(counter);
+				});
+
+			if (numWorkers == numHardwareThreads - 1)
+				break;
+		}
+
+		// ParallelFor scaling on a CPU-bound kernel (items = kernel calls), 1 job up to one per pool thread
+		// ------
+		{
+			JobSystem& jobSystem = JobSystem::GetShared();
+			std::vector<uint32_t> jobCounts{};
+			for (uint32_t numJobs{ 1 }; numJobs < jobSystem.GetNumThreads(); numJobs *= 2)
+				jobCounts.push_back(numJobs);
+			jobCounts.push_back(jobSystem.GetNumThreads());
+
+			constexpr size_t count{ 100'000 };
+			std::vector<float> results(count);
+			double singleJobNs{};
+			for (const uint32_t numJobs : jobCounts)
+			{
+				const Bench::Result result = Bench::Run("Jobs/ParallelFor/Kernel/100k/" + std::to_string(numJobs) + "t", count, [&]
+					{
+						jobSystem.ParallelFor(count, 1024, [&](size_t begin, size_t end)
+							{
+								for (size_t i{ begin }; i < end; ++i)
+									results[i] = Kernel(i);
+							}, numJobs);
+						Bench::DoNotOptimize(results.back());
+					});
+				if (result.items == 0)
+					continue;
+				if (numJobs == 1)
+					singleJobNs = result.nsPerItem;
+				if (singleJobNs > 0.0 && numJobs > 1)
+					std::printf("  %.2fx the single job throughput\n", singleJobNs / result.nsPerItem);
+			}
+		}
+	}
+}
@@ -0,0 +1,223 @@
+#include "Benchmark.h"
+
+#include <random>
+
+#include "Math.h"
+
+namespace dae
+{
+	void RunMathBenchmarks()
+	{
+		constexpr size_t count{ 4096 };
+		constexpr size_t batchCount{ 100'000 };
+
+		std::mt19937 rng{ 29 };
+		std::uniform_real_distribution<float> dist{ -10.f, 10.f };
+		std::uniform_real_distribution<float> colorDist{ 0.f, 2.f };
+
+		std::vector<Vector2> vectors2(count);
+		std::vector<Vector3> vectors3(count);
+		std::vector<Vector4> vectors4(count);
+		std::vector<Matrix> matrices(count);
+		std::vector<ColorRGB> colors(count);
+		for (size_t i{ 0 }; i < count; ++i)
+		{
+			vectors2[i] = { dist(rng), dist(rng) };
+			vectors3[i] = { dist(rng), dist(rng), dist(rng) };
+			vectors4[i] = { dist(rng), dist(rng), dist(rng), dist(rng) };
+			matrices[i] = Matrix::CreateRotation(dist(rng), dist(rng), dist(rng)) * Matrix::CreateTranslation(vectors3[i]);
+			colors[i] = { colorDist(rng), colorDist(rng), colorDist(rng) };
+		}
+
+		// Vector2
+		// ------
+		Bench::Run("Vector2/Dot", count, [&]
+			{
+				float sum{};
+				for (size_t i{ 0 }; i + 1 < count; ++i)
+					sum += Vector2::Dot(vectors2[i], vectors2[i + 1]);
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Vector2/Cross", count, [&]
+			{
+				float sum{};
+				for (size_t i{ 0 }; i + 1 < count; ++i)
+					sum += Vector2::Cross(vectors2[i], vectors2[i + 1]);
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Vector2/Normalized", count, [&]
+			{
+				Vector2 sum{};
+				for (const Vector2& v : vectors2)
+					sum += v.Normalized();
+				Bench::DoNotOptimize(sum);
+			});
+
+		// Vector3
+		// ------
+		Bench::Run("Vector3/Dot", count, [&]
+			{
+				float sum{};
+				for (size_t i{ 0 }; i + 1 < count; ++i)
+					sum += Vector3::Dot(vectors3[i], vectors3[i + 1]);
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Vector3/Cross", count, [&]
+			{
+				Vector3 sum{};
+				for (size_t i{ 0 }; i + 1 < count; ++i)
+					sum += Vector3::Cross(vectors3[i], vectors3[i + 1]);
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Vector3/Normalized", count, [&]
+			{
+				Vector3 sum{};
+				for (const Vector3& v : vectors3)
+					sum += v.Normalized();
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Vector3/Reflect", count, [&]
+			{
+				Vector3 sum{};
+				for (size_t i{ 0 }; i + 1 < count; ++i)
+					sum += Vector3::Reflect(vectors3[i], vectors3[i + 1]);
+				Bench::DoNotOptimize(sum);
+			});
+
+		// Vector4
+		// ------
+		Bench::Run("Vector4/Dot", count, [&]
+			{
+				float sum{};
+				for (size_t i{ 0 }; i + 1 < count; ++i)
+					sum += Vector4::Dot(vectors4[i], vectors4[i + 1]);
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Vector4/Normalized", count, [&]
+			{
+				Vector4 sum{ 0.f, 0.f, 0.f, 0.f };
+				for (const Vector4& v : vectors4)
+					sum += v.Normalized();
+				Bench::DoNotOptimize(sum);
+			});
+
+		// Matrix
+		// ------
+		Bench::Run("Matrix/Multiply", count, [&]
+			{
+				for (size_t i{ 0 }; i + 1 < count; ++i)
+				{
+					const Matrix product = matrices[i] * matrices[i + 1];
+					Bench::DoNotOptimize(product);
+				}
+			});
+
+		Bench::Run("Matrix/Inverse", count, [&]
+			{
+				for (const Matrix& m : matrices)
+				{
+					const Matrix inverse = Matrix::Inverse(m);
+					Bench::DoNotOptimize(inverse);
+				}
+			});
+
+		Bench::Run("Matrix/Transpose", count, [&]
+			{
+				for (const Matrix& m : matrices)
+				{
+					const Matrix transposed = Matrix::Transpose(m);
+					Bench::DoNotOptimize(transposed);
+				}
+			});
+
+		Bench::Run("Matrix/TransformPoint", count, [&]
+			{
+				Vector3 sum{};
+				for (size_t i{ 0 }; i < count; ++i)
+					sum += matrices[i].TransformPoint(vectors3[i]);
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Matrix/TransformPoint4", count, [&]
+			{
+				Vector4 sum{ 0.f, 0.f, 0.f, 0.f };
+				for (size_t i{ 0 }; i < count; ++i)
+					sum += matrices[i].TransformPoint(vectors4[i]);
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Matrix/TransformVector", count, [&]
+			{
+				Vector3 sum{};
+				for (size_t i{ 0 }; i < count; ++i)
+					sum += matrices[i].TransformVector(vectors3[i]);
+				Bench::DoNotOptimize(sum);
+			});
+
+		// Batches (one matrix, many points: what a CPU vertex stage does)
+		// ------
+		std::vector<Vector3> points(batchCount);
+		for (Vector3& p : points)
+			p = { dist(rng), dist(rng), dist(rng) };
+		std::vector<Vector4> transformed(batchCount);
+		const Matrix worldViewProjection = matrices[0] * Matrix::CreatePerspectiveFovLH(0.41f, 4.f / 3.f, 0.1f, 100.f);
+
+		Bench::Run("Batch/TransformPoints", batchCount, [&]
+			{
+				for (size_t i{ 0 }; i < batchCount; ++i)
+					transformed[i] = worldViewProjection.TransformPoint(points[i].ToPoint4());
+				Bench::DoNotOptimize(transformed.front());
+			});
+
+		std::vector<Vector3> normalized(batchCount);
+		Bench::Run("Batch/Normalize", batchCount, [&]
+			{
+				std::copy(points.begin(), points.end(), normalized.begin());
+				Vector3::Normalize(normalized.data(), batchCount);
+				Bench::DoNotOptimize(normalized.front());
+			});
+
+		Bench::Run("Batch/MatrixChain", count, [&]
+			{
+				// World * View * Projection per object, like Renderer::Render
+				for (size_t i{ 0 }; i + 2 < count; ++i)
+				{
+					const Matrix product = matrices[i] * matrices[i + 1] * matrices[i + 2];
+					Bench::DoNotOptimize(product);
+				}
+			});
+
+		// ColorRGB
+		// ------
+		Bench::Run("ColorRGB/MultiplyAdd", count, [&]
+			{
+				ColorRGB sum{};
+				for (size_t i{ 0 }; i + 1 < count; ++i)
+					sum += colors[i] * colors[i + 1] * 0.5f;
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("ColorRGB/Lerp", count, [&]
+			{
+				ColorRGB sum{};
+				for (size_t i{ 0 }; i + 1 < count; ++i)
+					sum += ColorRGB::Lerp(colors[i], colors[i + 1], 0.25f);
+				Bench::DoNotOptimize(sum);
+			});
+
+		std::vector<ColorRGB> maxToOne(count);
+		Bench::Run("ColorRGB/MaxToOne", count, [&]
+			{
+				std::copy(colors.begin(), colors.end(), maxToOne.begin());
+				for (ColorRGB& color : maxToOne)
+					color.MaxToOne();
+				Bench::DoNotOptimize(maxToOne.front());
+			});
+	}
+}
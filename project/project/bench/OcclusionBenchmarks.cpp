@@ -0,0 +1,187 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "Bounds.h"
+#include "Math.h"
+#include "OcclusionCuller.h"
+#include "RasterKernels.h"
+#include "TestScene.h"
+
+namespace dae
+{
+	struct OccluderScene
+	{
+		std::vector<Vector3> positions{};
+		std::vector<uint32_t> indices{};
+	};
+
+	// Per pixel nearest occluder depth with the exact rasterizer, projected and snapped like OcclusionCuller::RenderOccluder
+	static std::vector<float> RenderReferenceDepth(const OccluderScene& scene, const Matrix& viewProjection, int width, int height)
+	{
+		using namespace RasterKernels;
+
+		std::vector<float> depth(size_t(width) * height, 1.f);
+		for (size_t i{ 0 }; i + 2 < scene.indices.size(); i += 3)
+		{
+			int32_t x[3]{}, y[3]{};
+			float z[3]{};
+			for (int v{ 0 }; v < 3; ++v)
+			{
+				const Vector4 position = viewProjection.TransformPoint(Vector4{ scene.positions[scene.indices[i + v]], 1.f });
+				const float invW = 1.f / position.w;
+				x[v] = static_cast<int32_t>(std::lround((position.x * invW + 1.f) * width * 0.5f * SubPixelScale));
+				y[v] = static_cast<int32_t>(std::lround((1.f - position.y * invW) * height * 0.5f * SubPixelScale));
+				z[v] = position.z * invW;
+			}
+
+			const int64_t doubleArea = int64_t(x[1] - x[0]) * (y[2] - y[0]) - int64_t(y[1] - y[0]) * (x[2] - x[0]);
+			if (doubleArea <= 0)
+				continue;
+
+			const int minX = std::max(0, (std::min({ x[0], x[1], x[2] }) - SubPixelHalf + SubPixelScale - 1) >> SubPixelBits);
+			const int minY = std::max(0, (std::min({ y[0], y[1], y[2] }) - SubPixelHalf + SubPixelScale - 1) >> SubPixelBits);
+			const int maxX = std::min(width - 1, (std::max({ x[0], x[1], x[2] }) - SubPixelHalf) >> SubPixelBits);
+			const int maxY = std::min(height - 1, (std::max({ y[0], y[1], y[2] }) - SubPixelHalf) >> SubPixelBits);
+			if (minX > maxX || minY > maxY)
+				continue;
+
+			const EdgeSetup setup = SetupEdges(x, y, z, doubleArea, minX, minY);
+			RasterizeDepthReference(setup, maxX - minX + 1, maxY - minY + 1, depth.data() + size_t(minY) * width + minX, size_t(width));
+		}
+		return depth;
+	}
+
+	void RunOcclusionBenchmarks()
+	{
+		// Same camera as the renderer (45 degrees, 640x480), the culler runs at half resolution
+		const float fov = tanf((45.f * TO_RADIANS) / 2.f);
+		const Matrix view = Matrix::Inverse(Matrix::CreateLookAtLH({ 0.f, 0.f, 0.f }, Vector3::UnitZ, Vector3::UnitY));
+		const Matrix viewProjection = view * Matrix::CreatePerspectiveFovLH(fov, 640.f / 480.f, 0.1f, 100.f);
+
+		OcclusionCuller culler{ 320, 240 };
+
+		// A wall at z = 20 hides what is straight behind it, not what is in front or next to it
+		// ------
+		{
+			OccluderScene wall{};
+			AppendBox({ 0.f, 0.f, 20.f }, { 4.f, 3.f, 0.5f }, wall.positions, wall.indices);
+
+			culler.BeginFrame();
+			culler.RenderOccluder(wall.positions, wall.indices, viewProjection);
+			Bench::Check(!culler.IsVisible({ { 0.f, 0.f, 40.f }, { 3.f, 2.f, 1.f } }, viewProjection), "OcclusionCuller hides a box behind the wall");
+			Bench::Check(!culler.IsVisible({ { 1.f, -1.f, 25.f }, { 0.5f, 0.5f, 0.5f } }, viewProjection), "OcclusionCuller hides a small box right behind the wall");
+			Bench::Check(culler.IsVisible({ { 0.f, 0.f, 10.f }, { 1.f, 1.f, 1.f } }, viewProjection), "OcclusionCuller keeps a box in front of the wall");
+			Bench::Check(culler.IsVisible({ { 9.f, 0.f, 40.f }, { 1.f, 1.f, 1.f } }, viewProjection), "OcclusionCuller keeps a box sticking out past the wall edge");
+			Bench::Check(culler.IsVisible({ { 0.f, 0.f, 0.f }, { 1.f, 1.f, 1.f } }, viewProjection), "OcclusionCuller keeps a box around the eye");
+		}
+
+		// Random scene: the culler's depth never lies in front of the real depth buffer, so nothing visible is culled
+		// ------
+		std::mt19937 rng{ 35 };
+		std::uniform_real_distribution<float> sideDist{ -12.f, 12.f };
+		std::uniform_real_distribution<float> depthDist{ 8.f, 40.f };
+		std::uniform_real_distribution<float> sizeDist{ 0.5f, 4.f };
+
+		OccluderScene occluders{};
+		for (int i{ 0 }; i < 24; ++i)
+			AppendBox({ sideDist(rng), sideDist(rng) * 0.75f, depthDist(rng) }, { sizeDist(rng), sizeDist(rng), sizeDist(rng) }, occluders.positions, occluders.indices);
+
+		auto createObjects = [&](size_t count)
+			{
+				std::uniform_real_distribution<float> objectDepthDist{ 10.f, 90.f };
+				std::uniform_real_distribution<float> objectSizeDist{ 0.1f, 1.5f };
+				std::vector<AABB> objects(count);
+				for (AABB& object : objects)
+				{
+					const float z = objectDepthDist(rng);
+					object = { { sideDist(rng) * z / 20.f, sideDist(rng) * 0.75f * z / 20.f, z }, { objectSizeDist(rng), objectSizeDist(rng), objectSizeDist(rng) } };
+				}
+				return objects;
+			};
+
+		culler.BeginFrame();
+		culler.RenderOccluder(occluders.positions, occluders.indices, viewProjection);
+		{
+			const std::vector<float> referenceDepth = RenderReferenceDepth(occluders, viewProjection, culler.GetWidth(), culler.GetHeight());
+			bool isConservative{ true };
+			for (int y{ 0 }; y < culler.GetHeight(); ++y)
+				for (int x{ 0 }; x < culler.GetWidth(); ++x)
+					isConservative &= culler.GetDepthBound(x, y) >= referenceDepth[size_t(y) * culler.GetWidth() + x] - 1e-6f;
+			Bench::Check(isConservative, "OcclusionCuller depth bound is never in front of the per pixel depth");
+
+			// Culled objects: every pixel they touch is covered by an occluder in front of their nearest point
+			uint32_t numCulled{}, numWrong{};
+			for (const AABB& object : createObjects(4'000))
+			{
+				if (culler.IsVisible(object, viewProjection))
+					continue;
+
+				++numCulled;
+				float minX{ FLT_MAX }, minY{ FLT_MAX }, maxX{ -FLT_MAX }, maxY{ -FLT_MAX }, zMin{ FLT_MAX };
+				for (int corner{ 0 }; corner < 8; ++corner)
+				{
+					const Vector3 min = object.GetMin(), max = object.GetMax();
+					const Vector4 position = viewProjection.TransformPoint(Vector4{ (corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y, (corner & 4) ? max.z : min.z, 1.f });
+					minX = std::min(minX, (position.x / position.w + 1.f) * 0.5f * culler.GetWidth());
+					maxX = std::max(maxX, (position.x / position.w + 1.f) * 0.5f * culler.GetWidth());
+					minY = std::min(minY, (1.f - position.y / position.w) * 0.5f * culler.GetHeight());
+					maxY = std::max(maxY, (1.f - position.y / position.w) * 0.5f * culler.GetHeight());
+					zMin = std::min(zMin, position.z / position.w);
+				}
+				for (int y = std::max(0, int(std::floor(minY))); y <= std::min(culler.GetHeight() - 1, int(std::floor(maxY))); ++y)
+					for (int x = std::max(0, int(std::floor(minX))); x <= std::min(culler.GetWidth() - 1, int(std::floor(maxX))); ++x)
+						numWrong += referenceDepth[size_t(y) * culler.GetWidth() + x] > zMin;
+			}
+			Bench::Check(numCulled > 0 && numWrong == 0, "OcclusionCuller only culls objects hidden at every pixel");
+		}
+
+		// Occluders: a few walls and the vehicle stand-in sphere (items = triangles)
+		// ------
+		{
+			std::vector<Vertex_In> sphereVertices{};
+			std::vector<uint32_t> sphereIndices{};
+			CreateSphere(96, 192, 12.f, sphereVertices, sphereIndices);
+
+			OccluderScene scene{ occluders };
+			const uint32_t first = static_cast<uint32_t>(scene.positions.size());
+			for (const Vertex_In& vertex : sphereVertices)
+				scene.positions.push_back(vertex.position + Vector3{ 0.f, 0.f, 50.f });
+			for (const uint32_t index : sphereIndices)
+				scene.indices.push_back(first + index);
+
+			const uint64_t numTriangles = scene.indices.size() / 3;
+			const Bench::Result result = Bench::Run("Occlusion/RenderOccluders", numTriangles, [&]
+				{
+					culler.BeginFrame();
+					culler.RenderOccluder(scene.positions, scene.indices, viewProjection);
+				});
+			if (result.items > 0)
+				std::printf("  %u of %llu triangles rasterized\n", culler.GetStats().numRasterized, static_cast<unsigned long long>(numTriangles));
+		}
+
+		// Occlusion queries against the random scene (items = objects)
+		// ------
+		culler.BeginFrame();
+		culler.RenderOccluder(occluders.positions, occluders.indices, viewProjection);
+		for (const size_t count : { size_t{ 1'000 }, size_t{ 4'000 }, size_t{ 16'000 } })
+		{
+			const std::vector<AABB> objects = createObjects(count);
+			uint32_t numVisible{};
+			const Bench::Result result = Bench::Run("Occlusion/Test/" + std::to_string(count), count, [&]
+				{
+					numVisible = 0;
+					for (const AABB& object : objects)
+						numVisible += culler.IsVisible(object, viewProjection);
+					Bench::DoNotOptimize(numVisible);
+				});
+			if (result.items > 0)
+				std::printf("  %.1f%% culled\n", 100.0 * (count - numVisible) / count);
+		}
+	}
+}
@@ -0,0 +1,142 @@
+#include "Benchmark.h"
+
+#include <random>
+
+#include "Math.h"
+
+namespace dae
+{
+	void RunQuaternionBenchmarks()
+	{
+		constexpr size_t count{ 1024 };
+
+		std::mt19937 rng{ 1234 };
+		std::uniform_real_distribution<float> angleDist{ -PI, PI };
+
+		std::vector<float> pitches(count), yaws(count);
+		std::vector<Quaternion> quaternions(count);
+		std::vector<Matrix> matrices(count);
+		std::vector<Vector3> vectors(count);
+		for (size_t i{ 0 }; i < count; ++i)
+		{
+			pitches[i] = angleDist(rng);
+			yaws[i] = angleDist(rng);
+			quaternions[i] = Quaternion::CreateRotation(pitches[i], yaws[i], angleDist(rng));
+			matrices[i] = Matrix::CreateRotation(quaternions[i]);
+			vectors[i] = { angleDist(rng), angleDist(rng), angleDist(rng) };
+		}
+
+		// Composition
+		// ------
+		Bench::Run("Quaternion/Multiply", count, [&]
+			{
+				Quaternion result{};
+				for (const Quaternion& q : quaternions)
+					result = q * result;
+				Bench::DoNotOptimize(result);
+			});
+
+		Bench::Run("Matrix/MultiplyRotation", count, [&]
+			{
+				Matrix result{};
+				for (const Matrix& m : matrices)
+					result = m * result;
+				Bench::DoNotOptimize(result);
+			});
+
+		// Rotating vectors
+		// ------
+		Bench::Run("Quaternion/Rotate", count, [&]
+			{
+				Vector3 sum{};
+				for (size_t i{ 0 }; i < count; ++i)
+					sum += quaternions[i].Rotate(vectors[i]);
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Matrix/TransformVector", count, [&]
+			{
+				Vector3 sum{};
+				for (size_t i{ 0 }; i < count; ++i)
+					sum += matrices[i].TransformVector(vectors[i]);
+				Bench::DoNotOptimize(sum);
+			});
+
+		// Interpolation
+		// ------
+		Bench::Run("Quaternion/Lerp", count, [&]
+			{
+				Quaternion sum{};
+				for (size_t i{ 0 }; i + 1 < count; ++i)
+					sum = Quaternion::Lerp(quaternions[i], quaternions[i + 1], 0.3f) * sum;
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Quaternion/Slerp", count, [&]
+			{
+				Quaternion sum{};
+				for (size_t i{ 0 }; i + 1 < count; ++i)
+					sum = Quaternion::Slerp(quaternions[i], quaternions[i + 1], 0.3f) * sum;
+				Bench::DoNotOptimize(sum);
+			});
+
+		// Camera basis rebuild (mouse look)
+		// ------
+		Bench::Run("Camera/OrientationFromMatrix", count, [&]
+			{
+				Vector3 sum{};
+				for (size_t i{ 0 }; i < count; ++i)
+				{
+					const Matrix rotation = Matrix::CreateRotation(pitches[i], yaws[i], 0);
+					sum += rotation.TransformVector(Vector3::UnitZ).Normalized();
+					sum += rotation.TransformVector(Vector3::UnitY).Normalized();
+					sum += rotation.TransformVector(Vector3::UnitX).Normalized();
+				}
+				Bench::DoNotOptimize(sum);
+			});
+
+		Bench::Run("Camera/OrientationFromQuaternion", count, [&]
+			{
+				Vector3 sum{};
+				for (size_t i{ 0 }; i < count; ++i)
+				{
+					const Quaternion orientation = Quaternion::CreateRotationY(yaws[i]) * Quaternion::CreateRotationX(pitches[i]);
+					const Matrix rotation = Matrix::CreateRotation(orientation);
+					sum += rotation.GetAxisZ();
+					sum += rotation.GetAxisY();
+					sum += rotation.GetAxisX();
+				}
+				Bench::DoNotOptimize(sum);
+			});
+
+		// Spinning object world matrix (Renderer::Update)
+		// ------
+		const Vector3 position{ 0.f, 0.f, 50.f };
+
+		Bench::Run("World/RotationYMatrix", count, [&]
+			{
+				float rotation{};
+				Matrix world{};
+				for (size_t i{ 0 }; i < count; ++i)
+				{
+					rotation += pitches[i] * 0.01f;
+					world = Matrix::CreateRotationY(rotation) * Matrix::CreateTranslation(position);
+					Bench::DoNotOptimize(world);
+				}
+			});
+
+		Bench::Run("World/RotationYQuaternion", count, [&]
+			{
+				Quaternion orientation{};
+				Matrix world{};
+				for (size_t i{ 0 }; i < count; ++i)
+				{
+					orientation = Quaternion::CreateRotationY(pitches[i] * 0.01f) * orientation;
+					orientation.Normalize();
+					world = Matrix::CreateRotation(orientation);
+					world[3] = position.ToPoint4();
+					Bench::DoNotOptimize(world);
+				}
+			});
+	}
+}
@@ -0,0 +1,181 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <random>
+#include <tuple>
+
+#include "RasterKernels.h"
+
+namespace dae
+{
+	using namespace RasterKernels;
+
+	// Screen space triangle in fixed point with its pixel bounds, like SoftwareRenderer::Triangle
+	struct RasterTriangle
+	{
+		int32_t x[3]{}, y[3]{};
+		float z[3]{};
+		int64_t doubleArea{};
+		int minX{}, minY{}, maxX{}, maxY{};
+	};
+
+	static constexpr int s_Width{ 640 };
+	static constexpr int s_Height{ 480 };
+
+	// Random clockwise triangle with its vertices within size pixels of a random point, snapped to pixel centers
+	// or whole pixels part of the time so edges run exactly through pixel centers
+	static RasterTriangle CreateTriangle(std::mt19937& rng, float size)
+	{
+		std::uniform_real_distribution<float> centerX{ -size * 0.25f, s_Width + size * 0.25f };
+		std::uniform_real_distribution<float> centerY{ -size * 0.25f, s_Height + size * 0.25f };
+		std::uniform_real_distribution<float> offset{ -size, size };
+		std::uniform_real_distribution<float> depth{ 0.1f, 0.9f };
+		std::uniform_int_distribution<int> snapping{ 0, 2 };
+
+		RasterTriangle triangle{};
+		while (triangle.doubleArea <= 0)
+		{
+			const float x = centerX(rng);
+			const float y = centerY(rng);
+			const int snap = snapping(rng);
+			for (int v{ 0 }; v < 3; ++v)
+			{
+				float vertexX = x + offset(rng);
+				float vertexY = y + offset(rng);
+				if (snap == 1)
+				{
+					vertexX = std::floor(vertexX) + 0.5f;
+					vertexY = std::floor(vertexY) + 0.5f;
+				}
+				else if (snap == 2)
+				{
+					vertexX = std::floor(vertexX);
+					vertexY = std::floor(vertexY);
+				}
+				triangle.x[v] = static_cast<int32_t>(std::lround(vertexX * SubPixelScale));
+				triangle.y[v] = static_cast<int32_t>(std::lround(vertexY * SubPixelScale));
+				triangle.z[v] = depth(rng);
+			}
+
+			triangle.doubleArea = int64_t(triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0])
+				- int64_t(triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+			if (triangle.doubleArea < 0)
+			{
+				std::swap(triangle.x[1], triangle.x[2]);
+				std::swap(triangle.y[1], triangle.y[2]);
+				triangle.doubleArea = -triangle.doubleArea;
+			}
+		}
+
+		triangle.minX = std::max(0, (std::min({ triangle.x[0], triangle.x[1], triangle.x[2] }) - SubPixelHalf + SubPixelScale - 1) >> SubPixelBits);
+		triangle.minY = std::max(0, (std::min({ triangle.y[0], triangle.y[1], triangle.y[2] }) - SubPixelHalf + SubPixelScale - 1) >> SubPixelBits);
+		triangle.maxX = std::min(s_Width - 1, (std::max({ triangle.x[0], triangle.x[1], triangle.x[2] }) - SubPixelHalf) >> SubPixelBits);
+		triangle.maxY = std::min(s_Height - 1, (std::max({ triangle.y[0], triangle.y[1], triangle.y[2] }) - SubPixelHalf) >> SubPixelBits);
+		return triangle;
+	}
+
+	template<typename Rasterize>
+	static uint64_t RasterizeTriangles(const std::vector<RasterTriangle>& triangles, std::vector<float>& depthBuffer, Rasterize&& rasterize)
+	{
+		uint64_t numPixels{};
+		for (const RasterTriangle& triangle : triangles)
+		{
+			if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+				continue;
+
+			const EdgeSetup setup = SetupEdges(triangle.x, triangle.y, triangle.z, triangle.doubleArea, triangle.minX, triangle.minY);
+			numPixels += rasterize(setup, triangle.maxX - triangle.minX + 1, triangle.maxY - triangle.minY + 1,
+				depthBuffer.data() + size_t(triangle.minY) * s_Width + triangle.minX, size_t(s_Width));
+		}
+		return numPixels;
+	}
+
+	void RunRasterBenchmarks()
+	{
+		std::mt19937 rng{ 33 };
+
+		// Spans against the scalar reference: same coverage bit for bit, same weights,
+		// and the same early depth result against a buffer that is never close to the triangle depth
+		// ------
+		{
+			std::uniform_int_distribution<int> farOrNear{ 0, 1 };
+			bool isCoverageExact{ true }, isDepthExact{ true };
+			uint64_t numCovered{};
+			for (int t{ 0 }; t < 2'000; ++t)
+			{
+				const RasterTriangle triangle = CreateTriangle(rng, (t % 2) ? 40.f : 3.f);
+				if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+					continue;
+
+				// Start a few pixels early so spans also begin and end outside the triangle
+				const int startX = std::max(0, triangle.minX - 3);
+				const EdgeSetup setup = SetupEdges(triangle.x, triangle.y, triangle.z, triangle.doubleArea, startX, triangle.minY);
+				for (int y{ triangle.minY }; y <= triangle.maxY; ++y)
+				{
+					for (int x{ startX }; x <= triangle.maxX; x += SpanWidth)
+					{
+						const int count = std::min(SpanWidth, triangle.maxX - x + 1);
+						const int64_t edge[3]{
+							setup.edge[0] + (x - startX) * setup.stepX[0] + (y - triangle.minY) * setup.stepY[0],
+							setup.edge[1] + (x - startX) * setup.stepX[1] + (y - triangle.minY) * setup.stepY[1],
+							setup.edge[2] + (x - startX) * setup.stepX[2] + (y - triangle.minY) * setup.stepY[2] };
+
+						SpanOutput simd{}, reference{};
+						const uint32_t covered = RasterizeSpan(setup, edge, count, nullptr, simd);
+						isCoverageExact &= covered == RasterizeSpanReference(setup, edge, count, nullptr, reference);
+						numCovered += std::popcount(covered);
+						for (uint32_t bits = covered; bits != 0; bits &= bits - 1)
+						{
+							const int i = std::countr_zero(bits);
+							for (int k{ 0 }; k < 3; ++k)
+								isCoverageExact &= simd.weights[k][i] == reference.weights[k][i];
+							isCoverageExact &= std::abs(simd.depth[i] - reference.depth[i]) <= 1e-6f;
+						}
+
+						float depth[SpanWidth]{};
+						for (float& value : depth)
+							value = farOrNear(rng) ? 0.95f : 0.05f;
+						isDepthExact &= RasterizeSpan(setup, edge, count, depth, simd) == RasterizeSpanReference(setup, edge, count, depth, reference);
+					}
+				}
+			}
+			Bench::Check(isCoverageExact && numCovered > 0, "RasterKernels::RasterizeSpan coverage matches the scalar reference");
+			Bench::Check(isDepthExact, "RasterKernels::RasterizeSpan depth test matches the scalar reference");
+		}
+
+		// Whole triangles (depth only, items = triangles). The depth buffer is cleared every call
+		// Vehicle sized: about the vehicle's footprint at 640x480. Tiny: a few pixels, setup bound
+		// ------
+		for (const auto& [name, size, count] : { std::tuple{ "VehicleSized", 140.f, 256 }, std::tuple{ "Tiny", 1.5f, 65'536 } })
+		{
+			std::vector<RasterTriangle> triangles(count);
+			for (RasterTriangle& triangle : triangles)
+				triangle = CreateTriangle(rng, size);
+
+			std::vector<float> simdDepth(size_t(s_Width) * s_Height, 1.f);
+			std::vector<float> referenceDepth(simdDepth.size(), 1.f);
+			const uint64_t numSimd = RasterizeTriangles(triangles, simdDepth, RasterizeDepth);
+			const uint64_t numReference = RasterizeTriangles(triangles, referenceDepth, RasterizeDepthReference);
+			float maxDifference{};
+			for (size_t i{ 0 }; i < simdDepth.size(); ++i)
+				maxDifference = std::max(maxDifference, std::abs(simdDepth[i] - referenceDepth[i]));
+			Bench::Check(numSimd == numReference && maxDifference <= 1e-6f, std::string{ "RasterKernels::RasterizeDepth matches the scalar reference (" } + name + ")");
+
+			const std::string prefix = std::string{ "Raster/Depth/" } + name;
+			Bench::Run(prefix + "/Scalar", count, [&]
+				{
+					std::fill(referenceDepth.begin(), referenceDepth.end(), 1.f);
+					Bench::DoNotOptimize(RasterizeTriangles(triangles, referenceDepth, RasterizeDepthReference));
+				});
+			const Bench::Result result = Bench::Run(prefix + "/SIMD", count, [&]
+				{
+					std::fill(simdDepth.begin(), simdDepth.end(), 1.f);
+					Bench::DoNotOptimize(RasterizeTriangles(triangles, simdDepth, RasterizeDepth));
+				});
+			if (result.items > 0)
+				std::printf("  %.1f pixels per triangle\n", double(numSimd) / count);
+		}
+	}
+}
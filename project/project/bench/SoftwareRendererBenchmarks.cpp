@@ -0,0 +1,137 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "Math.h"
+#include "SoftwareRenderer.h"
+#include "TestScene.h"
+
+namespace dae
+{
+	static constexpr ColorRGB s_ClearColor{ 0.39f, 0.59f, 0.93f };
+
+	// Renderer::Render: vehicle then fire, both with the shared world matrix
+	static void RenderTestScene(SoftwareRenderer& renderer, const TestScene& scene, float rotation, FilteringMethod filteringMethod)
+	{
+		const float fov = tanf((45.f * TO_RADIANS) / 2.f);
+		const Vector3 cameraPos{ 0.f, 0.f, 0.f };
+		const Matrix view = Matrix::Inverse(Matrix::CreateLookAtLH(cameraPos, Vector3::UnitZ, Vector3::UnitY));
+		const Matrix projection = Matrix::CreatePerspectiveFovLH(fov, renderer.GetWidth() / float(renderer.GetHeight()), 0.1f, 100.f);
+		const Matrix world = Matrix::CreateRotationY(rotation) * Matrix::CreateTranslation(0.f, 0.f, 50.f);
+		const Matrix worldViewProjection = world * view * projection;
+
+		renderer.BeginFrame(s_ClearColor);
+		renderer.Draw(scene.GetVehicleMesh(), world, worldViewProjection, cameraPos, filteringMethod);
+		renderer.Draw(scene.GetFireMesh(), world, worldViewProjection, cameraPos, filteringMethod);
+		renderer.EndFrame();
+	}
+
+	void RunSoftwareRendererBenchmarks()
+	{
+		TestScene scene{};
+		CreateTestScene(scene);
+
+		// Tiles must not change the image: one thread and many threads are bit identical
+		// ------
+		{
+			SoftwareRenderer single{ 640, 480, 1 };
+			SoftwareRenderer threaded{ 640, 480, 8 };
+			bool isIdentical{ true };
+			for (const FilteringMethod filteringMethod : { FilteringMethod::Point, FilteringMethod::Linear, FilteringMethod::Anisotropic })
+			{
+				RenderTestScene(single, scene, 0.7f, filteringMethod);
+				RenderTestScene(threaded, scene, 0.7f, filteringMethod);
+				isIdentical &= std::memcmp(single.GetColorBuffer().data(), threaded.GetColorBuffer().data(), single.GetColorBuffer().size() * sizeof(ColorRGB)) == 0;
+			}
+			Bench::Check(isIdentical, "SoftwareRenderer threaded image matches single thread");
+			Bench::Check(single.GetFrameStats().numPixelsShaded > 640 * 480 / 8, "SoftwareRenderer draws the test scene");
+		}
+
+		// Fill rule: a grid of half transparent triangles whose edges run through pixel centers
+		// must blend every pixel exactly once (no gaps, no double hits)
+		// ------
+		{
+			constexpr int width{ 640 }, height{ 480 };
+			const SoftwareTexture halfAlpha{ 1, 1, { 0x80FFFFFFu } };
+			std::vector<Vertex_In> vertices{};
+			std::vector<uint32_t> indices{};
+			constexpr int cellsX{ 8 }, cellsY{ 6 };
+			for (int y{ 0 }; y <= cellsY; ++y)
+			{
+				for (int x{ 0 }; x <= cellsX; ++x)
+				{
+					// Inner vertices on pixel centers, the outer ones past the screen border
+					const float screenX = (x == 0) ? -10.f : (x == cellsX) ? width + 10.f : x * (width / cellsX) + 0.5f;
+					const float screenY = (y == 0) ? -10.f : (y == cellsY) ? height + 10.f : y * (height / cellsY) + 0.5f + (x % 2);
+					vertices.push_back({ { screenX / width * 2.f - 1.f, 1.f - screenY / height * 2.f, 0.5f }, {}, {}, {} });
+				}
+			}
+			for (int y{ 0 }; y < cellsY; ++y)
+			{
+				for (int x{ 0 }; x < cellsX; ++x)
+				{
+					const uint32_t topLeft = y * (cellsX + 1) + x;
+					const uint32_t bottomLeft = topLeft + cellsX + 1;
+					for (const uint32_t index : { topLeft, topLeft + 1, bottomLeft + 1, topLeft, bottomLeft + 1, bottomLeft })
+						indices.push_back(index);
+				}
+			}
+
+			SoftwareRenderer renderer{ width, height, 4 };
+			renderer.BeginFrame(colors::Black);
+			renderer.Draw({ vertices, indices, true, &halfAlpha }, {}, {}, {}, FilteringMethod::Point);
+			renderer.EndFrame();
+
+			const ColorRGB reference = colors::White * (128.f / 255.f);
+			const bool isExact = std::all_of(renderer.GetColorBuffer().begin(), renderer.GetColorBuffer().end(),
+				[&](const ColorRGB& color) { return color.r == reference.r && color.g == reference.g && color.b == reference.b; });
+			Bench::Check(isExact, "SoftwareRenderer top-left fill rule covers every pixel once");
+
+			// Same grid in opaque mode but mirrored winding: back faces, nothing may be drawn
+			std::vector<uint32_t> flipped{ indices };
+			for (size_t i{ 0 }; i < flipped.size(); i += 3)
+				std::swap(flipped[i + 1], flipped[i + 2]);
+			renderer.BeginFrame(colors::Black);
+			renderer.Draw({ vertices, flipped, false }, {}, {}, {}, FilteringMethod::Point);
+			Bench::Check(renderer.EndFrame().numRasterized == 0, "SoftwareRenderer culls back faces of opaque meshes");
+		}
+
+		// Whole frames (items = frames, so items/s is FPS), scaling from 1 thread to all hardware threads
+		// ------
+		const uint32_t numHardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+		std::vector<uint32_t> threadCounts{};
+		for (uint32_t numThreads{ 1 }; numThreads < numHardwareThreads; numThreads *= 2)
+			threadCounts.push_back(numThreads);
+		threadCounts.push_back(numHardwareThreads);
+
+		for (const auto& [width, height] : { std::pair{ 640, 480 }, std::pair{ 3840, 2160 } })
+		{
+			double singleThreadNs{};
+			for (const uint32_t numThreads : threadCounts)
+			{
+				SoftwareRenderer renderer{ width, height, numThreads };
+				const std::string name = "SoftwareRenderer/Frame/" + std::to_string(width) + "x" + std::to_string(height) + "/" + std::to_string(numThreads) + "t";
+
+				float rotation{};
+				const Bench::Result result = Bench::Run(name, 1, [&]
+					{
+						RenderTestScene(renderer, scene, rotation, FilteringMethod::Linear);
+						rotation += 0.01f;
+					});
+				if (result.items == 0)
+					continue;
+				if (numThreads == 1)
+					singleThreadNs = result.nsPerItem;
+
+				const SoftwareRenderer::FrameStats& stats = renderer.GetFrameStats();
+				std::printf("  last frame: %.2f ms (geometry %.2f, binning %.2f, raster %.2f), %u/%u triangles rasterized in %u tile references, %llu pixels shaded\n",
+					stats.frameMs, stats.geometryMs, stats.binningMs, stats.rasterMs, stats.numRasterized, stats.numTriangles, stats.numBinned,
+					static_cast<unsigned long long>(stats.numPixelsShaded));
+				if (singleThreadNs > 0.0 && numThreads > 1)
+					std::printf("  %.2fx the single thread frame rate\n", singleThreadNs / result.nsPerItem);
+			}
+		}
+	}
+}
@@ -0,0 +1,134 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+
+#include "DrawList.h"
+#include "Math.h"
+#include "Mesh.h"
+#include "NullRenderDevice.h"
+#include "StateCache.h"
+#include "TestScene.h"
+
+namespace dae
+{
+	// Renderer::Render without the frustum test
+	static void SubmitFrame(ICommandContext& context, Mesh& vehicle, Mesh& fire, const Matrix& world, const Matrix& worldViewProjection, FilteringMethod filteringMethod)
+	{
+		context.ClearRenderTarget({ .39f,.59f,.93f });
+		context.ClearDepthStencil(1.f, 0);
+		vehicle.Render(context, world, worldViewProjection, {}, filteringMethod);
+		fire.Render(context, world, worldViewProjection, {}, filteringMethod);
+		context.Present();
+	}
+
+	void RunSubmissionBenchmarks()
+	{
+		TestScene scene{};
+		CreateTestScene(scene);
+
+		NullRenderDevice device{};
+		ICommandContext& context = device.GetImmediateContext();
+
+		// Same textures and meshes the Renderer creates, only the effect/texture files are not read
+		// ------
+		GpuTestScene gpuScene{};
+		CreateGpuTestScene(scene, device, gpuScene);
+
+		const Matrix world = Matrix::CreateTranslation(0.f, 0.f, 50.f);
+
+		// One frame: 2 clears, per mesh topology + layout + vertex buffer + releasing the 2 constant buffer slots
+		// + 2 matrices + camera + index buffer + its textures + one pass, then present
+		// ------
+		device.ResetCounters();
+		SubmitFrame(context, *gpuScene.pVehicle, *gpuScene.pFire, world, world, FilteringMethod::Linear);
+
+		bool isExpected{ true };
+		isExpected &= device.GetCallCount(RenderCall::ClearRenderTarget) == 1 && device.GetCallCount(RenderCall::ClearDepthStencil) == 1;
+		isExpected &= device.GetCallCount(RenderCall::SetPrimitiveTopology) == 2 && device.GetCallCount(RenderCall::SetInputLayout) == 2;
+		isExpected &= device.GetCallCount(RenderCall::SetVertexBuffer) == 2 && device.GetCallCount(RenderCall::SetIndexBuffer) == 2;
+		isExpected &= device.GetCallCount(RenderCall::SetEffectMatrix) == 4 && device.GetCallCount(RenderCall::SetEffectVector) == 2;
+		isExpected &= device.GetCallCount(RenderCall::SetConstantBuffer) == 4 && device.GetCallCount(RenderCall::SetEffectTexture) == 5;
+		isExpected &= device.GetCallCount(RenderCall::ApplyTechnique) == 2 && device.GetCallCount(RenderCall::DrawIndexed) == 2;
+		isExpected &= device.GetCallCount(RenderCall::Present) == 1;
+		isExpected &= device.GetContextCallCount() == 30;
+		Bench::Check(isExpected, "Mesh::Render issues the expected context calls");
+
+		// The draw order has to survive the abstraction: vehicle first, with all of its indices
+		device.SetRecording(true);
+		SubmitFrame(context, *gpuScene.pVehicle, *gpuScene.pFire, world, world, FilteringMethod::Point);
+		device.SetRecording(false);
+		uint32_t numDraws{};
+		for (const NullRenderDevice::RecordedCall& call : device.GetRecordedCalls())
+		{
+			if (call.call != RenderCall::DrawIndexed)
+				continue;
+			const size_t numIndices = (numDraws++ == 0) ? scene.vehicleIndices.size() : scene.fireIndices.size();
+			isExpected &= call.value == numIndices;
+		}
+		Bench::Check(isExpected && numDraws == 2, "Mesh::Render draws every index in submission order");
+
+		// Submission cost without a driver (items = draws)
+		// ------
+		device.ResetCounters();
+		Bench::Run("Submission/NullDevice/Frame", 2, [&]
+			{
+				SubmitFrame(context, *gpuScene.pVehicle, *gpuScene.pFire, world, world, FilteringMethod::Anisotropic);
+			});
+
+		// Through the state cache, a repeated frame only forwards what changes between the two meshes:
+		// layout, buffers and technique. Topology, released slots, matrices, camera and textures are still bound
+		// ------
+		StateCache stateCache{ context };
+		SubmitFrame(stateCache, *gpuScene.pVehicle, *gpuScene.pFire, world, world, FilteringMethod::Linear);
+		const StateCache::FrameStats firstFrame = stateCache.GetLastFrameStats();
+		device.ResetCounters();
+		SubmitFrame(stateCache, *gpuScene.pVehicle, *gpuScene.pFire, world, world, FilteringMethod::Linear);
+		const StateCache::FrameStats& repeatedFrame = stateCache.GetLastFrameStats();
+		isExpected = firstFrame.GetSkippedCount() == 3;	// the fire's topology and slot releases
+		isExpected &= repeatedFrame.numStateCalls == 25 && repeatedFrame.numSkippedInputAssembler == 2;
+		isExpected &= repeatedFrame.numSkippedConstantBuffers == 4;
+		isExpected &= repeatedFrame.numSkippedEffectVariables == 11 && repeatedFrame.numSkippedTechniques == 0;
+		isExpected &= device.GetContextCallCount() == 30 - 17 && device.GetCallCount(RenderCall::DrawIndexed) == 2;
+		Bench::Check(isExpected, "StateCache skips state that is already bound");
+
+		// A changed value or an invalidated cache is forwarded again
+		device.ResetCounters();
+		const Matrix moved = Matrix::CreateTranslation(0.f, 1.f, 50.f);
+		SubmitFrame(stateCache, *gpuScene.pVehicle, *gpuScene.pFire, moved, world, FilteringMethod::Linear);
+		isExpected = device.GetCallCount(RenderCall::SetEffectMatrix) == 2 && device.GetCallCount(RenderCall::SetEffectVector) == 0;
+		device.ResetCounters();
+		stateCache.Invalidate();
+		SubmitFrame(stateCache, *gpuScene.pVehicle, *gpuScene.pFire, moved, world, FilteringMethod::Linear);
+		isExpected &= device.GetContextCallCount() == 30 - 3;	// the fire's topology and slot releases are the vehicle's again
+		Bench::Check(isExpected, "StateCache forwards changed values and everything after Invalidate");
+
+		// The same draw again right after itself only costs the draw, which is what a sorted draw list lines up
+		// (items = draws: numDraws packets alternating between the meshes, drawn sorted)
+		// ------
+		constexpr uint32_t numSortedDraws{ 1000 };
+		DrawList drawList{};
+		for (uint32_t i{ 0 }; i < numSortedDraws; ++i)
+		{
+			Mesh& mesh = (i % 2 == 0) ? *gpuScene.pVehicle : *gpuScene.pFire;
+			drawList.Submit(mesh.GetSortKey(0, 0.5f, FilteringMethod::Anisotropic), { &mesh, world, world, {}, FilteringMethod::Anisotropic });
+		}
+		drawList.Sort();
+
+		for (const bool isCached : { false, true })
+		{
+			ICommandContext& target = isCached ? static_cast<ICommandContext&>(stateCache) : context;
+			const Bench::Result result = Bench::Run(isCached ? "Submission/StateCache/SortedDraws/1000" : "Submission/NullDevice/SortedDraws/1000", numSortedDraws, [&]
+				{
+					drawList.Execute(target);
+					target.Present();
+				});
+			// The null device's calls cost next to nothing, so this is the cache's own overhead; the saving is in the driver
+			if (result.items > 0 && isCached)
+				std::printf("  %u of %u state calls skipped per frame\n", stateCache.GetLastFrameStats().GetSkippedCount(), stateCache.GetLastFrameStats().numStateCalls);
+		}
+
+		// Every handle has to be given back
+		gpuScene.Release();
+		Bench::Check(device.GetLiveResourceCount() == 0, "Mesh/Effect/Texture release every device resource");
+	}
+}
@@ -0,0 +1,180 @@
+#include "TestScene.h"
+
+#include <cmath>
+
+#include "Utils.h"
+
+namespace dae
+{
+	static uint32_t PackTexel(float r, float g, float b, float a = 1.f)
+	{
+		auto toByte = [](float value) { return static_cast<uint32_t>(Saturate(value) * 255.f + 0.5f); };
+		return toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | (toByte(a) << 24);
+	}
+
+	template<typename Function>
+	static std::unique_ptr<SoftwareTexture> CreateTexture(int size, Function&& texel)
+	{
+		std::vector<uint32_t> texels(size_t(size) * size);
+		for (int y{ 0 }; y < size; ++y)
+			for (int x{ 0 }; x < size; ++x)
+				texels[size_t(y) * size + x] = texel((x + 0.5f) / size, (y + 0.5f) / size);
+		return std::make_unique<SoftwareTexture>(size, size, std::move(texels));
+	}
+
+	SoftwareMesh TestScene::GetVehicleMesh() const
+	{
+		return { vehicleVertices, vehicleIndices, false,
+			pDiffuseTexture.get(), pNormalTexture.get(), pSpecularTexture.get(), pGlossinessTexture.get() };
+	}
+
+	SoftwareMesh TestScene::GetFireMesh() const
+	{
+		return { fireVertices, fireIndices, true, pFireTexture.get() };
+	}
+
+	void CreateTestScene(TestScene& scene)
+	{
+		// "Vehicle": ~37k triangles filling a good part of the 640x480 view at z = 50
+		CreateSphere(96, 192, 12.f, scene.vehicleVertices, scene.vehicleIndices);
+		Utils::ComputeTangents(scene.vehicleVertices, scene.vehicleIndices);
+
+		// "Fire": crossed quads in front of and around the vehicle, overlapping each other
+		scene.fireVertices.clear();
+		scene.fireIndices.clear();
+		for (int i{ 0 }; i < 8; ++i)
+		{
+			const float angle = PI * i / 8.f;
+			const Vector3 right{ cosf(angle) * 6.f, 0.f, sinf(angle) * 6.f };
+			AppendQuad({ 0.f, 4.f, -14.f }, right, { 0.f, 8.f, 0.f }, scene.fireVertices, scene.fireIndices);
+		}
+
+		// 512x512 maps like the vehicle_*.png set
+		constexpr int size{ 512 };
+		scene.pDiffuseTexture = CreateTexture(size, [](float u, float v)
+			{
+				const bool isDark = (int(u * 16.f) + int(v * 16.f)) % 2 != 0;
+				return isDark ? PackTexel(0.2f, 0.25f, 0.3f) : PackTexel(0.9f, 0.6f * u + 0.2f, 0.3f * v + 0.1f);
+			});
+		scene.pNormalTexture = CreateTexture(size, [](float u, float v)
+			{
+				const float nx = 0.4f * sinf(u * PI_2 * 24.f);
+				const float ny = 0.4f * sinf(v * PI_2 * 24.f);
+				const Vector3 normal = Vector3{ nx, ny, 1.f }.Normalized();
+				return PackTexel(normal.x * 0.5f + 0.5f, normal.y * 0.5f + 0.5f, normal.z * 0.5f + 0.5f);
+			});
+		scene.pSpecularTexture = CreateTexture(size, [](float u, float v)
+			{
+				const float specular = (int(u * 8.f) % 2) ? 0.8f : 0.f;
+				return PackTexel(specular, specular, specular);
+			});
+		scene.pGlossinessTexture = CreateTexture(size, [](float u, float v)
+			{
+				return PackTexel(v, v, v);
+			});
+		scene.pFireTexture = CreateTexture(256, [](float u, float v)
+			{
+				const float dx = u - 0.5f;
+				const float dy = v - 0.6f;
+				const float alpha = Saturate(1.f - 2.5f * sqrtf(dx * dx + dy * dy * 0.5f));
+				return PackTexel(1.f, 0.4f + 0.6f * alpha, 0.1f, alpha);
+			});
+	}
+
+	void GpuTestScene::Release()
+	{
+		pFire.reset();
+		pVehicle.reset();
+		pFireTexture.reset();
+		pGlossinessTexture.reset();
+		pSpecularTexture.reset();
+		pNormalTexture.reset();
+		pDiffuseTexture.reset();
+	}
+
+	void CreateGpuTestScene(const TestScene& scene, IRenderDevice& device, GpuTestScene& gpuScene)
+	{
+		gpuScene.pDiffuseTexture = std::make_unique<Texture>(device, *scene.pDiffuseTexture);
+		gpuScene.pNormalTexture = std::make_unique<Texture>(device, *scene.pNormalTexture);
+		gpuScene.pSpecularTexture = std::make_unique<Texture>(device, *scene.pSpecularTexture);
+		gpuScene.pGlossinessTexture = std::make_unique<Texture>(device, *scene.pGlossinessTexture);
+		gpuScene.pFireTexture = std::make_unique<Texture>(device, *scene.pFireTexture);
+
+		gpuScene.pVehicle = std::make_unique<Mesh>(device, scene.vehicleVertices, scene.vehicleIndices, false, MeshTextures{
+			gpuScene.pDiffuseTexture.get(), gpuScene.pNormalTexture.get(), gpuScene.pSpecularTexture.get(), gpuScene.pGlossinessTexture.get() });
+		gpuScene.pFire = std::make_unique<Mesh>(device, scene.fireVertices, scene.fireIndices, true, MeshTextures{ gpuScene.pFireTexture.get() });
+	}
+
+	void CreateSphere(int rings, int segments, float radius, std::vector<Vertex_In>& vertices, std::vector<uint32_t>& indices)
+	{
+		auto makeVertex = [&](int ring, int segment)
+			{
+				const float theta = PI * ring / rings;
+				const float phi = PI_2 * segment / segments;
+				const Vector3 normal{ sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi) };
+				return Vertex_In{ normal * radius, { float(segment) / segments, float(ring) / rings }, normal, {} };
+			};
+
+		vertices.clear();
+		indices.clear();
+		for (int ring{ 0 }; ring < rings; ++ring)
+		{
+			for (int segment{ 0 }; segment < segments; ++segment)
+			{
+				const Vertex_In quad[4]{
+					makeVertex(ring, segment), makeVertex(ring, segment + 1),
+					makeVertex(ring + 1, segment), makeVertex(ring + 1, segment + 1) };
+
+				for (const int corner : { 0, 1, 2, 1, 3, 2 })
+				{
+					indices.push_back(static_cast<uint32_t>(vertices.size()));
+					vertices.push_back(quad[corner]);
+				}
+			}
+		}
+	}
+
+	void AppendQuad(const Vector3& center, const Vector3& right, const Vector3& up, std::vector<Vertex_In>& vertices, std::vector<uint32_t>& indices)
+	{
+		const Vector3 normal = Vector3::Cross(up, right).Normalized();
+		const Vector3 tangent = right.Normalized();
+		const uint32_t first = static_cast<uint32_t>(vertices.size());
+
+		vertices.push_back({ center - right + up, { 0.f, 0.f }, normal, tangent });
+		vertices.push_back({ center + right + up, { 1.f, 0.f }, normal, tangent });
+		vertices.push_back({ center + right - up, { 1.f, 1.f }, normal, tangent });
+		vertices.push_back({ center - right - up, { 0.f, 1.f }, normal, tangent });
+
+		for (const uint32_t corner : { 0u, 1u, 2u, 0u, 2u, 3u })
+			indices.push_back(first + corner);
+	}
+
+	void AppendBox(const Vector3& center, const Vector3& extents, std::vector<Vector3>& positions, std::vector<uint32_t>& indices)
+	{
+		// Per face: outward normal, and right/up so that the face is clockwise seen from outside
+		const Vector3 faces[6][3]{
+			{ -Vector3::UnitZ, Vector3::UnitX, Vector3::UnitY },
+			{ Vector3::UnitZ, -Vector3::UnitX, Vector3::UnitY },
+			{ Vector3::UnitX, Vector3::UnitZ, Vector3::UnitY },
+			{ -Vector3::UnitX, -Vector3::UnitZ, Vector3::UnitY },
+			{ Vector3::UnitY, Vector3::UnitX, Vector3::UnitZ },
+			{ -Vector3::UnitY, Vector3::UnitX, -Vector3::UnitZ } };
+
+		auto scale = [&](const Vector3& axis) { return Vector3{ axis.x * extents.x, axis.y * extents.y, axis.z * extents.z }; };
+		for (const auto& [normal, right, up] : faces)
+		{
+			const Vector3 faceCenter = center + scale(normal);
+			const Vector3 faceRight = scale(right);
+			const Vector3 faceUp = scale(up);
+			const uint32_t first = static_cast<uint32_t>(positions.size());
+
+			positions.push_back(faceCenter - faceRight + faceUp);
+			positions.push_back(faceCenter + faceRight + faceUp);
+			positions.push_back(faceCenter + faceRight - faceUp);
+			positions.push_back(faceCenter - faceRight - faceUp);
+
+			for (const uint32_t corner : { 0u, 1u, 2u, 0u, 2u, 3u })
+				indices.push_back(first + corner);
+		}
+	}
+}
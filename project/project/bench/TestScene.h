@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Vertex.h"
+#include "Mesh.h"
+#include "SoftwareRenderer.h"
+#include "Texture.h"
+
+namespace dae
+{
+	// Stand-in for the vehicle + fireFX scene: the .obj files are not part of the repository,
+	// so the meshes and textures are generated with comparable triangle counts and texture sizes
+	struct TestScene
+	{
+		std::vector<Vertex_In> vehicleVertices{};
+		std::vector<uint32_t> vehicleIndices{};
+		std::vector<Vertex_In> fireVertices{};
+		std::vector<uint32_t> fireIndices{};
+
+		std::unique_ptr<SoftwareTexture> pDiffuseTexture{};
+		std::unique_ptr<SoftwareTexture> pNormalTexture{};
+		std::unique_ptr<SoftwareTexture> pSpecularTexture{};
+		std::unique_ptr<SoftwareTexture> pGlossinessTexture{};
+		std::unique_ptr<SoftwareTexture> pFireTexture{};
+
+		SoftwareMesh GetVehicleMesh() const;
+		SoftwareMesh GetFireMesh() const;
+	};
+
+	void CreateTestScene(TestScene& scene);
+
+	// The TestScene's textures and meshes on a render device, what the Renderer creates without reading the effect/texture files.
+	// Meshes are destroyed before the textures they use
+	struct GpuTestScene
+	{
+		std::unique_ptr<Texture> pDiffuseTexture{};
+		std::unique_ptr<Texture> pNormalTexture{};
+		std::unique_ptr<Texture> pSpecularTexture{};
+		std::unique_ptr<Texture> pGlossinessTexture{};
+		std::unique_ptr<Texture> pFireTexture{};
+
+		std::unique_ptr<Mesh> pVehicle{};
+		std::unique_ptr<Mesh> pFire{};
+
+		// Gives every resource back to the device, e.g. before checking for leaks
+		void Release();
+	};
+
+	void CreateGpuTestScene(const TestScene& scene, IRenderDevice& device, GpuTestScene& gpuScene);
+
+	// Unindexed UV sphere, laid out like ParseOBJ output (3 unique vertices per face), tangents left empty
+	void CreateSphere(int rings, int segments, float radius, std::vector<Vertex_In>& vertices, std::vector<uint32_t>& indices);
+	// Appends a two triangle quad, clockwise when seen from -normal (the D3D front face for a camera looking down +z)
+	void AppendQuad(const Vector3& center, const Vector3& right, const Vector3& up, std::vector<Vertex_In>& vertices, std::vector<uint32_t>& indices);
+	// Appends the 12 triangles of a box, front faces pointing out
+	void AppendBox(const Vector3& center, const Vector3& extents, std::vector<Vector3>& positions, std::vector<uint32_t>& indices);
+}
@@ -0,0 +1,175 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "SoftwareTexture.h"
+
+namespace dae
+{
+	template<typename Function>
+	static std::vector<uint32_t> CreateTexels(int width, int height, Function&& texel)
+	{
+		std::vector<uint32_t> texels(size_t(width) * height);
+		for (int y{ 0 }; y < height; ++y)
+			for (int x{ 0 }; x < width; ++x)
+				texels[size_t(y) * width + x] = texel(x, y);
+		return texels;
+	}
+
+	static bool AreEqual(const Vector4& a, const Vector4& b, float epsilon)
+	{
+		return std::abs(a.x - b.x) <= epsilon && std::abs(a.y - b.y) <= epsilon && std::abs(a.z - b.z) <= epsilon && std::abs(a.w - b.w) <= epsilon;
+	}
+
+	void RunTextureBenchmarks()
+	{
+		std::mt19937 rng{ 36 };
+		std::uniform_int_distribution<uint32_t> texelDist{};
+		std::uniform_real_distribution<float> uvDist{ -2.f, 3.f };
+		std::uniform_real_distribution<float> derivativeDist{ -0.05f, 0.05f };
+		constexpr FilteringMethod filteringMethods[]{ FilteringMethod::Point, FilteringMethod::Linear, FilteringMethod::Anisotropic };
+
+		// Layouts: Morton only moves texels, every sample matches the row major texture bit for bit
+		// ------
+		{
+			const std::vector<uint32_t> texels = CreateTexels(256, 128, [&](int, int) { return texelDist(rng); });
+			const SoftwareTexture linear{ 256, 128, texels };
+			const SoftwareTexture morton{ 256, 128, texels, SoftwareTexture::Layout::Morton };
+			Bench::Check(morton.GetLayout() == SoftwareTexture::Layout::Morton && linear.GetLevelCount() == 9 && morton.GetLevelCount() == 9,
+				"SoftwareTexture builds 9 levels for 256x128 in either layout");
+
+			bool isSame{ true };
+			for (int level{ 0 }; level < linear.GetLevelCount(); ++level)
+				for (int y{ 0 }; y < linear.GetHeight(level); ++y)
+					for (int x{ 0 }; x < linear.GetWidth(level); ++x)
+						isSame &= linear.GetTexel(level, x, y) == morton.GetTexel(level, x, y);
+			for (int i{ 0 }; i < 20'000; ++i)
+			{
+				const Vector2 uv{ uvDist(rng), uvDist(rng) };
+				const Vector2 ddx{ derivativeDist(rng), derivativeDist(rng) };
+				const Vector2 ddy{ derivativeDist(rng), derivativeDist(rng) };
+				for (const FilteringMethod filteringMethod : filteringMethods)
+					isSame &= AreEqual(linear.Sample(uv, ddx, ddy, filteringMethod), morton.Sample(uv, ddx, ddy, filteringMethod), 0.f);
+			}
+			Bench::Check(isSame, "SoftwareTexture Morton layout samples like the row major layout");
+
+			// Level 1 is the rounded average of 2x2 level 0 texels
+			bool isBoxFiltered{ true };
+			for (int y{ 0 }; y < linear.GetHeight(1); ++y)
+			{
+				for (int x{ 0 }; x < linear.GetWidth(1); ++x)
+				{
+					const uint32_t texel = linear.GetTexel(1, x, y);
+					for (int shift{ 0 }; shift < 32; shift += 8)
+					{
+						uint32_t sum{};
+						for (const auto& [dx, dy] : { std::pair{ 0, 0 }, std::pair{ 1, 0 }, std::pair{ 0, 1 }, std::pair{ 1, 1 } })
+							sum += (linear.GetTexel(0, 2 * x + dx, 2 * y + dy) >> shift) & 0xFF;
+						isBoxFiltered &= ((texel >> shift) & 0xFF) == (sum + 2) / 4;
+					}
+				}
+			}
+			Bench::Check(isBoxFiltered && linear.GetWidth(8) == 1 && linear.GetHeight(8) == 1, "SoftwareTexture mips are box filtered down to 1x1");
+
+			// Texel centers point sample exactly, also a whole number of wraps away
+			bool isExact{ true };
+			for (int i{ 0 }; i < 1'000; ++i)
+			{
+				const int x = i * 37 % 256, y = i * 11 % 128;
+				const Vector2 uv{ (x + 0.5f) / 256.f, (y + 0.5f) / 128.f };
+				const uint32_t texel = linear.GetTexel(0, x, y);
+				const Vector4 expected{ float(texel & 0xFF) / 255.f, float((texel >> 8) & 0xFF) / 255.f, float((texel >> 16) & 0xFF) / 255.f, float(texel >> 24) / 255.f };
+				isExact &= AreEqual(linear.SamplePoint(uv), expected, 1e-6f) && AreEqual(linear.SampleLinear(uv), expected, 1e-6f);
+				isExact &= AreEqual(linear.SamplePoint(uv + Vector2{ 2.f, -3.f }), expected, 1e-6f);
+			}
+			Bench::Check(isExact, "SoftwareTexture point and bilinear samples hit texel centers exactly, with wrapping");
+
+			// Non power of two sizes keep the row major layout
+			const SoftwareTexture odd{ 5, 3, std::vector<uint32_t>(15, 0xFF00FF00u), SoftwareTexture::Layout::Morton };
+			Bench::Check(odd.GetLayout() == SoftwareTexture::Layout::Linear && odd.GetLevelCount() == 3 && odd.GetTexel(2, 0, 0) == 0xFF00FF00u,
+				"SoftwareTexture falls back to row major for 5x3");
+		}
+
+		// Filters against closed form results
+		// ------
+		{
+			// Red ramps with x, so bilinear is linear in u between texel centers
+			const SoftwareTexture ramp{ 256, 256, CreateTexels(256, 256, [](int x, int) { return uint32_t(x) | 0xFF000000u; }) };
+			float maxError{};
+			for (int i{ 0 }; i < 1'000; ++i)
+			{
+				const float u = std::uniform_real_distribution<float>{ 0.5f / 256.f, 255.5f / 256.f }(rng);
+				maxError = std::max(maxError, std::abs(ramp.SampleLinear({ u, 0.3f }).x - (u * 256.f - 0.5f) / 255.f));
+			}
+			Bench::Check(maxError <= 1e-4f, "SoftwareTexture bilinear interpolates a ramp linearly");
+
+			// Lod 2 is a footprint of 4 texels, fractional lods blend the two levels
+			const float lod = ramp.ComputeLod({ 4.f / 256.f, 0.f }, { 0.f, 1.f / 256.f });
+			const Vector2 uv{ 0.37f, 0.61f };
+			const Vector4 blended = ramp.SampleLinear(uv, 2) * 0.75f + ramp.SampleLinear(uv, 3) * 0.25f;
+			Bench::Check(std::abs(lod - 2.f) <= 1e-5f && AreEqual(ramp.SampleTrilinear(uv, 2.f), ramp.SampleLinear(uv, 2), 0.f)
+				&& AreEqual(ramp.SampleTrilinear(uv, 2.25f), blended, 1e-6f) && AreEqual(ramp.SampleTrilinear(uv, -1.f), ramp.SampleLinear(uv, 0), 0.f)
+				&& AreEqual(ramp.Sample(uv, { 4.f / 256.f, 0.f }, { 0.f, 0.f }, FilteringMethod::Point), ramp.SamplePoint(uv, 2), 0.f),
+				"SoftwareTexture trilinear and mip point pick the levels of the footprint");
+
+			// One texel high stripes seen at a grazing angle: 8 texels across u per pixel, 1 across v.
+			// Trilinear goes to lod 3 and greys the stripes out, anisotropic keeps them
+			const SoftwareTexture stripes{ 256, 256, CreateTexels(256, 256, [](int, int y) { return (y % 2) ? 0xFFFFFFFFu : 0xFF000000u; }) };
+			const Vector2 ddx{ 8.f / 256.f, 0.f }, ddy{ 0.f, 1.f / 256.f };
+			const Vector2 white{ 0.3f, 101.5f / 256.f };
+			Bench::Check(std::abs(stripes.Sample(white, ddx, ddy, FilteringMethod::Linear).x - 0.5f) <= 0.1f
+				&& std::abs(stripes.Sample(white, ddx, ddy, FilteringMethod::Anisotropic).x - 1.f) <= 1e-5f,
+				"SoftwareTexture anisotropic keeps detail along the short axis that trilinear blurs");
+
+			// Isotropic footprints are a single trilinear tap
+			bool isTrilinear{ true };
+			for (int i{ 0 }; i < 1'000; ++i)
+			{
+				const Vector2 sampleUv{ uvDist(rng), uvDist(rng) };
+				const float scale = std::uniform_real_distribution<float>{ 0.1f, 40.f }(rng) / 256.f;
+				isTrilinear &= AreEqual(ramp.SampleAnisotropic(sampleUv, { scale, 0.f }, { 0.f, scale }), ramp.SampleTrilinear(sampleUv, std::log2(scale * 256.f)), 1e-6f);
+			}
+			Bench::Check(isTrilinear, "SoftwareTexture anisotropic equals trilinear for isotropic footprints");
+		}
+
+		// Samples per second (items = samples) for a rotated, minified plane walked like a rasterizer, 8 pixels per footprint.
+		// Footprint: 1.5 texels across x, 6 along y, so anisotropic takes 4 taps
+		// ------
+		{
+			constexpr int size{ 1024 };
+			constexpr int screenSize{ 256 };
+			constexpr int spanWidth{ 8 };
+			const std::vector<uint32_t> texels = CreateTexels(size, size, [&](int, int) { return texelDist(rng); });
+
+			const float angle = 0.6f;
+			const Vector2 ddx = Vector2{ cosf(angle), sinf(angle) } * (1.5f / size);
+			const Vector2 ddy = Vector2{ -sinf(angle), cosf(angle) } * (6.f / size);
+			std::vector<Vector2> uvs(size_t(screenSize) * screenSize);
+			for (int y{ 0 }; y < screenSize; ++y)
+				for (int x{ 0 }; x < screenSize; ++x)
+					uvs[size_t(y) * screenSize + x] = ddx * float(x) + ddy * float(y);
+			std::vector<Vector4> output(uvs.size());
+
+			for (const SoftwareTexture::Layout layout : { SoftwareTexture::Layout::Linear, SoftwareTexture::Layout::Morton })
+			{
+				const SoftwareTexture texture{ size, size, texels, layout };
+				for (const FilteringMethod filteringMethod : filteringMethods)
+				{
+					const char* pFilterName = filteringMethod == FilteringMethod::Point ? "Point" : filteringMethod == FilteringMethod::Linear ? "Linear" : "Anisotropic";
+					const char* pLayoutName = layout == SoftwareTexture::Layout::Linear ? "RowMajor" : "Morton";
+					Bench::Run(std::string{ "Texture/" } + pFilterName + "/" + pLayoutName, uvs.size(), [&]
+						{
+							for (size_t i{ 0 }; i < uvs.size(); i += spanWidth)
+								texture.Sample(std::span{ uvs }.subspan(i, spanWidth), ddx, ddy, filteringMethod, std::span{ output }.subspan(i, spanWidth));
+							Bench::DoNotOptimize(output.back());
+						});
+				}
+			}
+		}
+	}
+}
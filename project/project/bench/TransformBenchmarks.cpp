@@ -0,0 +1,141 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "Math.h"
+#include "TransformStore.h"
+
+namespace dae
+{
+	using EntityId = TransformStore::EntityId;
+
+	static constexpr uint32_t s_NumTransforms{ 1'000'000 };
+
+	// numRoots roots, then entities parented to any earlier one (a random tree, a few dozen levels deep at 1M)
+	static void CreateHierarchy(TransformStore& store, uint32_t count, uint32_t numRoots)
+	{
+		std::mt19937 rng{ 44 };
+		std::uniform_real_distribution<float> positionDist{ -50.f, 50.f };
+		std::uniform_real_distribution<float> angleDist{ -PI, PI };
+
+		store.Clear();
+		store.Reserve(count);
+		for (uint32_t root{ 0 }; root < numRoots; ++root)
+			store.Create(TransformStore::InvalidEntity, { positionDist(rng), 0.f, positionDist(rng) }, Quaternion::CreateRotationY(angleDist(rng)));
+		while (store.GetCount() < count)
+		{
+			const EntityId parent = std::uniform_int_distribution<EntityId>{ 0, store.GetCount() - 1 }(rng);
+			store.Create(parent, { positionDist(rng) * 0.05f, 0.5f, positionDist(rng) * 0.05f }, Quaternion::CreateRotation(angleDist(rng), angleDist(rng), 0.f), { 1.f, 1.5f, 1.f });
+		}
+	}
+
+	// What the store has to match: the same product with the Matrix helpers, parents first
+	static Matrix ComputeReference(const TransformStore& store, EntityId entity)
+	{
+		const Matrix local = Matrix::CreateScale(store.GetScale(entity)) * Matrix::CreateRotation(store.GetRotation(entity)) * Matrix::CreateTranslation(store.GetPosition(entity));
+		const EntityId parent = store.GetParent(entity);
+		return parent == TransformStore::InvalidEntity ? local : local * ComputeReference(store, parent);
+	}
+
+	void RunTransformBenchmarks()
+	{
+		TransformStore store{};
+
+		// Same world matrices as composing them with Matrix, and only dirty branches are recomputed
+		// ------
+		{
+			CreateHierarchy(store, 2000, 20);
+			store.Update(1);
+
+			float maxError{};
+			for (EntityId entity{ 0 }; entity < store.GetCount(); ++entity)
+			{
+				const Matrix reference = ComputeReference(store, entity);
+				for (int r{ 0 }; r < 4; ++r)
+					for (int c{ 0 }; c < 4; ++c)
+						maxError = std::max(maxError, std::abs(reference[r][c] - store.GetWorldMatrix(entity)[r][c]));
+			}
+			Bench::Check(maxError < 1e-3f, "TransformStore world matrices match Matrix products");
+
+			bool isExpected = store.Update(1) == 0;
+			store.SetPosition(0, { 1.f, 2.f, 3.f });
+			uint32_t numInBranch{};
+			for (EntityId entity{ 0 }; entity < store.GetCount(); ++entity)
+			{
+				EntityId root = entity;
+				while (store.GetParent(root) != TransformStore::InvalidEntity)
+					root = store.GetParent(root);
+				numInBranch += root == 0;
+			}
+			isExpected &= store.Update(1) == numInBranch && store.HasWorldChanged(0) && !store.HasWorldChanged(1);
+			Bench::Check(isExpected, "TransformStore only recomputes dirty entities and their descendants");
+		}
+
+		// The depths are split over threads, the result may not depend on how
+		// ------
+		{
+			CreateHierarchy(store, 200'000, 1000);
+			store.Update(1);
+			const std::vector<Matrix> single(store.GetWorldMatrices().begin(), store.GetWorldMatrices().end());
+			CreateHierarchy(store, 200'000, 1000);
+			store.Update(8);
+			Bench::Check(std::memcmp(single.data(), store.GetWorldMatrices().data(), single.size() * sizeof(Matrix)) == 0,
+				"TransformStore update on 8 threads matches one thread");
+		}
+
+		// 1M transforms a frame (items = transforms), on one thread and on all of them:
+		// a flat store where every rotation is written, a hierarchy where only the roots move
+		// (the rest follows through their parents) and a flat store with a random tenth moved
+		// ------
+		const uint32_t numHardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+		std::vector<EntityId> moved(s_NumTransforms / 10);
+		{
+			std::mt19937 rng{ 45 };
+			std::uniform_int_distribution<EntityId> entityDist{ 0, s_NumTransforms - 1 };
+			for (EntityId& entity : moved)
+				entity = entityDist(rng);
+		}
+
+		for (const uint32_t numThreads : { 1u, numHardwareThreads })
+		{
+			const std::string suffix = "/" + std::to_string(numThreads) + "t";
+
+			CreateHierarchy(store, s_NumTransforms, s_NumTransforms);
+			float angle{};
+			Bench::Run("Transform/Update/1M/Flat" + suffix, s_NumTransforms, [&]
+				{
+					angle += 0.01f;
+					const Quaternion rotation = Quaternion::CreateRotationY(angle);
+					for (EntityId entity{ 0 }; entity < s_NumTransforms; ++entity)
+						store.SetRotation(entity, rotation);
+					Bench::DoNotOptimize(store.Update(numThreads));
+				});
+
+			Bench::Run("Transform/Update/1M/TenthMoved" + suffix, s_NumTransforms, [&]
+				{
+					angle += 0.01f;
+					for (const EntityId entity : moved)
+						store.SetPosition(entity, { angle, 0.f, 0.f });
+					Bench::DoNotOptimize(store.Update(numThreads));
+				});
+
+			CreateHierarchy(store, s_NumTransforms, 1000);
+			Bench::Run("Transform/Update/1M/Hierarchy" + suffix, s_NumTransforms, [&]
+				{
+					angle += 0.01f;
+					const Quaternion rotation = Quaternion::CreateRotationY(angle);
+					for (EntityId root{ 0 }; root < 1000; ++root)
+						store.SetRotation(root, rotation);
+					Bench::DoNotOptimize(store.Update(numThreads));
+				});
+
+			if (numHardwareThreads == 1)
+				break;
+		}
+	}
+}
@@ -0,0 +1,143 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "Math.h"
+#include "SoftwareRenderer.h"
+#include "TestScene.h"
+
+namespace dae
+{
+	using TransparencyMode = SoftwareRenderer::TransparencyMode;
+
+	static constexpr ColorRGB s_ClearColor{ 0.39f, 0.59f, 0.93f };
+
+	static Matrix CreateViewProjection()
+	{
+		const float fov = tanf((45.f * TO_RADIANS) / 2.f);
+		return Matrix::Inverse(Matrix::CreateLookAtLH({}, Vector3::UnitZ, Vector3::UnitY)) * Matrix::CreatePerspectiveFovLH(fov, 640.f / 480.f, 0.1f, 100.f);
+	}
+
+	// numQuads fire quads at random positions and angles in front of and around the vehicle, overlapping each other
+	static void CreateFireQuads(int numQuads, std::vector<Vertex_In>& vertices, std::vector<uint32_t>& indices)
+	{
+		std::mt19937 rng{ 40 };
+		std::uniform_real_distribution<float> positionDist{ -10.f, 10.f };
+		std::uniform_real_distribution<float> angleDist{ 0.f, PI };
+		vertices.clear();
+		indices.clear();
+		for (int i{ 0 }; i < numQuads; ++i)
+		{
+			const float angle = angleDist(rng);
+			const Vector3 center{ positionDist(rng), positionDist(rng) * 0.5f, -14.f + positionDist(rng) };
+			AppendQuad(center, { cosf(angle) * 6.f, 0.f, sinf(angle) * 6.f }, { 0.f, 8.f, 0.f }, vertices, indices);
+		}
+	}
+
+	static void RenderFireScene(SoftwareRenderer& renderer, const TestScene& scene, const SoftwareMesh& fire)
+	{
+		const Matrix world = Matrix::CreateTranslation(0.f, 0.f, 50.f);
+		const Matrix worldViewProjection = world * CreateViewProjection();
+
+		renderer.BeginFrame(s_ClearColor);
+		renderer.Draw(scene.GetVehicleMesh(), world, worldViewProjection, {}, FilteringMethod::Linear);
+		renderer.Draw(fire, world, worldViewProjection, {}, FilteringMethod::Linear);
+		renderer.EndFrame();
+	}
+
+	static float GetMaxDifference(const std::vector<ColorRGB>& a, const std::vector<ColorRGB>& b)
+	{
+		float maxDifference{};
+		for (size_t i{ 0 }; i < a.size(); ++i)
+			maxDifference = std::max({ maxDifference, std::abs(a[i].r - b[i].r), std::abs(a[i].g - b[i].g), std::abs(a[i].b - b[i].b) });
+		return maxDifference;
+	}
+
+	void RunTransparencyBenchmarks()
+	{
+		TestScene scene{};
+		CreateTestScene(scene);
+
+		std::vector<Vertex_In> vertices{};
+		std::vector<uint32_t> indices{};
+
+		// Ordered blending keeps submission order per tile: any thread count gives the single thread image
+		// ------
+		{
+			CreateFireQuads(256, vertices, indices);
+			const SoftwareMesh fire{ vertices, indices, true, scene.pFireTexture.get() };
+			SoftwareRenderer single{ 640, 480, 1 };
+			SoftwareRenderer threaded{ 640, 480, 8 };
+			RenderFireScene(single, scene, fire);
+			RenderFireScene(threaded, scene, fire);
+			Bench::Check(std::memcmp(single.GetColorBuffer().data(), threaded.GetColorBuffer().data(), single.GetColorBuffer().size() * sizeof(ColorRGB)) == 0,
+				"SoftwareRenderer ordered blending of overlapping quads matches single thread");
+		}
+
+		// Weighted blended OIT is exact for layers of one color, and does not depend on the submission order
+		// ------
+		{
+			const SoftwareTexture halfOrange{ 1, 1, { 0x80'10'80'F0u } };
+			vertices.clear();
+			indices.clear();
+			for (int layer{ 0 }; layer < 6; ++layer)
+				AppendQuad({ 0.f, 0.f, 0.5f - 0.05f * layer }, { 2.f, 0.f, 0.f }, { 0.f, 2.f, 0.f }, vertices, indices);
+
+			SoftwareRenderer ordered{ 64, 48, 1 };
+			SoftwareRenderer weighted{ 64, 48, 1 };
+			weighted.SetTransparencyMode(TransparencyMode::WeightedBlended);
+			for (SoftwareRenderer* pRenderer : { &ordered, &weighted })
+			{
+				pRenderer->BeginFrame(s_ClearColor);
+				pRenderer->Draw({ vertices, indices, true, &halfOrange }, {}, {}, {}, FilteringMethod::Point);
+				pRenderer->EndFrame();
+			}
+			Bench::Check(GetMaxDifference(ordered.GetColorBuffer(), weighted.GetColorBuffer()) < 1e-4f, "SoftwareRenderer weighted blended OIT matches ordered blending for one color");
+
+			CreateFireQuads(64, vertices, indices);
+			std::vector<uint32_t> reversed(indices.size());
+			for (size_t i{ 0 }; i < indices.size(); i += 3)
+				std::copy(indices.end() - i - 3, indices.end() - i, reversed.begin() + i);
+
+			SoftwareRenderer forwards{ 640, 480, 1 };
+			SoftwareRenderer backwards{ 640, 480, 1 };
+			forwards.SetTransparencyMode(TransparencyMode::WeightedBlended);
+			backwards.SetTransparencyMode(TransparencyMode::WeightedBlended);
+			RenderFireScene(forwards, scene, { vertices, indices, true, scene.pFireTexture.get() });
+			RenderFireScene(backwards, scene, { vertices, reversed, true, scene.pFireTexture.get() });
+			Bench::Check(GetMaxDifference(forwards.GetColorBuffer(), backwards.GetColorBuffer()) < 1e-4f, "SoftwareRenderer weighted blended OIT does not depend on the order");
+		}
+
+		// Vehicle plus numQuads overlapping fire quads (items = frames), on one thread and on all of them
+		// ------
+		const uint32_t numHardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+		for (const int numQuads : { 64, 256 })
+		{
+			CreateFireQuads(numQuads, vertices, indices);
+			const SoftwareMesh fire{ vertices, indices, true, scene.pFireTexture.get() };
+			for (const TransparencyMode transparencyMode : { TransparencyMode::Ordered, TransparencyMode::WeightedBlended })
+			{
+				for (const uint32_t numThreads : { 1u, numHardwareThreads })
+				{
+					SoftwareRenderer renderer{ 640, 480, numThreads };
+					renderer.SetTransparencyMode(transparencyMode);
+					const std::string name = std::string{ "Transparency/" } + (transparencyMode == TransparencyMode::Ordered ? "Ordered/" : "WeightedBlended/")
+						+ std::to_string(numQuads) + "Quads/" + std::to_string(numThreads) + "t";
+					const Bench::Result result = Bench::Run(name, 1, [&] { RenderFireScene(renderer, scene, fire); });
+					if (result.items > 0)
+						std::printf("  %.2f shaded fragments per pixel, raster %.2f ms\n",
+							double(renderer.GetFrameStats().numPixelsShaded) / (640.0 * 480.0), renderer.GetFrameStats().rasterMs);
+
+					if (numHardwareThreads == 1)
+						break;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,217 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Bounds.h"
+#include "Math.h"
+#include "TransparencySorter.h"
+
+namespace dae
+{
+	// Camera turns per frame at 60 fps: drifting at 1 degree a second, panning at 15
+	static constexpr float s_DriftYawPerFrame{ (1.f / 60.f) * TO_RADIANS };
+	static constexpr float s_PanYawPerFrame{ .25f * TO_RADIANS };
+
+	// Boxes spread over a 1000 unit cube in front of the camera
+	static std::vector<AABB> CreateObjects(uint32_t count, uint32_t seed)
+	{
+		std::mt19937 rng{ seed };
+		std::uniform_real_distribution<float> positionDist{ -500.f, 500.f };
+		std::uniform_real_distribution<float> sizeDist{ .5f, 5.f };
+
+		std::vector<AABB> objects(count);
+		for (AABB& object : objects)
+			object = { { positionDist(rng), positionDist(rng), positionDist(rng) + 600.f }, { sizeDist(rng), sizeDist(rng), sizeDist(rng) } };
+		return objects;
+	}
+
+	static Matrix CreateViewMatrix(float yaw)
+	{
+		const Vector3 forward{ std::sin(yaw), 0.f, std::cos(yaw) };
+		return Matrix::Inverse(Matrix::CreateLookAtLH({ 0.f, 0.f, -100.f }, forward, { 0.f, 1.f, 0.f }));
+	}
+
+	// Every object once, farthest first
+	static bool IsBackToFront(std::span<const uint32_t> order, std::span<const AABB> objects, const Matrix& viewMatrix)
+	{
+		if (order.size() != objects.size())
+			return false;
+
+		std::vector<bool> isSeen(objects.size());
+		float previousDepth{ INFINITY };
+		for (const uint32_t index : order)
+		{
+			if (index >= objects.size() || isSeen[index])
+				return false;
+			isSeen[index] = true;
+
+			const float depth = viewMatrix.TransformPoint(objects[index].center).z;
+			if (depth > previousDepth)
+				return false;
+			previousDepth = depth;
+		}
+		return true;
+	}
+
+	static std::string GetCountName(uint32_t count)
+	{
+		return count >= 1'000'000 ? std::to_string(count / 1'000'000) + "M" : std::to_string(count / 1'000) + "k";
+	}
+
+	void RunTransparencySortBenchmarks()
+	{
+		using SortItem = TransparencySorter::SortItem;
+		const auto isKeyLess = [](const SortItem& a, const SortItem& b) { return a.key < b.key; };
+
+		// Keys order like the depths they come from, reversed, over the whole float range
+		// ------
+		{
+			const float depths[]{ -INFINITY, -1e30f, -5.f, -1.f, -1e-30f, -0.f, 1e-30f, 1.f, 5.f, 1e30f, INFINITY };
+			bool isReversed{ true };
+			for (size_t i{ 1 }; i < std::size(depths); ++i)
+				isReversed &= TransparencySorter::MakeKey(depths[i - 1]) > TransparencySorter::MakeKey(depths[i]);
+			Bench::Check(isReversed, "TransparencySorter::MakeKey orders larger depths first");
+		}
+
+		// The radix sort is stable: same order as std::stable_sort on the key. Depths on a coarse grid, so many tie
+		// ------
+		{
+			std::mt19937 rng{ 7 };
+			std::uniform_int_distribution<int> depthDist{ -2000, 2000 };
+			std::vector<SortItem> items(100'000);
+			for (uint32_t i{ 0 }; i < items.size(); ++i)
+				items[i] = { TransparencySorter::MakeKey(float(depthDist(rng)) * .25f), i };
+
+			std::vector<SortItem> expected = items;
+			std::stable_sort(expected.begin(), expected.end(), isKeyLess);
+			std::vector<SortItem> scratch{};
+			TransparencySorter::RadixSort(items, scratch);
+
+			bool isSame{ true };
+			for (size_t i{ 0 }; i < items.size(); ++i)
+				isSame &= items[i].key == expected[i].key && items[i].index == expected[i].index;
+			Bench::Check(isSame, "TransparencySorter::RadixSort matches std::stable_sort");
+		}
+
+		// First sort, a small camera turn (insertion sort), a turn around (too many moves: radix sort again)
+		// ------
+		{
+			const std::vector<AABB> objects = CreateObjects(10'000, 11);
+			TransparencySorter sorter{};
+
+			Matrix viewMatrix = CreateViewMatrix(0.f);
+			Bench::Check(IsBackToFront(sorter.Sort(objects, viewMatrix), objects, viewMatrix) && !sorter.WasIncremental(),
+				"TransparencySorter sorts back to front");
+
+			// Same as sorting last frame's order by the new keys, equal depths included
+			std::vector<SortItem> expected{};
+			viewMatrix = CreateViewMatrix(s_DriftYawPerFrame);
+			for (const uint32_t index : sorter.GetOrder())
+				expected.push_back({ TransparencySorter::MakeKey(viewMatrix.TransformPoint(objects[index].center).z), index });
+			std::stable_sort(expected.begin(), expected.end(), isKeyLess);
+
+			const std::span<const uint32_t> order = sorter.Sort(objects, viewMatrix);
+			bool isStable{ true };
+			for (size_t i{ 0 }; i < order.size(); ++i)
+				isStable &= order[i] == expected[i].index;
+			Bench::Check(IsBackToFront(order, objects, viewMatrix) && isStable && sorter.WasIncremental(),
+				"TransparencySorter fixes up last frame's order after a small camera turn");
+
+			viewMatrix = CreateViewMatrix(PI);
+			Bench::Check(IsBackToFront(sorter.Sort(objects, viewMatrix), objects, viewMatrix) && !sorter.WasIncremental() && sorter.GetStats().numFallbacks == 1,
+				"TransparencySorter falls back to the radix sort when the order changed a lot");
+
+			// Waiting to retry the insertion sort: still this frame's depths, turned back around
+			viewMatrix = CreateViewMatrix(0.f);
+			Bench::Check(IsBackToFront(sorter.Sort(objects, viewMatrix), objects, viewMatrix) && !sorter.WasIncremental(),
+				"TransparencySorter sorts by the new depths while waiting to retry");
+
+			// Steady state frames, both paths
+			const uint64_t numAllocations = Bench::GetNumHeapAllocations();
+			for (int frame{ 0 }; frame < 10; ++frame)
+			{
+				if (frame == 5)
+					sorter.Invalidate();
+				sorter.Sort(objects, CreateViewMatrix(PI + frame * s_DriftYawPerFrame));
+			}
+			const bool isAllocationFree = Bench::GetNumHeapAllocations() == numAllocations;
+			Bench::Check(isAllocationFree, "TransparencySorter doesn't allocate in steady state");
+		}
+
+		// Instances: local bounds placed by world matrices sort like the placed bounds
+		// ------
+		{
+			const AABB localBounds{ { 0.f, 2.f, -3.f }, { 1.f, 2.f, 1.f } };
+			std::mt19937 rng{ 13 };
+			std::uniform_real_distribution<float> positionDist{ -200.f, 200.f };
+			std::uniform_real_distribution<float> angleDist{ -PI, PI };
+
+			std::vector<Matrix> worldMatrices{};
+			std::vector<AABB> worldBounds{};
+			for (int i{ 0 }; i < 5'000; ++i)
+			{
+				worldMatrices.push_back(Matrix::CreateRotationY(angleDist(rng)) * Matrix::CreateTranslation(positionDist(rng), 0.f, positionDist(rng) + 300.f));
+				worldBounds.push_back(localBounds.Transform(worldMatrices.back()));
+			}
+
+			const Matrix viewMatrix = CreateViewMatrix(.3f);
+			TransparencySorter instanceSorter{};
+			TransparencySorter boundsSorter{};
+			const std::span<const uint32_t> instanceOrder = instanceSorter.Sort(localBounds, worldMatrices, viewMatrix);
+			const std::span<const uint32_t> boundsOrder = boundsSorter.Sort(worldBounds, viewMatrix);
+			Bench::Check(std::equal(instanceOrder.begin(), instanceOrder.end(), boundsOrder.begin(), boundsOrder.end()),
+				"TransparencySorter sorts instances like their world bounds");
+		}
+
+		// 1k to 1M objects (items = objects). Radix: every frame from scratch. Drift/Pan: the camera turns slowly/faster,
+		// the denser the objects the fewer turns keep last frame's order. StdSort: the same keys through std::sort
+		// ------
+		for (const uint32_t count : { 1'000u, 10'000u, 100'000u, 1'000'000u })
+		{
+			const std::vector<AABB> objects = CreateObjects(count, count);
+			const std::string countName = GetCountName(count);
+			const Matrix viewMatrix = CreateViewMatrix(0.f);
+			TransparencySorter sorter{};
+
+			Bench::Run("TransparencySort/Radix/" + countName, count, [&]
+				{
+					sorter.Invalidate();
+					Bench::DoNotOptimize(sorter.Sort(objects, viewMatrix).front());
+				});
+
+			// Every frame starts from last frame's order, prints how often that order was kept
+			const auto runTurning = [&](const char* pName, float yawPerFrame)
+				{
+					float yaw{ 0.f };
+					sorter.Invalidate();
+					const TransparencySorter::Stats statsBefore = sorter.GetStats();
+					const Bench::Result result = Bench::Run(std::string("TransparencySort/") + pName + "/" + countName, count, [&]
+						{
+							yaw += yawPerFrame;
+							Bench::DoNotOptimize(sorter.Sort(objects, CreateViewMatrix(yaw)).front());
+						});
+					if (result.items == 0)
+						return;
+					const TransparencySorter::Stats& stats = sorter.GetStats();
+					const uint32_t numInsertionSorts = stats.numInsertionSorts - statsBefore.numInsertionSorts;
+					std::printf("  %u of %u sorts kept last frame's order\n", numInsertionSorts, numInsertionSorts + stats.numRadixSorts - statsBefore.numRadixSorts);
+				};
+			runTurning("Drift", s_DriftYawPerFrame);
+			runTurning("Pan", s_PanYawPerFrame);
+
+			std::vector<SortItem> items(count);
+			Bench::Run("TransparencySort/StdSort/" + countName, count, [&]
+				{
+					for (uint32_t i{ 0 }; i < count; ++i)
+						items[i] = { TransparencySorter::MakeKey(viewMatrix.TransformPoint(objects[i].center).z), i };
+					std::sort(items.begin(), items.end(), isKeyLess);
+					Bench::DoNotOptimize(items.front());
+				});
+		}
+	}
+}
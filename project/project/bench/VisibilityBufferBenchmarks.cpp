@@ -0,0 +1,169 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include "Math.h"
+#include "SoftwareRenderer.h"
+#include "TestScene.h"
+
+namespace dae
+{
+	using ShadingMode = SoftwareRenderer::ShadingMode;
+
+	static constexpr ColorRGB s_ClearColor{ 0.39f, 0.59f, 0.93f };
+
+	static Matrix CreateViewProjection(float aspectRatio)
+	{
+		const float fov = tanf((45.f * TO_RADIANS) / 2.f);
+		return Matrix::Inverse(Matrix::CreateLookAtLH({}, Vector3::UnitZ, Vector3::UnitY)) * Matrix::CreatePerspectiveFovLH(fov, aspectRatio, 0.1f, 100.f);
+	}
+
+	static void RenderTestScene(SoftwareRenderer& renderer, const TestScene& scene, float rotation, FilteringMethod filteringMethod)
+	{
+		const Matrix world = Matrix::CreateRotationY(rotation) * Matrix::CreateTranslation(0.f, 0.f, 50.f);
+		const Matrix worldViewProjection = world * CreateViewProjection(renderer.GetWidth() / float(renderer.GetHeight()));
+
+		renderer.BeginFrame(s_ClearColor);
+		renderer.Draw(scene.GetVehicleMesh(), world, worldViewProjection, {}, filteringMethod);
+		renderer.Draw(scene.GetFireMesh(), world, worldViewProjection, {}, filteringMethod);
+		renderer.EndFrame();
+	}
+
+	// numLayers screen filling quads with the vehicle's materials, submitted back to front so every layer passes the
+	// depth test: forward shading shades each pixel numLayers times
+	static void CreateOverdrawLayers(int numLayers, std::vector<Vertex_In>& vertices, std::vector<uint32_t>& indices)
+	{
+		vertices.clear();
+		indices.clear();
+		for (int layer{ 0 }; layer < numLayers; ++layer)
+		{
+			const float z = 40.f - 30.f * layer / numLayers;
+			AppendQuad({ 0.f, 0.f, z }, { 0.7f * z, 0.05f * z, 0.f }, { -0.03f * z, 0.55f * z, 0.f }, vertices, indices);
+		}
+	}
+
+	static float GetMaxDifference(const std::vector<ColorRGB>& a, const std::vector<ColorRGB>& b)
+	{
+		float maxDifference{};
+		for (size_t i{ 0 }; i < a.size(); ++i)
+			maxDifference = std::max({ maxDifference, std::abs(a[i].r - b[i].r), std::abs(a[i].g - b[i].g), std::abs(a[i].b - b[i].b) });
+		return maxDifference;
+	}
+
+	void RunVisibilityBufferBenchmarks()
+	{
+		TestScene scene{};
+		CreateTestScene(scene);
+
+		// Same image as forward shading: identical coverage and weights, only the attribute transforms are done
+		// after interpolating instead of before (rounding differences)
+		// ------
+		{
+			SoftwareRenderer forward{ 640, 480, 1 };
+			SoftwareRenderer deferred{ 640, 480, 4 };
+			deferred.SetShadingMode(ShadingMode::VisibilityBuffer);
+			float maxDifference{};
+			bool isSameDepth{ true };
+			for (const FilteringMethod filteringMethod : { FilteringMethod::Point, FilteringMethod::Linear, FilteringMethod::Anisotropic })
+			{
+				RenderTestScene(forward, scene, 0.7f, filteringMethod);
+				RenderTestScene(deferred, scene, 0.7f, filteringMethod);
+				maxDifference = std::max(maxDifference, GetMaxDifference(forward.GetColorBuffer(), deferred.GetColorBuffer()));
+				isSameDepth &= forward.GetDepthBuffer() == deferred.GetDepthBuffer();
+			}
+			std::printf("VisibilityBuffer: largest channel difference to forward %.6f\n", maxDifference);
+			Bench::Check(isSameDepth && maxDifference < 2.f / 255.f, "SoftwareRenderer visibility buffer matches forward shading");
+
+			// Every covered pixel holds the vehicle (instance 0) or nothing: the fire is blended, it never gets an ID
+			const std::vector<SoftwareRenderer::VisibilitySample>& visibility = deferred.GetVisibilityBuffer();
+			const std::vector<float>& depth = deferred.GetDepthBuffer();
+			bool isConsistent{ true };
+			for (size_t i{ 0 }; i < visibility.size(); ++i)
+			{
+				const bool hasId = visibility[i].instanceId != SoftwareRenderer::VisibilitySample::InvalidId;
+				isConsistent &= hasId == (depth[i] < 1.f) && (!hasId || visibility[i].instanceId == 0);
+			}
+			Bench::Check(isConsistent, "SoftwareRenderer visibility buffer IDs match the depth buffer");
+		}
+
+		// Clipped triangles get their Vertex_In from the clip weights: a floor running under the camera
+		// ------
+		{
+			std::vector<Vertex_In> vertices{};
+			std::vector<uint32_t> indices{};
+			AppendQuad({ 0.f, -1.f, 0.f }, { 60.f, 0.f, 0.f }, { 0.f, 0.f, 50.f }, vertices, indices);
+			for (Vertex_In& vertex : vertices)
+				vertex.normal = Vector3::UnitY;
+
+			const SoftwareMesh floor{ vertices, indices, false, scene.pDiffuseTexture.get() };
+			SoftwareRenderer forward{ 640, 480, 1 };
+			SoftwareRenderer deferred{ 640, 480, 1 };
+			deferred.SetShadingMode(ShadingMode::VisibilityBuffer);
+			for (SoftwareRenderer* pRenderer : { &forward, &deferred })
+			{
+				pRenderer->BeginFrame(colors::Black);
+				pRenderer->Draw(floor, {}, CreateViewProjection(640.f / 480.f), {}, FilteringMethod::Linear);
+				pRenderer->EndFrame();
+			}
+			Bench::Check(deferred.GetFrameStats().numClipped == 2 && GetMaxDifference(forward.GetColorBuffer(), deferred.GetColorBuffer()) < 2.f / 255.f,
+				"SoftwareRenderer visibility buffer shades clipped triangles like forward");
+		}
+
+		// Shading cost against depth complexity (items = frames, single thread so only the shading work differs).
+		// Forward shades every layer, the visibility buffer each pixel once
+		// ------
+		std::vector<Vertex_In> vertices{};
+		std::vector<uint32_t> indices{};
+		for (const int numLayers : { 1, 2, 4, 8 })
+		{
+			CreateOverdrawLayers(numLayers, vertices, indices);
+			const SoftwareMesh layers{ vertices, indices, false,
+				scene.pDiffuseTexture.get(), scene.pNormalTexture.get(), scene.pSpecularTexture.get(), scene.pGlossinessTexture.get() };
+			const Matrix viewProjection = CreateViewProjection(640.f / 480.f);
+
+			double forwardNs{};
+			for (const ShadingMode shadingMode : { ShadingMode::Forward, ShadingMode::VisibilityBuffer })
+			{
+				SoftwareRenderer renderer{ 640, 480, 1 };
+				renderer.SetShadingMode(shadingMode);
+				const std::string name = std::string{ "VisibilityBuffer/Overdraw" } + std::to_string(numLayers)
+					+ (shadingMode == ShadingMode::Forward ? "/Forward" : "/Deferred");
+				const Bench::Result result = Bench::Run(name, 1, [&]
+					{
+						renderer.BeginFrame(s_ClearColor);
+						renderer.Draw(layers, {}, viewProjection, {}, FilteringMethod::Anisotropic);
+						renderer.EndFrame();
+					});
+				if (result.items == 0)
+					continue;
+
+				const SoftwareRenderer::FrameStats& stats = renderer.GetFrameStats();
+				std::printf("  %.2f shaded pixels per screen pixel, raster %.2f ms", double(stats.numPixelsShaded) / (640.0 * 480.0), stats.rasterMs);
+				if (shadingMode == ShadingMode::Forward)
+					forwardNs = result.nsPerItem;
+				else if (forwardNs > 0.0)
+					std::printf(", %.2fx the forward frame rate", forwardNs / result.nsPerItem);
+				std::printf("\n");
+			}
+		}
+
+		// The test scene itself: a closed mesh with back face culling has hardly any overdraw
+		// ------
+		for (const ShadingMode shadingMode : { ShadingMode::Forward, ShadingMode::VisibilityBuffer })
+		{
+			SoftwareRenderer renderer{ 640, 480, 1 };
+			renderer.SetShadingMode(shadingMode);
+			float rotation{};
+			const Bench::Result result = Bench::Run(std::string{ "VisibilityBuffer/TestScene" } + (shadingMode == ShadingMode::Forward ? "/Forward" : "/Deferred"), 1, [&]
+				{
+					RenderTestScene(renderer, scene, rotation, FilteringMethod::Anisotropic);
+					rotation += 0.01f;
+				});
+			if (result.items > 0)
+				std::printf("  %llu pixels shaded\n", static_cast<unsigned long long>(renderer.GetFrameStats().numPixelsShaded));
+		}
+	}
+}
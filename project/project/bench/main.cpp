@@ -0,0 +1,72 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace dae;
+
+static void PrintUsage()
+{
+	std::printf(
+		"Usage: GP1_DirectX_Bench [--filter <text>] [--min-time <seconds>] [--json <file>]\n"
+		"  --filter    only run benchmarks whose name contains <text>\n"
+		"  --min-time  minimum timed duration per benchmark (default 0.2)\n"
+		"  --json      also write the results to <file>\n");
+}
+
+int main(int argc, char* args[])
+{
+	Bench::Settings settings{};
+	const char* pJsonPath{ nullptr };
+
+	for (int i{ 1 }; i < argc; ++i)
+	{
+		const bool hasValue = i + 1 < argc;
+		if (std::strcmp(args[i], "--filter") == 0 && hasValue)
+			settings.filter = args[++i];
+		else if (std::strcmp(args[i], "--min-time") == 0 && hasValue)
+			settings.minSeconds = std::atof(args[++i]);
+		else if (std::strcmp(args[i], "--json") == 0 && hasValue)
+			pJsonPath = args[++i];
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+	Bench::SetSettings(settings);
+
+	RunMathBenchmarks();
+	RunQuaternionBenchmarks();
+	RunFrustumBenchmarks();
+	RunFastMathBenchmarks();
+	RunColorBenchmarks();
+	RunTextureBenchmarks();
+	RunClipBenchmarks();
+	RunRasterBenchmarks();
+	RunOcclusionBenchmarks();
+	RunSoftwareRendererBenchmarks();
+	RunVisibilityBufferBenchmarks();
+	RunTransparencyBenchmarks();
+	RunJobSystemBenchmarks();
+	RunTransformBenchmarks();
+	RunDrawListBenchmarks();
+	RunInstancingBenchmarks();
+	RunSubmissionBenchmarks();
+	RunFramePipelineBenchmarks();
+	RunFrameAllocatorBenchmarks();
+	RunConstantBufferBenchmarks();
+	RunFrameGraphBenchmarks();
+	RunTransparencySortBenchmarks();
+
+	std::printf("%zu benchmarks done\n", Bench::GetResults().size());
+
+	if (pJsonPath && !Bench::WriteJson(pJsonPath))
+	{
+		std::printf("Could not write %s\n", pJsonPath);
+		return 1;
+	}
+
+	return Bench::HasFailures() ? 1 : 0;
+}
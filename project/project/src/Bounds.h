@@ -0,0 +1,109 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Vector3.h"
+#include "Matrix.h"
+
+namespace dae
+{
+	struct AABB
+	{
+		Vector3 center{};
+		Vector3 extents{};	// half size
+
+		static AABB FromMinMax(const Vector3& min, const Vector3& max)
+		{
+			return { (min + max) * 0.5f, (max - min) * 0.5f };
+		}
+
+		Vector3 GetMin() const { return center - extents; }
+		Vector3 GetMax() const { return center + extents; }
+
+		// Box around the transformed box (Arvo), stays axis aligned in the new space
+		AABB Transform(const Matrix& matrix) const
+		{
+			const Vector4 xAxis = matrix[0];
+			const Vector4 yAxis = matrix[1];
+			const Vector4 zAxis = matrix[2];
+
+			return {
+				matrix.TransformPoint(center),
+				{
+					std::abs(xAxis.x) * extents.x + std::abs(yAxis.x) * extents.y + std::abs(zAxis.x) * extents.z,
+					std::abs(xAxis.y) * extents.x + std::abs(yAxis.y) * extents.y + std::abs(zAxis.y) * extents.z,
+					std::abs(xAxis.z) * extents.x + std::abs(yAxis.z) * extents.y + std::abs(zAxis.z) * extents.z
+				}
+			};
+		}
+	};
+
+	struct Sphere
+	{
+		Vector3 center{};
+		float radius{};
+	};
+
+	//Structure of arrays, so batches can be tested 4/8 at a time
+	struct AABBBatch
+	{
+		std::vector<float> centerX{};
+		std::vector<float> centerY{};
+		std::vector<float> centerZ{};
+		std::vector<float> extentX{};
+		std::vector<float> extentY{};
+		std::vector<float> extentZ{};
+
+		void Add(const AABB& box)
+		{
+			centerX.push_back(box.center.x);
+			centerY.push_back(box.center.y);
+			centerZ.push_back(box.center.z);
+			extentX.push_back(box.extents.x);
+			extentY.push_back(box.extents.y);
+			extentZ.push_back(box.extents.z);
+		}
+
+		AABB Get(size_t index) const
+		{
+			return { { centerX[index], centerY[index], centerZ[index] }, { extentX[index], extentY[index], extentZ[index] } };
+		}
+
+		void Clear()
+		{
+			centerX.clear(); centerY.clear(); centerZ.clear();
+			extentX.clear(); extentY.clear(); extentZ.clear();
+		}
+
+		size_t Size() const { return centerX.size(); }
+	};
+
+	struct SphereBatch
+	{
+		std::vector<float> centerX{};
+		std::vector<float> centerY{};
+		std::vector<float> centerZ{};
+		std::vector<float> radius{};
+
+		void Add(const Sphere& sphere)
+		{
+			centerX.push_back(sphere.center.x);
+			centerY.push_back(sphere.center.y);
+			centerZ.push_back(sphere.center.z);
+			radius.push_back(sphere.radius);
+		}
+
+		Sphere Get(size_t index) const
+		{
+			return { { centerX[index], centerY[index], centerZ[index] }, radius[index] };
+		}
+
+		void Clear()
+		{
+			centerX.clear(); centerY.clear(); centerZ.clear();
+			radius.clear();
+		}
+
+		size_t Size() const { return centerX.size(); }
+	};
+}
@@ -33,6 +33,7 @@ namespace dae{
 		float initialAspectRatio{}; //dont touch
 		float totalPitch{};
 		float totalYaw{};
+		Quaternion orientation{};
 		
 
 
@@ -101,8 +102,6 @@ namespace dae{
 			int mouseX{}, mouseY{};
 			const uint32_t mouseState = SDL_GetRelativeMouseState(&mouseX, &mouseY);
 
-			Matrix finalRotation{};
-
 			if (mouseState == 5) // Move (world) Up/Down (LMB + RMB + Mouse Move Y)
 			{
 				origin += up * float(mouseY);
@@ -112,34 +111,29 @@ namespace dae{
 				totalYaw += float(mouseX) / 360 * float(M_PI);	// Rotate Yaw (LMB + Mouse Move X)
 				origin -= forward * mouseY * 0.2f;	// Move (local) Forward/Backward (LMB + Mouse Move Y)
 
-				finalRotation = Matrix::CreateRotation(totalPitch, totalYaw, 0);
-
-				forward = finalRotation.TransformVector(Vector3::UnitZ);
-				forward.Normalize();
-
-				up = finalRotation.TransformVector(Vector3::UnitY);
-				up.Normalize();
-
-				right = finalRotation.TransformVector(Vector3::UnitX);
-				right.Normalize();
+				UpdateOrientation();
 			}
 			else if (mouseState == 4)
 			{
 				totalYaw += float(mouseX) / 360 * float(M_PI);	// Rotate Yaw (LMB + Mouse Move X)
 				totalPitch -= float(mouseY) / 360 * float(M_PI);	// Rotate Pitch (RMB + Mouse Move Y)
 
-				finalRotation = Matrix::CreateRotation(totalPitch, totalYaw, 0);
-
-				forward = finalRotation.TransformVector(Vector3::UnitZ);
-				forward.Normalize();
-
-				up = finalRotation.TransformVector(Vector3::UnitY);
-				up.Normalize();
-
-				right = finalRotation.TransformVector(Vector3::UnitX);
-				right.Normalize();
+				UpdateOrientation();
 			}
 		}
+
+	private:
+		void UpdateOrientation()
+		{
+			// Pitch first, then yaw (same order as Matrix::CreateRotation(totalPitch, totalYaw, 0))
+			orientation = Quaternion::CreateRotationY(totalYaw) * Quaternion::CreateRotationX(totalPitch);
+
+			// Unit quaternion -> orthonormal axes, no renormalization needed
+			const Matrix rotation = Matrix::CreateRotation(orientation);
+			forward = rotation.GetAxisZ();
+			up = rotation.GetAxisY();
+			right = rotation.GetAxisX();
+		}
 	};
 
 }
\ No newline at end of file
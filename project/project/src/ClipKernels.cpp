@@ -0,0 +1,185 @@
+#include "ClipKernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#include "Simd.h"
+
+namespace dae
+{
+	namespace ClipKernels
+	{
+		// Signed distance to plane (bit index) p, >= 0 inside
+		static float GetDistance(const Vector4& position, int plane, const ClipBounds& bounds)
+		{
+			switch (plane)
+			{
+			case 0: return position.z;
+			case 1: return position.w - position.z;
+			case 2: return position.x + bounds.guardBandX * position.w;
+			case 3: return bounds.guardBandX * position.w - position.x;
+			case 4: return position.y + bounds.guardBandY * position.w;
+			default: return bounds.guardBandY * position.w - position.y;
+			}
+		}
+
+		uint8_t ComputeClipCode(const Vector4& position, const ClipBounds& bounds)
+		{
+			uint8_t code{};
+			if (position.z < 0.f) code |= NearPlane;
+			if (position.w < position.z) code |= FarPlane;
+			if (position.x < -bounds.guardBandX * position.w) code |= LeftPlane;
+			if (bounds.guardBandX * position.w < position.x) code |= RightPlane;
+			if (position.y < -bounds.guardBandY * position.w) code |= BottomPlane;
+			if (bounds.guardBandY * position.w < position.y) code |= TopPlane;
+			return code;
+		}
+
+		/* --- TRIANGLE BATCHES --- */
+		// x, y, z, w lanes of the positions at pIndices[0], pIndices[3], ... (one vertex of LaneWidth triangles),
+		// transposed from 4 float loads at a time
+		static void LoadPositions(const Vector4* pPositions, const uint32_t* pIndices, Simd::Lane lanes[4])
+		{
+			static_assert(sizeof(Vector4) == 4 * sizeof(float), "Vector4 loads as one __m128");
+			__m128 rows[Simd::LaneWidth];
+			for (size_t t{ 0 }; t < Simd::LaneWidth; ++t)
+				rows[t] = _mm_loadu_ps(&pPositions[pIndices[t * 3]].x);
+
+			_MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+#if defined(__AVX__)
+			_MM_TRANSPOSE4_PS(rows[4], rows[5], rows[6], rows[7]);
+			for (int c{ 0 }; c < 4; ++c)
+				lanes[c] = _mm256_set_m128(rows[c + 4], rows[c]);
+#else
+			for (int c{ 0 }; c < 4; ++c)
+				lanes[c] = rows[c];
+#endif
+		}
+
+		void ClassifyTriangles(std::span<const Vector4> positions, std::span<const uint32_t> indices, const ClipBounds& bounds, std::span<ClipCodes> codes)
+		{
+			constexpr size_t width{ Simd::LaneWidth };
+			const size_t count = indices.size() / 3;
+			assert(codes.size() >= count);
+
+			// Codes are built as integer bit patterns in the float lanes: compare masks and'ed with the plane bit
+			auto bits = [](uint32_t bit) { return Simd::Broadcast(std::bit_cast<float>(bit)); };
+			const Simd::Lane planeBits[NumPlanes]{ bits(NearPlane), bits(FarPlane), bits(LeftPlane), bits(RightPlane), bits(BottomPlane), bits(TopPlane) };
+			const Simd::Lane zero = Simd::Zero();
+			const Simd::Lane guardBandX = Simd::Broadcast(bounds.guardBandX);
+			const Simd::Lane guardBandY = Simd::Broadcast(bounds.guardBandY);
+
+			size_t i{ 0 };
+			for (; i + width <= count; i += width)
+			{
+				Simd::Lane orCodes = zero;
+				Simd::Lane andCodes = bits(0xFF);
+				for (int v{ 0 }; v < 3; ++v)
+				{
+					Simd::Lane position[4];
+					LoadPositions(positions.data(), indices.data() + i * 3 + v, position);
+					const Simd::Lane& x = position[0];
+					const Simd::Lane& y = position[1];
+					const Simd::Lane& z = position[2];
+					const Simd::Lane& w = position[3];
+					const Simd::Lane boundX = Simd::Mul(guardBandX, w);
+					const Simd::Lane boundY = Simd::Mul(guardBandY, w);
+
+					Simd::Lane code = Simd::And(Simd::LessThan(z, zero), planeBits[0]);
+					code = Simd::Or(code, Simd::And(Simd::LessThan(w, z), planeBits[1]));
+					code = Simd::Or(code, Simd::And(Simd::LessThan(x, Simd::Sub(zero, boundX)), planeBits[2]));
+					code = Simd::Or(code, Simd::And(Simd::LessThan(boundX, x), planeBits[3]));
+					code = Simd::Or(code, Simd::And(Simd::LessThan(y, Simd::Sub(zero, boundY)), planeBits[4]));
+					code = Simd::Or(code, Simd::And(Simd::LessThan(boundY, y), planeBits[5]));
+					orCodes = Simd::Or(orCodes, code);
+					andCodes = Simd::And(andCodes, code);
+				}
+
+				alignas(32) float orLanes[width], andLanes[width];
+				Simd::Store(orLanes, orCodes);
+				Simd::Store(andLanes, andCodes);
+				for (size_t t{ 0 }; t < width; ++t)
+					codes[i + t] = { uint8_t(std::bit_cast<uint32_t>(orLanes[t])), uint8_t(std::bit_cast<uint32_t>(andLanes[t])) };
+			}
+
+			// Tail
+			ClassifyTrianglesReference(positions, indices.subspan(i * 3), bounds, codes.subspan(i));
+		}
+
+		void ClassifyTrianglesReference(std::span<const Vector4> positions, std::span<const uint32_t> indices, const ClipBounds& bounds, std::span<ClipCodes> codes)
+		{
+			const size_t count = indices.size() / 3;
+			assert(codes.size() >= count);
+
+			for (size_t i{ 0 }; i < count; ++i)
+			{
+				const uint8_t code0 = ComputeClipCode(positions[indices[i * 3]], bounds);
+				const uint8_t code1 = ComputeClipCode(positions[indices[i * 3 + 1]], bounds);
+				const uint8_t code2 = ComputeClipCode(positions[indices[i * 3 + 2]], bounds);
+				codes[i] = { uint8_t(code0 | code1 | code2), uint8_t(code0 & code1 & code2) };
+			}
+		}
+
+		/* --- CLIPPING --- */
+		int ClipTriangle(const Vector4 positions[3], uint8_t planes, const ClipBounds& bounds, ClipVertex output[MaxClipVertices])
+		{
+			ClipVertex buffer[MaxClipVertices];
+			ClipVertex* pInput = output;
+			ClipVertex* pOutput = buffer;
+
+			for (int v{ 0 }; v < 3; ++v)
+			{
+				pInput[v].position = positions[v];
+				pInput[v].weights[0] = pInput[v].weights[1] = pInput[v].weights[2] = 0.f;
+				pInput[v].weights[v] = 1.f;
+			}
+
+			int count{ 3 };
+			for (int plane{ 0 }; plane < NumPlanes && count > 0; ++plane)
+			{
+				if (!(planes & (1 << plane)))
+					continue;
+
+				// The intersection from inside to outside, whichever order the edge is walked in
+				auto intersect = [&](const ClipVertex& inside, float insideDistance, const ClipVertex& outside, float outsideDistance)
+					{
+						const float t = insideDistance / (insideDistance - outsideDistance);
+						ClipVertex vertex{};
+						vertex.position = inside.position + (outside.position - inside.position) * t;
+						for (int k{ 0 }; k < 3; ++k)
+							vertex.weights[k] = inside.weights[k] + (outside.weights[k] - inside.weights[k]) * t;
+						return vertex;
+					};
+
+				int numOutput{ 0 };
+				const ClipVertex* pPrevious = &pInput[count - 1];
+				float previousDistance = GetDistance(pPrevious->position, plane, bounds);
+				for (int v{ 0 }; v < count; ++v)
+				{
+					const ClipVertex& current = pInput[v];
+					const float distance = GetDistance(current.position, plane, bounds);
+					const bool isPreviousInside = previousDistance >= 0.f;
+					const bool isInside = distance >= 0.f;
+
+					if (isPreviousInside && !isInside)
+						pOutput[numOutput++] = intersect(*pPrevious, previousDistance, current, distance);
+					else if (!isPreviousInside && isInside)
+						pOutput[numOutput++] = intersect(current, distance, *pPrevious, previousDistance);
+					if (isInside)
+						pOutput[numOutput++] = current;
+
+					pPrevious = &current;
+					previousDistance = distance;
+				}
+
+				count = numOutput;
+				std::swap(pInput, pOutput);
+			}
+
+			if (pInput != output)
+				std::copy(pInput, pInput + count, output);
+			return count;
+		}
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include "Math.h"
+
+namespace dae
+{
+	// Homogeneous clipping of clip space (D3D: 0 <= z <= w) triangles. Near and far are real clip planes,
+	// x and y are only clipped against a guard band far outside the viewport: everything inside it is left to
+	// the rasterizer's pixel bounds, which is exact and free, so only triangles reaching far off screen pay
+	namespace ClipKernels
+	{
+		// Planes, as bits of a clip code
+		constexpr uint8_t NearPlane{ 1 << 0 };		// z >= 0
+		constexpr uint8_t FarPlane{ 1 << 1 };		// z <= w
+		constexpr uint8_t LeftPlane{ 1 << 2 };		// x >= -guardBandX * w
+		constexpr uint8_t RightPlane{ 1 << 3 };		// x <= guardBandX * w
+		constexpr uint8_t BottomPlane{ 1 << 4 };	// y >= -guardBandY * w
+		constexpr uint8_t TopPlane{ 1 << 5 };		// y <= guardBandY * w
+		constexpr int NumPlanes{ 6 };
+
+		// Every plane adds at most one vertex
+		constexpr int MaxClipVertices{ 3 + NumPlanes };
+
+		// Guard band in NDC units (1 = the viewport edge)
+		struct ClipBounds
+		{
+			float guardBandX{ 1.f };
+			float guardBandY{ 1.f };
+		};
+
+		// Per triangle: bit p of orCode is set when some vertex lies outside plane p, of andCode when all three do.
+		// andCode != 0: completely outside. orCode == 0: nothing to clip
+		struct ClipCodes
+		{
+			uint8_t orCode{};
+			uint8_t andCode{};
+		};
+
+		// Output vertex: its clip space position and the weights of the input triangle's vertices it was made of,
+		// attributes interpolate with the same weights (clip space is linear in them)
+		struct ClipVertex
+		{
+			Vector4 position{};
+			float weights[3]{};
+		};
+
+		uint8_t ComputeClipCode(const Vector4& position, const ClipBounds& bounds);
+
+		/* --- TRIANGLE BATCHES --- */
+		// Triangle i is positions[indices[3i]], positions[indices[3i + 1]], positions[indices[3i + 2]].
+		// The SIMD version tests Simd::LaneWidth triangles at a time
+		void ClassifyTriangles(std::span<const Vector4> positions, std::span<const uint32_t> indices, const ClipBounds& bounds, std::span<ClipCodes> codes);
+		void ClassifyTrianglesReference(std::span<const Vector4> positions, std::span<const uint32_t> indices, const ClipBounds& bounds, std::span<ClipCodes> codes);
+
+		/* --- CLIPPING --- */
+		// Sutherland-Hodgman against the planes set in planes (usually a triangle's orCode). Returns the vertex count of the
+		// convex polygon in output, 0 when nothing is left. The polygon keeps the triangle's winding, fan it from output[0].
+		// Edge intersections are computed from the inside vertex, so triangles sharing an edge clip it to the same point
+		int ClipTriangle(const Vector4 positions[3], uint8_t planes, const ClipBounds& bounds, ClipVertex output[MaxClipVertices]);
+	}
+}
@@ -0,0 +1,245 @@
+#include "ColorKernels.h"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+
+#include "Simd.h"
+
+namespace dae
+{
+	namespace ColorKernels
+	{
+		static_assert(sizeof(ColorRGB) == 3 * sizeof(float), "Batches treat ColorRGB spans as flat float arrays");
+
+		/* --- SINGLE COLOR --- */
+
+		ColorRGB ToneMapReinhard(const ColorRGB& color, float exposure)
+		{
+			const ColorRGB c = color * exposure;
+			return { c.r / (1.f + c.r), c.g / (1.f + c.g), c.b / (1.f + c.b) };
+		}
+
+		static float ACES(float x)
+		{
+			return Saturate((x * (2.51f * x + 0.03f)) / (x * (2.43f * x + 0.59f) + 0.14f));
+		}
+
+		ColorRGB ToneMapACES(const ColorRGB& color, float exposure)
+		{
+			const ColorRGB c = color * exposure;
+			return { ACES(c.r), ACES(c.g), ACES(c.b) };
+		}
+
+		float LinearToSRGB(float value)
+		{
+			if (value <= 0.0031308f)
+				return 12.92f * value;
+			return 1.055f * powf(value, 1.f / 2.4f) - 0.055f;
+		}
+
+		uint32_t PackRGBA8(const ColorRGB& color, bool sRGB)
+		{
+			auto toByte = [sRGB](float value)
+				{
+					value = Saturate(value);
+					if (sRGB)
+						value = LinearToSRGB(value);
+					return static_cast<uint32_t>(value * 255.f + 0.5f);
+				};
+
+			return toByte(color.r) | (toByte(color.g) << 8) | (toByte(color.b) << 16) | 0xFF000000u;
+		}
+
+		/* --- BATCHES --- */
+
+		// 12 bit linear -> 8 bit sRGB, at most 1/255 off the exact curve
+		static constexpr int s_SRGBTableBits{ 12 };
+		static constexpr int s_SRGBTableSize{ 1 << s_SRGBTableBits };
+
+		static const std::array<uint8_t, s_SRGBTableSize>& GetSRGBTable()
+		{
+			static const std::array<uint8_t, s_SRGBTableSize> table = []
+				{
+					std::array<uint8_t, s_SRGBTableSize> result{};
+					for (int i{ 0 }; i < s_SRGBTableSize; ++i)
+						result[i] = static_cast<uint8_t>(LinearToSRGB(i / float(s_SRGBTableSize - 1)) * 255.f + 0.5f);
+					return result;
+				}();
+			return table;
+		}
+
+		// Runs laneOp over the colors as one flat float array, the remainder (< one lane) goes through floatOp
+		template<typename LaneOp, typename FloatOp>
+		static void ForEachFloat(float* pData, size_t count, LaneOp&& laneOp, FloatOp&& floatOp)
+		{
+			size_t i{ 0 };
+			for (; i + Simd::LaneWidth <= count; i += Simd::LaneWidth)
+				Simd::Store(pData + i, laneOp(Simd::Load(pData + i)));
+			for (; i < count; ++i)
+				pData[i] = floatOp(pData[i]);
+		}
+
+		// 4 colors (r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3) <-> rrrr gggg bbbb
+		static void Deinterleave(__m128 a, __m128 b, __m128 c, __m128& r, __m128& g, __m128& bl)
+		{
+			r = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+			g = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+			bl = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+		}
+
+		void MultiplyAdd(std::span<ColorRGB> colors, std::span<const ColorRGB> a, std::span<const ColorRGB> b)
+		{
+			assert(a.size() >= colors.size() && b.size() >= colors.size());
+
+			float* pData = &colors.data()->r;
+			const float* pA = &a.data()->r;
+			const float* pB = &b.data()->r;
+			const size_t count = colors.size() * 3;
+
+			size_t i{ 0 };
+			for (; i + Simd::LaneWidth <= count; i += Simd::LaneWidth)
+				Simd::Store(pData + i, Simd::Add(Simd::Load(pData + i), Simd::Mul(Simd::Load(pA + i), Simd::Load(pB + i))));
+			for (; i < count; ++i)
+				pData[i] += pA[i] * pB[i];
+		}
+
+		void MultiplyAdd(std::span<ColorRGB> colors, std::span<const ColorRGB> a, float scale)
+		{
+			assert(a.size() >= colors.size());
+
+			float* pData = &colors.data()->r;
+			const float* pA = &a.data()->r;
+			const size_t count = colors.size() * 3;
+			const Simd::Lane scaleLane = Simd::Broadcast(scale);
+
+			size_t i{ 0 };
+			for (; i + Simd::LaneWidth <= count; i += Simd::LaneWidth)
+				Simd::Store(pData + i, Simd::Add(Simd::Load(pData + i), Simd::Mul(Simd::Load(pA + i), scaleLane)));
+			for (; i < count; ++i)
+				pData[i] += pA[i] * scale;
+		}
+
+		void Clamp(std::span<ColorRGB> colors, float min, float max)
+		{
+			const Simd::Lane minLane = Simd::Broadcast(min);
+			const Simd::Lane maxLane = Simd::Broadcast(max);
+
+			ForEachFloat(&colors.data()->r, colors.size() * 3,
+				[&](Simd::Lane c) { return Simd::Min(Simd::Max(c, minLane), maxLane); },
+				[&](float c) { return dae::Clamp(c, min, max); });
+		}
+
+		void MaxToOne(std::span<ColorRGB> colors)
+		{
+			// Needs the max over each color, so this one works on 4 deinterleaved colors at a time
+			float* pData = &colors.data()->r;
+			const __m128 one = _mm_set1_ps(1.f);
+
+			size_t i{ 0 };
+			for (; i + 4 <= colors.size(); i += 4, pData += 12)
+			{
+				const __m128 a = _mm_loadu_ps(pData);
+				const __m128 b = _mm_loadu_ps(pData + 4);
+				const __m128 c = _mm_loadu_ps(pData + 8);
+
+				__m128 r, g, bl;
+				Deinterleave(a, b, c, r, g, bl);
+
+				// Dividing by 1 keeps the colors that are in range bit exact
+				const __m128 divisor = _mm_max_ps(_mm_max_ps(r, _mm_max_ps(g, bl)), one);
+				_mm_storeu_ps(pData, _mm_div_ps(a, _mm_shuffle_ps(divisor, divisor, _MM_SHUFFLE(1, 0, 0, 0))));
+				_mm_storeu_ps(pData + 4, _mm_div_ps(b, _mm_shuffle_ps(divisor, divisor, _MM_SHUFFLE(2, 2, 1, 1))));
+				_mm_storeu_ps(pData + 8, _mm_div_ps(c, _mm_shuffle_ps(divisor, divisor, _MM_SHUFFLE(3, 3, 3, 2))));
+			}
+
+			for (; i < colors.size(); ++i)
+				colors[i].MaxToOne();
+		}
+
+		void ToneMapReinhard(std::span<ColorRGB> colors, float exposure)
+		{
+			const Simd::Lane exposureLane = Simd::Broadcast(exposure);
+			const Simd::Lane one = Simd::Broadcast(1.f);
+
+			ForEachFloat(&colors.data()->r, colors.size() * 3,
+				[&](Simd::Lane c)
+				{
+					c = Simd::Mul(c, exposureLane);
+					return Simd::Div(c, Simd::Add(one, c));
+				},
+				[&](float c)
+				{
+					c *= exposure;
+					return c / (1.f + c);
+				});
+		}
+
+		void ToneMapACES(std::span<ColorRGB> colors, float exposure)
+		{
+			const Simd::Lane exposureLane = Simd::Broadcast(exposure);
+			const Simd::Lane a = Simd::Broadcast(2.51f);
+			const Simd::Lane b = Simd::Broadcast(0.03f);
+			const Simd::Lane c = Simd::Broadcast(2.43f);
+			const Simd::Lane d = Simd::Broadcast(0.59f);
+			const Simd::Lane e = Simd::Broadcast(0.14f);
+			const Simd::Lane zero = Simd::Zero();
+			const Simd::Lane one = Simd::Broadcast(1.f);
+
+			ForEachFloat(&colors.data()->r, colors.size() * 3,
+				[&](Simd::Lane x)
+				{
+					x = Simd::Mul(x, exposureLane);
+					const Simd::Lane numerator = Simd::Mul(x, Simd::Add(Simd::Mul(a, x), b));
+					const Simd::Lane denominator = Simd::Add(Simd::Mul(x, Simd::Add(Simd::Mul(c, x), d)), e);
+					return Simd::Min(Simd::Max(Simd::Div(numerator, denominator), zero), one);
+				},
+				[&](float x) { return ACES(x * exposure); });
+		}
+
+		void PackRGBA8(std::span<const ColorRGB> colors, std::span<uint32_t> pixels, bool sRGB)
+		{
+			assert(pixels.size() >= colors.size());
+
+			const std::array<uint8_t, s_SRGBTableSize>& table = GetSRGBTable();
+			const float* pData = &colors.data()->r;
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.f);
+			const __m128 scale = _mm_set1_ps(sRGB ? float(s_SRGBTableSize - 1) : 255.f);
+			const __m128 half = _mm_set1_ps(0.5f);
+
+			size_t i{ 0 };
+			for (; i + 4 <= colors.size(); i += 4, pData += 12)
+			{
+				__m128 r, g, b;
+				Deinterleave(_mm_loadu_ps(pData), _mm_loadu_ps(pData + 4), _mm_loadu_ps(pData + 8), r, g, b);
+
+				// Saturate, then to table index or 0..255
+				__m128i ri = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(r, zero), one), scale), half));
+				__m128i gi = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(g, zero), one), scale), half));
+				__m128i bi = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(b, zero), one), scale), half));
+
+				if (sRGB)
+				{
+					alignas(16) int32_t indices[12];
+					_mm_store_si128(reinterpret_cast<__m128i*>(indices), ri);
+					_mm_store_si128(reinterpret_cast<__m128i*>(indices + 4), gi);
+					_mm_store_si128(reinterpret_cast<__m128i*>(indices + 8), bi);
+					for (int32_t& index : indices)
+						index = table[index];
+					ri = _mm_load_si128(reinterpret_cast<const __m128i*>(indices));
+					gi = _mm_load_si128(reinterpret_cast<const __m128i*>(indices + 4));
+					bi = _mm_load_si128(reinterpret_cast<const __m128i*>(indices + 8));
+				}
+
+				__m128i packed = _mm_or_si128(ri, _mm_slli_epi32(gi, 8));
+				packed = _mm_or_si128(packed, _mm_slli_epi32(bi, 16));
+				packed = _mm_or_si128(packed, _mm_set1_epi32(static_cast<int>(0xFF000000u)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels.data() + i), packed);
+			}
+
+			for (; i < colors.size(); ++i)
+				pixels[i] = PackRGBA8(colors[i], sRGB);
+		}
+	}
+}
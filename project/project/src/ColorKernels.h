@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include "ColorRGB.h"
+
+namespace dae
+{
+	// Span based ColorRGB operations for CPU image paths (screenshots, software rendering, texture cooking).
+	// The single color overloads are the reference the batch versions are checked against:
+	// everything except PackRGBA8 with sRGB matches them up to float contraction, sRGB packing is within 1/255
+	namespace ColorKernels
+	{
+		/* --- SINGLE COLOR --- */
+		ColorRGB ToneMapReinhard(const ColorRGB& color, float exposure = 1.f);	// c / (1 + c)
+		ColorRGB ToneMapACES(const ColorRGB& color, float exposure = 1.f);		// Narkowicz ACES filmic fit, output in [0, 1]
+		float LinearToSRGB(float value);
+		uint32_t PackRGBA8(const ColorRGB& color, bool sRGB);	// R in the lowest byte (R8G8B8A8 memory order), alpha 255
+
+		/* --- BATCHES --- */
+		void MultiplyAdd(std::span<ColorRGB> colors, std::span<const ColorRGB> a, std::span<const ColorRGB> b);	// colors += a * b
+		void MultiplyAdd(std::span<ColorRGB> colors, std::span<const ColorRGB> a, float scale);					// colors += a * scale
+		void Clamp(std::span<ColorRGB> colors, float min = 0.f, float max = 1.f);
+		void MaxToOne(std::span<ColorRGB> colors);
+		void ToneMapReinhard(std::span<ColorRGB> colors, float exposure = 1.f);
+		void ToneMapACES(std::span<ColorRGB> colors, float exposure = 1.f);
+		void PackRGBA8(std::span<const ColorRGB> colors, std::span<uint32_t> pixels, bool sRGB);
+	}
+}
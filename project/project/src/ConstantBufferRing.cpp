@@ -0,0 +1,126 @@
+#include "ConstantBufferRing.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dae
+{
+	ConstantBufferRing::ConstantBufferRing(IRenderDevice& device, uint32_t byteSize)
+		: m_Device{ device }
+		, m_Size{ GetBlockSize(std::max(byteSize, s_Alignment)) }
+	{
+		m_Buffer = m_Device.CreateBuffer({ BufferType::Constant, m_Size, true }, nullptr);
+	}
+
+	ConstantBufferRing::~ConstantBufferRing()
+	{
+		// Owners destroy the ring after the GPU is done with the last frame, like every other buffer
+		for (const RetiredBuffer& retired : m_RetiredBuffers)
+			m_Device.Destroy(retired.buffer);
+		m_Device.Destroy(m_Buffer);
+	}
+
+	ConstantBufferRange ConstantBufferRing::Write(ICommandContext& context, const void* pData, uint32_t byteSize)
+	{
+		assert(byteSize > 0 && pData);
+		const uint32_t alignedSize = GetBlockSize(byteSize);
+
+		// Full: first take back what the GPU finished meanwhile, then wait for it, and only when the current
+		// frame alone is too much make room for it
+		uint32_t offset = TryAllocate(alignedSize);
+		if (offset == s_InvalidOffset && m_NumFrames > 0)
+		{
+			Retire(m_Device.GetCompletedFence());
+			offset = TryAllocate(alignedSize);
+		}
+		while (offset == s_InvalidOffset && m_NumFrames > 0)
+		{
+			WaitForOldestFrame();
+			offset = TryAllocate(alignedSize);
+		}
+		if (offset == s_InvalidOffset)
+		{
+			Grow(alignedSize);
+			offset = TryAllocate(alignedSize);
+		}
+
+		context.WriteBuffer(m_Buffer, offset, pData, byteSize);
+		return { m_Buffer, offset, byteSize };
+	}
+
+	void ConstantBufferRing::EndFrame(ICommandContext& context)
+	{
+		if (m_NumFrames == s_MaxFramesInFlight)
+			WaitForOldestFrame();
+
+		const uint64_t fence = context.SignalFence();
+		m_Frames[(m_FirstFrame + m_NumFrames) % s_MaxFramesInFlight] = { fence, m_FrameSize };
+		++m_NumFrames;
+		m_FrameSize = 0;
+		for (RetiredBuffer& retired : m_RetiredBuffers)
+			if (retired.fence == 0)
+				retired.fence = fence;
+
+		Retire(m_Device.GetCompletedFence());
+	}
+
+	uint32_t ConstantBufferRing::TryAllocate(uint32_t byteSize)
+	{
+		// Nothing in flight: start over at the front instead of skipping the end later
+		if (m_UsedSize == 0)
+			m_Head = 0;
+
+		// A block never wraps, the bytes up to the end of the ring are skipped instead
+		const bool wraps = m_Head + byteSize > m_Size;
+		const uint32_t skipped = wraps ? m_Size - m_Head : 0;
+		if (m_UsedSize + skipped + byteSize > m_Size)
+			return s_InvalidOffset;
+
+		const uint32_t offset = wraps ? 0 : m_Head;
+		m_Head = offset + byteSize;
+		m_UsedSize += skipped + byteSize;
+		m_FrameSize += skipped + byteSize;
+		m_HighWatermark = std::max(m_HighWatermark, m_UsedSize);
+		return offset;
+	}
+
+	void ConstantBufferRing::Retire(uint64_t completedFence)
+	{
+		while (m_NumFrames > 0 && m_Frames[m_FirstFrame].fence <= completedFence)
+		{
+			m_UsedSize -= m_Frames[m_FirstFrame].byteSize;
+			m_FirstFrame = (m_FirstFrame + 1) % s_MaxFramesInFlight;
+			--m_NumFrames;
+		}
+
+		std::erase_if(m_RetiredBuffers, [&](const RetiredBuffer& retired)
+			{
+				if (retired.fence == 0 || retired.fence > completedFence)
+					return false;
+				m_Device.Destroy(retired.buffer);
+				return true;
+			});
+	}
+
+	void ConstantBufferRing::WaitForOldestFrame()
+	{
+		++m_NumStalls;
+		const uint64_t fence = m_Frames[m_FirstFrame].fence;
+		m_Device.WaitForFence(fence);
+		Retire(fence);
+	}
+
+	void ConstantBufferRing::Grow(uint32_t minSize)
+	{
+		// Only the current frame is left in the ring, its blocks stay where they were written
+		assert(m_NumFrames == 0);
+		++m_NumGrows;
+		m_RetiredBuffers.push_back({ m_Buffer, 0 });
+
+		m_Size = std::max(m_Size * 2, minSize);
+		m_Buffer = m_Device.CreateBuffer({ BufferType::Constant, m_Size, true }, nullptr);
+		m_Head = 0;
+		m_UsedSize = 0;
+		m_FrameSize = 0;
+	}
+}
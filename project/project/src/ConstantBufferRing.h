@@ -0,0 +1,116 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "RenderDevice.h"
+
+namespace dae
+{
+	// Where ConstantBufferRing::Write put a block of constants, what ICommandContext::SetConstantBuffer binds
+	struct ConstantBufferRange
+	{
+		BufferHandle buffer{};
+		uint32_t byteOffset{};
+		uint32_t byteSize{};
+	};
+
+	// One big dynamic constant buffer that per frame and per draw constants are written into back to back, each
+	// block 256 byte aligned so it can be bound as a range. Nothing is ever discarded: a frame's blocks are only
+	// written over once the fence EndFrame signaled for it completed.
+	// When the ring is full of frames the GPU still reads, Write waits for the oldest one; when the current frame
+	// alone does not fit, the ring grows (the old buffer lives until the frame's fence passed). Both are counted,
+	// a steady state frame should do neither. Not thread safe, like the context it writes through
+	class ConstantBufferRing final
+	{
+	public:
+		static constexpr uint32_t s_Alignment{ 256 };	// D3D11.1 constant buffer range offsets
+
+		// Bytes a block of byteSize takes, blocks written back to back in one Write are this far apart
+		static constexpr uint32_t GetBlockSize(uint32_t byteSize) { return (byteSize + s_Alignment - 1) / s_Alignment * s_Alignment; }
+
+		explicit ConstantBufferRing(IRenderDevice& device, uint32_t byteSize = 64 * 1024);
+		~ConstantBufferRing();
+
+		ConstantBufferRing(const ConstantBufferRing&) = delete;
+		ConstantBufferRing(ConstantBufferRing&&) noexcept = delete;
+		ConstantBufferRing& operator=(const ConstantBufferRing&) = delete;
+		ConstantBufferRing& operator=(ConstantBufferRing&&) noexcept = delete;
+
+		ConstantBufferRange Write(ICommandContext& context, const void* pData, uint32_t byteSize);
+
+		template<typename T>
+		ConstantBufferRange Write(ICommandContext& context, const T& constants)
+		{
+			static_assert(std::is_standard_layout_v<T>, "Constants are copied as bytes into the cbuffer layout");
+			return Write(context, &constants, static_cast<uint32_t>(sizeof(T)));
+		}
+
+		// Write + SetConstantBuffer on T::Slot
+		template<typename T>
+		void Bind(ICommandContext& context, const T& constants)
+		{
+			const ConstantBufferRange range = Write(context, constants);
+			context.SetConstantBuffer(T::Slot, range.buffer, range.byteOffset, range.byteSize);
+		}
+
+		// Closes the frame: signals the fence its blocks are released with and retires the frames the GPU finished
+		void EndFrame(ICommandContext& context);
+
+		uint32_t GetSize() const { return m_Size; }
+		// Bytes of the frames in flight and the current one, alignment and skipped ring ends included
+		uint32_t GetUsedSize() const { return m_UsedSize; }
+		uint32_t GetHighWatermark() const { return m_HighWatermark; }
+		uint32_t GetNumFramesInFlight() const { return m_NumFrames; }
+		BufferHandle GetBuffer() const { return m_Buffer; }
+
+		// Waits for the GPU because the ring or the frame queue was full
+		uint32_t GetNumStalls() const { return m_NumStalls; }
+		uint32_t GetNumGrows() const { return m_NumGrows; }
+
+	private:
+		static constexpr uint32_t s_MaxFramesInFlight{ 8 };
+		static constexpr uint32_t s_InvalidOffset{ ~0u };
+
+		// A closed frame and the bytes it took from the ring
+		struct Frame
+		{
+			uint64_t fence{};
+			uint32_t byteSize{};
+		};
+
+		// Buffer replaced by a bigger one, destroyed once the frames that used it are done (fence 0: current frame)
+		struct RetiredBuffer
+		{
+			BufferHandle buffer{};
+			uint64_t fence{};
+		};
+
+		IRenderDevice& m_Device;
+		BufferHandle m_Buffer{};
+		uint32_t m_Size{};
+
+		// Blocks go in at m_Head, the oldest frame in flight starts m_UsedSize bytes before it (wrapping around)
+		uint32_t m_Head{ 0 };
+		uint32_t m_UsedSize{ 0 };
+		uint32_t m_FrameSize{ 0 };	// the current frame's part of m_UsedSize
+		uint32_t m_HighWatermark{ 0 };
+
+		std::array<Frame, s_MaxFramesInFlight> m_Frames{};	// oldest at m_FirstFrame
+		uint32_t m_FirstFrame{ 0 };
+		uint32_t m_NumFrames{ 0 };
+
+		std::vector<RetiredBuffer> m_RetiredBuffers{};
+
+		uint32_t m_NumStalls{ 0 };
+		uint32_t m_NumGrows{ 0 };
+
+		// Offset of byteSize (aligned) bytes, s_InvalidOffset when they don't fit next to the frames in flight
+		uint32_t TryAllocate(uint32_t byteSize);
+		// Releases the frames up to completedFence
+		void Retire(uint64_t completedFence);
+		// Waits for the oldest frame in flight and releases it
+		void WaitForOldestFrame();
+		void Grow(uint32_t minSize);
+	};
+}
@@ -0,0 +1,808 @@
+#include "D3D11RenderDevice.h"
+
+#include <cassert>
+#include <cstring>
+#include <thread>
+
+namespace dae
+{
+	static DXGI_FORMAT ToDXGI(Format format)
+	{
+		switch (format)
+		{
+		case Format::R32G32B32_Float:		return DXGI_FORMAT_R32G32B32_FLOAT;
+		case Format::R32G32_Float:			return DXGI_FORMAT_R32G32_FLOAT;
+		case Format::R32G32B32A32_Float:	return DXGI_FORMAT_R32G32B32A32_FLOAT;
+		case Format::R32_UInt:				return DXGI_FORMAT_R32_UINT;
+		case Format::R8G8B8A8_UNorm:		return DXGI_FORMAT_R8G8B8A8_UNORM;
+		case Format::R16G16B16A16_Float:	return DXGI_FORMAT_R16G16B16A16_FLOAT;
+		case Format::D24_UNorm_S8_UInt:		return DXGI_FORMAT_D24_UNORM_S8_UINT;
+		default:							return DXGI_FORMAT_UNKNOWN;
+		}
+	}
+
+	// Handle id -> slot, nullptr when the handle is invalid or released
+	template<typename T>
+	static T* Lookup(const std::vector<T*>& resources, uint32_t id)
+	{
+		return (id != 0 && id <= resources.size()) ? resources[id - 1] : nullptr;
+	}
+
+	template<typename T>
+	static uint32_t Store(std::vector<T>& resources, const T& resource)
+	{
+		resources.push_back(resource);
+		return static_cast<uint32_t>(resources.size());
+	}
+
+	D3D11RenderDevice::D3D11RenderDevice(SDL_Window* pWindow, int width, int height)
+		: m_Width{ width }
+		, m_Height{ height }
+	{
+		//Initialize DirectX pipeline
+		const HRESULT result = InitializeDirectX(pWindow);
+		if (result == S_OK)
+		{
+			m_IsInitialized = true;
+			std::cout << "DirectX is initialized and ready!\n";
+		}
+		else
+		{
+			std::cout << "DirectX initialization failed!\n";
+		}
+	}
+
+	D3D11RenderDevice::~D3D11RenderDevice()
+	{
+		// Resources that were not destroyed by their owners
+		for (ID3D11Buffer* pBuffer : m_Buffers)
+			if (pBuffer) pBuffer->Release();
+		for (const TextureResource& texture : m_Textures)
+		{
+			if (texture.pSRV) texture.pSRV->Release();
+			if (texture.pRTV) texture.pRTV->Release();
+			if (texture.pDSV) texture.pDSV->Release();
+			if (texture.pResource) texture.pResource->Release();
+		}
+		for (ID3D11InputLayout* pInputLayout : m_InputLayouts)
+			if (pInputLayout) pInputLayout->Release();
+		for (ID3DX11Effect* pEffect : m_Effects)
+			if (pEffect) pEffect->Release();
+		for (const PendingFence& pending : m_PendingFences)
+			pending.pQuery->Release();
+		for (ID3D11Query* pQuery : m_FreeQueries)
+			pQuery->Release();
+
+		// Release Render Target View
+		if (m_pRenderTargetView) {
+			m_pRenderTargetView->Release();
+			m_pRenderTargetView = nullptr;
+		}
+
+		// Release Render Target Buffer
+		if (m_pRenderTargetBuffer) {
+			m_pRenderTargetBuffer->Release();
+			m_pRenderTargetBuffer = nullptr;
+		}
+
+		// Release Depth Stencil View
+		if (m_pDepthStencilView) {
+			m_pDepthStencilView->Release();
+			m_pDepthStencilView = nullptr;
+		}
+
+		// Release Depth Stencil Buffer
+		if (m_pDepthStencilBuffer) {
+			m_pDepthStencilBuffer->Release();
+			m_pDepthStencilBuffer = nullptr;
+		}
+
+		// Release Swap Chain
+		if (m_pSwapChain) {
+			m_pSwapChain->Release();
+			m_pSwapChain = nullptr;
+		}
+
+		// Release Device Context
+		if (m_pDeviceContext1) {
+			m_pDeviceContext1->Release();
+			m_pDeviceContext1 = nullptr;
+		}
+		if (m_pDeviceContext) {
+			m_pDeviceContext->ClearState();
+			m_pDeviceContext->Flush();
+			m_pDeviceContext->Release();
+			m_pDeviceContext = nullptr;
+		}
+
+		// Release Device
+		if (m_pDevice) {
+			m_pDevice->Release();
+			m_pDevice = nullptr;
+		}
+	}
+
+
+	// Resources
+	//--------------
+
+	BufferHandle D3D11RenderDevice::CreateBuffer(const BufferDesc& desc, const void* pInitialData)
+	{
+		D3D11_BUFFER_DESC bd = {};
+		bd.Usage = desc.isDynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_IMMUTABLE;
+		bd.ByteWidth = desc.byteSize;
+		bd.CPUAccessFlags = desc.isDynamic ? D3D11_CPU_ACCESS_WRITE : 0;
+		bd.MiscFlags = 0;
+		switch (desc.type)
+		{
+		case BufferType::Vertex:	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER; break;
+		case BufferType::Index:		bd.BindFlags = D3D11_BIND_INDEX_BUFFER; break;
+		case BufferType::Constant:	bd.BindFlags = D3D11_BIND_CONSTANT_BUFFER; break;
+		}
+
+		D3D11_SUBRESOURCE_DATA initData = {};
+		initData.pSysMem = pInitialData;
+
+		ID3D11Buffer* pBuffer{ nullptr };
+		const HRESULT result = m_pDevice->CreateBuffer(&bd, pInitialData ? &initData : nullptr, &pBuffer);
+		if (FAILED(result))
+		{
+			std::cerr << "Failed to create buffer. HRESULT: " << result << std::endl;
+			return {};
+		}
+
+		return { Store(m_Buffers, pBuffer) };
+	}
+
+	TextureHandle D3D11RenderDevice::CreateTexture(const TextureDesc& desc, const void* pTexels, uint32_t rowPitch)
+	{
+		// A depth buffer that is also sampled needs a typeless resource, viewed as depth and as red channel
+		const DXGI_FORMAT format = ToDXGI(desc.format);
+		const bool isSampledDepth = desc.isDepthStencil && desc.isShaderResource;
+		D3D11_TEXTURE2D_DESC textureDesc{};
+		textureDesc.Width = desc.width;
+		textureDesc.Height = desc.height;
+		textureDesc.MipLevels = desc.mipLevels;
+		textureDesc.ArraySize = 1;
+		textureDesc.Format = isSampledDepth ? DXGI_FORMAT_R24G8_TYPELESS : format;
+		textureDesc.SampleDesc.Count = 1;
+		textureDesc.SampleDesc.Quality = 0;
+		textureDesc.Usage = D3D11_USAGE_DEFAULT;
+		textureDesc.BindFlags = (desc.isShaderResource ? D3D11_BIND_SHADER_RESOURCE : 0)
+			| (desc.isRenderTarget ? D3D11_BIND_RENDER_TARGET : 0)
+			| (desc.isDepthStencil ? D3D11_BIND_DEPTH_STENCIL : 0);
+		textureDesc.CPUAccessFlags = 0;
+		textureDesc.MiscFlags = 0;
+
+		// One subresource per level, back to back. Only RGBA8 textures come with texels
+		std::vector<D3D11_SUBRESOURCE_DATA> initData(desc.mipLevels);
+		const uint8_t* pLevel = static_cast<const uint8_t*>(pTexels);
+		uint32_t levelWidth{ desc.width };
+		uint32_t levelHeight{ desc.height };
+		uint32_t levelPitch{ rowPitch };
+		for (D3D11_SUBRESOURCE_DATA& level : initData)
+		{
+			level.pSysMem = pLevel;
+			level.SysMemPitch = levelPitch;
+			level.SysMemSlicePitch = levelHeight * levelPitch;
+			if (pLevel)
+				pLevel += level.SysMemSlicePitch;
+			levelWidth = std::max(1u, levelWidth / 2);
+			levelHeight = std::max(1u, levelHeight / 2);
+			levelPitch = levelWidth * 4;
+		}
+
+		TextureResource texture{};
+		HRESULT hr = m_pDevice->CreateTexture2D(&textureDesc, pTexels ? initData.data() : nullptr, &texture.pResource);
+		if (FAILED(hr) || texture.pResource == nullptr)
+		{
+			std::cerr << "Failed to create texture2D. HRESULT: " << hr << std::endl;
+			return {};
+		}
+
+		if (desc.isShaderResource)
+		{
+			D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc{};
+			SRVDesc.Format = isSampledDepth ? DXGI_FORMAT_R24_UNORM_X8_TYPELESS : format;
+			SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+			SRVDesc.Texture2D.MipLevels = desc.mipLevels;
+			hr = m_pDevice->CreateShaderResourceView(texture.pResource, &SRVDesc, &texture.pSRV);
+		}
+		if (SUCCEEDED(hr) && desc.isRenderTarget)
+			hr = m_pDevice->CreateRenderTargetView(texture.pResource, nullptr, &texture.pRTV);
+		if (SUCCEEDED(hr) && desc.isDepthStencil)
+		{
+			D3D11_DEPTH_STENCIL_VIEW_DESC DSVDesc{};
+			DSVDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+			DSVDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+			hr = m_pDevice->CreateDepthStencilView(texture.pResource, &DSVDesc, &texture.pDSV);
+		}
+		if (FAILED(hr))
+		{
+			std::cerr << "Failed to create texture view. HRESULT: " << hr << std::endl;
+			if (texture.pSRV) texture.pSRV->Release();
+			if (texture.pRTV) texture.pRTV->Release();
+			texture.pResource->Release();
+			return {};
+		}
+
+		return { Store(m_Textures, texture) };
+	}
+
+	EffectHandle D3D11RenderDevice::CreateEffect(const std::wstring& assetFile)
+	{
+		HRESULT result;
+		ID3D10Blob* pErrorBlob{ nullptr };
+		ID3DX11Effect* pEffect{ nullptr };
+
+		DWORD shaderFlags = 0;
+
+#if defined(DEBUG) || defined(_DEBUG)
+		shaderFlags |= D3DCOMPILE_DEBUG;
+		shaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+		result = D3DX11CompileEffectFromFile(assetFile.c_str(),
+			nullptr,
+			nullptr,
+			shaderFlags,
+			0,
+			m_pDevice,
+			&pEffect,
+			&pErrorBlob);
+
+		if (FAILED(result))
+		{
+			if (pErrorBlob != nullptr)
+			{
+				const char* pErrors = static_cast<char*>(pErrorBlob->GetBufferPointer());
+
+				std::wstringstream ss{};
+				for (unsigned int i = 0; i < pErrorBlob->GetBufferSize(); ++i)
+					ss << pErrors[i];
+
+				OutputDebugStringW(ss.str().c_str());
+				pErrorBlob->Release();
+				pErrorBlob = nullptr;
+
+				std::wcout << ss.str() << std::endl;
+			}
+			else
+			{
+				std::wstringstream ss;
+				ss << "EffectLoader: Failed to CreateEffectFromFile!\nPath: " << assetFile;
+				std::wcout << ss.str() << std::endl;
+			}
+			return {};
+		}
+
+		return { Store(m_Effects, pEffect) };
+	}
+
+	InputLayoutHandle D3D11RenderDevice::CreateInputLayout(std::span<const InputElement> elements, TechniqueHandle technique)
+	{
+		std::vector<D3D11_INPUT_ELEMENT_DESC> vertexDesc(elements.size());
+		for (size_t i{ 0 }; i < elements.size(); ++i)
+		{
+			vertexDesc[i].SemanticName = elements[i].pSemanticName;
+			vertexDesc[i].SemanticIndex = elements[i].semanticIndex;
+			vertexDesc[i].Format = ToDXGI(elements[i].format);
+			vertexDesc[i].InputSlot = elements[i].inputSlot;
+			vertexDesc[i].AlignedByteOffset = elements[i].byteOffset;
+			vertexDesc[i].InputSlotClass = elements[i].isPerInstance ? D3D11_INPUT_PER_INSTANCE_DATA : D3D11_INPUT_PER_VERTEX_DATA;
+			vertexDesc[i].InstanceDataStepRate = elements[i].isPerInstance ? 1 : 0;
+		}
+
+		const uint32_t techniqueIndex = technique.id - 1;
+		if (!technique.IsValid() || techniqueIndex >= m_Techniques.size() || !m_Techniques[techniqueIndex].pChild)
+			return {};
+
+		// Input signature of the first pass
+		D3DX11_PASS_DESC passDesc{};
+		m_Techniques[techniqueIndex].pChild->GetPassByIndex(0)->GetDesc(&passDesc);
+
+		ID3D11InputLayout* pInputLayout{ nullptr };
+		const HRESULT result = m_pDevice->CreateInputLayout(
+			vertexDesc.data(),
+			static_cast<UINT>(vertexDesc.size()),
+			passDesc.pIAInputSignature,
+			passDesc.IAInputSignatureSize,
+			&pInputLayout);
+
+		if (FAILED(result))
+		{
+			std::cerr << "Failed to create input layout. HRESULT: " << result << std::endl;
+			return {};
+		}
+
+		return { Store(m_InputLayouts, pInputLayout) };
+	}
+
+	TechniqueHandle D3D11RenderDevice::GetTechnique(EffectHandle effect, const std::string& name)
+	{
+		ID3DX11Effect* pEffect = Lookup(m_Effects, effect.id);
+		if (!pEffect)
+			return {};
+
+		ID3DX11EffectTechnique* pTechnique = pEffect->GetTechniqueByName(name.c_str());
+		if (!pTechnique->IsValid())
+			return {};
+
+		return { Store(m_Techniques, { pTechnique, effect.id }) };
+	}
+
+	EffectVariableHandle D3D11RenderDevice::GetEffectVariable(EffectHandle effect, const std::string& name)
+	{
+		ID3DX11Effect* pEffect = Lookup(m_Effects, effect.id);
+		if (!pEffect)
+			return {};
+
+		ID3DX11EffectVariable* pVariable = pEffect->GetVariableByName(name.c_str());
+		if (!pVariable->IsValid())
+			return {};
+
+		return { Store(m_EffectVariables, { pVariable, effect.id }) };
+	}
+
+	uint32_t D3D11RenderDevice::GetPassCount(TechniqueHandle technique) const
+	{
+		if (!technique.IsValid() || technique.id > m_Techniques.size() || !m_Techniques[technique.id - 1].pChild)
+			return 0;
+
+		D3DX11_TECHNIQUE_DESC techDesc{};
+		m_Techniques[technique.id - 1].pChild->GetDesc(&techDesc);
+		return techDesc.Passes;
+	}
+
+	void D3D11RenderDevice::Destroy(BufferHandle buffer)
+	{
+		if (ID3D11Buffer* pBuffer = Lookup(m_Buffers, buffer.id))
+		{
+			pBuffer->Release();
+			m_Buffers[buffer.id - 1] = nullptr;
+		}
+	}
+
+	void D3D11RenderDevice::Destroy(TextureHandle texture)
+	{
+		if (!texture.IsValid() || texture.id > m_Textures.size())
+			return;
+
+		assert(texture != m_BackBuffer && "The back buffer is owned by the device");
+		TextureResource& resource = m_Textures[texture.id - 1];
+		if (resource.pSRV)
+			resource.pSRV->Release();
+		if (resource.pRTV)
+			resource.pRTV->Release();
+		if (resource.pDSV)
+			resource.pDSV->Release();
+		if (resource.pResource)
+			resource.pResource->Release();
+		resource = {};
+	}
+
+	void D3D11RenderDevice::Destroy(InputLayoutHandle inputLayout)
+	{
+		if (ID3D11InputLayout* pInputLayout = Lookup(m_InputLayouts, inputLayout.id))
+		{
+			pInputLayout->Release();
+			m_InputLayouts[inputLayout.id - 1] = nullptr;
+		}
+	}
+
+	void D3D11RenderDevice::Destroy(EffectHandle effect)
+	{
+		ID3DX11Effect* pEffect = Lookup(m_Effects, effect.id);
+		if (!pEffect)
+			return;
+
+		// Techniques and variables are owned by the effect, they die with it
+		for (EffectChild<ID3DX11EffectTechnique>& technique : m_Techniques)
+			if (technique.effect == effect.id) technique = {};
+		for (EffectChild<ID3DX11EffectVariable>& variable : m_EffectVariables)
+			if (variable.effect == effect.id) variable = {};
+
+		pEffect->Release();
+		m_Effects[effect.id - 1] = nullptr;
+	}
+
+
+	// Context
+	//--------------
+
+	void D3D11RenderDevice::ClearRenderTarget(const ColorRGB& color)
+	{
+		const float clearColor[4] = { color.r, color.g, color.b, 1.f };
+		for (UINT target{ 0 }; target < m_NumBoundRenderTargets; ++target)
+			m_pDeviceContext->ClearRenderTargetView(m_BoundRenderTargets[target], clearColor);
+	}
+
+	void D3D11RenderDevice::ClearDepthStencil(float depth, uint8_t stencil)
+	{
+		if (m_pBoundDepthStencil)
+			m_pDeviceContext->ClearDepthStencilView(m_pBoundDepthStencil, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, depth, stencil);
+	}
+
+	void D3D11RenderDevice::SetRenderTargets(std::span<const TextureHandle> colorTargets, TextureHandle depthStencil)
+	{
+		assert(colorTargets.size() <= m_BoundRenderTargets.size());
+		m_NumBoundRenderTargets = static_cast<UINT>(colorTargets.size());
+		for (UINT target{ 0 }; target < m_NumBoundRenderTargets; ++target)
+		{
+			const uint32_t id = colorTargets[target].id;
+			m_BoundRenderTargets[target] = (id != 0 && id <= m_Textures.size()) ? m_Textures[id - 1].pRTV : nullptr;
+		}
+		m_pBoundDepthStencil = (depthStencil.IsValid() && depthStencil.id <= m_Textures.size()) ? m_Textures[depthStencil.id - 1].pDSV : nullptr;
+		BindRenderTargets();
+	}
+
+	void D3D11RenderDevice::Transition(TextureHandle, ResourceState before, ResourceState after)
+	{
+		// Only bindings conflict: a texture about to be sampled leaves the output merger, one about to be drawn
+		// into leaves the pixel shader. The next SetRenderTargets/ApplyTechnique binds what the pass needs
+		const auto isOutput = [](ResourceState state)
+			{
+				return state == ResourceState::RenderTarget || state == ResourceState::DepthWrite || state == ResourceState::DepthRead;
+			};
+		if (after == ResourceState::ShaderResource && isOutput(before))
+		{
+			m_NumBoundRenderTargets = 0;
+			m_pBoundDepthStencil = nullptr;
+			BindRenderTargets();
+		}
+		else if (before == ResourceState::ShaderResource && isOutput(after))
+		{
+			ID3D11ShaderResourceView* const nullViews[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT]{};
+			m_pDeviceContext->PSSetShaderResources(0, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, nullViews);
+		}
+	}
+
+	void D3D11RenderDevice::BindRenderTargets()
+	{
+		m_pDeviceContext->OMSetRenderTargets(m_NumBoundRenderTargets, m_BoundRenderTargets.data(), m_pBoundDepthStencil);
+	}
+
+	void D3D11RenderDevice::SetPrimitiveTopology(PrimitiveTopology)
+	{
+		m_pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	}
+
+	void D3D11RenderDevice::SetInputLayout(InputLayoutHandle inputLayout)
+	{
+		m_pDeviceContext->IASetInputLayout(Lookup(m_InputLayouts, inputLayout.id));
+	}
+
+	void D3D11RenderDevice::SetVertexBuffer(uint32_t slot, BufferHandle buffer, uint32_t stride, uint32_t offset)
+	{
+		ID3D11Buffer* pBuffer = Lookup(m_Buffers, buffer.id);
+		const UINT strides[1]{ stride };
+		const UINT offsets[1]{ offset };
+		m_pDeviceContext->IASetVertexBuffers(slot, 1, &pBuffer, strides, offsets);
+	}
+
+	void D3D11RenderDevice::SetIndexBuffer(BufferHandle buffer, Format format, uint32_t offset)
+	{
+		m_pDeviceContext->IASetIndexBuffer(Lookup(m_Buffers, buffer.id), ToDXGI(format), offset);
+	}
+
+	void D3D11RenderDevice::SetEffectMatrix(EffectVariableHandle variable, const Matrix& matrix)
+	{
+		if (variable.IsValid() && m_EffectVariables[variable.id - 1].pChild)
+			m_EffectVariables[variable.id - 1].pChild->AsMatrix()->SetMatrix(reinterpret_cast<const float*>(&matrix));
+	}
+
+	void D3D11RenderDevice::SetEffectVector(EffectVariableHandle variable, const Vector3& vector)
+	{
+		if (variable.IsValid() && m_EffectVariables[variable.id - 1].pChild)
+			m_EffectVariables[variable.id - 1].pChild->AsVector()->SetFloatVector(reinterpret_cast<const float*>(&vector));
+	}
+
+	void D3D11RenderDevice::SetEffectTexture(EffectVariableHandle variable, TextureHandle texture)
+	{
+		if (!variable.IsValid() || !m_EffectVariables[variable.id - 1].pChild)
+			return;
+
+		ID3D11ShaderResourceView* pSRV = (texture.IsValid() && texture.id <= m_Textures.size()) ? m_Textures[texture.id - 1].pSRV : nullptr;
+		m_EffectVariables[variable.id - 1].pChild->AsShaderResource()->SetResource(pSRV);
+	}
+
+	void D3D11RenderDevice::ApplyTechnique(TechniqueHandle technique, uint32_t passIndex)
+	{
+		if (!technique.IsValid() || !m_Techniques[technique.id - 1].pChild)
+			return;
+
+		m_Techniques[technique.id - 1].pChild->GetPassByIndex(passIndex)->Apply(0, m_pDeviceContext);
+		for (uint32_t slot{ 0 }; slot < m_NumConstantBufferSlots; ++slot)
+			if (m_ConstantBufferRanges[slot].pBuffer)
+				BindConstantBufferRange(slot);
+	}
+
+	void D3D11RenderDevice::UpdateBuffer(BufferHandle buffer, const void* pData, uint32_t byteSize)
+	{
+		ID3D11Buffer* pBuffer = Lookup(m_Buffers, buffer.id);
+		if (!pBuffer || byteSize == 0)
+			return;
+
+		D3D11_MAPPED_SUBRESOURCE mapped{};
+		const HRESULT result = m_pDeviceContext->Map(pBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+		if (FAILED(result))
+		{
+			std::cerr << "Failed to map buffer. HRESULT: " << result << std::endl;
+			return;
+		}
+		std::memcpy(mapped.pData, pData, byteSize);
+		m_pDeviceContext->Unmap(pBuffer, 0);
+	}
+
+	void D3D11RenderDevice::WriteBuffer(BufferHandle buffer, uint32_t byteOffset, const void* pData, uint32_t byteSize)
+	{
+		ID3D11Buffer* pBuffer = Lookup(m_Buffers, buffer.id);
+		if (!pBuffer || byteSize == 0)
+			return;
+
+		// The caller guarantees the GPU is done with the range, so the rest of the buffer stays as it is
+		D3D11_MAPPED_SUBRESOURCE mapped{};
+		const HRESULT result = m_pDeviceContext->Map(pBuffer, 0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped);
+		if (FAILED(result))
+		{
+			std::cerr << "Failed to map buffer. HRESULT: " << result << std::endl;
+			return;
+		}
+		std::memcpy(static_cast<uint8_t*>(mapped.pData) + byteOffset, pData, byteSize);
+		m_pDeviceContext->Unmap(pBuffer, 0);
+	}
+
+	void D3D11RenderDevice::SetConstantBuffer(uint32_t slot, BufferHandle buffer, uint32_t byteOffset, uint32_t byteSize)
+	{
+		if (slot >= m_ConstantBufferRanges.size())
+			return;
+
+		// Released: the effect's own cbuffer (its variables) is bound again by the next ApplyTechnique
+		if (!buffer.IsValid())
+		{
+			m_ConstantBufferRanges[slot] = {};
+			while (m_NumConstantBufferSlots > 0 && !m_ConstantBufferRanges[m_NumConstantBufferSlots - 1].pBuffer)
+				--m_NumConstantBufferSlots;
+			return;
+		}
+
+		// Ranges are counted in float4s and have to be multiples of 16 of them
+		m_ConstantBufferRanges[slot] = { Lookup(m_Buffers, buffer.id), byteOffset / 16, (byteSize + 255) / 256 * 16 };
+		m_NumConstantBufferSlots = std::max(m_NumConstantBufferSlots, slot + 1);
+		BindConstantBufferRange(slot);
+	}
+
+	void D3D11RenderDevice::BindConstantBufferRange(uint32_t slot)
+	{
+		const ConstantBufferRange& range = m_ConstantBufferRanges[slot];
+		m_pDeviceContext1->VSSetConstantBuffers1(slot, 1, &range.pBuffer, &range.firstConstant, &range.numConstants);
+		m_pDeviceContext1->PSSetConstantBuffers1(slot, 1, &range.pBuffer, &range.firstConstant, &range.numConstants);
+	}
+
+	void D3D11RenderDevice::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+	{
+		m_pDeviceContext->DrawIndexed(indexCount, startIndex, baseVertex);
+	}
+
+	void D3D11RenderDevice::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+	{
+		m_pDeviceContext->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+	}
+
+	void D3D11RenderDevice::Present()
+	{
+		m_pSwapChain->Present(0, 0);
+	}
+
+
+	// Fences
+	//--------------
+
+	uint64_t D3D11RenderDevice::SignalFence()
+	{
+		ID3D11Query* pQuery{ nullptr };
+		if (!m_FreeQueries.empty())
+		{
+			pQuery = m_FreeQueries.back();
+			m_FreeQueries.pop_back();
+		}
+		else
+		{
+			const D3D11_QUERY_DESC queryDesc{ D3D11_QUERY_EVENT, 0 };
+			const HRESULT result = m_pDevice->CreateQuery(&queryDesc, &pQuery);
+			if (FAILED(result))
+			{
+				// Without a query there is nothing to wait for, treat the fence as passed once everything before it ran
+				std::cerr << "Failed to create fence query. HRESULT: " << result << std::endl;
+				m_pDeviceContext->Flush();
+				m_CompletedFence = ++m_LastSignaledFence;
+				return m_LastSignaledFence;
+			}
+		}
+
+		m_pDeviceContext->End(pQuery);
+		m_PendingFences.push_back({ ++m_LastSignaledFence, pQuery });
+		return m_LastSignaledFence;
+	}
+
+	uint64_t D3D11RenderDevice::GetCompletedFence()
+	{
+		// Events complete in order, stop at the first one the GPU did not reach
+		size_t numCompleted{ 0 };
+		for (const PendingFence& pending : m_PendingFences)
+		{
+			if (m_pDeviceContext->GetData(pending.pQuery, nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+				break;
+			m_CompletedFence = pending.fence;
+			m_FreeQueries.push_back(pending.pQuery);
+			++numCompleted;
+		}
+		m_PendingFences.erase(m_PendingFences.begin(), m_PendingFences.begin() + numCompleted);
+		return m_CompletedFence;
+	}
+
+	void D3D11RenderDevice::WaitForFence(uint64_t fence)
+	{
+		if (GetCompletedFence() >= fence)
+			return;
+
+		m_pDeviceContext->Flush();
+		while (GetCompletedFence() < fence)
+			std::this_thread::yield();
+	}
+
+
+	HRESULT D3D11RenderDevice::InitializeDirectX(SDL_Window* pWindow)
+	{
+		//1. Create Device & DeviceContent
+		//=====
+		D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_1;
+		uint32_t createDeviceFlags = 0;
+#if defined(DEBUG)|| defined(_DEBUG)
+		createDeviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+		HRESULT result = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, 0, createDeviceFlags, &featureLevel,
+			1,D3D11_SDK_VERSION, &m_pDevice, nullptr, &m_pDeviceContext);
+
+		if (FAILED(result))
+			return result;
+
+		//Constant buffer ranges (VSSetConstantBuffers1) and NO_OVERWRITE maps of constant buffers need 11.1
+		result = m_pDeviceContext->QueryInterface(__uuidof(ID3D11DeviceContext1), reinterpret_cast<void**>(&m_pDeviceContext1));
+		if (FAILED(result))
+			return result;
+
+		D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+		result = m_pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options));
+		if (FAILED(result))
+			return result;
+		if (!options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer)
+		{
+			std::cout << "The driver does not support constant buffer ranges\n";
+			return E_FAIL;
+		}
+
+		//Create DXGI Factory
+		IDXGIFactory1* pDxgiFactory{};
+		result = CreateDXGIFactory1(__uuidof(IDXGIFactory1), reinterpret_cast<void**>(&pDxgiFactory));
+		if (FAILED(result))
+			return result;
+
+
+
+		//2. Create Swapchain
+		//====
+		DXGI_SWAP_CHAIN_DESC swapChainDesc{};
+		swapChainDesc.BufferDesc.Width = m_Width;
+		swapChainDesc.BufferDesc.Height = m_Height;
+		swapChainDesc.BufferDesc.RefreshRate.Numerator = 1;
+		swapChainDesc.BufferDesc.RefreshRate.Denominator = 60;
+		swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
+		swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+		swapChainDesc.SampleDesc.Count = 1;
+		swapChainDesc.SampleDesc.Quality = 0;
+		swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+		swapChainDesc.BufferCount = 1;
+		swapChainDesc.Windowed = true;
+		swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+		swapChainDesc.Flags = 0;
+
+		//Get the handle (HWND) from the SDL backbuffer
+		SDL_SysWMinfo sysWMInfo{};
+		SDL_GetVersion(&sysWMInfo.version);
+		SDL_GetWindowWMInfo(pWindow, &sysWMInfo);
+		swapChainDesc.OutputWindow = sysWMInfo.info.win.window;
+
+		//Create Swapchain
+		result = pDxgiFactory->CreateSwapChain(m_pDevice, &swapChainDesc, &m_pSwapChain);
+		if (FAILED(result))
+			return result;
+
+
+
+		//3. Create DepthStencil (DS) & DepthStencilView (DSV)
+		//====
+
+		//Resource
+		D3D11_TEXTURE2D_DESC depthStencilDesc{};
+		depthStencilDesc.Width = m_Width;
+		depthStencilDesc.Height = m_Height;
+		depthStencilDesc.MipLevels = 1;
+		depthStencilDesc.ArraySize = 1;
+		depthStencilDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+		depthStencilDesc.SampleDesc.Count = 1;
+		depthStencilDesc.SampleDesc.Quality = 0;
+		depthStencilDesc.Usage = D3D11_USAGE_DEFAULT;
+		depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+		depthStencilDesc.CPUAccessFlags = 0;
+		depthStencilDesc.MiscFlags = 0;
+
+		//View
+		D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc{};
+		depthStencilViewDesc.Format = depthStencilDesc.Format;
+		depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+		depthStencilViewDesc.Texture2D.MipSlice = 0;
+
+		result = m_pDevice->CreateTexture2D(&depthStencilDesc, nullptr, &m_pDepthStencilBuffer);
+		if (FAILED(result))
+			return result;
+		result = m_pDevice->CreateDepthStencilView(m_pDepthStencilBuffer, &depthStencilViewDesc, &m_pDepthStencilView);
+		if (FAILED(result))
+			return result;
+
+
+
+		//4. Create RenderTarget (RT) & RenderTargetView (RTV)
+		//====
+
+		//Resource
+		result = m_pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&m_pRenderTargetBuffer));
+		if (FAILED(result))
+			return result;
+
+		//View
+		result = m_pDevice->CreateRenderTargetView(m_pRenderTargetBuffer,nullptr, &m_pRenderTargetView);
+		if (FAILED(result))
+			return result;
+
+
+
+		//The back buffer as texture the frame graph can import, sharing the view
+		m_pRenderTargetView->AddRef();
+		TextureResource backBuffer{};
+		backBuffer.pRTV = m_pRenderTargetView;
+		m_BackBuffer = { Store(m_Textures, backBuffer) };
+
+
+
+		//5. Bind RTV & DSV to Output Merger Stage
+		//====
+		m_BoundRenderTargets[0] = m_pRenderTargetView;
+		m_NumBoundRenderTargets = 1;
+		m_pBoundDepthStencil = m_pDepthStencilView;
+		BindRenderTargets();
+
+
+
+		//6. Set Viewport
+		//=====
+		D3D11_VIEWPORT viewport{};
+		viewport.Width = static_cast<float>(m_Width);
+		viewport.Height = static_cast<float>(m_Height);
+		viewport.TopLeftX = 0.f;
+		viewport.TopLeftY = 0.f;
+		viewport.MinDepth = 0.f;
+		viewport.MaxDepth = 1.f;
+		m_pDeviceContext->RSSetViewports(1, &viewport);
+
+
+
+		//Release DXGIFactory
+		pDxgiFactory->Release();
+
+
+
+		return S_OK;
+	}
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include "pch.h"
+#include <array>
+#include "RenderDevice.h"
+
+namespace dae
+{
+	// IRenderDevice on top of D3D11 + the effects framework, owns the device, swap chain and the
+	// back buffer/depth views. Handle ids are indices (+ 1) into the per type resource arrays.
+	// Needs the 11.1 runtime for constant buffer ranges, fences are event queries
+	class D3D11RenderDevice final : public IRenderDevice, private ICommandContext
+	{
+	public:
+		D3D11RenderDevice(SDL_Window* pWindow, int width, int height);
+		~D3D11RenderDevice() override;
+
+		D3D11RenderDevice(const D3D11RenderDevice&) = delete;
+		D3D11RenderDevice(D3D11RenderDevice&&) noexcept = delete;
+		D3D11RenderDevice& operator=(const D3D11RenderDevice&) = delete;
+		D3D11RenderDevice& operator=(D3D11RenderDevice&&) noexcept = delete;
+
+		bool IsInitialized() const { return m_IsInitialized; }
+
+		// IRenderDevice
+		// ------
+		BufferHandle CreateBuffer(const BufferDesc& desc, const void* pInitialData) override;
+		TextureHandle CreateTexture(const TextureDesc& desc, const void* pTexels, uint32_t rowPitch) override;
+		EffectHandle CreateEffect(const std::wstring& assetFile) override;
+		InputLayoutHandle CreateInputLayout(std::span<const InputElement> elements, TechniqueHandle technique) override;
+
+		TechniqueHandle GetTechnique(EffectHandle effect, const std::string& name) override;
+		EffectVariableHandle GetEffectVariable(EffectHandle effect, const std::string& name) override;
+		uint32_t GetPassCount(TechniqueHandle technique) const override;
+
+		void Destroy(BufferHandle buffer) override;
+		void Destroy(TextureHandle texture) override;
+		void Destroy(InputLayoutHandle inputLayout) override;
+		void Destroy(EffectHandle effect) override;
+
+		ICommandContext& GetImmediateContext() override { return *this; }
+		TextureHandle GetBackBuffer() const override { return m_BackBuffer; }
+
+		uint64_t GetCompletedFence() override;
+		void WaitForFence(uint64_t fence) override;
+
+	private:
+		struct TextureResource
+		{
+			ID3D11Texture2D* pResource{ nullptr };
+			ID3D11ShaderResourceView* pSRV{ nullptr };
+			ID3D11RenderTargetView* pRTV{ nullptr };
+			ID3D11DepthStencilView* pDSV{ nullptr };
+		};
+
+		// Techniques and variables live inside their effect, they are only looked up
+		template<typename T>
+		struct EffectChild
+		{
+			T* pChild{ nullptr };
+			uint32_t effect{};
+		};
+
+		// Range bound with SetConstantBuffer, in float4s like VSSetConstantBuffers1 wants it
+		struct ConstantBufferRange
+		{
+			ID3D11Buffer* pBuffer{ nullptr };
+			UINT firstConstant{};
+			UINT numConstants{};
+		};
+
+		struct PendingFence
+		{
+			uint64_t fence{};
+			ID3D11Query* pQuery{ nullptr };
+		};
+
+		int m_Width{};
+		int m_Height{};
+		bool m_IsInitialized{ false };
+
+		//Device & DeviceContent
+		ID3D11Device* m_pDevice = nullptr;
+		ID3D11DeviceContext* m_pDeviceContext = nullptr;
+		ID3D11DeviceContext1* m_pDeviceContext1 = nullptr;
+
+		//SwapChain
+		IDXGISwapChain* m_pSwapChain = nullptr;
+
+		//DepthStencil (DS) & DepthStencilView (DSV)
+		ID3D11Texture2D* m_pDepthStencilBuffer = nullptr;
+		ID3D11DepthStencilView* m_pDepthStencilView = nullptr;
+
+		//RenderTarget (RT) & RenderTargetView (RTV)
+		ID3D11Resource* m_pRenderTargetBuffer = nullptr;
+		ID3D11RenderTargetView* m_pRenderTargetView = nullptr;
+		TextureHandle m_BackBuffer{};	// holds a reference to m_pRenderTargetView
+
+		//What SetRenderTargets bound, the views are owned by m_Textures
+		std::array<ID3D11RenderTargetView*, D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT> m_BoundRenderTargets{};
+		UINT m_NumBoundRenderTargets{};
+		ID3D11DepthStencilView* m_pBoundDepthStencil = nullptr;
+
+		//Resources, released slots stay nullptr
+		std::vector<ID3D11Buffer*> m_Buffers{};
+		std::vector<TextureResource> m_Textures{};
+		std::vector<ID3D11InputLayout*> m_InputLayouts{};
+		std::vector<ID3DX11Effect*> m_Effects{};
+		std::vector<EffectChild<ID3DX11EffectTechnique>> m_Techniques{};
+		std::vector<EffectChild<ID3DX11EffectVariable>> m_EffectVariables{};
+
+		//Applying an effect pass binds the effect's own constant buffers, the bound ranges are restored after it
+		std::array<ConstantBufferRange, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT> m_ConstantBufferRanges{};
+		uint32_t m_NumConstantBufferSlots{};	// slots below this may hold a range
+
+		//Fences in signal order, queries are reused once they completed
+		std::vector<PendingFence> m_PendingFences{};
+		std::vector<ID3D11Query*> m_FreeQueries{};
+		uint64_t m_LastSignaledFence{ 0 };
+		uint64_t m_CompletedFence{ 0 };
+
+		HRESULT InitializeDirectX(SDL_Window* pWindow);
+		void BindConstantBufferRange(uint32_t slot);
+
+		// ICommandContext
+		// ------
+		void ClearRenderTarget(const ColorRGB& color) override;
+		void ClearDepthStencil(float depth, uint8_t stencil) override;
+
+		void SetRenderTargets(std::span<const TextureHandle> colorTargets, TextureHandle depthStencil) override;
+		void Transition(TextureHandle texture, ResourceState before, ResourceState after) override;
+		void BindRenderTargets();
+
+		void SetPrimitiveTopology(PrimitiveTopology topology) override;
+		void SetInputLayout(InputLayoutHandle inputLayout) override;
+		void SetVertexBuffer(uint32_t slot, BufferHandle buffer, uint32_t stride, uint32_t offset) override;
+		void SetIndexBuffer(BufferHandle buffer, Format format, uint32_t offset) override;
+
+		void SetEffectMatrix(EffectVariableHandle variable, const Matrix& matrix) override;
+		void SetEffectVector(EffectVariableHandle variable, const Vector3& vector) override;
+		void SetEffectTexture(EffectVariableHandle variable, TextureHandle texture) override;
+		void ApplyTechnique(TechniqueHandle technique, uint32_t passIndex) override;
+
+		void UpdateBuffer(BufferHandle buffer, const void* pData, uint32_t byteSize) override;
+		void WriteBuffer(BufferHandle buffer, uint32_t byteOffset, const void* pData, uint32_t byteSize) override;
+		void SetConstantBuffer(uint32_t slot, BufferHandle buffer, uint32_t byteOffset, uint32_t byteSize) override;
+
+		void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+		void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) override;
+
+		void Present() override;
+
+		uint64_t SignalFence() override;
+	};
+}
@@ -0,0 +1,133 @@
+#include "DrawList.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+#include "ConstantBufferRing.h"
+#include "Mesh.h"
+#include "RadixSort.h"
+
+namespace dae
+{
+	namespace DrawKey
+	{
+		static constexpr int s_LayerShift{ 64 - LayerBits };
+		static constexpr int s_TranslucentShift{ s_LayerShift - 1 };
+		static constexpr int s_UnusedBits{ s_TranslucentShift - EffectBits - TechniqueBits - TextureSetBits - DepthBits };
+		static_assert(s_UnusedBits >= 0, "Key fields do not fit in 64 bits");
+
+		static uint64_t Mask(uint32_t value, int bits)
+		{
+			return uint64_t(value) & ((uint64_t{ 1 } << bits) - 1);
+		}
+
+		// effect | technique | texture set, most significant first
+		static uint64_t PackState(uint32_t effect, uint32_t technique, uint32_t textureSet)
+		{
+			return (Mask(effect, EffectBits) << (TechniqueBits + TextureSetBits)) | (Mask(technique, TechniqueBits) << TextureSetBits) | Mask(textureSet, TextureSetBits);
+		}
+
+		uint64_t MakeOpaque(uint32_t layer, uint32_t effect, uint32_t technique, uint32_t textureSet, float depth)
+		{
+			const uint64_t state = PackState(effect, technique, textureSet);
+			return (Mask(layer, LayerBits) << s_LayerShift)
+				| (state << (DepthBits + s_UnusedBits))
+				| (uint64_t(QuantizeDepth(depth)) << s_UnusedBits);
+		}
+
+		uint64_t MakeTranslucent(uint32_t layer, uint32_t effect, uint32_t technique, uint32_t textureSet, float depth)
+		{
+			const uint64_t state = PackState(effect, technique, textureSet);
+			const uint32_t invertedDepth = ((1u << DepthBits) - 1) - QuantizeDepth(depth);
+			return (Mask(layer, LayerBits) << s_LayerShift)
+				| (uint64_t{ 1 } << s_TranslucentShift)
+				| (uint64_t(invertedDepth) << (s_TranslucentShift - DepthBits))
+				| (state << s_UnusedBits);
+		}
+
+		uint32_t QuantizeDepth(float depth)
+		{
+			constexpr float maxValue{ float((1u << DepthBits) - 1) };
+			if (!(depth > 0.f))	// also NaN
+				return 0;
+			return depth >= 1.f ? uint32_t(maxValue) : static_cast<uint32_t>(depth * maxValue);
+		}
+
+		uint32_t GetLayer(uint64_t key)
+		{
+			return static_cast<uint32_t>(key >> s_LayerShift);
+		}
+
+		bool IsTranslucent(uint64_t key)
+		{
+			return (key >> s_TranslucentShift) & 1;
+		}
+	}
+
+	void DrawList::Clear()
+	{
+		m_Packets.clear();
+		m_Items.clear();
+	}
+
+	void DrawList::Submit(uint64_t key, const Packet& packet)
+	{
+		assert(packet.pMesh);
+		m_Items.push_back({ key, static_cast<uint32_t>(m_Packets.size()) });
+		m_Packets.push_back(packet);
+	}
+
+	void DrawList::Sort()
+	{
+		RadixSort(m_Items, m_Scratch);
+	}
+
+	void DrawList::Execute(ICommandContext& context) const
+	{
+		for (const SortItem& item : m_Items)
+		{
+			const Packet& packet = m_Packets[item.packetIndex];
+			packet.pMesh->Render(context, packet.worldMatrix, packet.worldViewProjectionMatrix, packet.cameraPos, packet.filteringMethod);
+		}
+	}
+
+	void DrawList::Execute(ICommandContext& context, ConstantBufferRing& constants, Bucket bucket)
+	{
+		const auto isInBucket = [bucket](const SortItem& item)
+			{
+				return bucket == Bucket::All || DrawKey::IsTranslucent(item.key) == (bucket == Bucket::Translucent);
+			};
+
+		// Every packet's block in draw order, then one write for all of them
+		constexpr uint32_t stride{ ConstantBufferRing::GetBlockSize(sizeof(PerObjectConstants)) };
+		m_ConstantStaging.resize(m_Items.size() * stride);
+		uint32_t numBlocks{ 0 };
+		for (const SortItem& item : m_Items)
+		{
+			if (!isInBucket(item))
+				continue;
+			const Packet& packet = m_Packets[item.packetIndex];
+			std::byte* pBlock = m_ConstantStaging.data() + numBlocks++ * stride;
+			std::memcpy(pBlock + offsetof(PerObjectConstants, worldViewProjection), &packet.worldViewProjectionMatrix, sizeof(Matrix));
+			std::memcpy(pBlock + offsetof(PerObjectConstants, world), &packet.worldMatrix, sizeof(Matrix));
+		}
+		if (numBlocks == 0)
+			return;
+		const ConstantBufferRange blocks = constants.Write(context, m_ConstantStaging.data(), numBlocks * stride);
+
+		uint32_t block{ 0 };
+		for (const SortItem& item : m_Items)
+		{
+			if (!isInBucket(item))
+				continue;
+			const Packet& packet = m_Packets[item.packetIndex];
+			packet.pMesh->Render(context, { blocks.buffer, blocks.byteOffset + block++ * stride, sizeof(PerObjectConstants) }, packet.filteringMethod);
+		}
+	}
+
+	void DrawList::RadixSort(std::span<SortItem> items, std::vector<SortItem>& scratch)
+	{
+		LsdRadixSort<8>(items, scratch, [](const SortItem& item) { return item.key; });
+	}
+}
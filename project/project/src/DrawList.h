@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Math.h"
+#include "FilteringMethod.h"
+
+namespace dae
+{
+	class Mesh;
+	class ICommandContext;
+	class ConstantBufferRing;
+
+	// Packed 64 bit sort keys, compared as plain integers (most significant field first):
+	//   opaque:       layer 4 | 0 | effect 8 | technique 4 | texture set 12 | depth 24 | 11 unused
+	//   translucent:  layer 4 | 1 | ~depth 24 | effect 8 | technique 4 | texture set 12 | 11 unused
+	// So layers draw in order, opaque before blended, opaque grouped by state and front to back within it,
+	// blended back to front (the order blending needs) with state only breaking ties
+	namespace DrawKey
+	{
+		constexpr int LayerBits{ 4 };
+		constexpr int EffectBits{ 8 };
+		constexpr int TechniqueBits{ 4 };
+		constexpr int TextureSetBits{ 12 };
+		constexpr int DepthBits{ 24 };
+
+		// depth: 0 (near) to 1 (far), clamped. Ids are masked to their field width
+		uint64_t MakeOpaque(uint32_t layer, uint32_t effect, uint32_t technique, uint32_t textureSet, float depth);
+		uint64_t MakeTranslucent(uint32_t layer, uint32_t effect, uint32_t technique, uint32_t textureSet, float depth);
+
+		uint32_t QuantizeDepth(float depth);
+		uint32_t GetLayer(uint64_t key);
+		bool IsTranslucent(uint64_t key);
+	}
+
+	// Frame's draws as packets with sort keys, replayed in key order instead of the order they were submitted in.
+	// Packets and sort buffers are kept across Clear, so steady state frames don't allocate
+	class DrawList final
+	{
+	public:
+		// Mesh::Render's arguments
+		struct Packet
+		{
+			Mesh* pMesh{ nullptr };
+			Matrix worldMatrix{};
+			Matrix worldViewProjectionMatrix{};
+			Vector3 cameraPos{};
+			FilteringMethod filteringMethod{};
+		};
+
+		// Which of the sorted draws Execute replays, so opaque and blended draws can go to different passes
+		enum class Bucket
+		{
+			All = 0,
+			Opaque,
+			Translucent
+		};
+
+		// Key plus the packet it belongs to, this is what gets sorted
+		struct SortItem
+		{
+			uint64_t key{};
+			uint32_t packetIndex{};
+		};
+
+		DrawList() = default;
+		~DrawList() = default;
+
+		DrawList(const DrawList&) = delete;
+		DrawList(DrawList&&) noexcept = delete;
+		DrawList& operator=(const DrawList&) = delete;
+		DrawList& operator=(DrawList&&) noexcept = delete;
+
+		void Clear();
+		void Submit(uint64_t key, const Packet& packet);
+		void Sort();
+		// Mesh::Render per packet, in sorted order
+		void Execute(ICommandContext& context) const;
+		// Same with the matrices as cbPerObject blocks: all packets' blocks go into the ring in one write, every draw
+		// only binds its own. cbPerFrame has to be bound already (the packets' camera is not used)
+		void Execute(ICommandContext& context, ConstantBufferRing& constants, Bucket bucket = Bucket::All);
+
+		size_t GetSize() const { return m_Packets.size(); }
+		const Packet& GetPacket(uint32_t index) const { return m_Packets[index]; }
+		std::span<const SortItem> GetSortedItems() const { return m_Items; }
+
+		// Stable LSD radix sort on the key (LsdRadixSort), 8 bits per pass. Passes where every key has the same byte are skipped,
+		// so unused fields (one layer, no translucency, ...) cost one histogram instead of a scatter.
+		// scratch is resized to items.size()
+		static void RadixSort(std::span<SortItem> items, std::vector<SortItem>& scratch);
+
+	private:
+		std::vector<Packet> m_Packets{};
+		std::vector<SortItem> m_Items{};
+		std::vector<SortItem> m_Scratch{};
+		std::vector<std::byte> m_ConstantStaging{};	// cbPerObject blocks in draw order
+	};
+}
@@ -2,121 +2,63 @@
 
 namespace dae
 {
-	Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetFile)
-		:m_pDevice(pDevice)
+	Effect::Effect(IRenderDevice& device, const std::wstring& assetFile)
+		:m_Device(device)
 	{
-		// Load the effect using the function defined to the right, store the resulting pointer in a member of type ID3DX11Effect
-		m_pEffect = LoadEffect(pDevice, assetFile);
+		// Compile the effect, the device keeps it alive until the destructor
+		m_Effect = m_Device.CreateEffect(assetFile);
+
 
-		
 		// VARIABLES
 		//---------------
 
 		// Matrices
-		m_pMatWorldViewProjectionVariable = m_pEffect->GetVariableByName("gWorldViewProjection")->AsMatrix();	// WorldViewProjection
-		if (!m_pMatWorldViewProjectionVariable->IsValid())
-			std::wcout << L"m_pMatWorldViewProjectionVariable not valid!\n";
-
-		m_pMatWorldVariable = m_pEffect->GetVariableByName("gWorldMatrix")->AsMatrix();	// WorldViewProjection
-		if (!m_pMatWorldVariable->IsValid())
-			std::wcout << L"m_pMatWorldVariable not valid!\n";
-		
-
-		m_pCameraPositionVariable = m_pEffect->GetVariableByName("gCameraPosition")->AsVector();		// glossiness
-		if (!m_pCameraPositionVariable->IsValid())
-			std::wcout << L"m_pCameraPositionVariable not valid!\n";
-		
+		m_MatWorldViewProjectionVariable = FindVariable("gWorldViewProjection");	// WorldViewProjection
+		m_MatWorldVariable = FindVariable("gWorldMatrix");	// World
+
+		m_CameraPositionVariable = FindVariable("gCameraPosition");		// camera
+
 	}
 
 	Effect::~Effect() {
-		// Release resources
-		//----------------------
-
-		if (m_pCameraPositionVariable)
-			m_pCameraPositionVariable->Release();
+		// Techniques and variables belong to the effect, releasing it releases them too
+		m_Device.Destroy(m_Effect);
+	}
 
-		//Matricees
-		if (m_pMatWorldViewProjectionVariable)
-			m_pMatWorldViewProjectionVariable->Release();
-		if (m_pMatWorldVariable)
-			m_pMatWorldVariable->Release();
-		
-		//Effect
-		if (m_pEffect)
-			m_pEffect->Release();
 
-		// Do NOT release m_pDevice here; it is managed at a higher level (e.g., Renderer).
 
+	TechniqueHandle Effect::FindTechnique(const std::string& name) const
+	{
+		const TechniqueHandle technique = m_Device.GetTechnique(m_Effect, name);
+		if (!technique.IsValid())
+			std::cout << "Technique " << name << " not valid!\n";
+		return technique;
 	}
 
-
-
-	ID3DX11Effect* Effect::LoadEffect(ID3D11Device* pDevice, const std::wstring& assetFile)
+	EffectVariableHandle Effect::FindVariable(const std::string& name) const
 	{
-		HRESULT result;
-		ID3D10Blob* pErrorBlob{ nullptr };
-		ID3DX11Effect* pEffect;
-
-		DWORD shaderFlags = 0;
-
-#if defined(DEBUG) || defined(_DEBUG)
-		shaderFlags |= D3DCOMPILE_DEBUG;
-		shaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
-#endif 
-
-		result = D3DX11CompileEffectFromFile(assetFile.c_str(),
-			nullptr,
-			nullptr,
-			shaderFlags,
-			0,
-			pDevice,
-			&pEffect,
-			&pErrorBlob);
-
-		if (FAILED(result))
-		{
-			if (pErrorBlob != nullptr)
-			{
-				const char* pErrors = static_cast<char*>(pErrorBlob->GetBufferPointer());
-
-				std::wstringstream ss{};
-				for (unsigned int i = 0; i < pErrorBlob->GetBufferSize(); ++i)
-					ss << pErrors[i];
-
-				OutputDebugStringW(ss.str().c_str());
-				pErrorBlob->Release();
-				pErrorBlob = nullptr;
-
-				std::wcout << ss.str() << std::endl;
-			}
-			else
-			{
-				std::wstringstream ss;
-				ss << "EffectLoader: Failed to CreateEffectFromFile!\nPath: " << assetFile;
-				std::wcout << ss.str() << std::endl;
-				return nullptr;
-			}
-		}
-
-		return pEffect;
+		const EffectVariableHandle variable = m_Device.GetEffectVariable(m_Effect, name);
+		if (!variable.IsValid())
+			std::cout << "Variable " << name << " not valid!\n";
+		return variable;
 	}
 
 
 	// SetVariables
 	//--------------
 
-	void Effect::SetWorldViewProjectionMatrix(const Matrix& matrix)
+	void Effect::SetWorldViewProjectionMatrix(ICommandContext& context, const Matrix& matrix)
 	{
-		m_pMatWorldViewProjectionVariable->SetMatrix(reinterpret_cast<const float*> (&matrix));
+		context.SetEffectMatrix(m_MatWorldViewProjectionVariable, matrix);
 	}
-	void Effect::SetWorldMatrix(const Matrix& matrix)
+	void Effect::SetWorldMatrix(ICommandContext& context, const Matrix& matrix)
 	{
-		m_pMatWorldVariable->SetMatrix(reinterpret_cast<const float*> (&matrix));
+		context.SetEffectMatrix(m_MatWorldVariable, matrix);
 	}
 
-	void Effect::SetCameraPosition(const Vector3& position)
+	void Effect::SetCameraPosition(ICommandContext& context, const Vector3& position)
 	{
-		m_pCameraPositionVariable->SetFloatVector(reinterpret_cast<const float*>( & position));
+		context.SetEffectVector(m_CameraPositionVariable, position);
 	}
 
 }
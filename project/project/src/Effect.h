@@ -1,23 +1,38 @@
 #pragma once
 #include <iostream>
-#include "pch.h"
+#include "RenderDevice.h"
 #include "Texture.h"
+#include "FilteringMethod.h"
 
 namespace dae
 {
-	enum class FilteringMethod
+	// cbuffer cbPerFrame : register(b0) of both .fx files, bound once per frame through a ConstantBufferRing
+	struct PerFrameConstants
 	{
-		Point = 0,
-		Linear = 1,
-		Anisotropic = 2
+		static constexpr uint32_t Slot{ 0 };
+
+		Matrix viewProjection{};
+		Vector3 cameraPosition{};
+		float padding{};	// cbuffers are made of float4s
+	};
+	static_assert(sizeof(PerFrameConstants) == 80, "Has to match cbPerFrame");
+
+	// cbuffer cbPerObject : register(b1), written per draw
+	struct PerObjectConstants
+	{
+		static constexpr uint32_t Slot{ 1 };
+
+		Matrix worldViewProjection{};
+		Matrix world{};
 	};
+	static_assert(sizeof(PerObjectConstants) == 128, "Has to match cbPerObject");
 
 	class Effect
 	{
 	public:
 		// Constructor + Destructor
 		// ------
-		Effect(ID3D11Device* pDevice, const std::wstring& assetFile);		
+		Effect(IRenderDevice& device, const std::wstring& assetFile);
 		virtual ~Effect();
 
 		// Rule of 5
@@ -30,34 +45,35 @@ namespace dae
 
 		// Member Functions
 		// ------
-		static ID3DX11Effect* LoadEffect(ID3D11Device* pDevice, const std::wstring& assetFile);
+		void SetWorldViewProjectionMatrix(ICommandContext& context, const Matrix& matrix);
+		void SetWorldMatrix(ICommandContext& context, const Matrix& matrix);
 
-		void SetWorldViewProjectionMatrix(const Matrix& matrix);
-		void SetWorldMatrix(const Matrix& matrix);
-
-		void SetCameraPosition(const Vector3& position);
+		void SetCameraPosition(ICommandContext& context, const Vector3& position);
 
 		// Getter functions
-		ID3DX11Effect* GetEffect()const {
-			if(m_pEffect)
-				return m_pEffect;
-		};
-		virtual ID3DX11EffectTechnique* GetTechnique(const FilteringMethod& filteringMethod) const
+		EffectHandle GetEffect() const { return m_Effect; }
+		virtual TechniqueHandle GetTechnique(const FilteringMethod& filteringMethod) const
 		{
-			return nullptr;
+			return {};
 		};
+		// Same shading with the world matrix (and tint) read from the per instance vertex stream
+		virtual TechniqueHandle GetInstancedTechnique(const FilteringMethod& filteringMethod) const = 0;
 
 
 	protected:
-		ID3DX11Effect* m_pEffect;
-		ID3D11Device* m_pDevice;
-		
+		IRenderDevice& m_Device;
+		EffectHandle m_Effect;
+
 		//Matrices
-		ID3DX11EffectMatrixVariable* m_pMatWorldViewProjectionVariable;
-		ID3DX11EffectMatrixVariable* m_pMatWorldVariable;
+		EffectVariableHandle m_MatWorldViewProjectionVariable;
+		EffectVariableHandle m_MatWorldVariable;
+
+		EffectVariableHandle m_CameraPositionVariable;
 
-		ID3DX11EffectVectorVariable* m_pCameraPositionVariable;
+		// Lookups that report what the .fx is missing
+		TechniqueHandle FindTechnique(const std::string& name) const;
+		EffectVariableHandle FindVariable(const std::string& name) const;
 	};
 
 
-}
\ No newline at end of file
+}
@@ -8,58 +8,25 @@ namespace dae
 	public:
 		// CTOR + DTOR
 		// ------
-		EffectDefault(ID3D11Device* pDevice, const std::wstring& assetFile)
-			:Effect(pDevice,assetFile)
+		EffectDefault(IRenderDevice& device, const std::wstring& assetFile)
+			:Effect(device,assetFile)
 		{
-			// Get the technique and store it in a datamember
-			m_pTechniquePoint = m_pEffect->GetTechniqueByName("PointTechnique");
-			m_pTechniqueLinear = m_pEffect->GetTechniqueByName("LinearTechnique");
-			m_pTechniqueAnisotropic = m_pEffect->GetTechniqueByName("AnisotropicTechnique");
-			if (!m_pTechniquePoint->IsValid())
-				std::wcout << L"m_pTechniquePoint not valid\n";
-			if (!m_pTechniqueLinear->IsValid())
-				std::wcout << L"m_pTechniqueLinear not valid\n";
-			if (!m_pTechniqueAnisotropic->IsValid())
-				std::wcout << L"m_pTechniqueAnisotropic not valid\n";
+			// Get the techniques and store them in datamembers
+			m_TechniquePoint = FindTechnique("PointTechnique");
+			m_TechniqueLinear = FindTechnique("LinearTechnique");
+			m_TechniqueAnisotropic = FindTechnique("AnisotropicTechnique");
+			m_TechniquePointInstanced = FindTechnique("PointInstancedTechnique");
+			m_TechniqueLinearInstanced = FindTechnique("LinearInstancedTechnique");
+			m_TechniqueAnisotropicInstanced = FindTechnique("AnisotropicInstancedTechnique");
 
 
 			// Textures
-			m_pDiffuseMapVariable = m_pEffect->GetVariableByName("gDiffuseMap")->AsShaderResource();	// diffuse
-			if (!m_pDiffuseMapVariable->IsValid())
-				std::wcout << L"m_pDiffuseMapVariable not valid!\n";
-			m_pNormalMapVariable = m_pEffect->GetVariableByName("gNormalMap")->AsShaderResource();		// normal
-			if (!m_pNormalMapVariable->IsValid())
-				std::wcout << L"m_pNormalMapVariable not valid!\n";
-			m_pSpecularMapVariable = m_pEffect->GetVariableByName("gSpecularMap")->AsShaderResource();		// specular
-			if (!m_pSpecularMapVariable->IsValid())
-				std::wcout << L"m_pNormalMapVariable not valid!\n";
-			m_pGlossinessMapVariable = m_pEffect->GetVariableByName("gGlossinessMap")->AsShaderResource();		// glossiness
-			if (!m_pNormalMapVariable->IsValid())
-				std::wcout << L"m_pGlossinessMapVariable not valid!\n";
-		}
-		~EffectDefault()
-		{
-
-			//Textures
-			if (m_pDiffuseMapVariable)
-				m_pDiffuseMapVariable->Release();
-			if (m_pNormalMapVariable)
-				m_pNormalMapVariable->Release();
-			if (m_pSpecularMapVariable)
-				m_pSpecularMapVariable->Release();
-			if (m_pGlossinessMapVariable)
-				m_pGlossinessMapVariable->Release();
-
-
-			//Techniques
-			if (m_pTechniqueAnisotropic)
-				m_pTechniqueAnisotropic->Release();
-			if (m_pTechniqueLinear)
-				m_pTechniqueLinear->Release();
-			if (m_pTechniquePoint)
-				m_pTechniquePoint->Release();
-
+			m_DiffuseMapVariable = FindVariable("gDiffuseMap");			// diffuse
+			m_NormalMapVariable = FindVariable("gNormalMap");			// normal
+			m_SpecularMapVariable = FindVariable("gSpecularMap");		// specular
+			m_GlossinessMapVariable = FindVariable("gGlossinessMap");	// glossiness
 		}
+		~EffectDefault() = default;
 
 		// Rule of 5
 		// ------
@@ -70,53 +37,65 @@ namespace dae
 
 		// Member Functions
 		// ------
-		void SetDiffuseMap(Texture* pDiffuseTexture)
+		void SetDiffuseMap(ICommandContext& context, const Texture* pDiffuseTexture)
 		{
-			if (m_pDiffuseMapVariable)
-				m_pDiffuseMapVariable->SetResource(pDiffuseTexture->GetSRV());
+			context.SetEffectTexture(m_DiffuseMapVariable, pDiffuseTexture ? pDiffuseTexture->GetHandle() : TextureHandle{});
 		}
-		void SetNormalMap(Texture* pNormalTexture) {
-			if (m_pNormalMapVariable)
-				m_pNormalMapVariable->SetResource(pNormalTexture->GetSRV());
+		void SetNormalMap(ICommandContext& context, const Texture* pNormalTexture) {
+			context.SetEffectTexture(m_NormalMapVariable, pNormalTexture ? pNormalTexture->GetHandle() : TextureHandle{});
 		}
-		void SetSpecularMap(Texture* pSpecularTexture) {
-			if (m_pSpecularMapVariable)
-				m_pSpecularMapVariable->SetResource(pSpecularTexture->GetSRV());
+		void SetSpecularMap(ICommandContext& context, const Texture* pSpecularTexture) {
+			context.SetEffectTexture(m_SpecularMapVariable, pSpecularTexture ? pSpecularTexture->GetHandle() : TextureHandle{});
 		}
-		void SetGlossinessMap(Texture* pGlossinessTexture) {
-			if (m_pGlossinessMapVariable)
-				m_pGlossinessMapVariable->SetResource(pGlossinessTexture->GetSRV());
+		void SetGlossinessMap(ICommandContext& context, const Texture* pGlossinessTexture) {
+			context.SetEffectTexture(m_GlossinessMapVariable, pGlossinessTexture ? pGlossinessTexture->GetHandle() : TextureHandle{});
+		}
+
+		virtual TechniqueHandle GetInstancedTechnique(const FilteringMethod& filteringMethod) const override
+		{
+			switch (filteringMethod)
+			{
+			case FilteringMethod::Linear:
+				return m_TechniqueLinearInstanced;
+			case FilteringMethod::Anisotropic:
+				return m_TechniqueAnisotropicInstanced;
+			default:
+				return m_TechniquePointInstanced;
+			}
 		}
 
-		virtual ID3DX11EffectTechnique* GetTechnique(const FilteringMethod& filteringMethod) const override
+		virtual TechniqueHandle GetTechnique(const FilteringMethod& filteringMethod) const override
 		{
 			switch (filteringMethod)
 			{
 			case FilteringMethod::Point:
-				return m_pTechniquePoint;
+				return m_TechniquePoint;
 				break;
 			case FilteringMethod::Linear:
-				return m_pTechniqueLinear;
+				return m_TechniqueLinear;
 				break;
 			case FilteringMethod::Anisotropic:
-				return m_pTechniqueAnisotropic;
+				return m_TechniqueAnisotropic;
 				break;
 			default:
-				return m_pTechniquePoint;
+				return m_TechniquePoint;
 			}
 		};
 
 	private:
 		//Technique
-		ID3DX11EffectTechnique* m_pTechniquePoint;
-		ID3DX11EffectTechnique* m_pTechniqueLinear;
-		ID3DX11EffectTechnique* m_pTechniqueAnisotropic;
+		TechniqueHandle m_TechniquePoint;
+		TechniqueHandle m_TechniqueLinear;
+		TechniqueHandle m_TechniqueAnisotropic;
+		TechniqueHandle m_TechniquePointInstanced;
+		TechniqueHandle m_TechniqueLinearInstanced;
+		TechniqueHandle m_TechniqueAnisotropicInstanced;
 
 		//Textures
-		ID3DX11EffectShaderResourceVariable* m_pDiffuseMapVariable;
-		ID3DX11EffectShaderResourceVariable* m_pNormalMapVariable;
-		ID3DX11EffectShaderResourceVariable* m_pSpecularMapVariable;
-		ID3DX11EffectShaderResourceVariable* m_pGlossinessMapVariable;
+		EffectVariableHandle m_DiffuseMapVariable;
+		EffectVariableHandle m_NormalMapVariable;
+		EffectVariableHandle m_SpecularMapVariable;
+		EffectVariableHandle m_GlossinessMapVariable;
 
 	};
-}
\ No newline at end of file
+}
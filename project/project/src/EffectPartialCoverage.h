@@ -8,12 +8,11 @@ namespace dae
 	public:
 		// CTOR + DTOR
 		// ------
-		EffectPartialCoverage(ID3D11Device* pDevice, const std::wstring& assetFile)
-			: Effect(pDevice,assetFile)
+		EffectPartialCoverage(IRenderDevice& device, const std::wstring& assetFile)
+			: Effect(device,assetFile)
 		{
-			m_pTechnique = m_pEffect->GetTechniqueByName("DefaultTechnique");
-			if (!m_pTechnique->IsValid())
-				std::wcout << L"m_pTechnique not valid\n";
+			m_Technique = FindTechnique("DefaultTechnique");
+			m_InstancedTechnique = FindTechnique("InstancedTechnique");
 
 
 
@@ -21,19 +20,9 @@ namespace dae
 			//---------------
 		
 			// Initialize only resources specific to EffectPartialCoverage
-			m_pDiffuseMapVariable = m_pEffect->GetVariableByName("gDiffuseMap")->AsShaderResource();
-			if (!m_pDiffuseMapVariable->IsValid())
-				std::wcout << L"m_pDiffuseMapVariable not valid!\n";
-		}
-		~EffectPartialCoverage()
-		{
-			if (m_pTechnique)
-				m_pTechnique->Release();
-
-			if (m_pDiffuseMapVariable)
-				m_pDiffuseMapVariable->Release();
-
+			m_DiffuseMapVariable = FindVariable("gDiffuseMap");
 		}
+		~EffectPartialCoverage() = default;
 
 		// Rule of 5
 		// ------
@@ -44,21 +33,27 @@ namespace dae
 
 		// MemberFunctiuons
 		// ------
-		void SetDiffuseMap(Texture* pDiffuseTexture)
+		void SetDiffuseMap(ICommandContext& context, const Texture* pDiffuseTexture)
 		{
-			if (m_pDiffuseMapVariable)
-				m_pDiffuseMapVariable->SetResource(pDiffuseTexture->GetSRV());
+			context.SetEffectTexture(m_DiffuseMapVariable, pDiffuseTexture ? pDiffuseTexture->GetHandle() : TextureHandle{});
 		}
 
-		virtual ID3DX11EffectTechnique* GetTechnique(const FilteringMethod& filteringMethod) const override
+		virtual TechniqueHandle GetTechnique(const FilteringMethod& filteringMethod) const override
+		{
+			return m_Technique;
+		};
+
+		// Unlit, the instance tint is not used
+		virtual TechniqueHandle GetInstancedTechnique(const FilteringMethod&) const override
 		{
-			return m_pTechnique;
+			return m_InstancedTechnique;
 		};
 
 	private:
 		//Textures
-		ID3DX11EffectShaderResourceVariable* m_pDiffuseMapVariable;
+		EffectVariableHandle m_DiffuseMapVariable;
 
-		ID3DX11EffectTechnique* m_pTechnique;
+		TechniqueHandle m_Technique;
+		TechniqueHandle m_InstancedTechnique;
 	};
-}
\ No newline at end of file
+}
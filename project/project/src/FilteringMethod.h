@@ -0,0 +1,12 @@
+#pragma once
+
+namespace dae
+{
+	// Matches the samPoint/samLinear/samAnisotropic techniques in PosCol3D.fx
+	enum class FilteringMethod
+	{
+		Point = 0,
+		Linear = 1,
+		Anisotropic = 2
+	};
+}
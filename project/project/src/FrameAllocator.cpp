@@ -0,0 +1,83 @@
+#include "FrameAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace dae
+{
+	FrameAllocator::FrameAllocator(uint32_t numFrames, size_t frameCapacity)
+		: m_FrameCapacity{ frameCapacity }
+	{
+		assert(numFrames > 0);
+		m_Arenas.reserve(numFrames);
+		for (uint32_t frame{ 0 }; frame < numFrames; ++frame)
+			m_Arenas.push_back(std::make_unique<LinearArena>(frameCapacity));
+#if DAE_FRAME_ALLOCATOR_CHECKS
+		m_LastGuards.assign(numFrames, nullptr);
+#endif
+	}
+
+	void FrameAllocator::BeginFrame()
+	{
+		FinishFrame();
+
+		m_ArenaIndex = (m_ArenaIndex + 1) % GetNumFrames();
+		++m_FrameIndex;
+
+		// Whoever wrote past an allocation did so within the frames it stayed valid for
+		assert(CountCorruptedGuards(m_ArenaIndex) == 0 && "Frame allocation overflowed its size");
+		m_Arenas[m_ArenaIndex]->Reset();
+#if DAE_FRAME_ALLOCATOR_CHECKS
+		m_LastGuards[m_ArenaIndex] = nullptr;
+#endif
+	}
+
+	void* FrameAllocator::Allocate(size_t size, size_t alignment)
+	{
+		LinearArena& arena = *m_Arenas[m_ArenaIndex];
+#if DAE_FRAME_ALLOCATOR_CHECKS
+		std::byte* pData = static_cast<std::byte*>(arena.Allocate(size + s_GuardSize, alignment));
+		std::memset(pData + size, static_cast<int>(s_GuardByte), s_GuardSize);
+
+		Guard* pGuard = static_cast<Guard*>(arena.Allocate(sizeof(Guard), alignof(Guard)));
+		*pGuard = { pData + size, m_LastGuards[m_ArenaIndex] };
+		m_LastGuards[m_ArenaIndex] = pGuard;
+		return pData;
+#else
+		return arena.Allocate(size, alignment);
+#endif
+	}
+
+	size_t FrameAllocator::GetHighWatermark() const
+	{
+		return std::max(m_HighWatermark, GetUsedSize());
+	}
+
+	uint32_t FrameAllocator::CountCorruptedGuards() const
+	{
+		return CountCorruptedGuards(m_ArenaIndex);
+	}
+
+	void FrameAllocator::FinishFrame()
+	{
+		assert(CountCorruptedGuards(m_ArenaIndex) == 0 && "Frame allocation overflowed its size");
+
+		const size_t usedSize = GetUsedSize();
+		m_HighWatermark = std::max(m_HighWatermark, usedSize);
+		if (usedSize > m_FrameCapacity)
+			++m_NumOverflows;
+	}
+
+	uint32_t FrameAllocator::CountCorruptedGuards(uint32_t arenaIndex) const
+	{
+		uint32_t numCorrupted{};
+#if DAE_FRAME_ALLOCATOR_CHECKS
+		for (const Guard* pGuard = m_LastGuards[arenaIndex]; pGuard; pGuard = pGuard->pPrevious)
+			numCorrupted += std::any_of(pGuard->pBytes, pGuard->pBytes + s_GuardSize, [](std::byte value) { return value != s_GuardByte; });
+#else
+		(void)arenaIndex;
+#endif
+		return numCorrupted;
+	}
+}
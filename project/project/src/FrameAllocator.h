@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "LinearArena.h"
+
+// Guard bytes behind every allocation, checked when a frame's memory is reused (on in debug builds)
+#if !defined(DAE_FRAME_ALLOCATOR_CHECKS)
+#if defined(NDEBUG)
+#define DAE_FRAME_ALLOCATOR_CHECKS 0
+#else
+#define DAE_FRAME_ALLOCATOR_CHECKS 1
+#endif
+#endif
+
+namespace dae
+{
+	// Transient per frame memory: one LinearArena per frame in flight, BeginFrame moves on to the next and
+	// resets it. What was allocated in a frame stays valid for numFrames - 1 more BeginFrames, so a render
+	// thread or the GPU can still read the last frame's data while the next one is built.
+	// Arenas keep their memory, so once the frames stopped growing nothing touches the heap anymore.
+	// frameCapacity is the expected size of a frame: frames going over it still work (the arena grows) but
+	// are counted as overflows. Not thread safe, like LinearArena
+	class FrameAllocator final
+	{
+	public:
+		explicit FrameAllocator(uint32_t numFrames = 2, size_t frameCapacity = size_t{ 1 } << 20);
+		~FrameAllocator() = default;
+
+		FrameAllocator(const FrameAllocator&) = delete;
+		FrameAllocator(FrameAllocator&&) noexcept = delete;
+		FrameAllocator& operator=(const FrameAllocator&) = delete;
+		FrameAllocator& operator=(FrameAllocator&&) noexcept = delete;
+
+		// Reuses the memory of the frame numFrames back
+		void BeginFrame();
+
+		void* Allocate(size_t size, size_t alignment);
+
+		// Default constructed (trivial types are left uninitialized), destructors never run
+		template<typename T>
+		std::span<T> AllocateSpan(size_t count)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "Frame memory is reused without running destructors");
+			T* pData = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+			std::uninitialized_default_construct_n(pData, count);
+			return { pData, count };
+		}
+
+		template<typename T>
+		std::span<T> AllocateCopy(std::span<const T> source)
+		{
+			static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "Copied as bytes and never destroyed");
+			T* pData = static_cast<T*>(Allocate(sizeof(T) * source.size(), alignof(T)));
+			std::uninitialized_copy(source.begin(), source.end(), pData);
+			return { pData, source.size() };
+		}
+
+		uint32_t GetNumFrames() const { return static_cast<uint32_t>(m_Arenas.size()); }
+		uint64_t GetFrameIndex() const { return m_FrameIndex; }
+
+		// Current frame
+		size_t GetUsedSize() const { return m_Arenas[m_ArenaIndex]->GetUsedSize(); }
+		// Largest frame so far, including the current one
+		size_t GetHighWatermark() const;
+		// Frames that needed more than frameCapacity
+		uint32_t GetNumOverflows() const { return m_NumOverflows; }
+		size_t GetFrameCapacity() const { return m_FrameCapacity; }
+
+		// Allocations of the current frame whose guard bytes were written over. Always 0 without checks
+		uint32_t CountCorruptedGuards() const;
+
+	private:
+#if DAE_FRAME_ALLOCATOR_CHECKS
+		static constexpr size_t s_GuardSize{ 16 };
+		static constexpr std::byte s_GuardByte{ 0xFD };
+
+		// Stored in the arena behind the guard bytes, a list per frame
+		struct Guard
+		{
+			const std::byte* pBytes;
+			const Guard* pPrevious;
+		};
+		std::vector<const Guard*> m_LastGuards{};	// per arena
+#endif
+
+		std::vector<std::unique_ptr<LinearArena>> m_Arenas{};
+		uint32_t m_ArenaIndex{ 0 };
+		uint64_t m_FrameIndex{ 0 };
+		size_t m_FrameCapacity;
+		size_t m_HighWatermark{ 0 };	// of the finished frames
+		uint32_t m_NumOverflows{ 0 };
+
+		void FinishFrame();
+		uint32_t CountCorruptedGuards(uint32_t arenaIndex) const;
+	};
+}
@@ -0,0 +1,399 @@
+#include "FrameGraph.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dae
+{
+	static bool IsOutput(ResourceState state)
+	{
+		return state == ResourceState::RenderTarget || state == ResourceState::DepthWrite;
+	}
+
+	static bool IsDepth(ResourceState state)
+	{
+		return state == ResourceState::DepthWrite || state == ResourceState::DepthRead;
+	}
+
+	static bool IsSameDesc(const TextureDesc& a, const TextureDesc& b)
+	{
+		return a.width == b.width && a.height == b.height && a.format == b.format
+			&& a.isShaderResource == b.isShaderResource && a.isRenderTarget == b.isRenderTarget && a.isDepthStencil == b.isDepthStencil;
+	}
+
+	FrameGraph::FrameGraph(IRenderDevice& device)
+		: m_Device{ device }
+	{
+	}
+
+	FrameGraph::~FrameGraph()
+	{
+		for (const PooledTexture& pooled : m_Pool)
+			m_Device.Destroy(pooled.texture);
+	}
+
+	FrameGraph::ResourceId FrameGraph::CreateTexture(std::string name, const TextureDesc& desc)
+	{
+		Resource resource{};
+		resource.name = std::move(name);
+		resource.desc = { desc.width, desc.height, desc.format, false, false, false };
+		m_Resources.push_back(std::move(resource));
+		return static_cast<ResourceId>(m_Resources.size() - 1);
+	}
+
+	FrameGraph::ResourceId FrameGraph::ImportTexture(std::string name, TextureHandle texture, const TextureDesc& desc, ResourceState state)
+	{
+		assert(texture.IsValid());
+		Resource resource{};
+		resource.name = std::move(name);
+		resource.desc = desc;
+		resource.isImported = true;
+		resource.texture = texture;
+		resource.importedState = state;
+		m_Resources.push_back(std::move(resource));
+		return static_cast<ResourceId>(m_Resources.size() - 1);
+	}
+
+	uint32_t FrameGraph::BeginPass(std::string name, ExecuteFunction execute)
+	{
+		Pass pass{};
+		pass.name = std::move(name);
+		pass.execute = std::move(execute);
+		m_Passes.push_back(std::move(pass));
+		return static_cast<uint32_t>(m_Passes.size() - 1);
+	}
+
+	void FrameGraph::AddAccess(uint32_t pass, ResourceId resource, ResourceState state, bool isCleared, const ColorRGB& clearColor, float clearDepth)
+	{
+		assert(resource < m_Resources.size());
+		std::vector<Access>& accesses = m_Passes[pass].accesses;
+		assert(std::none_of(accesses.begin(), accesses.end(), [&](const Access& access) { return access.resource == resource; })
+			&& "A pass accesses a resource once");
+		assert(IsDepth(state) == (m_Resources[resource].desc.format == Format::D24_UNorm_S8_UInt) && "Depth formats are only used as depth buffers");
+
+		// Transients get the usage of every access, whatever pass ends up using them
+		TextureDesc& desc = m_Resources[resource].desc;
+		if (!m_Resources[resource].isImported)
+		{
+			desc.isShaderResource |= state == ResourceState::ShaderResource;
+			desc.isRenderTarget |= state == ResourceState::RenderTarget;
+			desc.isDepthStencil |= IsDepth(state);
+		}
+		accesses.push_back({ resource, state, isCleared, clearColor, clearDepth });
+	}
+
+	void FrameGraph::Reset()
+	{
+		m_Resources.clear();
+		m_Passes.clear();
+		m_Slots.clear();
+		m_Barriers.clear();
+		m_FirstFinalBarrier = 0;
+		m_Stats = {};
+	}
+
+	void FrameGraph::Compile()
+	{
+		m_Stats = {};
+		m_Stats.numPasses = static_cast<uint32_t>(m_Passes.size());
+
+		CullPasses();
+		ComputeLifetimes();
+		AssignSlots();
+		AcquireTextures();
+		AddBarriers();
+		GatherTargets();
+	}
+
+	void FrameGraph::CullPasses()
+	{
+		// A pass lives while something reads one of its outputs, imported resources count as read by the frame.
+		// Starting from the resources nobody reads, take their producers' references away and cull the passes
+		// that are left without any, which can leave their inputs unread in turn
+		for (Resource& resource : m_Resources)
+		{
+			resource.refCount = resource.isImported ? 1 : 0;
+			resource.producers.clear();
+		}
+		for (uint32_t pass{ 0 }; pass < m_Passes.size(); ++pass)
+		{
+			m_Passes[pass].refCount = 0;
+			m_Passes[pass].isCulled = false;
+			for (const Access& access : m_Passes[pass].accesses)
+			{
+				if (IsOutput(access.state))
+				{
+					++m_Passes[pass].refCount;
+					m_Resources[access.resource].producers.push_back(pass);
+				}
+				else
+				{
+					++m_Resources[access.resource].refCount;
+				}
+			}
+		}
+
+		std::vector<ResourceId> unread{};
+		for (ResourceId resource{ 0 }; resource < m_Resources.size(); ++resource)
+			if (m_Resources[resource].refCount == 0)
+				unread.push_back(resource);
+
+		const auto cull = [&](Pass& pass)
+			{
+				pass.isCulled = true;
+				++m_Stats.numCulledPasses;
+				for (const Access& access : pass.accesses)
+					if (!IsOutput(access.state) && --m_Resources[access.resource].refCount == 0)
+						unread.push_back(access.resource);
+			};
+
+		// Passes without outputs have no effect
+		for (Pass& pass : m_Passes)
+			if (pass.refCount == 0)
+				cull(pass);
+
+		while (!unread.empty())
+		{
+			const ResourceId resource = unread.back();
+			unread.pop_back();
+			for (uint32_t producer : m_Resources[resource].producers)
+			{
+				Pass& pass = m_Passes[producer];
+				if (!pass.isCulled && --pass.refCount == 0)
+					cull(pass);
+			}
+		}
+	}
+
+	void FrameGraph::ComputeLifetimes()
+	{
+		for (Resource& resource : m_Resources)
+		{
+			resource.isUsed = false;
+			resource.lifetime = {};
+		}
+
+		for (uint32_t pass{ 0 }; pass < m_Passes.size(); ++pass)
+		{
+			if (m_Passes[pass].isCulled)
+				continue;
+
+			for (const Access& access : m_Passes[pass].accesses)
+			{
+				Resource& resource = m_Resources[access.resource];
+				if (!resource.isUsed)
+					resource.lifetime.firstPass = pass;
+				resource.lifetime.lastPass = pass;
+				resource.isUsed = true;
+			}
+		}
+	}
+
+	void FrameGraph::AssignSlots()
+	{
+		// Interval partitioning per size and format: in order of their first pass, every transient goes into the
+		// first slot whose last user is done before it starts. Uses as few textures as there are overlapping
+		// lifetimes, the slot's usage is what all of its transients need
+		std::vector<ResourceId> transients{};
+		for (ResourceId resource{ 0 }; resource < m_Resources.size(); ++resource)
+		{
+			m_Resources[resource].slot = s_NoSlot;
+			if (!m_Resources[resource].isImported && m_Resources[resource].isUsed)
+				transients.push_back(resource);
+		}
+		std::stable_sort(transients.begin(), transients.end(), [&](ResourceId a, ResourceId b)
+			{
+				return m_Resources[a].lifetime.firstPass < m_Resources[b].lifetime.firstPass;
+			});
+
+		m_Slots.clear();
+		for (ResourceId id : transients)
+		{
+			Resource& resource = m_Resources[id];
+			const auto slot = std::find_if(m_Slots.begin(), m_Slots.end(), [&](const Slot& candidate)
+				{
+					return candidate.desc.width == resource.desc.width && candidate.desc.height == resource.desc.height
+						&& candidate.desc.format == resource.desc.format && candidate.lastPass < resource.lifetime.firstPass;
+				});
+
+			if (slot == m_Slots.end())
+			{
+				resource.slot = static_cast<uint32_t>(m_Slots.size());
+				m_Slots.push_back({ resource.desc, resource.lifetime.lastPass });
+			}
+			else
+			{
+				resource.slot = static_cast<uint32_t>(slot - m_Slots.begin());
+				slot->lastPass = resource.lifetime.lastPass;
+				slot->desc.isShaderResource |= resource.desc.isShaderResource;
+				slot->desc.isRenderTarget |= resource.desc.isRenderTarget;
+				slot->desc.isDepthStencil |= resource.desc.isDepthStencil;
+			}
+
+			++m_Stats.numTransientTextures;
+			m_Stats.transientBytes += GetByteSize(resource.desc);
+		}
+
+		m_Stats.numTextures = static_cast<uint32_t>(m_Slots.size());
+		for (const Slot& slot : m_Slots)
+			m_Stats.textureBytes += GetByteSize(slot.desc);
+	}
+
+	void FrameGraph::AcquireTextures()
+	{
+		// Textures from the last compile with the same description are taken over, the ones left are destroyed
+		std::vector<PooledTexture> pool{};
+		pool.swap(m_Pool);
+
+		for (Slot& slot : m_Slots)
+		{
+			const auto pooled = std::find_if(pool.begin(), pool.end(), [&](const PooledTexture& texture) { return IsSameDesc(texture.desc, slot.desc); });
+			if (pooled != pool.end())
+			{
+				slot.texture = pooled->texture;
+				pool.erase(pooled);
+			}
+			else
+			{
+				slot.texture = m_Device.CreateTexture(slot.desc, nullptr, 0);
+				++m_Stats.numCreatedTextures;
+			}
+			m_Pool.push_back({ slot.desc, slot.texture });
+		}
+
+		for (const PooledTexture& unused : pool)
+			m_Device.Destroy(unused.texture);
+	}
+
+	void FrameGraph::AddBarriers()
+	{
+		// Frames repeat, so a slot starts a frame in the state it ended the last one in: find that first
+		for (Slot& slot : m_Slots)
+			slot.state = ResourceState::Undefined;
+		for (const Pass& pass : m_Passes)
+		{
+			if (pass.isCulled)
+				continue;
+			for (const Access& access : pass.accesses)
+				if (m_Resources[access.resource].slot != s_NoSlot)
+					m_Slots[m_Resources[access.resource].slot].state = access.state;
+		}
+
+		std::vector<ResourceState> importedStates(m_Resources.size());
+		for (ResourceId resource{ 0 }; resource < m_Resources.size(); ++resource)
+			importedStates[resource] = m_Resources[resource].importedState;
+
+		m_Barriers.clear();
+		for (uint32_t passIndex{ 0 }; passIndex < m_Passes.size(); ++passIndex)
+		{
+			Pass& pass = m_Passes[passIndex];
+			pass.firstBarrier = static_cast<uint32_t>(m_Barriers.size());
+			if (!pass.isCulled)
+			{
+				for (const Access& access : pass.accesses)
+				{
+					const Resource& resource = m_Resources[access.resource];
+					ResourceState& state = resource.isImported ? importedStates[access.resource] : m_Slots[resource.slot].state;
+					if (state == access.state)
+						continue;
+					m_Barriers.push_back({ passIndex, access.resource, GetTexture(access.resource), state, access.state });
+					state = access.state;
+				}
+			}
+			pass.numBarriers = static_cast<uint32_t>(m_Barriers.size()) - pass.firstBarrier;
+		}
+
+		// Imported textures leave the frame the way they came in
+		m_FirstFinalBarrier = static_cast<uint32_t>(m_Barriers.size());
+		for (ResourceId id{ 0 }; id < m_Resources.size(); ++id)
+		{
+			const Resource& resource = m_Resources[id];
+			if (resource.isImported && resource.isUsed && importedStates[id] != resource.importedState)
+				m_Barriers.push_back({ static_cast<uint32_t>(m_Passes.size()), id, resource.texture, importedStates[id], resource.importedState });
+		}
+		m_Stats.numBarriers = static_cast<uint32_t>(m_Barriers.size());
+	}
+
+	void FrameGraph::GatherTargets()
+	{
+		for (Pass& pass : m_Passes)
+		{
+			pass.colorTargets.clear();
+			pass.depthTarget = {};
+			pass.isClearingColor = false;
+			pass.isClearingDepth = false;
+			if (pass.isCulled)
+				continue;
+
+			uint32_t numClearedColorTargets{ 0 };
+			for (const Access& access : pass.accesses)
+			{
+				if (access.state == ResourceState::RenderTarget)
+				{
+					pass.colorTargets.push_back(GetTexture(access.resource));
+					if (access.isCleared)
+					{
+						++numClearedColorTargets;
+						pass.clearColor = access.clearColor;
+					}
+				}
+				else if (IsDepth(access.state))
+				{
+					assert(!pass.depthTarget.IsValid() && "A pass has one depth buffer");
+					pass.depthTarget = GetTexture(access.resource);
+					pass.isClearingDepth = access.isCleared;
+					pass.clearDepth = access.clearDepth;
+				}
+			}
+			assert((numClearedColorTargets == 0 || numClearedColorTargets == pass.colorTargets.size()) && "ClearRenderTarget clears every bound target");
+			pass.isClearingColor = numClearedColorTargets > 0;
+		}
+	}
+
+	void FrameGraph::Execute(ICommandContext& context) const
+	{
+		for (const Pass& pass : m_Passes)
+		{
+			if (pass.isCulled)
+				continue;
+
+			for (uint32_t barrier{ pass.firstBarrier }; barrier < pass.firstBarrier + pass.numBarriers; ++barrier)
+				context.Transition(m_Barriers[barrier].texture, m_Barriers[barrier].before, m_Barriers[barrier].after);
+
+			if (!pass.colorTargets.empty() || pass.depthTarget.IsValid())
+				context.SetRenderTargets(pass.colorTargets, pass.depthTarget);
+			if (pass.isClearingColor)
+				context.ClearRenderTarget(pass.clearColor);
+			if (pass.isClearingDepth)
+				context.ClearDepthStencil(pass.clearDepth, 0);
+
+			if (pass.execute)
+				pass.execute(context, *this);
+		}
+
+		for (uint32_t barrier{ m_FirstFinalBarrier }; barrier < m_Barriers.size(); ++barrier)
+			context.Transition(m_Barriers[barrier].texture, m_Barriers[barrier].before, m_Barriers[barrier].after);
+	}
+
+	TextureHandle FrameGraph::GetTexture(ResourceId resource) const
+	{
+		const Resource& graphResource = m_Resources[resource];
+		if (graphResource.isImported)
+			return graphResource.texture;
+		return graphResource.slot != s_NoSlot ? m_Slots[graphResource.slot].texture : TextureHandle{};
+	}
+
+	uint64_t FrameGraph::GetByteSize(const TextureDesc& desc)
+	{
+		uint64_t bytesPerTexel{ 4 };
+		switch (desc.format)
+		{
+		case Format::R32G32B32A32_Float:	bytesPerTexel = 16; break;
+		case Format::R32G32B32_Float:		bytesPerTexel = 12; break;
+		case Format::R32G32_Float:
+		case Format::R16G16B16A16_Float:	bytesPerTexel = 8; break;
+		default:							break;
+		}
+		return uint64_t(desc.width) * desc.height * bytesPerTexel;
+	}
+}
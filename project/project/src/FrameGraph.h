@@ -0,0 +1,202 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+#include "RenderDevice.h"
+
+namespace dae
+{
+	// A frame as passes that declare which textures they read and write instead of binding and clearing by hand.
+	// Compile culls the passes that nothing imported (the back buffer) depends on, gives every transient texture
+	// a lifetime from the first to the last pass using it, lets transients of the same size and format whose
+	// lifetimes don't overlap share one texture and works out the state transitions between the passes.
+	// Execute replays the surviving passes in the order they were added.
+	// Build the graph once and compile it again when the passes change: the textures are pooled across compiles,
+	// compiling the same graph twice creates nothing. Executing allocates nothing
+	class FrameGraph final
+	{
+	public:
+		using ResourceId = uint32_t;
+		static constexpr ResourceId InvalidResource{ ~0u };
+
+		using ExecuteFunction = std::function<void(ICommandContext& context, const FrameGraph& graph)>;
+
+		// Handed to a pass's setup to declare its accesses. Render targets are bound in the order they are
+		// written, a pass clears all of its color targets or none
+		class PassBuilder final
+		{
+		public:
+			void ReadTexture(ResourceId resource) { m_Graph.AddAccess(m_Pass, resource, ResourceState::ShaderResource); }
+			// Depth tested but not written, bound as the pass's depth buffer
+			void ReadDepth(ResourceId resource) { m_Graph.AddAccess(m_Pass, resource, ResourceState::DepthRead); }
+			void WriteRenderTarget(ResourceId resource) { m_Graph.AddAccess(m_Pass, resource, ResourceState::RenderTarget); }
+			void WriteDepth(ResourceId resource) { m_Graph.AddAccess(m_Pass, resource, ResourceState::DepthWrite); }
+			// Write that starts with a clear, before the pass's execute function runs
+			void ClearRenderTarget(ResourceId resource, const ColorRGB& color) { m_Graph.AddAccess(m_Pass, resource, ResourceState::RenderTarget, true, color); }
+			void ClearDepth(ResourceId resource, float depth) { m_Graph.AddAccess(m_Pass, resource, ResourceState::DepthWrite, true, {}, depth); }
+
+		private:
+			friend class FrameGraph;
+			PassBuilder(FrameGraph& graph, uint32_t pass) : m_Graph{ graph }, m_Pass{ pass } {}
+
+			FrameGraph& m_Graph;
+			uint32_t m_Pass;
+		};
+
+		// Passes from the first to the last one (of the ones that are not culled) using a resource
+		struct Lifetime
+		{
+			uint32_t firstPass{};
+			uint32_t lastPass{};
+		};
+
+		struct Barrier
+		{
+			uint32_t pass{};	// executed before this pass, the number of passes for the ones at the end of the frame
+			ResourceId resource{};
+			TextureHandle texture{};
+			ResourceState before{};
+			ResourceState after{};
+		};
+
+		// Of the last Compile
+		struct Stats
+		{
+			uint32_t numPasses{};
+			uint32_t numCulledPasses{};
+			uint32_t numTransientTextures{};	// used by a pass that is not culled
+			uint32_t numTextures{};	// the transients after aliasing
+			uint32_t numCreatedTextures{};	// not found in the pool
+			uint32_t numBarriers{};
+			uint64_t transientBytes{};	// every transient in a texture of its own
+			uint64_t textureBytes{};
+
+			uint64_t GetSavedBytes() const { return transientBytes - textureBytes; }
+		};
+
+		explicit FrameGraph(IRenderDevice& device);
+		~FrameGraph();
+
+		FrameGraph(const FrameGraph&) = delete;
+		FrameGraph(FrameGraph&&) noexcept = delete;
+		FrameGraph& operator=(const FrameGraph&) = delete;
+		FrameGraph& operator=(FrameGraph&&) noexcept = delete;
+
+		// Texture created by the graph and only valid during the frame. Width, height and format come from desc,
+		// its usage flags are ignored: they follow from how the passes access the texture
+		ResourceId CreateTexture(std::string name, const TextureDesc& desc);
+		// Texture owned by someone else, in state before and after the frame. Writing it keeps a pass alive
+		ResourceId ImportTexture(std::string name, TextureHandle texture, const TextureDesc& desc, ResourceState state);
+
+		// setup(PassBuilder&) declares the accesses right away, execute records the pass when the graph runs
+		template<typename Setup>
+		uint32_t AddPass(std::string name, Setup&& setup, ExecuteFunction execute)
+		{
+			const uint32_t pass = BeginPass(std::move(name), std::move(execute));
+			PassBuilder builder{ *this, pass };
+			setup(builder);
+			return pass;
+		}
+
+		// Forget passes and resources, pooled textures are kept for the next Compile
+		void Reset();
+		void Compile();
+		void Execute(ICommandContext& context) const;
+
+		// The texture behind a resource, transients only after Compile
+		TextureHandle GetTexture(ResourceId resource) const;
+		Lifetime GetLifetime(ResourceId resource) const { return m_Resources[resource].lifetime; }
+		bool IsCulled(uint32_t pass) const { return m_Passes[pass].isCulled; }
+		const std::string& GetPassName(uint32_t pass) const { return m_Passes[pass].name; }
+		std::span<const Barrier> GetBarriers() const { return m_Barriers; }
+		const Stats& GetStats() const { return m_Stats; }
+
+		static uint64_t GetByteSize(const TextureDesc& desc);
+
+	private:
+		static constexpr uint32_t s_NoSlot{ ~0u };
+
+		struct Access
+		{
+			ResourceId resource{};
+			ResourceState state{};
+			bool isCleared{ false };
+			ColorRGB clearColor{};
+			float clearDepth{ 1.f };
+		};
+
+		struct Resource
+		{
+			std::string name{};
+			TextureDesc desc{};
+			bool isImported{ false };
+			TextureHandle texture{};	// imported only
+			ResourceState importedState{ ResourceState::Undefined };
+
+			// Compile
+			uint32_t refCount{};
+			std::vector<uint32_t> producers{};
+			Lifetime lifetime{};
+			bool isUsed{ false };
+			uint32_t slot{ s_NoSlot };
+		};
+
+		struct Pass
+		{
+			std::string name{};
+			ExecuteFunction execute{};
+			std::vector<Access> accesses{};
+
+			// Compile
+			uint32_t refCount{};
+			bool isCulled{ false };
+			uint32_t firstBarrier{};
+			uint32_t numBarriers{};
+			std::vector<TextureHandle> colorTargets{};
+			TextureHandle depthTarget{};
+			bool isClearingColor{ false };
+			ColorRGB clearColor{};
+			bool isClearingDepth{ false };
+			float clearDepth{ 1.f };
+		};
+
+		// Texture shared by transients with disjoint lifetimes
+		struct Slot
+		{
+			TextureDesc desc{};
+			uint32_t lastPass{};
+			TextureHandle texture{};
+			ResourceState state{ ResourceState::Undefined };
+		};
+
+		struct PooledTexture
+		{
+			TextureDesc desc{};
+			TextureHandle texture{};
+		};
+
+		IRenderDevice& m_Device;
+		std::vector<Resource> m_Resources{};
+		std::vector<Pass> m_Passes{};
+
+		// Compile
+		std::vector<Slot> m_Slots{};
+		std::vector<Barrier> m_Barriers{};
+		uint32_t m_FirstFinalBarrier{};
+		Stats m_Stats{};
+
+		std::vector<PooledTexture> m_Pool{};
+
+		uint32_t BeginPass(std::string name, ExecuteFunction execute);
+		void AddAccess(uint32_t pass, ResourceId resource, ResourceState state, bool isCleared = false, const ColorRGB& clearColor = {}, float clearDepth = 1.f);
+
+		void CullPasses();
+		void ComputeLifetimes();
+		void AssignSlots();
+		void AcquireTextures();
+		void AddBarriers();
+		void GatherTargets();
+	};
+}
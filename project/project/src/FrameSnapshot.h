@@ -0,0 +1,58 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "Math.h"
+#include "FilteringMethod.h"
+
+namespace dae
+{
+	// Everything the render side needs from one simulated frame. Written by the simulation, handed over through
+	// a TripleBuffer and never changed once published, so the render thread reads it without locks
+	struct FrameSnapshot
+	{
+		uint64_t frameIndex{};	// 0 = nothing simulated yet
+		std::chrono::steady_clock::time_point inputTime{};	// when the simulation sampled the input for this frame
+
+		Matrix viewMatrix{};
+		Matrix projectionMatrix{};
+		Vector3 cameraPosition{};
+		float farPlane{};
+
+		Matrix vehicleWorldMatrix{};
+		std::vector<Matrix> parkingLotWorldMatrices{};	// empty when the parking lot is hidden
+		FilteringMethod filteringMethod{};
+	};
+
+	// Input-to-submit latency of the snapshots a render loop submitted
+	struct FrameLatencyStats
+	{
+		uint32_t numFrames{};
+		uint32_t numRepeatedFrames{};	// submitted again because no newer snapshot was published
+		uint32_t numSkippedSnapshots{};	// published but overwritten before the render side got to them
+		float lastMs{};
+		float maxMs{};
+		double totalMs{};
+
+		float GetAverageMs() const { return numFrames > 0 ? static_cast<float>(totalMs / numFrames) : 0.f; }
+
+		// Call once the frame's draws are recorded. isNew is what TripleBuffer::Acquire returned, previousFrameIndex
+		// the snapshot submitted before this one
+		void Record(const FrameSnapshot& snapshot, bool isNew, uint64_t previousFrameIndex, std::chrono::steady_clock::time_point submitTime)
+		{
+			if (!isNew)
+			{
+				++numRepeatedFrames;
+				return;
+			}
+
+			lastMs = std::chrono::duration<float, std::milli>(submitTime - snapshot.inputTime).count();
+			maxMs = std::max(maxMs, lastMs);
+			totalMs += lastMs;
+			++numFrames;
+			if (previousFrameIndex != 0)
+				numSkippedSnapshots += static_cast<uint32_t>(snapshot.frameIndex - previousFrameIndex - 1);
+		}
+	};
+}
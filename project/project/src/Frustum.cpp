@@ -0,0 +1,183 @@
+#include "Frustum.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "JobSystem.h"
+#include "Simd.h"
+
+namespace dae
+{
+	Frustum::Frustum(const Matrix& viewProjection)
+	{
+		// Row vectors: clip = p * M, so every clip component is p dotted with a column of M.
+		// D3D clip volume: -w <= x <= w, -w <= y <= w, 0 <= z <= w (Gribb/Hartmann)
+		Vector4 columns[4]{};
+		for (int c{ 0 }; c < 4; ++c)
+			columns[c] = { viewProjection[0][c], viewProjection[1][c], viewProjection[2][c], viewProjection[3][c] };
+
+		const Vector4 planes[PlaneIndex::Count]
+		{
+			columns[3] + columns[0],	// left
+			columns[3] - columns[0],	// right
+			columns[3] + columns[1],	// bottom
+			columns[3] - columns[1],	// top
+			columns[2],					// near
+			columns[3] - columns[2]		// far
+		};
+
+		for (int i{ 0 }; i < PlaneIndex::Count; ++i)
+		{
+			const Vector3 normal = planes[i].GetXYZ();
+			const float invLength = 1.f / normal.Magnitude();
+			m_Planes[i].normal = normal * invLength;
+			m_Planes[i].distance = planes[i].w * invLength;
+		}
+	}
+
+	bool Frustum::IsVisible(const AABB& box) const
+	{
+		for (const Plane& plane : m_Planes)
+		{
+			const float radius =
+				std::abs(plane.normal.x) * box.extents.x +
+				std::abs(plane.normal.y) * box.extents.y +
+				std::abs(plane.normal.z) * box.extents.z;
+
+			if (plane.GetSignedDistance(box.center) + radius < 0.f)
+				return false;
+		}
+		return true;
+	}
+
+	bool Frustum::IsVisible(const Sphere& sphere) const
+	{
+		for (const Plane& plane : m_Planes)
+		{
+			if (plane.GetSignedDistance(sphere.center) + sphere.radius < 0.f)
+				return false;
+		}
+		return true;
+	}
+
+	using namespace Simd;
+
+	void Frustum::Cull(const AABBBatch& boxes, uint64_t* pVisibleMask, size_t begin, size_t end) const
+	{
+		assert(begin % 64 == 0 && "Cull ranges must start on a mask word");
+		std::fill(pVisibleMask + begin / 64, pVisibleMask + GetMaskSize(end), uint64_t{ 0 });
+
+		// Splat the planes once
+		Lane normalX[PlaneIndex::Count], normalY[PlaneIndex::Count], normalZ[PlaneIndex::Count], distance[PlaneIndex::Count];
+		Lane absNormalX[PlaneIndex::Count], absNormalY[PlaneIndex::Count], absNormalZ[PlaneIndex::Count];
+		for (int p{ 0 }; p < PlaneIndex::Count; ++p)
+		{
+			normalX[p] = Broadcast(m_Planes[p].normal.x);
+			normalY[p] = Broadcast(m_Planes[p].normal.y);
+			normalZ[p] = Broadcast(m_Planes[p].normal.z);
+			distance[p] = Broadcast(m_Planes[p].distance);
+			absNormalX[p] = Broadcast(std::abs(m_Planes[p].normal.x));
+			absNormalY[p] = Broadcast(std::abs(m_Planes[p].normal.y));
+			absNormalZ[p] = Broadcast(std::abs(m_Planes[p].normal.z));
+		}
+
+		size_t i{ begin };
+		for (; i + LaneWidth <= end; i += LaneWidth)
+		{
+			const Lane centerX = Load(&boxes.centerX[i]);
+			const Lane centerY = Load(&boxes.centerY[i]);
+			const Lane centerZ = Load(&boxes.centerZ[i]);
+			const Lane extentX = Load(&boxes.extentX[i]);
+			const Lane extentY = Load(&boxes.extentY[i]);
+			const Lane extentZ = Load(&boxes.extentZ[i]);
+
+			Lane outside = Zero();
+			for (int p{ 0 }; p < PlaneIndex::Count; ++p)
+			{
+				const Lane signedDistance = Add(Add(Mul(normalX[p], centerX), Mul(normalY[p], centerY)), Add(Mul(normalZ[p], centerZ), distance[p]));
+				const Lane radius = Add(Add(Mul(absNormalX[p], extentX), Mul(absNormalY[p], extentY)), Mul(absNormalZ[p], extentZ));
+				outside = Or(outside, LessThan(Add(signedDistance, radius), Zero()));
+			}
+
+			const uint64_t visible = ~MoveMask(outside) & LaneBits;
+			pVisibleMask[i / 64] |= visible << (i % 64);
+		}
+
+		for (; i < end; ++i)
+		{
+			if (IsVisible(boxes.Get(i)))
+				pVisibleMask[i / 64] |= uint64_t{ 1 } << (i % 64);
+		}
+	}
+
+	void Frustum::Cull(const SphereBatch& spheres, uint64_t* pVisibleMask, size_t begin, size_t end) const
+	{
+		assert(begin % 64 == 0 && "Cull ranges must start on a mask word");
+		std::fill(pVisibleMask + begin / 64, pVisibleMask + GetMaskSize(end), uint64_t{ 0 });
+
+		Lane normalX[PlaneIndex::Count], normalY[PlaneIndex::Count], normalZ[PlaneIndex::Count], distance[PlaneIndex::Count];
+		for (int p{ 0 }; p < PlaneIndex::Count; ++p)
+		{
+			normalX[p] = Broadcast(m_Planes[p].normal.x);
+			normalY[p] = Broadcast(m_Planes[p].normal.y);
+			normalZ[p] = Broadcast(m_Planes[p].normal.z);
+			distance[p] = Broadcast(m_Planes[p].distance);
+		}
+
+		size_t i{ begin };
+		for (; i + LaneWidth <= end; i += LaneWidth)
+		{
+			const Lane centerX = Load(&spheres.centerX[i]);
+			const Lane centerY = Load(&spheres.centerY[i]);
+			const Lane centerZ = Load(&spheres.centerZ[i]);
+			const Lane radius = Load(&spheres.radius[i]);
+
+			Lane outside = Zero();
+			for (int p{ 0 }; p < PlaneIndex::Count; ++p)
+			{
+				const Lane signedDistance = Add(Add(Mul(normalX[p], centerX), Mul(normalY[p], centerY)), Add(Mul(normalZ[p], centerZ), distance[p]));
+				outside = Or(outside, LessThan(Add(signedDistance, radius), Zero()));
+			}
+
+			const uint64_t visible = ~MoveMask(outside) & LaneBits;
+			pVisibleMask[i / 64] |= visible << (i % 64);
+		}
+
+		for (; i < end; ++i)
+		{
+			if (IsVisible(spheres.Get(i)))
+				pVisibleMask[i / 64] |= uint64_t{ 1 } << (i % 64);
+		}
+	}
+
+	template<typename Batch>
+	static std::vector<uint64_t> CullSplit(const Frustum& frustum, const Batch& batch, uint32_t numThreads)
+	{
+		const size_t count = batch.Size();
+		std::vector<uint64_t> visibleMask(Frustum::GetMaskSize(count));
+
+		// Whole mask words per job, so no two jobs write the same word
+		const size_t numWords = visibleMask.size();
+		numThreads = std::max(1u, std::min(numThreads, static_cast<uint32_t>(numWords)));
+		if (numThreads <= 1)
+		{
+			frustum.Cull(batch, visibleMask.data(), 0, count);
+			return visibleMask;
+		}
+
+		const size_t wordsPerJob = (numWords + numThreads - 1) / numThreads;
+		JobSystem::GetShared().ParallelFor(count, wordsPerJob * 64, [&](size_t begin, size_t end) { frustum.Cull(batch, visibleMask.data(), begin, end); }, numThreads);
+
+		return visibleMask;
+	}
+
+	std::vector<uint64_t> Frustum::Cull(const AABBBatch& boxes, uint32_t numThreads) const
+	{
+		return CullSplit(*this, boxes, numThreads);
+	}
+
+	std::vector<uint64_t> Frustum::Cull(const SphereBatch& spheres, uint32_t numThreads) const
+	{
+		return CullSplit(*this, spheres, numThreads);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Bounds.h"
+
+namespace dae
+{
+	struct Plane
+	{
+		Vector3 normal{};
+		float distance{};
+
+		// >= 0 means on the inside of the plane
+		float GetSignedDistance(const Vector3& point) const
+		{
+			return Vector3::Dot(normal, point) + distance;
+		}
+	};
+
+	class Frustum final
+	{
+	public:
+		enum PlaneIndex
+		{
+			Left = 0,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+			Count
+		};
+
+		Frustum() = default;
+		explicit Frustum(const Matrix& viewProjection);	// planes in the space the matrix transforms from
+
+		bool IsVisible(const AABB& box) const;
+		bool IsVisible(const Sphere& sphere) const;
+
+		// Batch tests: bit i of pVisibleMask[i / 64] is set when object i intersects the frustum.
+		// begin must be a multiple of 64, so ranges can be split over threads without sharing mask words
+		void Cull(const AABBBatch& boxes, uint64_t* pVisibleMask, size_t begin, size_t end) const;
+		void Cull(const SphereBatch& spheres, uint64_t* pVisibleMask, size_t begin, size_t end) const;
+
+		// Whole batch, optionally split into numThreads jobs on the shared JobSystem
+		std::vector<uint64_t> Cull(const AABBBatch& boxes, uint32_t numThreads = 1) const;
+		std::vector<uint64_t> Cull(const SphereBatch& spheres, uint32_t numThreads = 1) const;
+
+		const Plane& GetPlane(PlaneIndex index) const { return m_Planes[index]; }
+
+		static size_t GetMaskSize(size_t count) { return (count + 63) / 64; }
+		static bool IsVisible(const std::vector<uint64_t>& visibleMask, size_t index)
+		{
+			return (visibleMask[index / 64] >> (index % 64)) & 1;
+		}
+
+	private:
+		Plane m_Planes[PlaneIndex::Count]{};
+	};
+}
@@ -0,0 +1,59 @@
+#include "InstanceBuffer.h"
+
+#include <algorithm>
+
+#include "JobSystem.h"
+
+namespace dae
+{
+	InstanceBuffer::InstanceBuffer(IRenderDevice& device, uint32_t capacity)
+		: m_Device{ device }
+		, m_Capacity{ std::max(capacity, 1u) }
+	{
+		m_Buffer = m_Device.CreateBuffer({ BufferType::Vertex, m_Capacity * static_cast<uint32_t>(sizeof(InstanceData)), true }, nullptr);
+	}
+
+	InstanceBuffer::~InstanceBuffer()
+	{
+		m_Device.Destroy(m_Buffer);
+	}
+
+	void InstanceBuffer::Build(uint32_t count, const FillFunction& fill, uint32_t numThreads)
+	{
+		m_Instances.resize(count);
+		if (count == 0)
+			return;
+
+		if (numThreads == 0)
+			numThreads = JobSystem::GetShared().GetNumThreads();
+		numThreads = std::min(numThreads, (count + s_MinInstancesPerJob - 1) / s_MinInstancesPerJob);
+		if (numThreads <= 1)
+		{
+			fill(0, count, m_Instances.data());
+			return;
+		}
+
+		// Every instance costs the same, so equal contiguous ranges: each job writes its own cache lines
+		const uint32_t rangeSize = (count + numThreads - 1) / numThreads;
+		JobSystem::GetShared().ParallelFor(count, rangeSize, [&](size_t begin, size_t end)
+			{
+				fill(static_cast<uint32_t>(begin), static_cast<uint32_t>(end), m_Instances.data() + begin);
+			}, numThreads);
+	}
+
+	void InstanceBuffer::Upload(ICommandContext& context)
+	{
+		const uint32_t count = GetCount();
+		if (count == 0)
+			return;
+
+		if (count > m_Capacity)
+		{
+			m_Device.Destroy(m_Buffer);
+			m_Capacity = std::max(count, m_Capacity * 2);
+			m_Buffer = m_Device.CreateBuffer({ BufferType::Vertex, m_Capacity * static_cast<uint32_t>(sizeof(InstanceData)), true }, nullptr);
+		}
+
+		context.UpdateBuffer(m_Buffer, m_Instances.data(), count * static_cast<uint32_t>(sizeof(InstanceData)));
+	}
+}
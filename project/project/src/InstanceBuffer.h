@@ -0,0 +1,54 @@
+#pragma once
+#include <functional>
+#include <span>
+#include <vector>
+#include "Math.h"
+#include "RenderDevice.h"
+
+namespace dae
+{
+	// Per instance vertex data (input slot 1): the world matrix as 4 rows and a tint multiplied into the shaded color
+	struct InstanceData
+	{
+		Matrix worldMatrix{};
+		ColorRGB tint{ 1.f, 1.f, 1.f };
+		float padding{ 1.f };	// tint is read as a float4
+	};
+	static_assert(sizeof(InstanceData) == 80, "The instanced input layout expects 4 float4 rows + a float4 tint");
+
+	// CPU copy of a frame's instances plus the dynamic vertex buffer they are uploaded to.
+	// Built in parallel, uploaded once and drawn with one DrawIndexedInstanced per mesh (see Mesh::RenderInstanced)
+	class InstanceBuffer final
+	{
+	public:
+		// Fills the instances [begin, end), pInstances points at instance begin
+		using FillFunction = std::function<void(uint32_t begin, uint32_t end, InstanceData* pInstances)>;
+
+		InstanceBuffer(IRenderDevice& device, uint32_t capacity = 1024);
+		~InstanceBuffer();
+
+		InstanceBuffer(const InstanceBuffer&) = delete;
+		InstanceBuffer(InstanceBuffer&&) noexcept = delete;
+		InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+		InstanceBuffer& operator=(InstanceBuffer&&) noexcept = delete;
+
+		// Replaces the instances with count new ones, split in contiguous ranges over numThreads jobs (0 = one per pool thread)
+		void Build(uint32_t count, const FillFunction& fill, uint32_t numThreads = 0);
+		// Copies the instances into the vertex buffer, recreating it when it is too small
+		void Upload(ICommandContext& context);
+
+		uint32_t GetCount() const { return static_cast<uint32_t>(m_Instances.size()); }
+		std::span<const InstanceData> GetInstances() const { return m_Instances; }
+		BufferHandle GetBuffer() const { return m_Buffer; }
+		uint32_t GetCapacity() const { return m_Capacity; }
+
+	private:
+		// Ranges smaller than this are not worth a job
+		static constexpr uint32_t s_MinInstancesPerJob{ 4096 };
+
+		IRenderDevice& m_Device;
+		std::vector<InstanceData> m_Instances{};
+		BufferHandle m_Buffer{};
+		uint32_t m_Capacity{};
+	};
+}
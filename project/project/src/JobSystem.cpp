@@ -0,0 +1,188 @@
+#include "JobSystem.h"
+
+namespace dae
+{
+	// Which pool the current thread works for and its queue there
+	static thread_local const JobSystem* t_pWorkerSystem{ nullptr };
+	static thread_local uint32_t t_WorkerIndex{ 0 };
+
+	JobSystem::JobSystem(uint32_t numWorkers)
+		: m_Queues(numWorkers == ~0u ? std::max(1u, std::thread::hardware_concurrency()) : numWorkers + 1)
+	{
+		const uint32_t count = static_cast<uint32_t>(m_Queues.size()) - 1;
+		m_Workers.reserve(count);
+		for (uint32_t index{ 0 }; index < count; ++index)
+			m_Workers.emplace_back(&JobSystem::WorkerLoop, this, index);
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard lock{ m_WakeMutex };
+			m_IsStopping = true;
+		}
+		m_WakeCondition.notify_all();
+
+		for (std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	JobSystem& JobSystem::GetShared()
+	{
+		static JobSystem s_JobSystem{};
+		return s_JobSystem;
+	}
+
+	void JobSystem::Run(JobFunction function, Counter* pCounter, Counter* pDependency)
+	{
+		if (pCounter)
+			pCounter->m_NumPending.fetch_add(1);
+
+		if (pDependency)
+		{
+			std::lock_guard lock{ pDependency->m_Mutex };
+			if (pDependency->m_NumPending.load() > 0)
+			{
+				pDependency->m_Continuations.push_back({ std::move(function), pCounter });
+				return;
+			}
+		}
+
+		Push({ std::move(function), pCounter });
+	}
+
+	void JobSystem::Wait(Counter& counter)
+	{
+		while (counter.m_NumPending.load(std::memory_order_acquire) > 0)
+		{
+			Job job{};
+			if (TryPop(job))
+				Execute(job);
+			else
+				std::this_thread::yield();
+		}
+
+		// The last job decrements under the lock, wait until it let go
+		std::lock_guard lock{ counter.m_Mutex };
+	}
+
+	void JobSystem::Push(Job&& job)
+	{
+		Queue& queue = m_Queues[GetQueueIndex()];
+		{
+			std::lock_guard lock{ queue.mutex };
+			queue.PushBack(std::move(job));
+		}
+
+		// Sleepers count themselves before checking m_NumQueued under the wake mutex: either they see this job
+		// or we see them, and taking the mutex makes sure they are waiting before the notify
+		m_NumQueued.fetch_add(1);
+		if (m_NumSleeping.load() > 0)
+		{
+			{
+				std::lock_guard lock{ m_WakeMutex };
+			}
+			m_WakeCondition.notify_one();
+		}
+	}
+
+	bool JobSystem::TryPop(Job& job)
+	{
+		if (m_NumQueued.load() == 0)
+			return false;
+
+		// Own jobs newest first (still warm in cache), then steal the oldest from the others
+		const uint32_t numQueues = static_cast<uint32_t>(m_Queues.size());
+		const uint32_t ownIndex = GetQueueIndex();
+		for (uint32_t offset{ 0 }; offset < numQueues; ++offset)
+		{
+			Queue& queue = m_Queues[(ownIndex + offset) % numQueues];
+			std::lock_guard lock{ queue.mutex };
+			if (queue.count == 0)
+				continue;
+
+			job = offset == 0 ? queue.PopBack() : queue.PopFront();
+			m_NumQueued.fetch_sub(1);
+			return true;
+		}
+		return false;
+	}
+
+	void JobSystem::Execute(Job& job)
+	{
+		job.function();
+
+		Counter* pCounter = job.pCounter;
+		if (!pCounter)
+			return;
+
+		std::vector<Counter::Continuation> continuations{};
+		{
+			std::lock_guard lock{ pCounter->m_Mutex };
+			if (pCounter->m_NumPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				continuations.swap(pCounter->m_Continuations);
+		}
+
+		// The counter may be gone from here on
+		for (Counter::Continuation& continuation : continuations)
+			Push({ std::move(continuation.function), continuation.pCounter });
+	}
+
+	void JobSystem::WorkerLoop(uint32_t index)
+	{
+		t_pWorkerSystem = this;
+		t_WorkerIndex = index;
+
+		while (true)
+		{
+			Job job{};
+			if (TryPop(job))
+			{
+				Execute(job);
+				continue;
+			}
+
+			std::unique_lock lock{ m_WakeMutex };
+			m_NumSleeping.fetch_add(1);
+			m_WakeCondition.wait(lock, [this] { return m_IsStopping || m_NumQueued.load() > 0; });
+			m_NumSleeping.fetch_sub(1);
+			if (m_IsStopping && m_NumQueued.load() == 0)
+				return;
+		}
+	}
+
+	void JobSystem::Queue::PushBack(Job&& job)
+	{
+		if (count == jobs.size())
+		{
+			// Full: unroll into a buffer twice the size
+			std::vector<Job> grown(std::max<size_t>(16, jobs.size() * 2));
+			for (size_t i{ 0 }; i < count; ++i)
+				grown[i] = std::move(jobs[(head + i) % jobs.size()]);
+			jobs.swap(grown);
+			head = 0;
+		}
+
+		jobs[(head + count) % jobs.size()] = std::move(job);
+		++count;
+	}
+
+	JobSystem::Job JobSystem::Queue::PopBack()
+	{
+		--count;
+		return std::move(jobs[(head + count) % jobs.size()]);
+	}
+
+	JobSystem::Job JobSystem::Queue::PopFront()
+	{
+		Job job = std::move(jobs[head]);
+		head = (head + 1) % jobs.size();
+		--count;
+		return job;
+	}
+
+	uint32_t JobSystem::GetQueueIndex() const
+	{
+		return t_pWorkerSystem == this ? t_WorkerIndex : static_cast<uint32_t>(m_Queues.size()) - 1;
+	}
+}
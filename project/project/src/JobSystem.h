@@ -0,0 +1,141 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dae
+{
+	// Work-stealing job scheduler. Every worker owns a deque: it pushes and pops its own jobs at the back,
+	// idle workers steal from the front of the others'. Threads outside the pool push into one shared deque.
+	// A Counter tracks unfinished jobs: Wait helps running jobs until it reaches zero, and a job run with
+	// a dependency is only queued once that counter reached zero. Wait on a counter before it goes out of scope
+	class JobSystem final
+	{
+	public:
+		using JobFunction = std::function<void()>;
+
+		class Counter final
+		{
+		public:
+			Counter() = default;
+			~Counter() = default;
+
+			Counter(const Counter&) = delete;
+			Counter(Counter&&) noexcept = delete;
+			Counter& operator=(const Counter&) = delete;
+			Counter& operator=(Counter&&) noexcept = delete;
+
+		private:
+			friend class JobSystem;
+
+			struct Continuation
+			{
+				JobFunction function;
+				Counter* pCounter;
+			};
+
+			std::atomic<uint32_t> m_NumPending{ 0 };
+			std::mutex m_Mutex{};	// held while finishing a job, so Wait only returns once nothing touches the counter anymore
+			std::vector<Continuation> m_Continuations{};	// jobs waiting for this counter
+		};
+
+		explicit JobSystem(uint32_t numWorkers = ~0u);	// ~0u = hardware threads - 1, the thread that waits helps
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) noexcept = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem& operator=(JobSystem&&) noexcept = delete;
+
+		// The pool the renderer, culling and transform updates share
+		static JobSystem& GetShared();
+
+		// Queues function, pCounter (optional) counts it until it finished. With pDependency it is only queued
+		// once that counter reached zero
+		void Run(JobFunction function, Counter* pCounter = nullptr, Counter* pDependency = nullptr);
+		// Runs queued jobs on the calling thread until counter reached zero
+		void Wait(Counter& counter);
+
+		// Calls function(begin, end) for [0, count) in chunks of grainSize, handed out dynamically to at most
+		// maxJobs jobs (0 = one per thread). The calling thread takes part and returns when every chunk is done
+		template<typename Function>
+		void ParallelFor(size_t count, size_t grainSize, Function&& function, uint32_t maxJobs = 0);
+
+		uint32_t GetNumWorkers() const { return static_cast<uint32_t>(m_Workers.size()); }
+		// Workers + the thread that waits
+		uint32_t GetNumThreads() const { return GetNumWorkers() + 1; }
+
+	private:
+		struct Job
+		{
+			JobFunction function;
+			Counter* pCounter;
+		};
+
+		// Ring buffer that only grows, so steady state frames queue jobs without touching the heap
+		struct alignas(64) Queue
+		{
+			std::mutex mutex{};
+			std::vector<Job> jobs{};
+			size_t head{};
+			size_t count{};
+
+			void PushBack(Job&& job);
+			Job PopBack();
+			Job PopFront();
+		};
+
+		// One per worker, the last one for threads outside the pool
+		std::vector<Queue> m_Queues;
+		std::vector<std::thread> m_Workers{};
+
+		std::atomic<uint32_t> m_NumQueued{ 0 };
+		std::atomic<uint32_t> m_NumSleeping{ 0 };
+		std::mutex m_WakeMutex{};
+		std::condition_variable m_WakeCondition{};
+		bool m_IsStopping{ false };
+
+		void Push(Job&& job);
+		bool TryPop(Job& job);
+		void Execute(Job& job);
+		void WorkerLoop(uint32_t index);
+		uint32_t GetQueueIndex() const;
+	};
+
+	template<typename Function>
+	void JobSystem::ParallelFor(size_t count, size_t grainSize, Function&& function, uint32_t maxJobs)
+	{
+		grainSize = std::max<size_t>(grainSize, 1);
+		const size_t numChunks = (count + grainSize - 1) / grainSize;
+		if (maxJobs == 0)
+			maxJobs = GetNumThreads();
+		const uint32_t numJobs = static_cast<uint32_t>(std::min<size_t>(maxJobs, numChunks));
+		if (numJobs <= 1)
+		{
+			if (count > 0)
+				function(size_t{ 0 }, count);
+			return;
+		}
+
+		// Chunks are handed out dynamically, so a job that got stolen late or hit expensive chunks takes fewer
+		std::atomic<size_t> nextChunk{ 0 };
+		auto worker = [&]
+			{
+				for (size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+					function(chunk * grainSize, std::min(count, (chunk + 1) * grainSize));
+			};
+
+		// The jobs only capture a reference, small enough for std::function to store without allocating
+		Counter counter{};
+		for (uint32_t job{ 1 }; job < numJobs; ++job)
+			Run([&worker] { worker(); }, &counter);
+
+		worker();
+		Wait(counter);
+	}
+}
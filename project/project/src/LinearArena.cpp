@@ -0,0 +1,65 @@
+#include "LinearArena.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dae
+{
+	LinearArena::LinearArena(size_t blockSize)
+		: m_BlockSize{ blockSize }
+	{
+		assert(blockSize > 0);
+		m_Blocks.push_back({ std::make_unique_for_overwrite<std::byte[]>(blockSize), blockSize });
+	}
+
+	void* LinearArena::Allocate(size_t size, size_t alignment)
+	{
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+		for (;;)
+		{
+			if (m_BlockIndex == m_Blocks.size())
+			{
+				// Out of blocks: this frame needs more than any before, grow
+				const size_t blockSize = std::max(m_BlockSize, size + alignment);
+				m_Blocks.push_back({ std::make_unique_for_overwrite<std::byte[]>(blockSize), blockSize });
+			}
+
+			Block& block = m_Blocks[m_BlockIndex];
+			const uintptr_t base = reinterpret_cast<uintptr_t>(block.pData.get());
+			const uintptr_t aligned = (base + m_Offset + alignment - 1) & ~uintptr_t(alignment - 1);
+			if (aligned + size <= base + block.size)
+			{
+				m_Offset = aligned + size - base;
+				return reinterpret_cast<void*>(aligned);
+			}
+
+			m_UsedSize += m_Offset;
+			m_Offset = 0;
+			++m_BlockIndex;
+		}
+	}
+
+	void LinearArena::Reset()
+	{
+		// One block big enough for the largest frame so far
+		if (m_Blocks.size() > 1)
+		{
+			const size_t capacity = GetCapacity();
+			m_Blocks.clear();
+			m_Blocks.push_back({ std::make_unique_for_overwrite<std::byte[]>(capacity), capacity });
+		}
+
+		m_BlockIndex = 0;
+		m_Offset = 0;
+		m_UsedSize = 0;
+	}
+
+	size_t LinearArena::GetCapacity() const
+	{
+		size_t capacity{};
+		for (const Block& block : m_Blocks)
+			capacity += block.size;
+		return capacity;
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace dae
+{
+	// Bump allocator for data that lives until the next Reset (e.g. one frame).
+	// Allocating is a pointer increment and Reset frees everything at once. Memory is kept across Resets,
+	// once a frame outgrew the first block the blocks are merged, so steady state frames never touch the heap.
+	// Not thread safe: allocate from one thread, fill from many
+	class LinearArena final
+	{
+	public:
+		explicit LinearArena(size_t blockSize = size_t{ 1 } << 20);
+		~LinearArena() = default;
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena(LinearArena&&) noexcept = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+		LinearArena& operator=(LinearArena&&) noexcept = delete;
+
+		void* Allocate(size_t size, size_t alignment);
+
+		// Default constructed (so trivial types are left uninitialized), destructors never run
+		template<typename T>
+		std::span<T> AllocateSpan(size_t count)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "Reset does not run destructors");
+			T* pData = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+			std::uninitialized_default_construct_n(pData, count);
+			return { pData, count };
+		}
+
+		void Reset();
+
+		size_t GetUsedSize() const { return m_UsedSize + m_Offset; }	// since the last Reset
+		size_t GetCapacity() const;
+
+	private:
+		struct Block
+		{
+			std::unique_ptr<std::byte[]> pData{};
+			size_t size{};
+		};
+
+		std::vector<Block> m_Blocks{};
+		size_t m_BlockSize;
+		size_t m_BlockIndex{ 0 };
+		size_t m_Offset{ 0 };	// into the current block
+		size_t m_UsedSize{ 0 };	// in the blocks before the current one
+	};
+}
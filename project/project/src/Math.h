@@ -4,4 +4,5 @@
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Matrix.h"
+#include "Quaternion.h"
 #include "MathHelpers.h"
\ No newline at end of file
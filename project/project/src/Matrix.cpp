@@ -1,10 +1,9 @@
-#include "pch.h"
-
 #include "Matrix.h"
 
 #include <cassert>
 
 #include "MathHelpers.h"
+#include "Quaternion.h"
 #include <cmath>
 
 namespace dae {
@@ -211,8 +210,8 @@ namespace dae {
 	{
 		return {
 			{1, 0, 0, 0},
-			{0, cos(pitch), -sin(pitch), 0},
-			{0, sin(pitch), cos(pitch), 0},
+			{0, std::cos(pitch), -std::sin(pitch), 0},
+			{0, std::sin(pitch), std::cos(pitch), 0},
 			{0, 0, 0, 1}
 		};
 	}
@@ -220,9 +219,9 @@ namespace dae {
 	Matrix Matrix::CreateRotationY(float yaw)
 	{
 		return {
-			{cos(yaw), 0, -sin(yaw), 0},
+			{std::cos(yaw), 0, -std::sin(yaw), 0},
 			{0, 1, 0, 0},
-			{sin(yaw), 0, cos(yaw), 0},
+			{std::sin(yaw), 0, std::cos(yaw), 0},
 			{0, 0, 0, 1}
 		};
 	}
@@ -230,8 +229,8 @@ namespace dae {
 	Matrix Matrix::CreateRotationZ(float roll)
 	{
 		return {
-			{cos(roll), sin(roll), 0, 0},
-			{-sin(roll), cos(roll), 0, 0},
+			{std::cos(roll), std::sin(roll), 0, 0},
+			{-std::sin(roll), std::cos(roll), 0, 0},
 			{0, 0, 1, 0},
 			{0, 0, 0, 1}
 		};
@@ -247,6 +246,21 @@ namespace dae {
 		return CreateRotationX(r[0]) * CreateRotationY(r[1]) * CreateRotationZ(r[2]);
 	}
 
+	Matrix Matrix::CreateRotation(const Quaternion& q)
+	{
+		// Rows are the rotated unit axes, no trig needed
+		const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+		return {
+			{1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0},
+			{2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0},
+			{2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0},
+			{0, 0, 0, 1}
+		};
+	}
+
 	Matrix Matrix::CreateScale(float sx, float sy, float sz)
 	{
 		return { {sx, 0, 0}, {0, sy, 0}, {0, 0, sz}, Vector3::Zero };
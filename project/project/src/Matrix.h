@@ -3,6 +3,7 @@
 #include "Vector4.h"
 
 namespace dae {
+	struct Quaternion;
 	struct Matrix
 	{
 		Matrix() = default;
@@ -43,6 +44,7 @@ namespace dae {
 		static Matrix CreateRotationZ(float roll);
 		static Matrix CreateRotation(float pitch, float yaw, float roll);
 		static Matrix CreateRotation(const Vector3& r);
+		static Matrix CreateRotation(const Quaternion& q);
 		static Matrix CreateScale(float sx, float sy, float sz);
 		static Matrix CreateScale(const Vector3& s);
 		static Matrix Transpose(const Matrix& m);
@@ -1,100 +1,70 @@
 #include "Mesh.h"
+#include "DrawList.h"
 
 namespace dae {
 
-	Mesh::Mesh(ID3D11Device* pDevice, const std::vector<Vertex_In>& vertices, const std::vector<uint32_t>& indices,  bool isPartialCoverage)
-		:m_IsPartialCoverage{ isPartialCoverage }
+	Mesh::Mesh(IRenderDevice& device, const std::vector<Vertex_In>& vertices, const std::vector<uint32_t>& indices,  bool isPartialCoverage, const MeshTextures& textures)
+		:m_Device{ device }
+		,m_IsPartialCoverage{ isPartialCoverage }
+		,m_Textures{ textures }
 	{
 		// Create an instance of the effect class you just created
 		if(isPartialCoverage)
-			m_pEffect = new EffectPartialCoverage(pDevice, L"../../../../../resources/PosCol3D_PartialCoverage.fx");
+			m_pEffect = new EffectPartialCoverage(device, L"../../../../../resources/PosCol3D_PartialCoverage.fx");
 		else 
-			m_pEffect = new EffectDefault(pDevice, L"../../../../../resources/PosCol3D.fx");
+			m_pEffect = new EffectDefault(device, L"../../../../../resources/PosCol3D.fx");
 
-		m_pTechnique = m_pEffect->GetTechnique(m_FilteringMethod);
-
-		if (isPartialCoverage)
-		{
-			m_pDiffuseTexture = Texture::LoadFromFile("resources/fireFX_diffuse.png", pDevice);
-
-			m_pNormalTexture =		nullptr;
-			m_pSpecularTexture =	nullptr;
-			m_pGlossinessTexture =	nullptr;
-		}
-		else
+		// Object space bounds for culling
+		if (!vertices.empty())
 		{
-			m_pDiffuseTexture = Texture::LoadFromFile("resources/vehicle_diffuse.png", pDevice);
-			m_pNormalTexture = Texture::LoadFromFile("resources/vehicle_normal.png", pDevice);
-			m_pSpecularTexture = Texture::LoadFromFile("resources/vehicle_specular.png", pDevice);
-			m_pGlossinessTexture = Texture::LoadFromFile("resources/vehicle_gloss.png", pDevice);
+			Vector3 min{ vertices[0].position };
+			Vector3 max{ vertices[0].position };
+			for (const Vertex_In& vertex : vertices)
+			{
+				min = { std::min(min.x, vertex.position.x), std::min(min.y, vertex.position.y), std::min(min.z, vertex.position.z) };
+				max = { std::max(max.x, vertex.position.x), std::max(max.y, vertex.position.y), std::max(max.z, vertex.position.z) };
+			}
+			m_Bounds = AABB::FromMinMax(min, max);
 		}
-			
 
 
 		// Create the vertex layout
-		static constexpr uint32_t numElements{ 4 };
-		D3D11_INPUT_ELEMENT_DESC vertexDesc[numElements]{};
-
-		vertexDesc[0].SemanticName = "POSITION";
-		vertexDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[0].AlignedByteOffset = 0;
-		vertexDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-		vertexDesc[1].SemanticName = "TEXCOORD";
-		vertexDesc[1].Format = DXGI_FORMAT_R32G32_FLOAT;
-		vertexDesc[1].AlignedByteOffset = 12;
-		vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-		vertexDesc[2].SemanticName = "NORMAL";
-		vertexDesc[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[2].AlignedByteOffset = 20;
-		vertexDesc[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-		vertexDesc[3].SemanticName = "TANGENT";
-		vertexDesc[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[3].AlignedByteOffset = 32;
-		vertexDesc[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		static constexpr InputElement vertexDesc[]{
+			{ "POSITION",	Format::R32G32B32_Float,	0 },
+			{ "TEXCOORD",	Format::R32G32_Float,		12 },
+			{ "NORMAL",		Format::R32G32B32_Float,	20 },
+			{ "TANGENT",	Format::R32G32B32_Float,	32 },
+		};
 
 		// Create the input layout
-		D3DX11_PASS_DESC passDesc{};
-		m_pTechnique->GetPassByIndex(0)->GetDesc(&passDesc);
-
-		/*const*/ HRESULT result = pDevice->CreateInputLayout(
-			vertexDesc,
-			numElements,
-			passDesc.pIAInputSignature,
-			passDesc.IAInputSignatureSize,
-			&m_pInputLayout);
-
-		if (FAILED(result))
+		m_InputLayout = device.CreateInputLayout(vertexDesc, m_pEffect->GetTechnique(m_FilteringMethod));
+		if (!m_InputLayout.IsValid())
 			assert(false); //or return
 
-		// Create vertex buffer
-		D3D11_BUFFER_DESC bd = {};
-		bd.Usage = D3D11_USAGE_IMMUTABLE;
-		bd.ByteWidth = sizeof(Vertex) * static_cast<uint32_t> (vertices.size());
-		bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		bd.CPUAccessFlags = 0;
-		bd.MiscFlags = 0;
-
-		D3D11_SUBRESOURCE_DATA initData = {};
-		initData.pSysMem = vertices.data();
-
+		// Same vertices plus one InstanceData per instance
+		static constexpr InputElement instancedDesc[]{
+			{ "POSITION",		Format::R32G32B32_Float,	0 },
+			{ "TEXCOORD",		Format::R32G32_Float,		12 },
+			{ "NORMAL",			Format::R32G32B32_Float,	20 },
+			{ "TANGENT",		Format::R32G32B32_Float,	32 },
+			{ "INSTANCEWORLD",	Format::R32G32B32A32_Float,	0,	1, true, 0 },
+			{ "INSTANCEWORLD",	Format::R32G32B32A32_Float,	16,	1, true, 1 },
+			{ "INSTANCEWORLD",	Format::R32G32B32A32_Float,	32,	1, true, 2 },
+			{ "INSTANCEWORLD",	Format::R32G32B32A32_Float,	48,	1, true, 3 },
+			{ "INSTANCETINT",	Format::R32G32B32A32_Float,	64,	1, true },
+		};
+		m_InstancedInputLayout = device.CreateInputLayout(instancedDesc, m_pEffect->GetInstancedTechnique(m_FilteringMethod));
+		assert(m_InstancedInputLayout.IsValid());
 
-		/*HRESULT*/ result = pDevice->CreateBuffer(&bd, &initData, &m_pVertexBuffer);
-		if (FAILED(result))
-			result;
+		// Create vertex buffer
+		m_VertexBuffer = device.CreateBuffer({ BufferType::Vertex, static_cast<uint32_t>(sizeof(Vertex) * vertices.size()) }, vertices.data());
+		if (!m_VertexBuffer.IsValid())
+			return;
 
 		// Create index buffer
 		m_NumIndices = static_cast<uint32_t>(indices.size());
-		bd.Usage = D3D11_USAGE_IMMUTABLE;
-		bd.ByteWidth = sizeof(uint32_t) * m_NumIndices;
-		bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
-		bd.CPUAccessFlags = 0;
-		bd.MiscFlags = 0;
-		initData.pSysMem = indices.data();
-		result = pDevice->CreateBuffer(&bd, &initData, &m_pIndexBuffer);
-		if (FAILED(result))
+		m_IndexBuffer = device.CreateBuffer({ BufferType::Index, static_cast<uint32_t>(sizeof(uint32_t) * m_NumIndices) }, indices.data());
+		if (!m_IndexBuffer.IsValid())
 			return;
 
 	}
@@ -103,76 +73,120 @@ namespace dae {
 	{
 		// Release resources - oposite order of constr
 
-		if (m_pIndexBuffer)
-			m_pIndexBuffer->Release();
-
-		if (m_pVertexBuffer)
-			m_pVertexBuffer->Release();
-
-		if (m_pInputLayout)
-			m_pInputLayout->Release();
-
-		if (m_pTechnique)
-			m_pTechnique->Release();
-
-		delete m_pDiffuseTexture; 
-		delete m_pNormalTexture;
-		delete m_pSpecularTexture;
-		delete m_pGlossinessTexture;
+		m_Device.Destroy(m_IndexBuffer);
+		m_Device.Destroy(m_VertexBuffer);
+		m_Device.Destroy(m_InstancedInputLayout);
+		m_Device.Destroy(m_InputLayout);
 
 		delete m_pEffect;
 		
 	}
 
 
-	void Mesh::Render(ID3D11DeviceContext* pDeviceContext, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix,const Vector3& cameraPos, const FilteringMethod& filteringMethod)
+	void Mesh::Render(ICommandContext& context, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix,const Vector3& cameraPos, const FilteringMethod& filteringMethod)
 
 	{
 		//1. Set Primitive Topology
-		pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		context.SetPrimitiveTopology(PrimitiveTopology::TriangleList);
 
 		//2. Set Input Layout
-		pDeviceContext->IASetInputLayout(m_pInputLayout);
+		context.SetInputLayout(m_InputLayout);
 
 		//3. Set VertexBuffer
-		constexpr UINT stride = sizeof(Vertex);
-		constexpr UINT offset = 0;
-		pDeviceContext->IASetVertexBuffers(0, 1, &m_pVertexBuffer, &stride, &offset);
+		constexpr uint32_t stride = sizeof(Vertex);
+		constexpr uint32_t offset = 0;
+		context.SetVertexBuffer(0, m_VertexBuffer, stride, offset);
 
-		//4. Set Matrices + Pos
-		m_pEffect->SetWorldViewProjectionMatrix(worldViewProjectionMatrix);
-		m_pEffect->SetWorldMatrix(worldMatrix);
+		//4. Set Matrices + Pos, ranges bound by the other Render would hide them
+		context.SetConstantBuffer(PerFrameConstants::Slot, {}, 0, 0);
+		context.SetConstantBuffer(PerObjectConstants::Slot, {}, 0, 0);
+		m_pEffect->SetWorldViewProjectionMatrix(context, worldViewProjectionMatrix);
+		m_pEffect->SetWorldMatrix(context, worldMatrix);
 
-		m_pEffect->SetCameraPosition(cameraPos);
+		m_pEffect->SetCameraPosition(context, cameraPos);
 
 		//5. Set IndexBuffer
-		pDeviceContext->IASetIndexBuffer(m_pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+		context.SetIndexBuffer(m_IndexBuffer, Format::R32_UInt, 0);
+
+		SetTextures(context);
+
+		//6. Draw
+		DrawPasses(context, filteringMethod);
+	}
 
+	void Mesh::Render(ICommandContext& context, const ConstantBufferRange& objectConstants, const FilteringMethod& filteringMethod)
+	{
+		context.SetPrimitiveTopology(PrimitiveTopology::TriangleList);
+		context.SetInputLayout(m_InputLayout);
+		context.SetVertexBuffer(0, m_VertexBuffer, sizeof(Vertex), 0);
+		context.SetIndexBuffer(m_IndexBuffer, Format::R32_UInt, 0);
+
+		// One range bind instead of a call per variable, the camera is in cbPerFrame
+		context.SetConstantBuffer(PerObjectConstants::Slot, objectConstants.buffer, objectConstants.byteOffset, objectConstants.byteSize);
+
+		SetTextures(context);
+		DrawPasses(context, filteringMethod);
+	}
+
+	void Mesh::SetTextures(ICommandContext& context) const
+	{
 		if (m_IsPartialCoverage)
 		{
-			static_cast<EffectPartialCoverage*>(m_pEffect)->SetDiffuseMap(m_pDiffuseTexture);
+			static_cast<EffectPartialCoverage*>(m_pEffect)->SetDiffuseMap(context, m_Textures.pDiffuse);
 		}
 		else
 		{
-			static_cast<EffectDefault*>(m_pEffect)->SetDiffuseMap(m_pDiffuseTexture);
-			static_cast<EffectDefault*>(m_pEffect)->SetNormalMap(m_pNormalTexture);
-			static_cast<EffectDefault*>(m_pEffect)->SetSpecularMap(m_pSpecularTexture);
-			static_cast<EffectDefault*>(m_pEffect)->SetGlossinessMap(m_pGlossinessTexture);
+			static_cast<EffectDefault*>(m_pEffect)->SetDiffuseMap(context, m_Textures.pDiffuse);
+			static_cast<EffectDefault*>(m_pEffect)->SetNormalMap(context, m_Textures.pNormal);
+			static_cast<EffectDefault*>(m_pEffect)->SetSpecularMap(context, m_Textures.pSpecular);
+			static_cast<EffectDefault*>(m_pEffect)->SetGlossinessMap(context, m_Textures.pGlossiness);
 		}
-		
-
+	}
 
-		//6. Draw
-		D3DX11_TECHNIQUE_DESC techDesc{};
+	void Mesh::DrawPasses(ICommandContext& context, const FilteringMethod& filteringMethod)
+	{
 		m_FilteringMethod = filteringMethod;
-		m_pEffect->GetTechnique(m_FilteringMethod)->GetDesc(&techDesc);
-		for (UINT p = 0; p < techDesc.Passes; ++p)
+		const TechniqueHandle technique = m_pEffect->GetTechnique(m_FilteringMethod);
+		const uint32_t numPasses = m_Device.GetPassCount(technique);
+		for (uint32_t p = 0; p < numPasses; ++p)
 		{
-			m_pEffect->GetTechnique(m_FilteringMethod)->GetPassByIndex(p)->Apply(0, pDeviceContext);
-			pDeviceContext->DrawIndexed(m_NumIndices, 0, 0);
+			context.ApplyTechnique(technique, p);
+			context.DrawIndexed(m_NumIndices, 0, 0);
 		}
+	}
 
+
+	void Mesh::RenderInstanced(ICommandContext& context, const InstanceBuffer& instances, const FilteringMethod& filteringMethod)
+	{
+		if (instances.GetCount() == 0)
+			return;
+
+		context.SetPrimitiveTopology(PrimitiveTopology::TriangleList);
+		context.SetInputLayout(m_InstancedInputLayout);
+		context.SetVertexBuffer(0, m_VertexBuffer, sizeof(Vertex), 0);
+		context.SetVertexBuffer(1, instances.GetBuffer(), sizeof(InstanceData), 0);
+		context.SetIndexBuffer(m_IndexBuffer, Format::R32_UInt, 0);
+
+		// The world matrix comes per instance, the camera from cbPerFrame
+		SetTextures(context);
+
+		const TechniqueHandle technique = m_pEffect->GetInstancedTechnique(filteringMethod);
+		const uint32_t numPasses = m_Device.GetPassCount(technique);
+		for (uint32_t p = 0; p < numPasses; ++p)
+		{
+			context.ApplyTechnique(technique, p);
+			context.DrawIndexedInstanced(m_NumIndices, instances.GetCount(), 0, 0, 0);
+		}
 	}
 
+	uint64_t Mesh::GetSortKey(uint32_t layer, float depth, const FilteringMethod& filteringMethod) const
+	{
+		const uint32_t effect = m_pEffect->GetEffect().id;
+		const uint32_t technique = m_pEffect->GetTechnique(filteringMethod).id;
+		const uint32_t textureSet = m_Textures.pDiffuse ? m_Textures.pDiffuse->GetHandle().id : 0;
+		if (m_IsPartialCoverage)
+			return DrawKey::MakeTranslucent(layer, effect, technique, textureSet, depth);
+		return DrawKey::MakeOpaque(layer, effect, technique, textureSet, depth);
+	}
 
-};
\ No newline at end of file
+};
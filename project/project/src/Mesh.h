@@ -1,37 +1,32 @@
 #pragma once
 
 //includes
-#include "math.h"
+#include "Math.h"
+#include "Bounds.h"
+#include "Vertex.h"
 #include "Effect.h"
 #include "EffectPartialCoverage.h"
 #include "EffectDefault.h"
+#include "InstanceBuffer.h"
+#include "ConstantBufferRing.h"
 #include <cassert>
+#include <vector>
 
 namespace dae {
 
-	struct Vertex
+	// Textures a mesh binds, owned by whoever loaded them (PartialCoverage only uses the diffuse map)
+	struct MeshTextures
 	{
-		Vector3 position{};
-		//Vector3 worldPosition{};
-		Vector2 uv{};
-		Vector3 normal{}; 
-		Vector3 tangent{};
-		//Vector3 viewDirection{}; 
-	};
-
-	struct Vertex_In
-	{
-		Vector3 position{};
-		Vector2 uv{};
-		Vector3 normal{};
-		Vector3 tangent{};
-		//Vector3 viewDirection{};
+		const Texture* pDiffuse{ nullptr };
+		const Texture* pNormal{ nullptr };
+		const Texture* pSpecular{ nullptr };
+		const Texture* pGlossiness{ nullptr };
 	};
 
 	class Mesh 
 	{
 	public:
-		Mesh( ID3D11Device* pDevice, const std::vector<Vertex_In>& vertices, const std::vector<uint32_t>& indices,  bool isPartialCoverage );
+		Mesh( IRenderDevice& device, const std::vector<Vertex_In>& vertices, const std::vector<uint32_t>& indices,  bool isPartialCoverage, const MeshTextures& textures );
 		~Mesh();
 
 		Mesh(const Mesh&) = delete;
@@ -39,24 +34,38 @@ namespace dae {
 		Mesh& operator=(const Mesh&) = delete;
 		Mesh& operator=(Mesh&&) noexcept = delete;
 
-		virtual void Render(ID3D11DeviceContext* pDeviceContext, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix, const Vector3& cameraPos, const FilteringMethod& filteringMethod);
+		virtual void Render(ICommandContext& context, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix, const Vector3& cameraPos, const FilteringMethod& filteringMethod);
+		// Same draw with its matrices from a ring block (PerObjectConstants) bound as cbPerObject instead of set as
+		// effect variables. cbPerFrame (camera) has to be bound already
+		void Render(ICommandContext& context, const ConstantBufferRange& objectConstants, const FilteringMethod& filteringMethod);
+		// Every instance of the (uploaded) buffer in one DrawIndexedInstanced, in buffer order: blended meshes need
+		// their instances sorted back to front (see TransparencySorter). cbPerFrame (camera) has to be bound already
+		void RenderInstanced(ICommandContext& context, const InstanceBuffer& instances, const FilteringMethod& filteringMethod);
+
+		const AABB& GetBounds() const { return m_Bounds; }	// object space
+		bool IsPartialCoverage() const { return m_IsPartialCoverage; }
+
+		// DrawList key from the effect, technique and diffuse map ids (blended meshes sort back to front), depth: 0 near to 1 far
+		uint64_t GetSortKey(uint32_t layer, float depth, const FilteringMethod& filteringMethod) const;
 		
 	private:
+		IRenderDevice& m_Device;
 		const bool m_IsPartialCoverage;
+		AABB m_Bounds{};
 
 		Effect* m_pEffect = nullptr;
-		ID3DX11EffectTechnique* m_pTechnique = nullptr;
 		FilteringMethod m_FilteringMethod{}; 
 
-		ID3D11InputLayout* m_pInputLayout = nullptr;
-		ID3D11Buffer* m_pVertexBuffer = nullptr;
-		ID3D11Buffer* m_pIndexBuffer = nullptr;
+		InputLayoutHandle m_InputLayout{};
+		InputLayoutHandle m_InstancedInputLayout{};	// vertices in slot 0, InstanceData in slot 1
+		BufferHandle m_VertexBuffer{};
+		BufferHandle m_IndexBuffer{};
 
 		uint32_t m_NumIndices{};
 
-		Texture* m_pDiffuseTexture;
-		Texture* m_pNormalTexture;
-		Texture* m_pSpecularTexture;
-		Texture* m_pGlossinessTexture;
+		MeshTextures m_Textures{};
+
+		void SetTextures(ICommandContext& context) const;
+		void DrawPasses(ICommandContext& context, const FilteringMethod& filteringMethod);
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,176 @@
+#include "NullRenderDevice.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace dae
+{
+	const char* ToString(RenderCall call)
+	{
+		static constexpr const char* names[]{
+			"CreateBuffer", "CreateTexture", "CreateEffect", "CreateInputLayout", "GetTechnique", "GetEffectVariable", "Destroy",
+			"ClearRenderTarget", "ClearDepthStencil", "SetRenderTargets", "Transition", "SetPrimitiveTopology", "SetInputLayout", "SetVertexBuffer", "SetIndexBuffer",
+			"SetEffectMatrix", "SetEffectVector", "SetEffectTexture", "ApplyTechnique",
+			"UpdateBuffer", "WriteBuffer", "SetConstantBuffer", "DrawIndexed", "DrawIndexedInstanced", "Present", "SignalFence" };
+		static_assert(std::size(names) == static_cast<size_t>(RenderCall::Count));
+
+		return names[static_cast<size_t>(call)];
+	}
+
+	uint64_t NullRenderDevice::GetContextCallCount() const
+	{
+		uint64_t count{};
+		for (size_t call{ static_cast<size_t>(RenderCall::ClearRenderTarget) }; call < m_CallCounts.size(); ++call)
+			count += m_CallCounts[call];
+		return count;
+	}
+
+	void NullRenderDevice::ResetCounters()
+	{
+		m_CallCounts = {};
+		m_RecordedCalls.clear();
+	}
+
+	BufferHandle NullRenderDevice::CreateBuffer(const BufferDesc& desc, [[maybe_unused]] const void* pInitialData)
+	{
+		// Immutable buffers need their contents up front, like D3D11_USAGE_IMMUTABLE
+		assert(desc.byteSize > 0 && (desc.isDynamic || pInitialData));
+		const uint32_t id = Allocate();
+		if (desc.isDynamic)
+			m_DynamicBufferSizes.emplace(id, desc.byteSize);
+		Record(RenderCall::CreateBuffer, id, desc.byteSize);
+		return { id };
+	}
+
+	TextureHandle NullRenderDevice::CreateTexture([[maybe_unused]] const TextureDesc& desc, [[maybe_unused]] const void* pTexels, [[maybe_unused]] uint32_t rowPitch)
+	{
+		// Only textures that are drawn into can start without texels
+		assert(desc.width > 0 && desc.height > 0);
+		assert((pTexels && rowPitch > 0) || desc.isRenderTarget || desc.isDepthStencil);
+		assert(!desc.isDepthStencil || desc.format == Format::D24_UNorm_S8_UInt);
+		const uint32_t id = Allocate();
+		Record(RenderCall::CreateTexture, id);
+		return { id };
+	}
+
+	EffectHandle NullRenderDevice::CreateEffect(const std::wstring&)
+	{
+		const uint32_t id = Allocate();
+		Record(RenderCall::CreateEffect, id);
+		return { id };
+	}
+
+	InputLayoutHandle NullRenderDevice::CreateInputLayout([[maybe_unused]] std::span<const InputElement> elements, [[maybe_unused]] TechniqueHandle technique)
+	{
+		assert(!elements.empty() && technique.IsValid());
+		const uint32_t id = Allocate();
+		Record(RenderCall::CreateInputLayout, id);
+		return { id };
+	}
+
+	TechniqueHandle NullRenderDevice::GetTechnique(EffectHandle effect, const std::string&)
+	{
+		// Every name exists, there is no .fx to check against
+		if (!effect.IsValid())
+			return {};
+		const uint32_t id = Allocate(effect.id);
+		Record(RenderCall::GetTechnique, id);
+		return { id };
+	}
+
+	EffectVariableHandle NullRenderDevice::GetEffectVariable(EffectHandle effect, const std::string&)
+	{
+		if (!effect.IsValid())
+			return {};
+		const uint32_t id = Allocate(effect.id);
+		Record(RenderCall::GetEffectVariable, id);
+		return { id };
+	}
+
+	void NullRenderDevice::Destroy(EffectHandle effect)
+	{
+		if (!effect.IsValid())
+			return;
+
+		std::erase_if(m_LiveResources, [&](const auto& resource) { return resource.second == effect.id; });
+		Release(effect.id);
+	}
+
+	uint32_t NullRenderDevice::Allocate(uint32_t ownerEffect)
+	{
+		const uint32_t id = m_NextId++;
+		m_LiveResources.emplace(id, ownerEffect);
+		return id;
+	}
+
+	void NullRenderDevice::Release(uint32_t id)
+	{
+		if (id == 0)
+			return;
+
+		Record(RenderCall::Destroy, id);
+		[[maybe_unused]] const size_t numErased = m_LiveResources.erase(id);
+		assert(numErased == 1 && "Destroying a handle twice or one this device did not create");
+		m_DynamicBufferSizes.erase(id);
+	}
+
+	void NullRenderDevice::SetRenderTargets(std::span<const TextureHandle> colorTargets, TextureHandle depthStencil)
+	{
+		// D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT
+		assert(colorTargets.size() <= 8);
+		Record(RenderCall::SetRenderTargets, depthStencil.id, static_cast<uint32_t>(colorTargets.size()));
+	}
+
+	void NullRenderDevice::Transition(TextureHandle texture, [[maybe_unused]] ResourceState before, ResourceState after)
+	{
+		assert(texture.IsValid() && before != after && after != ResourceState::Undefined);
+		Record(RenderCall::Transition, texture.id, static_cast<uint32_t>(after));
+	}
+
+	void NullRenderDevice::UpdateBuffer(BufferHandle buffer, [[maybe_unused]] const void* pData, uint32_t byteSize)
+	{
+		// Only dynamic buffers can be written, and not past their end
+		assert(IsWritable(buffer, 0, byteSize) && pData);
+		Record(RenderCall::UpdateBuffer, buffer.id, byteSize);
+	}
+
+	bool NullRenderDevice::IsWritable(BufferHandle buffer, uint32_t byteOffset, uint32_t byteSize) const
+	{
+		const auto it = m_DynamicBufferSizes.find(buffer.id);
+		return it != m_DynamicBufferSizes.end() && byteOffset + byteSize <= it->second;
+	}
+
+	void NullRenderDevice::WriteBuffer(BufferHandle buffer, [[maybe_unused]] uint32_t byteOffset, [[maybe_unused]] const void* pData, [[maybe_unused]] uint32_t byteSize)
+	{
+		assert(IsWritable(buffer, byteOffset, byteSize) && pData);
+		Record(RenderCall::WriteBuffer, buffer.id, byteOffset);
+	}
+
+	void NullRenderDevice::SetConstantBuffer(uint32_t slot, BufferHandle buffer, [[maybe_unused]] uint32_t byteOffset, [[maybe_unused]] uint32_t byteSize)
+	{
+		// Same limits as VSSetConstantBuffers1: offsets in 256 byte steps, at most 4096 float4s
+		assert(byteOffset % 256 == 0 && byteSize <= 4096 * 16);
+		Record(RenderCall::SetConstantBuffer, buffer.id, slot);
+	}
+
+	uint64_t NullRenderDevice::SignalFence()
+	{
+		Record(RenderCall::SignalFence);
+		return ++m_LastSignaledFence;
+	}
+
+	uint64_t NullRenderDevice::GetCompletedFence()
+	{
+		const uint64_t lagging = m_LastSignaledFence > m_FenceLatency ? m_LastSignaledFence - m_FenceLatency : 0;
+		m_CompletedFence = std::max(m_CompletedFence, lagging);
+		return m_CompletedFence;
+	}
+
+	void NullRenderDevice::WaitForFence(uint64_t fence)
+	{
+		assert(fence <= m_LastSignaledFence && "Waiting for a fence that was never signaled");
+		++m_NumFenceWaits;
+		m_CompletedFence = std::max(m_CompletedFence, fence);
+	}
+}
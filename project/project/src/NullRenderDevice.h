@@ -0,0 +1,169 @@
+#pragma once
+#include <array>
+#include <unordered_map>
+#include <vector>
+#include "RenderDevice.h"
+
+namespace dae
+{
+	enum class RenderCall
+	{
+		// Device
+		CreateBuffer = 0,
+		CreateTexture,
+		CreateEffect,
+		CreateInputLayout,
+		GetTechnique,
+		GetEffectVariable,
+		Destroy,
+
+		// Context
+		ClearRenderTarget,
+		ClearDepthStencil,
+		SetRenderTargets,
+		Transition,
+		SetPrimitiveTopology,
+		SetInputLayout,
+		SetVertexBuffer,
+		SetIndexBuffer,
+		SetEffectMatrix,
+		SetEffectVector,
+		SetEffectTexture,
+		ApplyTechnique,
+		UpdateBuffer,
+		WriteBuffer,
+		SetConstantBuffer,
+		DrawIndexed,
+		DrawIndexedInstanced,
+		Present,
+		SignalFence,
+
+		Count
+	};
+
+	const char* ToString(RenderCall call);
+
+	// Backend without a GPU: hands out handles, counts every call and optionally records them in order.
+	// Used to measure submission cost apart from the driver and to assert call counts headlessly.
+	// Fences complete right away unless a latency is set, then the simulated GPU stays that many fences behind
+	class NullRenderDevice final : public IRenderDevice, private ICommandContext
+	{
+	public:
+		struct RecordedCall
+		{
+			RenderCall call{};
+			uint32_t handle{};	// id of the resource the call is about, 0 if none
+			uint32_t value{};	// slot, pass, byte size, byte offset, index count, target count or new state
+			uint32_t instanceCount{};	// DrawIndexedInstanced only
+		};
+
+		NullRenderDevice() = default;
+		~NullRenderDevice() override = default;
+
+		NullRenderDevice(const NullRenderDevice&) = delete;
+		NullRenderDevice(NullRenderDevice&&) noexcept = delete;
+		NullRenderDevice& operator=(const NullRenderDevice&) = delete;
+		NullRenderDevice& operator=(NullRenderDevice&&) noexcept = delete;
+
+		// Counters
+		// ------
+		uint64_t GetCallCount(RenderCall call) const { return m_CallCounts[static_cast<size_t>(call)]; }
+		uint64_t GetContextCallCount() const;	// everything recorded through the context
+		void ResetCounters();
+
+		void SetRecording(bool isRecording) { m_IsRecording = isRecording; }
+		const std::vector<RecordedCall>& GetRecordedCalls() const { return m_RecordedCalls; }
+
+		size_t GetLiveResourceCount() const { return m_LiveResources.size(); }
+
+		// Fences
+		// ------
+		void SetFenceLatency(uint32_t numFences) { m_FenceLatency = numFences; }
+		uint64_t GetLastSignaledFence() const { return m_LastSignaledFence; }
+		uint32_t GetNumFenceWaits() const { return m_NumFenceWaits; }
+
+		// IRenderDevice
+		// ------
+		BufferHandle CreateBuffer(const BufferDesc& desc, const void* pInitialData) override;
+		TextureHandle CreateTexture(const TextureDesc& desc, const void* pTexels, uint32_t rowPitch) override;
+		EffectHandle CreateEffect(const std::wstring& assetFile) override;
+		InputLayoutHandle CreateInputLayout(std::span<const InputElement> elements, TechniqueHandle technique) override;
+
+		TechniqueHandle GetTechnique(EffectHandle effect, const std::string& name) override;
+		EffectVariableHandle GetEffectVariable(EffectHandle effect, const std::string& name) override;
+		uint32_t GetPassCount(TechniqueHandle technique) const override { return technique.IsValid() ? 1 : 0; }
+
+		void Destroy(BufferHandle buffer) override { Release(buffer.id); }
+		void Destroy(TextureHandle texture) override { Release(texture.id); }
+		void Destroy(InputLayoutHandle inputLayout) override { Release(inputLayout.id); }
+		void Destroy(EffectHandle effect) override;
+
+		ICommandContext& GetImmediateContext() override { return *this; }
+		TextureHandle GetBackBuffer() const override { return { s_BackBufferId }; }
+
+		uint64_t GetCompletedFence() override;
+		void WaitForFence(uint64_t fence) override;
+
+	private:
+		// Reserved up front and not a live resource: nobody creates or destroys the back buffer
+		static constexpr uint32_t s_BackBufferId{ 1 };
+
+		std::array<uint64_t, static_cast<size_t>(RenderCall::Count)> m_CallCounts{};
+		std::vector<RecordedCall> m_RecordedCalls{};
+		bool m_IsRecording{ false };
+
+		// id -> owning effect (0 for resources that are not part of an effect)
+		std::unordered_map<uint32_t, uint32_t> m_LiveResources{};
+		// id -> byte size, UpdateBuffer/WriteBuffer are checked against it
+		std::unordered_map<uint32_t, uint32_t> m_DynamicBufferSizes{};
+		uint32_t m_NextId{ s_BackBufferId + 1 };
+
+		uint64_t m_LastSignaledFence{ 0 };
+		uint64_t m_CompletedFence{ 0 };	// what waits forced, the latency only ever lets it lag behind the last signal
+		uint32_t m_FenceLatency{ 0 };
+		uint32_t m_NumFenceWaits{ 0 };
+
+		void Record(RenderCall call, uint32_t handle = 0, uint32_t value = 0, uint32_t instanceCount = 0)
+		{
+			++m_CallCounts[static_cast<size_t>(call)];
+			if (m_IsRecording)
+				m_RecordedCalls.push_back({ call, handle, value, instanceCount });
+		}
+		uint32_t Allocate(uint32_t ownerEffect = 0);
+		void Release(uint32_t id);
+		// Dynamic and big enough, only looked up in asserts so release builds time the calls alone
+		bool IsWritable(BufferHandle buffer, uint32_t byteOffset, uint32_t byteSize) const;
+
+		// ICommandContext
+		// ------
+		void ClearRenderTarget(const ColorRGB&) override { Record(RenderCall::ClearRenderTarget); }
+		void ClearDepthStencil(float, uint8_t) override { Record(RenderCall::ClearDepthStencil); }
+
+		void SetRenderTargets(std::span<const TextureHandle> colorTargets, TextureHandle depthStencil) override;
+		void Transition(TextureHandle texture, ResourceState before, ResourceState after) override;
+
+		void SetPrimitiveTopology(PrimitiveTopology topology) override { Record(RenderCall::SetPrimitiveTopology, 0, static_cast<uint32_t>(topology)); }
+		void SetInputLayout(InputLayoutHandle inputLayout) override { Record(RenderCall::SetInputLayout, inputLayout.id); }
+		void SetVertexBuffer(uint32_t slot, BufferHandle buffer, uint32_t, uint32_t) override { Record(RenderCall::SetVertexBuffer, buffer.id, slot); }
+		void SetIndexBuffer(BufferHandle buffer, Format, uint32_t) override { Record(RenderCall::SetIndexBuffer, buffer.id); }
+
+		void SetEffectMatrix(EffectVariableHandle variable, const Matrix&) override { Record(RenderCall::SetEffectMatrix, variable.id); }
+		void SetEffectVector(EffectVariableHandle variable, const Vector3&) override { Record(RenderCall::SetEffectVector, variable.id); }
+		void SetEffectTexture(EffectVariableHandle variable, TextureHandle texture) override { Record(RenderCall::SetEffectTexture, variable.id, texture.id); }
+		void ApplyTechnique(TechniqueHandle technique, uint32_t passIndex) override { Record(RenderCall::ApplyTechnique, technique.id, passIndex); }
+
+		void UpdateBuffer(BufferHandle buffer, const void* pData, uint32_t byteSize) override;
+		void WriteBuffer(BufferHandle buffer, uint32_t byteOffset, const void* pData, uint32_t byteSize) override;
+		void SetConstantBuffer(uint32_t slot, BufferHandle buffer, uint32_t byteOffset, uint32_t byteSize) override;
+
+		void DrawIndexed(uint32_t indexCount, uint32_t, int32_t) override { Record(RenderCall::DrawIndexed, 0, indexCount); }
+		void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t, int32_t, uint32_t) override
+		{
+			Record(RenderCall::DrawIndexedInstanced, 0, indexCount, instanceCount);
+		}
+
+		void Present() override { Record(RenderCall::Present); }
+
+		uint64_t SignalFence() override;
+	};
+}
@@ -0,0 +1,212 @@
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+#include "RasterKernels.h"
+
+namespace dae
+{
+	static_assert(OcclusionCuller::TileWidth == RasterKernels::SpanWidth, "A tile row is one raster span");
+	static_assert(OcclusionCuller::TileWidth * OcclusionCuller::TileHeight == 32, "Tile masks are 32 bit");
+
+	static constexpr uint32_t s_FullMask{ ~0u };
+	static constexpr float s_GuardBand{ 16384.f };
+
+	OcclusionCuller::OcclusionCuller(int width, int height)
+		: m_Width{ (width + TileWidth - 1) / TileWidth * TileWidth }
+		, m_Height{ (height + TileHeight - 1) / TileHeight * TileHeight }
+		, m_NumTilesX{ m_Width / TileWidth }
+		, m_NumTilesY{ m_Height / TileHeight }
+		, m_Tiles(size_t(m_NumTilesX) * m_NumTilesY)
+	{
+		assert(width > 0 && height > 0);
+	}
+
+	void OcclusionCuller::BeginFrame()
+	{
+		std::fill(m_Tiles.begin(), m_Tiles.end(), Tile{});
+		m_Stats = {};
+	}
+
+	void OcclusionCuller::UpdateTile(Tile& tile, uint32_t coverage, float zMax)
+	{
+		// Behind everything already known for the tile, it can't tighten anything
+		if (zMax >= tile.zMax0)
+			return;
+
+		// Merging pushes the layer back to its farthest triangle. When the working layer is farther behind
+		// the new triangle than in front of the reference, dropping it loses less than merging
+		if (tile.zMax1 - zMax > tile.zMax0 - tile.zMax1)
+		{
+			tile.mask = 0;
+			tile.zMax1 = 0.f;
+		}
+
+		tile.mask |= coverage;
+		tile.zMax1 = std::max(tile.zMax1, zMax);
+
+		// Working layer covers the whole tile: it becomes the reference
+		if (tile.mask == s_FullMask)
+		{
+			tile.zMax0 = tile.zMax1;
+			tile.mask = 0;
+			tile.zMax1 = 0.f;
+		}
+	}
+
+	void OcclusionCuller::RenderOccluder(std::span<const Vector3> positions, std::span<const uint32_t> indices, const Matrix& worldViewProjectionMatrix)
+	{
+		using namespace RasterKernels;
+
+		const float halfWidth = m_Width * 0.5f;
+		const float halfHeight = m_Height * 0.5f;
+
+		for (size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+		{
+			++m_Stats.numOccluderTriangles;
+
+			int32_t x[3]{}, y[3]{};
+			float z[3]{};
+			bool isValid{ true };
+			for (int v{ 0 }; v < 3 && isValid; ++v)
+			{
+				const Vector4 position = worldViewProjectionMatrix.TransformPoint(Vector4{ positions[indices[i + v]], 1.f });
+				if (position.w <= 1e-6f)
+				{
+					isValid = false;
+					break;
+				}
+
+				const float invW = 1.f / position.w;
+				const float screenX = (position.x * invW + 1.f) * halfWidth;
+				const float screenY = (1.f - position.y * invW) * halfHeight;
+				isValid = std::abs(screenX) <= s_GuardBand && std::abs(screenY) <= s_GuardBand;
+
+				x[v] = static_cast<int32_t>(std::lround(screenX * SubPixelScale));
+				y[v] = static_cast<int32_t>(std::lround(screenY * SubPixelScale));
+				z[v] = position.z * invW;
+			}
+			if (!isValid)
+				continue;
+
+			const int64_t doubleArea = int64_t(x[1] - x[0]) * (y[2] - y[0]) - int64_t(y[1] - y[0]) * (x[2] - x[0]);
+			if (doubleArea <= 0)
+				continue;
+
+			const int minX = std::max(0, (std::min({ x[0], x[1], x[2] }) - SubPixelHalf + SubPixelScale - 1) >> SubPixelBits);
+			const int minY = std::max(0, (std::min({ y[0], y[1], y[2] }) - SubPixelHalf + SubPixelScale - 1) >> SubPixelBits);
+			const int maxX = std::min(m_Width - 1, (std::max({ x[0], x[1], x[2] }) - SubPixelHalf) >> SubPixelBits);
+			const int maxY = std::min(m_Height - 1, (std::max({ y[0], y[1], y[2] }) - SubPixelHalf) >> SubPixelBits);
+			if (minX > maxX || minY > maxY)
+				continue;
+
+			++m_Stats.numRasterized;
+
+			// Coverage per tile row with the exact rasterizer, the tile depth is the farthest covered pixel
+			const int startX = minX / TileWidth * TileWidth;
+			const int startY = minY / TileHeight * TileHeight;
+			const EdgeSetup setup = SetupEdges(x, y, z, doubleArea, startX, startY);
+			SpanOutput span{};
+			for (int tileY{ startY / TileHeight }; tileY <= maxY / TileHeight; ++tileY)
+			{
+				for (int tileX{ startX / TileWidth }; tileX <= maxX / TileWidth; ++tileX)
+				{
+					uint32_t coverage{};
+					float zMax{};
+					for (int row{ 0 }; row < TileHeight; ++row)
+					{
+						const int64_t offsetX = tileX * TileWidth - startX;
+						const int64_t offsetY = tileY * TileHeight + row - startY;
+						const int64_t edge[3]{
+							setup.edge[0] + offsetX * setup.stepX[0] + offsetY * setup.stepY[0],
+							setup.edge[1] + offsetX * setup.stepX[1] + offsetY * setup.stepY[1],
+							setup.edge[2] + offsetX * setup.stepX[2] + offsetY * setup.stepY[2] };
+
+						const uint32_t covered = RasterizeSpan(setup, edge, SpanWidth, nullptr, span);
+						for (uint32_t bits = covered; bits != 0; bits &= bits - 1)
+							zMax = std::max(zMax, span.depth[std::countr_zero(bits)]);
+						coverage |= covered << (row * TileWidth);
+					}
+
+					if (coverage != 0)
+						UpdateTile(m_Tiles[size_t(tileY) * m_NumTilesX + tileX], coverage, zMax);
+				}
+			}
+		}
+	}
+
+	bool OcclusionCuller::IsVisible(const AABB& bounds, const Matrix& worldViewProjectionMatrix)
+	{
+		++m_Stats.numTested;
+
+		// Screen rectangle and nearest depth of the 8 corners
+		const Vector3 min = bounds.GetMin();
+		const Vector3 max = bounds.GetMax();
+		float screenMinX{ FLT_MAX }, screenMinY{ FLT_MAX }, screenMaxX{ -FLT_MAX }, screenMaxY{ -FLT_MAX };
+		float zMin{ FLT_MAX };
+		for (int corner{ 0 }; corner < 8; ++corner)
+		{
+			const Vector3 point{ (corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y, (corner & 4) ? max.z : min.z };
+			const Vector4 position = worldViewProjectionMatrix.TransformPoint(Vector4{ point, 1.f });
+			if (position.w <= 1e-6f)
+				return true;	// reaches behind the eye
+
+			const float invW = 1.f / position.w;
+			const float screenX = (position.x * invW + 1.f) * 0.5f * m_Width;
+			const float screenY = (1.f - position.y * invW) * 0.5f * m_Height;
+			screenMinX = std::min(screenMinX, screenX);
+			screenMaxX = std::max(screenMaxX, screenX);
+			screenMinY = std::min(screenMinY, screenY);
+			screenMaxY = std::max(screenMaxY, screenY);
+			zMin = std::min(zMin, position.z * invW);
+		}
+
+		// Every pixel the rectangle touches (clamped before the int conversion, corners can be far off screen)
+		const int minX = static_cast<int>(std::floor(std::max(screenMinX, 0.f)));
+		const int minY = static_cast<int>(std::floor(std::max(screenMinY, 0.f)));
+		const int maxX = static_cast<int>(std::floor(std::min(screenMaxX, m_Width - 1.f)));
+		const int maxY = static_cast<int>(std::floor(std::min(screenMaxY, m_Height - 1.f)));
+		if (minX > maxX || minY > maxY)
+		{
+			++m_Stats.numOccluded;	// off screen
+			return false;
+		}
+
+		for (int tileY{ minY / TileHeight }; tileY <= maxY / TileHeight; ++tileY)
+		{
+			const int rowBegin = std::max(minY - tileY * TileHeight, 0);
+			const int rowEnd = std::min(maxY - tileY * TileHeight, TileHeight - 1);
+			for (int tileX{ minX / TileWidth }; tileX <= maxX / TileWidth; ++tileX)
+			{
+				const int columnBegin = std::max(minX - tileX * TileWidth, 0);
+				const int columnEnd = std::min(maxX - tileX * TileWidth, TileWidth - 1);
+				const uint32_t rowMask = ((1u << (columnEnd + 1)) - 1) & ~((1u << columnBegin) - 1);
+				uint32_t rectangleMask{};
+				for (int row{ rowBegin }; row <= rowEnd; ++row)
+					rectangleMask |= rowMask << (row * TileWidth);
+
+				// Only pixels of the working layer under the box: its depth is the tighter bound
+				const Tile& tile = m_Tiles[size_t(tileY) * m_NumTilesX + tileX];
+				const float tileZMax = (rectangleMask & ~tile.mask) == 0 ? std::min(tile.zMax0, tile.zMax1) : tile.zMax0;
+				if (zMin < tileZMax)
+					return true;
+			}
+		}
+
+		++m_Stats.numOccluded;
+		return false;
+	}
+
+	float OcclusionCuller::GetDepthBound(int x, int y) const
+	{
+		assert(x >= 0 && x < m_Width && y >= 0 && y < m_Height);
+
+		const Tile& tile = m_Tiles[size_t(y / TileHeight) * m_NumTilesX + x / TileWidth];
+		const uint32_t bit = 1u << ((y % TileHeight) * TileWidth + x % TileWidth);
+		return (tile.mask & bit) ? std::min(tile.zMax0, tile.zMax1) : tile.zMax0;
+	}
+}
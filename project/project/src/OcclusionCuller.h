@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Math.h"
+#include "Bounds.h"
+
+namespace dae
+{
+	// Conservative occlusion test against a low resolution depth approximation of a few large occluders,
+	// in the style of masked occlusion culling (Hasselgren et al. 2016). There is no per pixel depth:
+	// every 8x4 pixel tile keeps a reference layer (farthest depth of the whole tile) and a working layer
+	// (coverage mask + farthest depth of the covered pixels) that becomes the reference once it is full.
+	// Frame: BeginFrame -> RenderOccluder... -> IsVisible...
+	class OcclusionCuller final
+	{
+	public:
+		struct Stats
+		{
+			uint32_t numOccluderTriangles{};	// submitted
+			uint32_t numRasterized{};			// front facing, in front of the eye, on screen
+			uint32_t numTested{};
+			uint32_t numOccluded{};				// hidden or off screen
+		};
+
+		static constexpr int TileWidth{ 8 };
+		static constexpr int TileHeight{ 4 };
+
+		OcclusionCuller(int width, int height);	// rounded up to whole tiles
+		~OcclusionCuller() = default;
+
+		OcclusionCuller(const OcclusionCuller&) = delete;
+		OcclusionCuller(OcclusionCuller&&) noexcept = delete;
+		OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+		OcclusionCuller& operator=(OcclusionCuller&&) noexcept = delete;
+
+		void BeginFrame();
+
+		// Front faces (clockwise on screen) only, like the default D3D rasterizer state. Triangles reaching
+		// behind the eye or past the guard band are skipped, leaving out an occluder is always safe
+		void RenderOccluder(std::span<const Vector3> positions, std::span<const uint32_t> indices, const Matrix& worldViewProjectionMatrix);
+
+		// false when the box is completely hidden behind the occluders rendered so far
+		bool IsVisible(const AABB& bounds, const Matrix& worldViewProjectionMatrix);
+
+		int GetWidth() const { return m_Width; }
+		int GetHeight() const { return m_Height; }
+		const Stats& GetStats() const { return m_Stats; }
+
+		// Farthest occluder depth at a pixel as the culler sees it, 1 where nothing is known
+		float GetDepthBound(int x, int y) const;
+
+	private:
+		struct Tile
+		{
+			uint32_t mask{};	// working layer coverage, bit = row * TileWidth + column
+			float zMax0{ 1.f };	// reference layer, whole tile
+			float zMax1{ 0.f };	// working layer, masked pixels
+		};
+
+		int m_Width;
+		int m_Height;
+		int m_NumTilesX;
+		int m_NumTilesY;
+
+		std::vector<Tile> m_Tiles;
+		Stats m_Stats{};
+
+		static void UpdateTile(Tile& tile, uint32_t coverage, float zMax);
+	};
+}
@@ -0,0 +1,195 @@
+#include "Quaternion.h"
+
+#include <cassert>
+#include <cmath>
+#include <xmmintrin.h>
+
+#include "Vector3.h"
+
+namespace dae
+{
+	const Quaternion Quaternion::Identity = Quaternion{ 0, 0, 0, 1 };
+
+	Quaternion::Quaternion(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+
+	Quaternion::Quaternion(const Vector3& axis, float angle)
+	{
+		const Vector3 n = axis.Normalized();
+		const float s = sinf(angle * 0.5f);
+		x = n.x * s;
+		y = n.y * s;
+		z = n.z * s;
+		w = cosf(angle * 0.5f);
+	}
+
+	float Quaternion::Magnitude() const
+	{
+		return sqrtf(x * x + y * y + z * z + w * w);
+	}
+
+	float Quaternion::SqrMagnitude() const
+	{
+		return x * x + y * y + z * z + w * w;
+	}
+
+	float Quaternion::Normalize()
+	{
+		const float m = Magnitude();
+		x /= m;
+		y /= m;
+		z /= m;
+		w /= m;
+
+		return m;
+	}
+
+	Quaternion Quaternion::Normalized() const
+	{
+		const float m = Magnitude();
+		return { x / m, y / m, z / m, w / m };
+	}
+
+	Quaternion Quaternion::Conjugate() const
+	{
+		return { -x, -y, -z, w };
+	}
+
+	Quaternion Quaternion::Inverse() const
+	{
+		const float sqrMagnitude = SqrMagnitude();
+		return { -x / sqrMagnitude, -y / sqrMagnitude, -z / sqrMagnitude, w / sqrMagnitude };
+	}
+
+	Vector3 Quaternion::Rotate(const Vector3& v) const
+	{
+		// v' = v + w * t + q.xyz x t, with t = 2 * (q.xyz x v)
+		const Vector3 u{ x, y, z };
+		const Vector3 t = Vector3::Cross(u, v) * 2.f;
+		return v + t * w + Vector3::Cross(u, t);
+	}
+
+	float Quaternion::Dot(const Quaternion& q1, const Quaternion& q2)
+	{
+		return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+	}
+
+	Quaternion Quaternion::Lerp(const Quaternion& q1, const Quaternion& q2, float factor)
+	{
+		// q and -q are the same rotation, flip to take the shortest arc
+		const float sign = Dot(q1, q2) < 0.f ? -1.f : 1.f;
+		const float f1 = 1.f - factor;
+		const float f2 = factor * sign;
+
+		Quaternion result{
+			q1.x * f1 + q2.x * f2,
+			q1.y * f1 + q2.y * f2,
+			q1.z * f1 + q2.z * f2,
+			q1.w * f1 + q2.w * f2 };
+		result.Normalize();
+
+		return result;
+	}
+
+	Quaternion Quaternion::Slerp(const Quaternion& q1, const Quaternion& q2, float factor)
+	{
+		float cosTheta = Dot(q1, q2);
+		const float sign = cosTheta < 0.f ? -1.f : 1.f;
+		cosTheta *= sign;
+
+		// Nearly parallel: sin(theta) goes to 0, the normalized lerp is exact enough
+		if (cosTheta > 0.9995f)
+			return Lerp(q1, q2, factor);
+
+		const float theta = acosf(cosTheta);
+		const float invSinTheta = 1.f / sinf(theta);
+		const float f1 = sinf((1.f - factor) * theta) * invSinTheta;
+		const float f2 = sinf(factor * theta) * invSinTheta * sign;
+
+		return {
+			q1.x * f1 + q2.x * f2,
+			q1.y * f1 + q2.y * f2,
+			q1.z * f1 + q2.z * f2,
+			q1.w * f1 + q2.w * f2 };
+	}
+
+	Quaternion Quaternion::CreateRotationX(float pitch)
+	{
+		// Matrix::CreateRotationX turns +Y towards -Z, which is a negative angle around +X
+		const float halfAngle = -pitch * 0.5f;
+		return { sinf(halfAngle), 0, 0, cosf(halfAngle) };
+	}
+
+	Quaternion Quaternion::CreateRotationY(float yaw)
+	{
+		const float halfAngle = yaw * 0.5f;
+		return { 0, sinf(halfAngle), 0, cosf(halfAngle) };
+	}
+
+	Quaternion Quaternion::CreateRotationZ(float roll)
+	{
+		const float halfAngle = roll * 0.5f;
+		return { 0, 0, sinf(halfAngle), cosf(halfAngle) };
+	}
+
+	Quaternion Quaternion::CreateRotation(float pitch, float yaw, float roll)
+	{
+		// Matrix::CreateRotation applies X, then Y, then Z (row vectors)
+		return CreateRotationZ(roll) * CreateRotationY(yaw) * CreateRotationX(pitch);
+	}
+
+	Quaternion Quaternion::CreateRotation(const Vector3& r)
+	{
+		return CreateRotation(r[0], r[1], r[2]);
+	}
+
+#pragma region Operator Overloads
+	Quaternion Quaternion::operator*(const Quaternion& q) const
+	{
+		// Hamilton product, one broadcast component of this times a swizzle of q per row
+		const __m128 b = _mm_loadu_ps(&q.x);
+
+		const __m128 bWZYX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3));
+		const __m128 bZWXY = _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2));
+		const __m128 bYXWZ = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1));
+
+		const __m128 signX = _mm_setr_ps(1.f, -1.f, 1.f, -1.f);
+		const __m128 signY = _mm_setr_ps(1.f, 1.f, -1.f, -1.f);
+		const __m128 signZ = _mm_setr_ps(-1.f, 1.f, 1.f, -1.f);
+
+		__m128 result = _mm_mul_ps(_mm_set1_ps(w), b);
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(x), _mm_mul_ps(bWZYX, signX)));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(y), _mm_mul_ps(bZWXY, signY)));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(z), _mm_mul_ps(bYXWZ, signZ)));
+
+		Quaternion out;
+		_mm_storeu_ps(&out.x, result);
+		return out;
+	}
+
+	Quaternion& Quaternion::operator*=(const Quaternion& q)
+	{
+		*this = *this * q;
+		return *this;
+	}
+
+	float& Quaternion::operator[](int index)
+	{
+		assert(index <= 3 && index >= 0);
+
+		if (index == 0)return x;
+		if (index == 1)return y;
+		if (index == 2)return z;
+		return w;
+	}
+
+	float Quaternion::operator[](int index) const
+	{
+		assert(index <= 3 && index >= 0);
+
+		if (index == 0)return x;
+		if (index == 1)return y;
+		if (index == 2)return z;
+		return w;
+	}
+#pragma endregion
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+namespace dae
+{
+	struct Vector3;
+	struct Vector4;
+	struct Quaternion
+	{
+		float x{};
+		float y{};
+		float z{};
+		float w{ 1.f };
+
+		Quaternion() = default;
+		Quaternion(float _x, float _y, float _z, float _w);
+		Quaternion(const Vector3& axis, float angle);
+
+		float Magnitude() const;
+		float SqrMagnitude() const;
+		float Normalize();
+		Quaternion Normalized() const;
+		Quaternion Conjugate() const;
+		Quaternion Inverse() const;
+
+		Vector3 Rotate(const Vector3& v) const;
+
+		static float Dot(const Quaternion& q1, const Quaternion& q2);
+		static Quaternion Lerp(const Quaternion& q1, const Quaternion& q2, float factor); // normalized lerp, shortest arc
+		static Quaternion Slerp(const Quaternion& q1, const Quaternion& q2, float factor);
+
+		// Same rotations as their Matrix::CreateRotation* counterparts
+		static Quaternion CreateRotationX(float pitch);
+		static Quaternion CreateRotationY(float yaw);
+		static Quaternion CreateRotationZ(float roll);
+		static Quaternion CreateRotation(float pitch, float yaw, float roll);
+		static Quaternion CreateRotation(const Vector3& r);
+
+		//Member Operators
+		Quaternion operator*(const Quaternion& q) const; // applies q first, then this
+		Quaternion& operator*=(const Quaternion& q);
+		float& operator[](int index);
+		float operator[](int index) const;
+
+		static const Quaternion Identity;
+	};
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dae
+{
+	// Stable LSD radix sort of items by the unsigned integer getKey(item) returns, ascending. Keys are sorted
+	// DigitBits at a time, as many passes as the key type needs (a 32 bit key with 11 bit digits: 11/11/10).
+	// All histograms come from one read of the keys, passes where every key has the same digit are skipped,
+	// so key bits no item uses cost a histogram instead of a scatter. scratch is resized to items.size()
+	template<int DigitBits, typename Item, typename KeyFunction>
+	void LsdRadixSort(std::span<Item> items, std::vector<Item>& scratch, KeyFunction getKey)
+	{
+		using Key = std::remove_cvref_t<std::invoke_result_t<KeyFunction, const Item&>>;
+		static_assert(std::is_unsigned_v<Key>, "Keys are sorted as unsigned integers");
+		static_assert(DigitBits > 0 && DigitBits <= 16, "Histograms live on the stack");
+
+		constexpr int numPasses{ (static_cast<int>(sizeof(Key)) * 8 + DigitBits - 1) / DigitBits };
+		constexpr uint32_t numDigits{ 1u << DigitBits };
+		constexpr Key digitMask{ numDigits - 1 };
+
+		const size_t count = items.size();
+		if (count < 2)
+			return;
+		scratch.resize(count);
+
+		uint32_t histograms[numPasses][numDigits];
+		std::memset(histograms, 0, sizeof(histograms));
+		for (const Item& item : items)
+		{
+			const Key key = getKey(item);
+			for (int pass{ 0 }; pass < numPasses; ++pass)
+				++histograms[pass][(key >> (pass * DigitBits)) & digitMask];
+		}
+
+		Item* pSource = items.data();
+		Item* pTarget = scratch.data();
+		for (int pass{ 0 }; pass < numPasses; ++pass)
+		{
+			// Every key has the same digit here: nothing moves
+			uint32_t* pHistogram = histograms[pass];
+			const int shift = pass * DigitBits;
+			if (pHistogram[(getKey(pSource[0]) >> shift) & digitMask] == count)
+				continue;
+
+			uint32_t offset{};
+			for (uint32_t digit{ 0 }; digit < numDigits; ++digit)
+			{
+				const uint32_t digitCount = pHistogram[digit];
+				pHistogram[digit] = offset;
+				offset += digitCount;
+			}
+
+			for (size_t i{ 0 }; i < count; ++i)
+				pTarget[pHistogram[(getKey(pSource[i]) >> shift) & digitMask]++] = pSource[i];
+			std::swap(pSource, pTarget);
+		}
+
+		if (pSource != items.data())
+			std::copy(pSource, pSource + count, items.data());
+	}
+}
@@ -0,0 +1,266 @@
+#include "RasterKernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#include "Simd.h"
+
+namespace dae
+{
+	namespace RasterKernels
+	{
+		// Edge values as doubles: integers below 2^53 add and multiply by small lane indices exactly,
+		// and unlike int64 lanes they convert straight to float
+#if defined(__AVX__)
+		using EdgeLane = __m256d;
+		static constexpr int s_EdgeLaneWidth{ 4 };
+
+		static inline EdgeLane EdgeBroadcast(double value) { return _mm256_set1_pd(value); }
+		static inline EdgeLane EdgeLoad(const double* pData) { return _mm256_loadu_pd(pData); }
+		static inline EdgeLane EdgeAdd(EdgeLane a, EdgeLane b) { return _mm256_add_pd(a, b); }
+		static inline EdgeLane EdgeMul(EdgeLane a, EdgeLane b) { return _mm256_mul_pd(a, b); }
+		static inline uint32_t EdgeSigns(EdgeLane a, EdgeLane b, EdgeLane c) { return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_or_pd(_mm256_or_pd(a, b), c))); }
+		static inline Simd::Lane EdgeToFloats(EdgeLane low, EdgeLane high) { return _mm256_set_m128(_mm256_cvtpd_ps(high), _mm256_cvtpd_ps(low)); }
+#else
+		using EdgeLane = __m128d;
+		static constexpr int s_EdgeLaneWidth{ 2 };
+
+		static inline EdgeLane EdgeBroadcast(double value) { return _mm_set1_pd(value); }
+		static inline EdgeLane EdgeLoad(const double* pData) { return _mm_loadu_pd(pData); }
+		static inline EdgeLane EdgeAdd(EdgeLane a, EdgeLane b) { return _mm_add_pd(a, b); }
+		static inline EdgeLane EdgeMul(EdgeLane a, EdgeLane b) { return _mm_mul_pd(a, b); }
+		static inline uint32_t EdgeSigns(EdgeLane a, EdgeLane b, EdgeLane c) { return static_cast<uint32_t>(_mm_movemask_pd(_mm_or_pd(_mm_or_pd(a, b), c))); }
+		static inline Simd::Lane EdgeToFloats(EdgeLane low, EdgeLane high) { return _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high)); }
+#endif
+		static constexpr int s_NumEdgeLanes{ SpanWidth / s_EdgeLaneWidth };
+		static constexpr double s_LaneIndices[SpanWidth]{ 0., 1., 2., 3., 4., 5., 6., 7. };
+		static_assert(SpanWidth == 8 && Simd::LaneWidth == 2 * s_EdgeLaneWidth, "One float lane holds two edge lanes");
+
+		struct SpanEdges
+		{
+			EdgeLane lanes[3][s_NumEdgeLanes];
+		};
+
+		static SpanEdges LoadSpan(const EdgeSetup& setup, const int64_t edge[3])
+		{
+			SpanEdges span;
+			for (int k{ 0 }; k < 3; ++k)
+			{
+				const EdgeLane start = EdgeBroadcast(double(edge[k]));
+				const EdgeLane stepX = EdgeBroadcast(double(setup.stepX[k]));
+				for (int j{ 0 }; j < s_NumEdgeLanes; ++j)
+					span.lanes[k][j] = EdgeAdd(start, EdgeMul(EdgeLoad(s_LaneIndices + j * s_EdgeLaneWidth), stepX));
+			}
+			return span;
+		}
+
+		// Bit i: all three edges of pixel i are >= 0
+		static uint32_t Coverage(const SpanEdges& span)
+		{
+			uint32_t outside{};
+			for (int j{ 0 }; j < s_NumEdgeLanes; ++j)
+				outside |= EdgeSigns(span.lanes[0][j], span.lanes[1][j], span.lanes[2][j]) << (j * s_EdgeLaneWidth);
+			return ~outside & ((1u << SpanWidth) - 1);
+		}
+
+		// Depth (and weights when asked for) of the whole span, returns the pixels passing the range and depth tests
+		static uint32_t Interpolate(const EdgeSetup& setup, const SpanEdges& span, int count, const float* pDepth, float* pDepthOut, float (*pWeightsOut)[SpanWidth])
+		{
+			// Partial spans must not read past the end of the depth row, the padding fails the less test
+			float depthPadded[SpanWidth];
+			if (pDepth && count < SpanWidth)
+			{
+				std::copy(pDepth, pDepth + count, depthPadded);
+				std::fill(depthPadded + count, depthPadded + SpanWidth, 0.f);
+				pDepth = depthPadded;
+			}
+
+			const Simd::Lane invDoubleArea = Simd::Broadcast(setup.invDoubleArea);
+			const Simd::Lane zero = Simd::Zero();
+			const Simd::Lane one = Simd::Broadcast(1.f);
+			EdgeLane bias[3];
+			for (int k{ 0 }; k < 3; ++k)
+				bias[k] = EdgeBroadcast(double(setup.bias[k]));
+
+			uint32_t passed{};
+			for (size_t i{ 0 }; i < SpanWidth; i += Simd::LaneWidth)
+			{
+				const int j = static_cast<int>(i) / s_EdgeLaneWidth;
+
+				// Undo the fill rule bias before turning the edges into weights
+				Simd::Lane weights[3];
+				for (int k{ 0 }; k < 3; ++k)
+					weights[k] = Simd::Mul(EdgeToFloats(EdgeAdd(span.lanes[k][j], bias[k]), EdgeAdd(span.lanes[k][j + 1], bias[k])), invDoubleArea);
+
+				const Simd::Lane depth = Simd::Add(Simd::Add(
+					Simd::Mul(weights[0], Simd::Broadcast(setup.z[0])),
+					Simd::Mul(weights[1], Simd::Broadcast(setup.z[1]))),
+					Simd::Mul(weights[2], Simd::Broadcast(setup.z[2])));
+				Simd::Store(pDepthOut + i, depth);
+				if (pWeightsOut)
+				{
+					for (int k{ 0 }; k < 3; ++k)
+						Simd::Store(pWeightsOut[k] + i, weights[k]);
+				}
+
+				const uint32_t outOfRange = Simd::MoveMask(Simd::Or(Simd::LessThan(depth, zero), Simd::LessThan(one, depth)));
+				const uint32_t closer = pDepth ? Simd::MoveMask(Simd::LessThan(depth, Simd::Load(pDepth + i))) : Simd::LaneBits;
+				passed |= (closer & ~outOfRange) << i;
+			}
+			return passed;
+		}
+
+		EdgeSetup SetupEdges(const int32_t x[3], const int32_t y[3], const float z[3], int64_t doubleArea, int startX, int startY)
+		{
+			assert(doubleArea > 0);
+
+			// Top-left fill rule: pixel centers exactly on an edge only belong to top and left edges
+			EdgeSetup setup{};
+			const int64_t sampleX = int64_t(startX) * SubPixelScale + SubPixelHalf;
+			const int64_t sampleY = int64_t(startY) * SubPixelScale + SubPixelHalf;
+			for (int k{ 0 }; k < 3; ++k)
+			{
+				const int a = (k + 1) % 3;
+				const int b = (k + 2) % 3;
+				const int64_t dx = int64_t(x[b]) - x[a];
+				const int64_t dy = int64_t(y[b]) - y[a];
+				const bool isTopLeft = dy < 0 || (dy == 0 && dx > 0);
+
+				setup.bias[k] = isTopLeft ? 0 : 1;
+				setup.edge[k] = dx * (sampleY - y[a]) - dy * (sampleX - x[a]) - setup.bias[k];
+				setup.stepX[k] = -dy * SubPixelScale;
+				setup.stepY[k] = dx * SubPixelScale;
+				setup.z[k] = z[k];
+			}
+			setup.invDoubleArea = 1.f / float(doubleArea);
+			return setup;
+		}
+
+		/* --- SPANS --- */
+
+		uint32_t RasterizeSpan(const EdgeSetup& setup, const int64_t edge[3], int count, const float* pDepth, SpanOutput& output)
+		{
+			assert(count > 0 && count <= SpanWidth);
+
+			const SpanEdges span = LoadSpan(setup, edge);
+			const uint32_t covered = Coverage(span) & ((1u << count) - 1);
+			if (covered == 0)
+				return 0;
+
+			return covered & Interpolate(setup, span, count, pDepth, output.depth, output.weights);
+		}
+
+		uint32_t RasterizeSpanReference(const EdgeSetup& setup, const int64_t edge[3], int count, const float* pDepth, SpanOutput& output)
+		{
+			assert(count > 0 && count <= SpanWidth);
+
+			uint32_t passed{};
+			for (int i{ 0 }; i < count; ++i)
+			{
+				const int64_t e0 = edge[0] + i * setup.stepX[0];
+				const int64_t e1 = edge[1] + i * setup.stepX[1];
+				const int64_t e2 = edge[2] + i * setup.stepX[2];
+				if ((e0 | e1 | e2) < 0)
+					continue;
+
+				const float w0 = float(e0 + setup.bias[0]) * setup.invDoubleArea;
+				const float w1 = float(e1 + setup.bias[1]) * setup.invDoubleArea;
+				const float w2 = float(e2 + setup.bias[2]) * setup.invDoubleArea;
+				const float depth = w0 * setup.z[0] + w1 * setup.z[1] + w2 * setup.z[2];
+				if (depth < 0.f || depth > 1.f || (pDepth && !(depth < pDepth[i])))
+					continue;
+
+				output.weights[0][i] = w0;
+				output.weights[1][i] = w1;
+				output.weights[2][i] = w2;
+				output.depth[i] = depth;
+				passed |= 1u << i;
+			}
+			return passed;
+		}
+
+		/* --- TRIANGLES --- */
+
+		uint64_t RasterizeDepth(const EdgeSetup& setup, int width, int height, float* pDepth, size_t pitch)
+		{
+			// Incremental: one span step and one row step per edge, no multiplies in the loops
+			SpanEdges row = LoadSpan(setup, setup.edge);
+			EdgeLane stepSpan[3], stepRow[3];
+			for (int k{ 0 }; k < 3; ++k)
+			{
+				stepSpan[k] = EdgeBroadcast(double(setup.stepX[k] * SpanWidth));
+				stepRow[k] = EdgeBroadcast(double(setup.stepY[k]));
+			}
+
+			uint64_t numPixels{};
+			alignas(32) float depth[SpanWidth];
+			for (int y{ 0 }; y < height; ++y)
+			{
+				float* pRow = pDepth + size_t(y) * pitch;
+				SpanEdges span = row;
+				bool wasCovered{ false };
+				for (int x{ 0 }; x < width; x += SpanWidth)
+				{
+					const int count = std::min(SpanWidth, width - x);
+					const uint32_t covered = Coverage(span) & ((1u << count) - 1);
+					if (covered == 0 && wasCovered)
+						break;	// a row crosses a triangle once, the rest is outside
+					wasCovered |= covered != 0;
+
+					const uint32_t passed = covered ? covered & Interpolate(setup, span, count, pRow + x, depth, nullptr) : 0;
+					if (passed == (1u << SpanWidth) - 1)
+					{
+						// Interior of the triangle, nothing in front: whole span at once
+						for (size_t i{ 0 }; i < SpanWidth; i += Simd::LaneWidth)
+							Simd::Store(pRow + x + i, Simd::Load(depth + i));
+						numPixels += SpanWidth;
+					}
+					else
+					{
+						for (uint32_t bits = passed; bits != 0; bits &= bits - 1)
+						{
+							const int i = std::countr_zero(bits);
+							pRow[x + i] = depth[i];
+							++numPixels;
+						}
+					}
+
+					for (int k{ 0 }; k < 3; ++k)
+						for (int j{ 0 }; j < s_NumEdgeLanes; ++j)
+							span.lanes[k][j] = EdgeAdd(span.lanes[k][j], stepSpan[k]);
+				}
+
+				for (int k{ 0 }; k < 3; ++k)
+					for (int j{ 0 }; j < s_NumEdgeLanes; ++j)
+						row.lanes[k][j] = EdgeAdd(row.lanes[k][j], stepRow[k]);
+			}
+			return numPixels;
+		}
+
+		uint64_t RasterizeDepthReference(const EdgeSetup& setup, int width, int height, float* pDepth, size_t pitch)
+		{
+			uint64_t numPixels{};
+			SpanOutput output{};
+			int64_t rowEdge[3]{ setup.edge[0], setup.edge[1], setup.edge[2] };
+			for (int y{ 0 }; y < height; ++y)
+			{
+				float* pRow = pDepth + size_t(y) * pitch;
+				for (int x{ 0 }; x < width; x += SpanWidth)
+				{
+					const int64_t edge[3]{ rowEdge[0] + x * setup.stepX[0], rowEdge[1] + x * setup.stepX[1], rowEdge[2] + x * setup.stepX[2] };
+					for (uint32_t passed = RasterizeSpanReference(setup, edge, std::min(SpanWidth, width - x), pRow + x, output); passed != 0; passed &= passed - 1)
+					{
+						const int i = std::countr_zero(passed);
+						pRow[x + i] = output.depth[i];
+						++numPixels;
+					}
+				}
+
+				for (int k{ 0 }; k < 3; ++k)
+					rowEdge[k] += setup.stepY[k];
+			}
+			return numPixels;
+		}
+	}
+}
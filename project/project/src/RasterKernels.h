@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace dae
+{
+	// Edge function rasterization of screen space triangles, SpanWidth pixels of a row at a time.
+	// Vertices are in fixed point with SubPixelBits of sub-pixel precision, pixel centers sit at +0.5,
+	// and clockwise triangles (y down) with a positive doubled area are inside.
+	// Edges are exact integers, the vector paths step them as doubles (|edge| < 2^53 inside the guard band),
+	// so coverage matches the scalar reference bit for bit, top-left fill rule included
+	namespace RasterKernels
+	{
+		constexpr int SpanWidth{ 8 };
+		constexpr int SubPixelBits{ 8 };
+		constexpr int SubPixelScale{ 1 << SubPixelBits };
+		constexpr int SubPixelHalf{ SubPixelScale / 2 };
+
+		// Edge k is opposite vertex k, so its value is vertex k's barycentric weight times doubleArea
+		struct EdgeSetup
+		{
+			int64_t edge[3]{};		// at the center of the start pixel, fill rule bias subtracted
+			int64_t stepX[3]{};		// one pixel to the right
+			int64_t stepY[3]{};		// one pixel down
+			int64_t bias[3]{};		// 1 for edges that are neither top nor left
+			float z[3]{};
+			float invDoubleArea{};
+		};
+
+		EdgeSetup SetupEdges(const int32_t x[3], const int32_t y[3], const float z[3], int64_t doubleArea, int startX, int startY);
+
+		// Per pixel barycentric weights (not perspective corrected) and depth of one span
+		struct SpanOutput
+		{
+			alignas(32) float weights[3][SpanWidth]{};
+			alignas(32) float depth[SpanWidth]{};
+		};
+
+		/* --- SPANS --- */
+		// First count (<= SpanWidth) pixels of a span whose first pixel center has the values edge.
+		// Bit i of the result is set when pixel i is covered, its depth lies in [0, 1] and is less than pDepth[i]
+		// (no depth test for pDepth == nullptr). Output is only filled when some pixel passes
+		uint32_t RasterizeSpan(const EdgeSetup& setup, const int64_t edge[3], int count, const float* pDepth, SpanOutput& output);
+		uint32_t RasterizeSpanReference(const EdgeSetup& setup, const int64_t edge[3], int count, const float* pDepth, SpanOutput& output);
+
+		/* --- TRIANGLES --- */
+		// Depth only pass over width x height pixels starting at the setup's start pixel: less test + write.
+		// pDepth points at the start pixel, pitch in floats. Returns the number of pixels written
+		uint64_t RasterizeDepth(const EdgeSetup& setup, int width, int height, float* pDepth, size_t pitch);
+		uint64_t RasterizeDepthReference(const EdgeSetup& setup, int width, int height, float* pDepth, size_t pitch);
+	}
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include "Math.h"
+
+namespace dae
+{
+	// Opaque resource ids handed out by an IRenderDevice. 0 is never a valid id
+	template<typename Tag>
+	struct Handle
+	{
+		uint32_t id{ 0 };
+
+		bool IsValid() const { return id != 0; }
+		bool operator==(const Handle&) const = default;
+	};
+
+	using BufferHandle = Handle<struct BufferTag>;
+	using TextureHandle = Handle<struct TextureTag>;
+	using InputLayoutHandle = Handle<struct InputLayoutTag>;
+	using EffectHandle = Handle<struct EffectTag>;
+	using TechniqueHandle = Handle<struct TechniqueTag>;
+	using EffectVariableHandle = Handle<struct EffectVariableTag>;
+
+	enum class Format
+	{
+		Unknown = 0,
+		R32G32B32_Float,
+		R32G32_Float,
+		R32G32B32A32_Float,
+		R32_UInt,
+		R8G8B8A8_UNorm,
+		R16G16B16A16_Float,
+		D24_UNorm_S8_UInt
+	};
+
+	enum class BufferType
+	{
+		Vertex = 0,
+		Index,
+		Constant
+	};
+
+	enum class PrimitiveTopology
+	{
+		TriangleList = 0
+	};
+
+	struct BufferDesc
+	{
+		BufferType type{ BufferType::Vertex };
+		uint32_t byteSize{};
+		bool isDynamic{ false };	// CPU writable every frame, immutable otherwise
+	};
+
+	struct TextureDesc
+	{
+		uint32_t width{};
+		uint32_t height{};
+		Format format{ Format::R8G8B8A8_UNorm };
+		uint32_t mipLevels{ 1 };	// halved down like D3D, the smaller levels' texels follow the top level's, rows tightly packed
+		bool isShaderResource{ true };
+		bool isRenderTarget{ false };	// created without texels, contents come from draws
+		bool isDepthStencil{ false };	// D24_UNorm_S8_UInt only
+	};
+
+	// How the next commands use a texture, see ICommandContext::Transition
+	enum class ResourceState
+	{
+		Undefined = 0,	// contents don't matter, e.g. a texture that held another resource before
+		RenderTarget,
+		DepthWrite,
+		DepthRead,	// depth tested but not written
+		ShaderResource,
+		Present
+	};
+
+	struct InputElement
+	{
+		const char* pSemanticName{};
+		Format format{ Format::Unknown };
+		uint32_t byteOffset{};
+		uint32_t inputSlot{ 0 };
+		bool isPerInstance{ false };	// advances once per instance instead of once per vertex
+		uint32_t semanticIndex{ 0 };	// e.g. the row of a matrix passed as 4 float4s
+	};
+
+	// Everything that happens while recording a frame. Effect variables are set here too,
+	// they only reach the GPU when a technique pass is applied
+	class ICommandContext
+	{
+	public:
+		virtual ~ICommandContext() = default;
+
+		// Clear the bound render targets / depth buffer
+		virtual void ClearRenderTarget(const ColorRGB& color) = 0;
+		virtual void ClearDepthStencil(float depth, uint8_t stencil) = 0;
+
+		// Until the first call the back buffer and the device's depth buffer are bound. The targets have the
+		// size of the viewport, an invalid depthStencil binds none
+		virtual void SetRenderTargets(std::span<const TextureHandle> colorTargets, TextureHandle depthStencil) = 0;
+		// Declares that texture is used as after from here on, e.g. a render target read by the next pass.
+		// D3D11 tracks hazards itself but a texture can't stay bound for output and input at once: the
+		// backend unbinds it where needed
+		virtual void Transition(TextureHandle texture, ResourceState before, ResourceState after) = 0;
+
+		virtual void SetPrimitiveTopology(PrimitiveTopology topology) = 0;
+		virtual void SetInputLayout(InputLayoutHandle inputLayout) = 0;
+		virtual void SetVertexBuffer(uint32_t slot, BufferHandle buffer, uint32_t stride, uint32_t offset) = 0;
+		virtual void SetIndexBuffer(BufferHandle buffer, Format format, uint32_t offset) = 0;
+
+		virtual void SetEffectMatrix(EffectVariableHandle variable, const Matrix& matrix) = 0;
+		virtual void SetEffectVector(EffectVariableHandle variable, const Vector3& vector) = 0;
+		virtual void SetEffectTexture(EffectVariableHandle variable, TextureHandle texture) = 0;
+		virtual void ApplyTechnique(TechniqueHandle technique, uint32_t passIndex) = 0;
+
+		// Rewrites the start of a dynamic buffer, its previous contents are discarded
+		virtual void UpdateBuffer(BufferHandle buffer, const void* pData, uint32_t byteSize) = 0;
+		// Writes into a dynamic buffer without discarding the rest, the range must not be in use by the GPU anymore
+		// (see SignalFence). Used by ConstantBufferRing
+		virtual void WriteBuffer(BufferHandle buffer, uint32_t byteOffset, const void* pData, uint32_t byteSize) = 0;
+		// Binds byteSize bytes of a constant buffer from byteOffset (a multiple of 256) to a cbuffer register of
+		// the vertex and pixel shader. Effect variables in that cbuffer are ignored while a range is bound (every
+		// ApplyTechnique binds it again), an invalid buffer releases the slot back to the effect
+		virtual void SetConstantBuffer(uint32_t slot, BufferHandle buffer, uint32_t byteOffset, uint32_t byteSize) = 0;
+
+		virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) = 0;
+		virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) = 0;
+
+		virtual void Present() = 0;
+
+		// Marks the point the GPU reached once IRenderDevice::GetCompletedFence returns the value or more.
+		// Values start at 1 and increase by one per call
+		virtual uint64_t SignalFence() = 0;
+	};
+
+	// Creates and owns the GPU resources. Destroying an invalid handle is a no-op
+	class IRenderDevice
+	{
+	public:
+		virtual ~IRenderDevice() = default;
+
+		virtual BufferHandle CreateBuffer(const BufferDesc& desc, const void* pInitialData) = 0;
+		virtual TextureHandle CreateTexture(const TextureDesc& desc, const void* pTexels, uint32_t rowPitch) = 0;
+		virtual EffectHandle CreateEffect(const std::wstring& assetFile) = 0;
+		// Validated against the input signature of pass 0 of technique
+		virtual InputLayoutHandle CreateInputLayout(std::span<const InputElement> elements, TechniqueHandle technique) = 0;
+
+		// Invalid handle when the effect has no technique/variable with that name
+		virtual TechniqueHandle GetTechnique(EffectHandle effect, const std::string& name) = 0;
+		virtual EffectVariableHandle GetEffectVariable(EffectHandle effect, const std::string& name) = 0;
+		virtual uint32_t GetPassCount(TechniqueHandle technique) const = 0;
+
+		virtual void Destroy(BufferHandle buffer) = 0;
+		virtual void Destroy(TextureHandle texture) = 0;
+		virtual void Destroy(InputLayoutHandle inputLayout) = 0;
+		virtual void Destroy(EffectHandle effect) = 0;	// also invalidates its techniques and variables
+
+		virtual ICommandContext& GetImmediateContext() = 0;
+		// The swap chain's color buffer, to bind with SetRenderTargets. Owned by the device, never destroyed
+		virtual TextureHandle GetBackBuffer() const = 0;
+
+		// Last fence the GPU got past, 0 before the first one
+		virtual uint64_t GetCompletedFence() = 0;
+		// Blocks until the GPU got past fence
+		virtual void WaitForFence(uint64_t fence) = 0;
+	};
+}
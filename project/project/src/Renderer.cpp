@@ -1,9 +1,16 @@
 #include "pch.h"
 #include "Renderer.h"
 #include "Utils.h"
+#include "Frustum.h"
+#include "D3D11RenderDevice.h"
 
 namespace dae {
 
+	static constexpr uint32_t s_ParkingLotRows{ 100 };	// 100 x 100 vehicles
+	static constexpr float s_ParkingLotSpacing{ 15.f };
+	static constexpr size_t s_FrameMemorySize{ 256 * 1024 };	// per frame in flight, the culled lot needs 40 KB
+	static constexpr uint32_t s_ConstantRingSize{ 64 * 1024 };	// a frame takes 3 blocks of 256 bytes
+
 	Renderer::Renderer(SDL_Window* pWindow) :
 		m_pWindow(pWindow)
 	{
@@ -11,16 +18,18 @@ namespace dae {
 		SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
 
 		//Initialize DirectX pipeline
-		const HRESULT result = InitializeDirectX();
-		if (result == S_OK)
-		{
-			m_IsInitialized = true;
-			std::cout << "DirectX is initialized and ready!\n";
-		}
-		else
-		{
-			std::cout << "DirectX initialization failed!\n";
-		}
+		D3D11RenderDevice* pDevice = new D3D11RenderDevice(pWindow, m_Width, m_Height);
+		m_IsInitialized = pDevice->IsInitialized();
+		m_pDevice = pDevice;
+		m_pStateCache = new StateCache(m_pDevice->GetImmediateContext());
+
+		//	Initialise Textures
+		// ---------------------
+		m_pVehicleDiffuseTexture = Texture::LoadFromFile("resources/vehicle_diffuse.png", *m_pDevice);
+		m_pVehicleNormalTexture = Texture::LoadFromFile("resources/vehicle_normal.png", *m_pDevice);
+		m_pVehicleSpecularTexture = Texture::LoadFromFile("resources/vehicle_specular.png", *m_pDevice);
+		m_pVehicleGlossinessTexture = Texture::LoadFromFile("resources/vehicle_gloss.png", *m_pDevice);
+		m_pFireDiffuseTexture = Texture::LoadFromFile("resources/fireFX_diffuse.png", *m_pDevice);
 
 		//	Initialise Mesh
 		// ---------------------
@@ -32,9 +41,44 @@ namespace dae {
 			verticesVehicle,
 			indicesVehicle);
 
-		m_pMeshVehicle = new Mesh(m_pDevice, verticesVehicle, indicesVehicle,false);
-
-			
+		m_pMeshVehicle = new Mesh(*m_pDevice, verticesVehicle, indicesVehicle,false,
+			{ m_pVehicleDiffuseTexture, m_pVehicleNormalTexture, m_pVehicleSpecularTexture, m_pVehicleGlossinessTexture });
+
+		//The vehicle is the occluder
+		m_OccluderPositions.reserve(verticesVehicle.size());
+		for (const Vertex_In& vertex : verticesVehicle)
+			m_OccluderPositions.push_back(vertex.position);
+		m_OccluderIndices = indicesVehicle;
+		m_pOcclusionCuller = new OcclusionCuller(m_Width / 2, m_Height / 2);
+		m_pDrawList = new DrawList();
+		m_pParkingLot = new InstanceBuffer(*m_pDevice, s_ParkingLotRows * s_ParkingLotRows);
+		m_pParkingLotFires = new InstanceBuffer(*m_pDevice, s_ParkingLotRows * s_ParkingLotRows);
+		m_pTransparencySorter = new TransparencySorter();
+		m_pFrameAllocator = new FrameAllocator(2, s_FrameMemorySize);
+		m_pConstants = new ConstantBufferRing(*m_pDevice, s_ConstantRingSize);
+
+		//	Initialise Frame graph
+		// ---------------------
+		m_pFrameGraph = new FrameGraph(*m_pDevice);
+		const uint32_t width = static_cast<uint32_t>(m_Width);
+		const uint32_t height = static_cast<uint32_t>(m_Height);
+		const FrameGraph::ResourceId backBuffer = m_pFrameGraph->ImportTexture("BackBuffer", m_pDevice->GetBackBuffer(),
+			{ width, height, Format::R8G8B8A8_UNorm, false, true, false }, ResourceState::Present);
+		const FrameGraph::ResourceId sceneDepth = m_pFrameGraph->CreateTexture("SceneDepth", { width, height, Format::D24_UNorm_S8_UInt });
+
+		m_pFrameGraph->AddPass("Opaque", [&](FrameGraph::PassBuilder& builder)
+			{
+				builder.ClearRenderTarget(backBuffer, { .39f,.59f,.93f });
+				builder.ClearDepth(sceneDepth, 1.f);
+			},
+			[this](ICommandContext& context, const FrameGraph&) { RenderOpaque(context); });
+		m_pFrameGraph->AddPass("Transparent", [&](FrameGraph::PassBuilder& builder)
+			{
+				builder.WriteRenderTarget(backBuffer);
+				builder.ReadDepth(sceneDepth);
+			},
+			[this](ICommandContext& context, const FrameGraph&) { RenderTransparent(context); });
+		m_pFrameGraph->Compile();
 
 		std::vector<Vertex_In> verticesFire;
 		std::vector<uint32_t> indicesFire;
@@ -44,10 +88,21 @@ namespace dae {
 			verticesFire,
 			indicesFire);
 
-		m_pMeshFire = new Mesh(m_pDevice, verticesFire, indicesFire,true);
+		m_pMeshFire = new Mesh(*m_pDevice, verticesFire, indicesFire,true, { m_pFireDiffuseTexture });
 
-		// Transform objects
-		m_WorldMatrix *= Matrix::CreateTranslation(0.f, 0.f, 50.f);	// move the objects
+		// Transform objects: the vehicle, then the parking lot on a grid starting behind it
+		m_pTransforms = new TransformStore();
+		m_pTransforms->Reserve(1 + s_ParkingLotRows * s_ParkingLotRows);
+		m_VehicleEntity = m_pTransforms->Create(TransformStore::InvalidEntity, m_Position);
+		m_FirstParkingLotEntity = m_pTransforms->GetCount();
+		for (uint32_t i{ 0 }; i < s_ParkingLotRows * s_ParkingLotRows; ++i)
+		{
+			const float x = (float(i % s_ParkingLotRows) - s_ParkingLotRows / 2.f) * s_ParkingLotSpacing;
+			const float z = float(i / s_ParkingLotRows + 1) * s_ParkingLotSpacing;
+			m_pTransforms->Create(TransformStore::InvalidEntity, m_Position + Vector3{ x, 0.f, z });
+		}
+		m_pTransforms->Update();
+		m_WorldMatrix = m_pTransforms->GetWorldMatrix(m_VehicleEntity);
 
 		//	Initialise Camera
 		// ---------------------
@@ -56,216 +111,174 @@ namespace dae {
 
 	Renderer::~Renderer()
 	{
-		// Release Render Target View
-		if (m_pRenderTargetView) {
-			m_pRenderTargetView->Release();
-			m_pRenderTargetView = nullptr;
-		}
-
-		// Release Render Target Buffer
-		if (m_pRenderTargetBuffer) {
-			m_pRenderTargetBuffer->Release();
-			m_pRenderTargetBuffer = nullptr;
-		}
-
-		// Release Depth Stencil View
-		if (m_pDepthStencilView) {
-			m_pDepthStencilView->Release();
-			m_pDepthStencilView = nullptr;
-		}
-
-		// Release Depth Stencil Buffer
-		if (m_pDepthStencilBuffer) {
-			m_pDepthStencilBuffer->Release();
-			m_pDepthStencilBuffer = nullptr;
-		}
-
-		// Release Swap Chain
-		if (m_pSwapChain) {
-			m_pSwapChain->Release();
-			m_pSwapChain = nullptr;
-		}
-
-		// Release Device Context
-		if (m_pDeviceContext) {
-			m_pDeviceContext->ClearState();
-			m_pDeviceContext->Flush();
-			m_pDeviceContext->Release();
-			m_pDeviceContext = nullptr;
-		}
-
-		// Release Device
-		if (m_pDevice) {
-			m_pDevice->Release();
-			m_pDevice = nullptr;
-		}
-
 		//delete
+		delete m_pFrameGraph;
+		delete m_pConstants;
+		delete m_pFrameAllocator;
+		delete m_pTransparencySorter;
+		delete m_pParkingLotFires;
+		delete m_pParkingLot;
+		delete m_pTransforms;
+		delete m_pDrawList;
+		delete m_pOcclusionCuller;
 		delete m_pMeshFire;
 		delete m_pMeshVehicle;
 
+		delete m_pFireDiffuseTexture;
+		delete m_pVehicleGlossinessTexture;
+		delete m_pVehicleSpecularTexture;
+		delete m_pVehicleNormalTexture;
+		delete m_pVehicleDiffuseTexture;
+
+		delete m_pStateCache;
+		delete m_pDevice;
 	}
 
 	void Renderer::Update(const Timer* pTimer)
 	{
+		FrameSnapshot& snapshot = m_Snapshots.GetWriteBuffer();
+		snapshot.inputTime = std::chrono::steady_clock::now();
+
 		m_Camera.Update(pTimer);
 
 		// Update rotation
 		if (m_Rotating)
 		{
-			m_Rotation += M_PI/2 * pTimer->GetElapsed();
-			m_WorldMatrix = Matrix::CreateRotationY(m_Rotation) * Matrix::CreateTranslation(0.f, 0.f, 50.f); ;	// rotate the object 
+			m_Orientation = Quaternion::CreateRotationY(PI_DIV_2 * pTimer->GetElapsed()) * m_Orientation;
+			m_Orientation.Normalize();	// keep drift from accumulating
+
+			// rotate the objects, every parked vehicle turns in place too
+			m_pTransforms->SetRotation(m_VehicleEntity, m_Orientation);
+			for (uint32_t i{ 0 }; i < s_ParkingLotRows * s_ParkingLotRows; ++i)
+				m_pTransforms->SetRotation(m_FirstParkingLotEntity + i, m_Orientation);
+		}
+
+		// Only the changed transforms are recomputed
+		m_pTransforms->Update();
+		m_WorldMatrix = m_pTransforms->GetWorldMatrix(m_VehicleEntity);
+
+		// Publish the frame, the render side never sees the camera or the store itself
+		snapshot.frameIndex = ++m_NumSimulatedFrames;
+		snapshot.viewMatrix = m_Camera.GetViewMatrix();
+		snapshot.projectionMatrix = m_Camera.GetProjectionMatrix();
+		snapshot.cameraPosition = m_Camera.origin;
+		snapshot.farPlane = m_Camera.farPlane;
+		snapshot.vehicleWorldMatrix = m_WorldMatrix;
+		snapshot.filteringMethod = m_FilteringMethod;
+		snapshot.parkingLotWorldMatrices.clear();
+		if (m_ShowParkingLot)
+		{
+			const std::span<const Matrix> worldMatrices = m_pTransforms->GetWorldMatrices();
+			snapshot.parkingLotWorldMatrices.assign(worldMatrices.begin() + m_FirstParkingLotEntity, worldMatrices.begin() + m_FirstParkingLotEntity + s_ParkingLotRows * s_ParkingLotRows);
 		}
-		
+		m_Snapshots.Publish();
 	}
 
 
-	void Renderer::Render() const
+	void Renderer::SubmitMesh(Mesh& mesh, const FrameSnapshot& snapshot, const Matrix& worldViewProjectionMatrix) const
+	{
+		const float depth = worldViewProjectionMatrix.TransformPoint(mesh.GetBounds().center.ToPoint4()).w / snapshot.farPlane;
+		m_pDrawList->Submit(mesh.GetSortKey(0, depth, snapshot.filteringMethod),
+			{ &mesh, snapshot.vehicleWorldMatrix, worldViewProjectionMatrix, snapshot.cameraPosition, snapshot.filteringMethod });
+	}
+
+	void Renderer::Render()
 	{
 		if (!m_IsInitialized)
 			return;
 
-		// 1. CLEAR RTV & DSV
-		//constexpr float color[4] = { 0.f, 0.f, 0.3f, 1.f };
-		constexpr float color[4] = { .39f,.59f,.93f , 1.f };
-		m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView, color);
-		m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0);
+		const bool isNewSnapshot = m_Snapshots.Acquire();
+		const FrameSnapshot& snapshot = m_Snapshots.GetReadBuffer();
+		if (snapshot.frameIndex == 0)
+			return;
 
-		// 2. SET PIPELINE + INVOKE DRAW CALLS (=RENDER)
-		Matrix worldViewProjectionMatrix = m_WorldMatrix * m_Camera.GetViewMatrix() * m_Camera.GetProjectionMatrix();
-		m_pMeshVehicle->Render(m_pDeviceContext,m_WorldMatrix, worldViewProjectionMatrix,m_Camera.origin, m_FilteringMethod);
-		m_pMeshFire->Render(m_pDeviceContext, m_WorldMatrix, worldViewProjectionMatrix, m_Camera.origin, m_FilteringMethod);
-		
+		ICommandContext& context = *m_pStateCache;
+		m_pFrameAllocator->BeginFrame();
+
+		// 1. CULL & SORT
+		const Matrix viewProjectionMatrix = snapshot.viewMatrix * snapshot.projectionMatrix;
+		const Matrix worldViewProjectionMatrix = snapshot.vehicleWorldMatrix * viewProjectionMatrix;
+
+		// Both meshes share the world matrix, so cull their object space bounds against one object space frustum
+		const Frustum frustum{ worldViewProjectionMatrix };
+
+		// Visible meshes go into the draw list with their bounds' view depth (clip w over the far plane), it orders them
+		m_pDrawList->Clear();
+		m_pOcclusionCuller->BeginFrame();
+		if (frustum.IsVisible(m_pMeshVehicle->GetBounds()))
+		{
+			SubmitMesh(*m_pMeshVehicle, snapshot, worldViewProjectionMatrix);
+			m_pOcclusionCuller->RenderOccluder(m_OccluderPositions, m_OccluderIndices, worldViewProjectionMatrix);
+		}
+		if (frustum.IsVisible(m_pMeshFire->GetBounds()) && m_pOcclusionCuller->IsVisible(m_pMeshFire->GetBounds(), worldViewProjectionMatrix))
+			SubmitMesh(*m_pMeshFire, snapshot, worldViewProjectionMatrix);
+		m_pDrawList->Sort();
+
+		// Parking lot: the vehicles in the frustum (a list in frame memory) with their world matrix from the snapshot
+		// and a paint color picked by their place in the lot
+		m_IsParkingLotVisible = !snapshot.parkingLotWorldMatrices.empty();
+		if (m_IsParkingLotVisible)
+		{
+			const Frustum worldFrustum{ viewProjectionMatrix };
+			const std::span<uint32_t> visible = m_pFrameAllocator->AllocateSpan<uint32_t>(snapshot.parkingLotWorldMatrices.size());
+			uint32_t numVisible{};
+			for (uint32_t i{ 0 }; i < visible.size(); ++i)
+				if (worldFrustum.IsVisible(m_pMeshVehicle->GetBounds().Transform(snapshot.parkingLotWorldMatrices[i])))
+					visible[numVisible++] = i;
+
+			m_pParkingLot->Build(numVisible, [&](uint32_t begin, uint32_t end, InstanceData* pInstances)
+				{
+					static constexpr ColorRGB paints[]{ { 1.f, 1.f, 1.f }, { 1.f, .35f, .3f }, { .35f, .6f, 1.f }, { .4f, .9f, .45f }, { 1.f, .85f, .3f } };
+					for (uint32_t i{ begin }; i < end; ++i, ++pInstances)
+					{
+						pInstances->worldMatrix = snapshot.parkingLotWorldMatrices[visible[i]];
+						pInstances->tint = paints[(visible[i] * 2654435761u >> 16) % std::size(paints)];
+					}
+				});
+			m_pParkingLot->Upload(context);
+
+			// Fires back to front, the visible ones keep the sorted order
+			const AABB& fireBounds = m_pMeshFire->GetBounds();
+			const std::span<const uint32_t> fireOrder = m_pTransparencySorter->Sort(fireBounds, snapshot.parkingLotWorldMatrices, snapshot.viewMatrix);
+			const std::span<uint32_t> visibleFires = m_pFrameAllocator->AllocateSpan<uint32_t>(fireOrder.size());
+			uint32_t numVisibleFires{};
+			for (const uint32_t index : fireOrder)
+				if (worldFrustum.IsVisible(fireBounds.Transform(snapshot.parkingLotWorldMatrices[index])))
+					visibleFires[numVisibleFires++] = index;
+
+			m_pParkingLotFires->Build(numVisibleFires, [&](uint32_t begin, uint32_t end, InstanceData* pInstances)
+				{
+					for (uint32_t i{ begin }; i < end; ++i, ++pInstances)
+						pInstances->worldMatrix = snapshot.parkingLotWorldMatrices[visibleFires[i]];
+				});
+			m_pParkingLotFires->Upload(context);
+		}
+
+		// 2. RENDER PASSES: camera constants once for the frame, every draw only writes and binds its own matrices
+		m_pConstants->Bind(context, PerFrameConstants{ viewProjectionMatrix, snapshot.cameraPosition });
+		m_pFrameSnapshot = &snapshot;
+		m_pFrameGraph->Execute(context);
+
+		m_LatencyStats.Record(snapshot, isNewSnapshot, m_SubmittedFrameIndex, std::chrono::steady_clock::now());
+		m_SubmittedFrameIndex = snapshot.frameIndex;
 
 		// 3. PRESENT BACKBUFFER (SWAP)
-		m_pSwapChain->Present(0, 0);
+		context.Present();
+		m_pConstants->EndFrame(context);
 	}
 
-	HRESULT Renderer::InitializeDirectX()
+	void Renderer::RenderOpaque(ICommandContext& context) const
 	{
-		//1. Create Device & DeviceContent
-		//=====
-		D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_1;
-		uint32_t createDeviceFlags = 0;
-#if defined(DEBUG)|| defined(_DEBUG)
-		createDeviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
-#endif
-		HRESULT result = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, 0, createDeviceFlags, &featureLevel,
-			1,D3D11_SDK_VERSION, &m_pDevice, nullptr, &m_pDeviceContext);
-
-		if (FAILED(result))
-			return result;
-
-		//Create DXGI Factory
-		IDXGIFactory1* pDxgiFactory{};
-		result = CreateDXGIFactory1(__uuidof(IDXGIFactory1), reinterpret_cast<void**>(&pDxgiFactory));
-		if (FAILED(result))
-			return result;
-
-
-
-		//2. Create Swapchain
-		//====
-		DXGI_SWAP_CHAIN_DESC swapChainDesc{};
-		swapChainDesc.BufferDesc.Width = m_Width;
-		swapChainDesc.BufferDesc.Height = m_Height;
-		swapChainDesc.BufferDesc.RefreshRate.Numerator = 1;
-		swapChainDesc.BufferDesc.RefreshRate.Denominator = 60;
-		swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-		swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-		swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
-		swapChainDesc.SampleDesc.Count = 1;
-		swapChainDesc.SampleDesc.Quality = 0;
-		swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-		swapChainDesc.BufferCount = 1;
-		swapChainDesc.Windowed = true;
-		swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
-		swapChainDesc.Flags = 0;
-
-		//Get the handle (HWND) from the SDL backbuffer
-		SDL_SysWMinfo sysWMInfo{};
-		SDL_GetVersion(&sysWMInfo.version);
-		SDL_GetWindowWMInfo(m_pWindow, &sysWMInfo);
-		swapChainDesc.OutputWindow = sysWMInfo.info.win.window;
-
-		//Create Swapchain
-		result = pDxgiFactory->CreateSwapChain(m_pDevice, &swapChainDesc, &m_pSwapChain);
-		if (FAILED(result))
-			return result;
-
-
-
-		//3. Create DepthStencil (DS) & DepthStencilView (DSV)
-		//====
-		
-		//Resource
-		D3D11_TEXTURE2D_DESC depthStencilDesc{};
-		depthStencilDesc.Width = m_Width;
-		depthStencilDesc.Height = m_Height;
-		depthStencilDesc.MipLevels = 1;
-		depthStencilDesc.ArraySize = 1;
-		depthStencilDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-		depthStencilDesc.SampleDesc.Count = 1;
-		depthStencilDesc.SampleDesc.Quality = 0;
-		depthStencilDesc.Usage = D3D11_USAGE_DEFAULT;
-		depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
-		depthStencilDesc.CPUAccessFlags = 0;
-		depthStencilDesc.MiscFlags = 0;
-
-		//View
-		D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc{};
-		depthStencilViewDesc.Format = depthStencilDesc.Format;
-		depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
-		depthStencilViewDesc.Texture2D.MipSlice = 0;
-
-		result = m_pDevice->CreateTexture2D(&depthStencilDesc, nullptr, &m_pDepthStencilBuffer);
-		if (FAILED(result))
-			return result;
-		result = m_pDevice->CreateDepthStencilView(m_pDepthStencilBuffer, &depthStencilViewDesc, &m_pDepthStencilView);
-		if (FAILED(result))
-			return result;
-
-
-
-		//4. Create RenderTarget (RT) & RenderTargetView (RTV)
-		//====
-		
-		//Resource
-		result = m_pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&m_pRenderTargetBuffer));
-		if (FAILED(result))
-			return result;
-
-		//View
-		result = m_pDevice->CreateRenderTargetView(m_pRenderTargetBuffer,nullptr, &m_pRenderTargetView);
-		if (FAILED(result))
-			return result;
-
-
-
-		//5. Bind RTV & DSV to Output Merger Stage
-		//====
-		m_pDeviceContext->OMSetRenderTargets(1, &m_pRenderTargetView, m_pDepthStencilView);
-
-
-
-		//6. Set Viewport
-		//=====
-		D3D11_VIEWPORT viewport{};
-		viewport.Width = static_cast<float>(m_Width);
-		viewport.Height = static_cast<float>(m_Height);
-		viewport.TopLeftX = 0.f;
-		viewport.TopLeftY = 0.f;
-		viewport.MinDepth = 0.f;
-		viewport.MaxDepth = 1.f;
-		m_pDeviceContext->RSSetViewports(1, &viewport);
-
-
+		m_pDrawList->Execute(context, *m_pConstants, DrawList::Bucket::Opaque);
+		if (m_IsParkingLotVisible)
+			m_pMeshVehicle->RenderInstanced(context, *m_pParkingLot, m_pFrameSnapshot->filteringMethod);
+	}
 
-		//Release DXGIFactory
-		pDxgiFactory->Release();
-
-
-
-		return S_OK;
+	void Renderer::RenderTransparent(ICommandContext& context) const
+	{
+		// The lot starts behind the vehicle, so its fires go first
+		if (m_IsParkingLotVisible)
+			m_pMeshFire->RenderInstanced(context, *m_pParkingLotFires, m_pFrameSnapshot->filteringMethod);
+		m_pDrawList->Execute(context, *m_pConstants, DrawList::Bucket::Translucent);
 	}
 }
@@ -1,6 +1,17 @@
 #pragma once
 #include "Mesh.h"
 #include "Camera.h"
+#include "RenderDevice.h"
+#include "OcclusionCuller.h"
+#include "DrawList.h"
+#include "StateCache.h"
+#include "TransformStore.h"
+#include "TripleBuffer.h"
+#include "FrameSnapshot.h"
+#include "FrameAllocator.h"
+#include "ConstantBufferRing.h"
+#include "FrameGraph.h"
+#include "TransparencySorter.h"
 
 struct SDL_Window;
 struct SDL_Surface;
@@ -18,8 +29,17 @@ namespace dae
 		Renderer& operator=(const Renderer&) = delete;
 		Renderer& operator=(Renderer&&) noexcept = delete;
 
+		// Simulation side: samples input, moves everything and publishes the frame as a snapshot
 		void Update(const Timer* pTimer);
-		void Render() const;
+		// Render side: submits the newest published snapshot (the previous one again when there is none).
+		// May run on its own thread, it only reads the snapshot and touches the render objects
+		void Render();
+
+		// Render side only
+		const FrameLatencyStats& GetLatencyStats() const { return m_LatencyStats; }
+		void ResetLatencyStats() { m_LatencyStats = {}; }
+		// Passes, transient memory and what aliasing saved, fixed once the graph is compiled in the constructor
+		const FrameGraph::Stats& GetFrameGraphStats() const { return m_pFrameGraph->GetStats(); }
 
 		void SwitchFilterMode()
 		{
@@ -40,8 +60,14 @@ namespace dae
 			}
 		};
 		void ToggleRotation() { m_Rotating = !m_Rotating; };
+		void ToggleParkingLot() { m_ShowParkingLot = !m_ShowParkingLot; };
 
 	private:
+		void SubmitMesh(Mesh& mesh, const FrameSnapshot& snapshot, const Matrix& worldViewProjectionMatrix) const;
+		// Frame graph passes, they draw what Render prepared for m_pFrameSnapshot
+		void RenderOpaque(ICommandContext& context) const;
+		void RenderTransparent(ICommandContext& context) const;
+
 		SDL_Window* m_pWindow{};
 
 		int m_Width{};
@@ -54,32 +80,60 @@ namespace dae
 		Mesh* m_pMeshFire;
 
 		Matrix m_WorldMatrix{ {1,0,0,0},{0,1,0,0},{0,0,1,0} ,{0,0,0,1} };
+		Vector3 m_Position{ 0.f, 0.f, 50.f };
 		bool m_Rotating{};
-		float m_Rotation{};
-
-		Camera m_Camera{};
-	
+		Quaternion m_Orientation{};
 
+		//Vehicle + parking lot transforms, m_WorldMatrix is the vehicle's world matrix after the store's update
+		TransformStore* m_pTransforms{};
+		TransformStore::EntityId m_VehicleEntity{};
+		TransformStore::EntityId m_FirstParkingLotEntity{};
 
-		//DIRECTX
-		//======
-		HRESULT InitializeDirectX();
-
-		//Device & DeviceContent
-		ID3D11Device* m_pDevice = nullptr;
-		ID3D11DeviceContext* m_pDeviceContext = nullptr;
-
-		//SwapChain
-		IDXGISwapChain* m_pSwapChain = nullptr;
-		
-		//DepthStencil (DS) & DepthStencilView (DSV)
-		ID3D11Texture2D* m_pDepthStencilBuffer = nullptr;
-		ID3D11DepthStencilView* m_pDepthStencilView = nullptr;
-
-		//RenderTarget (RT) & RenderTargetView (RTV)
-		ID3D11Resource* m_pRenderTargetBuffer = nullptr;
-		ID3D11RenderTargetView* m_pRenderTargetView = nullptr;
+		Camera m_Camera{};
 
-			
+		//CPU depth of the vehicle at half resolution, draws hidden behind it are skipped
+		OcclusionCuller* m_pOcclusionCuller{};
+		std::vector<Vector3> m_OccluderPositions{};
+		std::vector<uint32_t> m_OccluderIndices{};
+
+		//Visible meshes are submitted with a sort key and drawn in key order
+		DrawList* m_pDrawList{};
+
+		//Grid of tinted vehicles behind the real one, the ones in the frustum in one instanced draw
+		bool m_ShowParkingLot{};
+		InstanceBuffer* m_pParkingLot{};
+		//Their fires, blended so drawn back to front: all of them sorted by depth (the same set every frame, so last
+		//frame's order is mostly still right), the ones in the frustum drawn in that order
+		InstanceBuffer* m_pParkingLotFires{};
+		TransparencySorter* m_pTransparencySorter{};
+
+		//Render side transient data (culled lists), reused every other frame
+		FrameAllocator* m_pFrameAllocator{};
+		//Per frame and per draw shader constants, blocks of one ring buffer the GPU reads them from
+		ConstantBufferRing* m_pConstants{};
+
+		//Opaque pass (clears, draws the vehicle and the parking lot) then the blended one on the back buffer,
+		//the depth buffer is transient. Built once, executed every frame
+		FrameGraph* m_pFrameGraph{};
+		const FrameSnapshot* m_pFrameSnapshot{};
+		bool m_IsParkingLotVisible{};
+
+		//Simulation -> render hand over, the render side keeps what it submitted last for the latency stats
+		TripleBuffer<FrameSnapshot> m_Snapshots{};
+		uint64_t m_NumSimulatedFrames{};
+		uint64_t m_SubmittedFrameIndex{};
+		FrameLatencyStats m_LatencyStats{};
+
+		//Textures, shared by the meshes
+		Texture* m_pVehicleDiffuseTexture{};
+		Texture* m_pVehicleNormalTexture{};
+		Texture* m_pVehicleSpecularTexture{};
+		Texture* m_pVehicleGlossinessTexture{};
+		Texture* m_pFireDiffuseTexture{};
+
+		//Owns the swap chain and every GPU resource, created first and deleted last
+		IRenderDevice* m_pDevice{};
+		//Everything is recorded through this, it drops state that is already bound
+		StateCache* m_pStateCache{};
 	};
 }
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace dae
+{
+	// Thin wrappers over the widest float vector this build targets:
+	// 8 lanes (AVX) when compiled with GP1_ENABLE_AVX2, 4 lanes (SSE2) otherwise
+	namespace Simd
+	{
+#if defined(__AVX__)
+		using Lane = __m256;
+		constexpr size_t LaneWidth{ 8 };
+
+		inline Lane Load(const float* pData) { return _mm256_loadu_ps(pData); }
+		inline void Store(float* pData, Lane a) { _mm256_storeu_ps(pData, a); }
+		inline Lane Broadcast(float value) { return _mm256_set1_ps(value); }
+		inline Lane Zero() { return _mm256_setzero_ps(); }
+
+		inline Lane Add(Lane a, Lane b) { return _mm256_add_ps(a, b); }
+		inline Lane Sub(Lane a, Lane b) { return _mm256_sub_ps(a, b); }
+		inline Lane Mul(Lane a, Lane b) { return _mm256_mul_ps(a, b); }
+		inline Lane Div(Lane a, Lane b) { return _mm256_div_ps(a, b); }
+		inline Lane Min(Lane a, Lane b) { return _mm256_min_ps(a, b); }
+		inline Lane Max(Lane a, Lane b) { return _mm256_max_ps(a, b); }
+
+		inline Lane And(Lane a, Lane b) { return _mm256_and_ps(a, b); }
+		inline Lane Or(Lane a, Lane b) { return _mm256_or_ps(a, b); }
+		inline Lane LessThan(Lane a, Lane b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		inline Lane Select(Lane mask, Lane a, Lane b) { return _mm256_blendv_ps(b, a, mask); }	// mask ? a : b
+		inline uint32_t MoveMask(Lane a) { return static_cast<uint32_t>(_mm256_movemask_ps(a)); }
+#else
+		using Lane = __m128;
+		constexpr size_t LaneWidth{ 4 };
+
+		inline Lane Load(const float* pData) { return _mm_loadu_ps(pData); }
+		inline void Store(float* pData, Lane a) { _mm_storeu_ps(pData, a); }
+		inline Lane Broadcast(float value) { return _mm_set1_ps(value); }
+		inline Lane Zero() { return _mm_setzero_ps(); }
+
+		inline Lane Add(Lane a, Lane b) { return _mm_add_ps(a, b); }
+		inline Lane Sub(Lane a, Lane b) { return _mm_sub_ps(a, b); }
+		inline Lane Mul(Lane a, Lane b) { return _mm_mul_ps(a, b); }
+		inline Lane Div(Lane a, Lane b) { return _mm_div_ps(a, b); }
+		inline Lane Min(Lane a, Lane b) { return _mm_min_ps(a, b); }
+		inline Lane Max(Lane a, Lane b) { return _mm_max_ps(a, b); }
+
+		inline Lane And(Lane a, Lane b) { return _mm_and_ps(a, b); }
+		inline Lane Or(Lane a, Lane b) { return _mm_or_ps(a, b); }
+		inline Lane LessThan(Lane a, Lane b) { return _mm_cmplt_ps(a, b); }
+		inline Lane Select(Lane mask, Lane a, Lane b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }	// mask ? a : b
+		inline uint32_t MoveMask(Lane a) { return static_cast<uint32_t>(_mm_movemask_ps(a)); }
+#endif
+		constexpr uint32_t LaneBits{ (1u << LaneWidth) - 1 };
+	}
+}
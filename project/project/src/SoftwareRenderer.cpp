@@ -0,0 +1,784 @@
+#include "SoftwareRenderer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+#include "ColorKernels.h"
+#include "JobSystem.h"
+#include "RasterKernels.h"
+
+namespace dae
+{
+	// PosCol3D.fx constants
+	static const Vector3 s_LightDirection{ -0.577f, 0.577f, -0.577f };
+	static constexpr float s_LightIntensity{ 7.f };
+	static constexpr float s_Shininess{ 25.f };
+	static constexpr ColorRGB s_Ambient{ 0.025f, 0.025f, 0.025f };
+
+	// Fixed point screen coordinates
+	static constexpr int s_SubPixelBits{ RasterKernels::SubPixelBits };
+	static constexpr int s_SubPixelScale{ RasterKernels::SubPixelScale };
+	static constexpr int s_SubPixelHalf{ RasterKernels::SubPixelHalf };
+
+	// Screen coordinates stay within this many pixels (keeps the edge functions in int64).
+	// The clipper's guard band is half of it, so rounding never pushes a clipped vertex past
+	static constexpr float s_GuardBand{ 16384.f };
+
+	static ClipKernels::ClipBounds GetClipBounds(int width, int height)
+	{
+		return { 0.5f * s_GuardBand / (width * 0.5f), 0.5f * s_GuardBand / (height * 0.5f) };
+	}
+
+	static float ElapsedMs(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	static ColorRGB ToColor(const Vector4& sample)
+	{
+		return { sample.x, sample.y, sample.z };
+	}
+
+	SoftwareRenderer::SoftwareRenderer(int width, int height, uint32_t numThreads)
+		: m_Width{ width }
+		, m_Height{ height }
+		, m_NumTilesX{ (width + TileSize - 1) / TileSize }
+		, m_NumTilesY{ (height + TileSize - 1) / TileSize }
+		, m_NumThreads{ numThreads ? numThreads : std::max(1u, std::thread::hardware_concurrency()) }
+		, m_ColorBuffer(size_t(width) * size_t(height))
+		, m_DepthBuffer(size_t(width) * size_t(height), 1.f)
+	{
+		assert(width > 0 && height > 0);
+	}
+
+	void SoftwareRenderer::SetShadingMode(ShadingMode shadingMode)
+	{
+		m_ShadingMode = shadingMode;
+		if (shadingMode == ShadingMode::VisibilityBuffer && m_VisibilityBuffer.empty())
+			m_VisibilityBuffer.resize(m_ColorBuffer.size());
+	}
+
+	void SoftwareRenderer::SetTransparencyMode(TransparencyMode transparencyMode)
+	{
+		m_TransparencyMode = transparencyMode;
+		if (transparencyMode == TransparencyMode::WeightedBlended && m_AccumulationBuffer.empty())
+		{
+			m_AccumulationBuffer.resize(m_ColorBuffer.size());
+			m_RevealageBuffer.resize(m_ColorBuffer.size(), 1.f);
+		}
+	}
+
+	void SoftwareRenderer::BeginFrame(const ColorRGB& clearColor)
+	{
+		m_ClearColor = clearColor;
+		m_DrawCalls.clear();
+		m_FrameArena.Reset();
+		m_FrameStats = {};
+	}
+
+	void SoftwareRenderer::Draw(const SoftwareMesh& mesh, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix, const Vector3& cameraPos, FilteringMethod filteringMethod)
+	{
+		DrawCall& drawCall = m_DrawCalls.emplace_back();
+		drawCall.mesh = mesh;
+		drawCall.worldMatrix = worldMatrix;
+		drawCall.worldViewProjectionMatrix = worldViewProjectionMatrix;
+		drawCall.cameraPos = cameraPos;
+		drawCall.filteringMethod = filteringMethod;
+		// Blended draws need every fragment in order, they are rasterized over the shaded visibility buffer
+		drawCall.isDeferred = m_ShadingMode == ShadingMode::VisibilityBuffer && !mesh.isPartialCoverage;
+	}
+
+	const SoftwareRenderer::FrameStats& SoftwareRenderer::EndFrame()
+	{
+		const auto frameStart = std::chrono::steady_clock::now();
+
+		// 1. GEOMETRY
+		uint32_t numTriangles{};
+		for (DrawCall& drawCall : m_DrawCalls)
+		{
+			const size_t numVertices = drawCall.mesh.vertices.size();
+			const size_t numDrawTriangles = drawCall.mesh.indices.size() / 3;
+			drawCall.positions = m_FrameArena.AllocateSpan<Vector4>(numVertices);
+			drawCall.vertices = drawCall.isDeferred ? std::span<VertexOut>{} : m_FrameArena.AllocateSpan<VertexOut>(numVertices);
+			drawCall.clipCodes = m_FrameArena.AllocateSpan<ClipKernels::ClipCodes>(numDrawTriangles);
+			drawCall.triangles = m_FrameArena.AllocateSpan<Triangle>(numDrawTriangles);
+			m_FrameStats.numTriangles += static_cast<uint32_t>(numDrawTriangles);
+
+			ParallelFor(numVertices, 4096, [&](size_t begin, size_t end) { TransformVertices(drawCall, begin, end); });
+			ParallelFor(numDrawTriangles, 4096, [&](size_t begin, size_t end) { SetupTriangles(drawCall, begin, end); });
+
+			// Usually none or a handful, so they are clipped on this thread
+			const uint32_t numToClip = static_cast<uint32_t>(std::count_if(drawCall.clipCodes.begin(), drawCall.clipCodes.end(),
+				[](const ClipKernels::ClipCodes& codes) { return codes.orCode != 0 && codes.andCode == 0; }));
+			if (numToClip > 0)
+				ClipTriangles(drawCall, numToClip);
+			m_FrameStats.numClipped += numToClip;
+
+			drawCall.firstTriangle = numTriangles;
+			numTriangles += static_cast<uint32_t>(drawCall.triangles.size());
+
+			m_FrameStats.numRasterized += static_cast<uint32_t>(std::count_if(drawCall.triangles.begin(), drawCall.triangles.end(),
+				[](const Triangle& triangle) { return triangle.isVisible; }));
+		}
+		m_FrameStats.geometryMs = ElapsedMs(frameStart);
+
+		// 2. BINNING
+		const auto binningStart = std::chrono::steady_clock::now();
+		BinTriangles(numTriangles);
+		m_FrameStats.binningMs = ElapsedMs(binningStart);
+
+		// 3. TILES (clear + their bins in order)
+		const auto rasterStart = std::chrono::steady_clock::now();
+		std::atomic<uint64_t> numPixelsShaded{ 0 };
+		ParallelFor(size_t(m_NumTilesX) * m_NumTilesY, 1, [&](size_t begin, size_t end)
+			{
+				uint64_t numPixels{};
+				for (size_t tile{ begin }; tile < end; ++tile)
+					numPixels += RenderTile(static_cast<int>(tile % m_NumTilesX), static_cast<int>(tile / m_NumTilesX));
+				numPixelsShaded += numPixels;
+			});
+		m_FrameStats.rasterMs = ElapsedMs(rasterStart);
+
+		m_FrameStats.numDraws = static_cast<uint32_t>(m_DrawCalls.size());
+		m_FrameStats.numPixelsShaded = numPixelsShaded;
+		m_FrameStats.frameMs = ElapsedMs(frameStart);
+		return m_FrameStats;
+	}
+
+	void SoftwareRenderer::Resolve(std::span<uint32_t> pixels) const
+	{
+		ColorKernels::PackRGBA8(m_ColorBuffer, pixels, false);
+	}
+
+	void SoftwareRenderer::TransformVertices(DrawCall& drawCall, size_t begin, size_t end) const
+	{
+		// VS of PosCol3D.fx
+		const Matrix& world = drawCall.worldMatrix;
+		const Matrix& worldViewProjection = drawCall.worldViewProjectionMatrix;
+
+		// Deferred: only the positions, the rest is worked out per visible pixel
+		if (drawCall.isDeferred)
+		{
+			for (size_t i{ begin }; i < end; ++i)
+				drawCall.positions[i] = worldViewProjection.TransformPoint(Vector4{ drawCall.mesh.vertices[i].position, 1.f });
+			return;
+		}
+
+		for (size_t i{ begin }; i < end; ++i)
+		{
+			const Vertex_In& input = drawCall.mesh.vertices[i];
+			VertexOut& output = drawCall.vertices[i];
+
+			drawCall.positions[i] = worldViewProjection.TransformPoint(Vector4{ input.position, 1.f });
+			output.worldPosition = world.TransformPoint(input.position);
+			output.uv = input.uv;
+			output.normal = world.TransformVector(input.normal);
+			output.tangent = world.TransformVector(input.tangent);
+		}
+	}
+
+	void SoftwareRenderer::SetupTriangles(DrawCall& drawCall, size_t begin, size_t end) const
+	{
+		const std::span<const uint32_t> indices = drawCall.mesh.indices;
+		ClipKernels::ClassifyTriangles(drawCall.positions, indices.subspan(begin * 3, (end - begin) * 3), GetClipBounds(m_Width, m_Height),
+			drawCall.clipCodes.subspan(begin, end - begin));
+
+		for (size_t i{ begin }; i < end; ++i)
+		{
+			// Outside a clip plane: gone. Crossing one: left to ClipTriangles
+			Triangle& triangle = drawCall.triangles[i];
+			if (drawCall.clipCodes[i].orCode != 0)
+			{
+				triangle.isVisible = false;
+				continue;
+			}
+
+			const Vector4* pPositions[3]{};
+			for (int v{ 0 }; v < 3; ++v)
+			{
+				const uint32_t index = indices[i * 3 + v];
+				pPositions[v] = &drawCall.positions[index];
+				if (drawCall.isDeferred)
+					triangle.pInputs[v] = &drawCall.mesh.vertices[index];
+				else
+					triangle.pVertices[v] = &drawCall.vertices[index];
+			}
+			triangle.isVisible = SetupTriangle(triangle, pPositions, drawCall.mesh.isPartialCoverage);
+		}
+	}
+
+	void SoftwareRenderer::ClipTriangles(DrawCall& drawCall, uint32_t numToClip)
+	{
+		using namespace ClipKernels;
+
+		// A clipped triangle becomes a fan of up to MaxClipVertices - 2 triangles, all of them go right after the triangles
+		// before it so the draw keeps its order (blending). The new vertices get their attributes from the weights,
+		// deferred draws interpolate the Vertex_In (the vertex shader is linear in them)
+		const std::span<const uint32_t> indices = drawCall.mesh.indices;
+		const size_t maxVertices = size_t(numToClip) * MaxClipVertices;
+		const std::span<Triangle> triangles = m_FrameArena.AllocateSpan<Triangle>(drawCall.triangles.size() + size_t(numToClip) * (MaxClipVertices - 3));
+		const std::span<Vector4> positions = m_FrameArena.AllocateSpan<Vector4>(maxVertices);
+		const std::span<VertexOut> vertices = drawCall.isDeferred ? std::span<VertexOut>{} : m_FrameArena.AllocateSpan<VertexOut>(maxVertices);
+		const std::span<Vertex_In> inputs = drawCall.isDeferred ? m_FrameArena.AllocateSpan<Vertex_In>(maxVertices) : std::span<Vertex_In>{};
+		const ClipBounds bounds = GetClipBounds(m_Width, m_Height);
+
+		size_t numTriangles{}, numVertices{};
+		for (size_t i{ 0 }; i < drawCall.triangles.size(); ++i)
+		{
+			const ClipCodes& codes = drawCall.clipCodes[i];
+			if (codes.orCode == 0 || codes.andCode != 0)
+			{
+				if (drawCall.triangles[i].isVisible)
+					triangles[numTriangles++] = drawCall.triangles[i];
+				continue;
+			}
+
+			const uint32_t triangleIndices[3]{ indices[i * 3], indices[i * 3 + 1], indices[i * 3 + 2] };
+			const Vector4 corners[3]{ drawCall.positions[triangleIndices[0]], drawCall.positions[triangleIndices[1]], drawCall.positions[triangleIndices[2]] };
+			ClipVertex polygon[MaxClipVertices];
+			const int count = ClipTriangle(corners, codes.orCode, bounds, polygon);
+
+			const size_t first = numVertices;
+			for (int v{ 0 }; v < count; ++v)
+			{
+				const float* pWeights = polygon[v].weights;
+				positions[numVertices] = polygon[v].position;
+				if (drawCall.isDeferred)
+				{
+					const Vertex_In& v0 = drawCall.mesh.vertices[triangleIndices[0]];
+					const Vertex_In& v1 = drawCall.mesh.vertices[triangleIndices[1]];
+					const Vertex_In& v2 = drawCall.mesh.vertices[triangleIndices[2]];
+					Vertex_In& input = inputs[numVertices++];
+					input.position = v0.position * pWeights[0] + v1.position * pWeights[1] + v2.position * pWeights[2];
+					input.uv = v0.uv * pWeights[0] + v1.uv * pWeights[1] + v2.uv * pWeights[2];
+					input.normal = v0.normal * pWeights[0] + v1.normal * pWeights[1] + v2.normal * pWeights[2];
+					input.tangent = v0.tangent * pWeights[0] + v1.tangent * pWeights[1] + v2.tangent * pWeights[2];
+					continue;
+				}
+
+				const VertexOut& v0 = drawCall.vertices[triangleIndices[0]];
+				const VertexOut& v1 = drawCall.vertices[triangleIndices[1]];
+				const VertexOut& v2 = drawCall.vertices[triangleIndices[2]];
+				VertexOut& vertex = vertices[numVertices++];
+				vertex.worldPosition = v0.worldPosition * pWeights[0] + v1.worldPosition * pWeights[1] + v2.worldPosition * pWeights[2];
+				vertex.uv = v0.uv * pWeights[0] + v1.uv * pWeights[1] + v2.uv * pWeights[2];
+				vertex.normal = v0.normal * pWeights[0] + v1.normal * pWeights[1] + v2.normal * pWeights[2];
+				vertex.tangent = v0.tangent * pWeights[0] + v1.tangent * pWeights[1] + v2.tangent * pWeights[2];
+			}
+
+			for (int v{ 1 }; v + 1 < count; ++v)
+			{
+				const size_t fan[3]{ first, first + v, first + v + 1 };
+				Triangle& triangle = triangles[numTriangles];
+				const Vector4* pPositions[3]{};
+				for (int k{ 0 }; k < 3; ++k)
+				{
+					pPositions[k] = &positions[fan[k]];
+					if (drawCall.isDeferred)
+						triangle.pInputs[k] = &inputs[fan[k]];
+					else
+						triangle.pVertices[k] = &vertices[fan[k]];
+				}
+				if (SetupTriangle(triangle, pPositions, drawCall.mesh.isPartialCoverage))
+				{
+					triangle.isVisible = true;
+					++numTriangles;
+				}
+			}
+		}
+
+		drawCall.triangles = triangles.first(numTriangles);
+	}
+
+	bool SoftwareRenderer::SetupTriangle(Triangle& triangle, const Vector4* pPositions[3], bool isTwoSided) const
+	{
+		const float halfWidth = m_Width * 0.5f;
+		const float halfHeight = m_Height * 0.5f;
+
+		for (int v{ 0 }; v < 3; ++v)
+		{
+			// Inside the near plane and the guard band, so w > 0 for any perspective projection
+			const Vector4& position = *pPositions[v];
+			if (position.w <= 1e-6f)
+				return false;
+
+			const float invW = 1.f / position.w;
+			const float screenX = (position.x * invW + 1.f) * halfWidth;
+			const float screenY = (1.f - position.y * invW) * halfHeight;
+			if (std::abs(screenX) > s_GuardBand || std::abs(screenY) > s_GuardBand)
+				return false;
+
+			triangle.x[v] = static_cast<int32_t>(std::lround(screenX * s_SubPixelScale));
+			triangle.y[v] = static_cast<int32_t>(std::lround(screenY * s_SubPixelScale));
+			triangle.z[v] = position.z * invW;
+			triangle.invW[v] = invW;
+		}
+
+		// Clockwise on screen (y down) is positive, that is the D3D default front face
+		int64_t doubleArea = int64_t(triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0])
+			- int64_t(triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+		if (doubleArea < 0 && isTwoSided)	// CullMode = none, only blended draws so never deferred
+		{
+			std::swap(triangle.x[1], triangle.x[2]);
+			std::swap(triangle.y[1], triangle.y[2]);
+			std::swap(triangle.z[1], triangle.z[2]);
+			std::swap(triangle.invW[1], triangle.invW[2]);
+			std::swap(triangle.pVertices[1], triangle.pVertices[2]);
+			doubleArea = -doubleArea;
+		}
+		if (doubleArea <= 0)
+			return false;
+		triangle.doubleArea = doubleArea;
+
+		// Pixels whose center lies inside the fixed point bounds
+		const int32_t minX = std::min({ triangle.x[0], triangle.x[1], triangle.x[2] });
+		const int32_t maxX = std::max({ triangle.x[0], triangle.x[1], triangle.x[2] });
+		const int32_t minY = std::min({ triangle.y[0], triangle.y[1], triangle.y[2] });
+		const int32_t maxY = std::max({ triangle.y[0], triangle.y[1], triangle.y[2] });
+		triangle.minX = std::max(0, (minX - s_SubPixelHalf + s_SubPixelScale - 1) >> s_SubPixelBits);
+		triangle.minY = std::max(0, (minY - s_SubPixelHalf + s_SubPixelScale - 1) >> s_SubPixelBits);
+		triangle.maxX = std::min(m_Width - 1, (maxX - s_SubPixelHalf) >> s_SubPixelBits);
+		triangle.maxY = std::min(m_Height - 1, (maxY - s_SubPixelHalf) >> s_SubPixelBits);
+		return triangle.minX <= triangle.maxX && triangle.minY <= triangle.maxY;
+	}
+
+	template<typename Function>
+	void SoftwareRenderer::ForEachVisibleTriangle(uint32_t begin, uint32_t end, Function&& function) const
+	{
+		for (const DrawCall& drawCall : m_DrawCalls)
+		{
+			const uint32_t drawEnd = drawCall.firstTriangle + static_cast<uint32_t>(drawCall.triangles.size());
+			for (uint32_t i{ std::max(begin, drawCall.firstTriangle) }; i < std::min(end, drawEnd); ++i)
+			{
+				const Triangle& triangle = drawCall.triangles[i - drawCall.firstTriangle];
+				if (triangle.isVisible)
+					function(i, triangle);
+			}
+		}
+	}
+
+	void SoftwareRenderer::BinTriangles(uint32_t numTriangles)
+	{
+		// Every chunk of triangles counts, then writes, its own references per tile. Laying the bins out
+		// tile major and chunk minor keeps every bin in submission order without any locking
+		const size_t numTiles = size_t(m_NumTilesX) * m_NumTilesY;
+		const size_t numChunks = (numTriangles + BinChunkSize - 1) / BinChunkSize;
+		const std::span<uint32_t> chunkOffsets = m_FrameArena.AllocateSpan<uint32_t>(numChunks * numTiles);	// [chunk][tile]
+
+		auto forEachTile = [](const Triangle& triangle, auto&& function)
+			{
+				for (int tileY{ triangle.minY / TileSize }; tileY <= triangle.maxY / TileSize; ++tileY)
+					for (int tileX{ triangle.minX / TileSize }; tileX <= triangle.maxX / TileSize; ++tileX)
+						function(tileX, tileY);
+			};
+
+		ParallelFor(numChunks, 1, [&](size_t begin, size_t end)
+			{
+				for (size_t chunk{ begin }; chunk < end; ++chunk)
+				{
+					uint32_t* pCounts = chunkOffsets.data() + chunk * numTiles;
+					std::fill(pCounts, pCounts + numTiles, 0u);
+					const uint32_t first = static_cast<uint32_t>(chunk * BinChunkSize);
+					ForEachVisibleTriangle(first, first + BinChunkSize, [&](uint32_t, const Triangle& triangle)
+						{
+							forEachTile(triangle, [&](int tileX, int tileY) { ++pCounts[tileY * m_NumTilesX + tileX]; });
+						});
+				}
+			});
+
+		// Counts -> offsets
+		m_TileBinStart = m_FrameArena.AllocateSpan<uint32_t>(numTiles + 1);
+		uint32_t numBinned{};
+		for (size_t tile{ 0 }; tile < numTiles; ++tile)
+		{
+			m_TileBinStart[tile] = numBinned;
+			for (size_t chunk{ 0 }; chunk < numChunks; ++chunk)
+			{
+				const uint32_t count = chunkOffsets[chunk * numTiles + tile];
+				chunkOffsets[chunk * numTiles + tile] = numBinned;
+				numBinned += count;
+			}
+		}
+		m_TileBinStart[numTiles] = numBinned;
+		m_FrameStats.numBinned = numBinned;
+
+		m_TileBins = m_FrameArena.AllocateSpan<uint32_t>(numBinned);
+		ParallelFor(numChunks, 1, [&](size_t begin, size_t end)
+			{
+				for (size_t chunk{ begin }; chunk < end; ++chunk)
+				{
+					uint32_t* pOffsets = chunkOffsets.data() + chunk * numTiles;
+					const uint32_t first = static_cast<uint32_t>(chunk * BinChunkSize);
+					ForEachVisibleTriangle(first, first + BinChunkSize, [&](uint32_t index, const Triangle& triangle)
+						{
+							forEachTile(triangle, [&](int tileX, int tileY) { m_TileBins[pOffsets[tileY * m_NumTilesX + tileX]++] = index; });
+						});
+				}
+			});
+	}
+
+	uint64_t SoftwareRenderer::RenderTile(int tileX, int tileY)
+	{
+		const int minX = tileX * TileSize;
+		const int minY = tileY * TileSize;
+		const int maxX = std::min(minX + TileSize, m_Width) - 1;
+		const int maxY = std::min(minY + TileSize, m_Height) - 1;
+
+		const bool isVisibilityBuffer = m_ShadingMode == ShadingMode::VisibilityBuffer;
+		const bool isWeightedBlended = m_TransparencyMode == TransparencyMode::WeightedBlended;
+		for (int y{ minY }; y <= maxY; ++y)
+		{
+			const size_t row = size_t(y) * m_Width;
+			std::fill(m_ColorBuffer.begin() + row + minX, m_ColorBuffer.begin() + row + maxX + 1, m_ClearColor);
+			std::fill(m_DepthBuffer.begin() + row + minX, m_DepthBuffer.begin() + row + maxX + 1, 1.f);
+			if (isVisibilityBuffer)
+				std::fill(m_VisibilityBuffer.begin() + row + minX, m_VisibilityBuffer.begin() + row + maxX + 1, VisibilitySample{});
+			if (isWeightedBlended)
+			{
+				std::fill(m_AccumulationBuffer.begin() + row + minX, m_AccumulationBuffer.begin() + row + maxX + 1, Vector4{});
+				std::fill(m_RevealageBuffer.begin() + row + minX, m_RevealageBuffer.begin() + row + maxX + 1, 1.f);
+			}
+		}
+
+		// The bin is sorted by frame index, so the draws are walked front to back once per pass.
+		// function(drawCall, triangle, index in the draw) for the bin's triangles of the draws passing filter
+		const size_t tile = size_t(tileY) * m_NumTilesX + tileX;
+		auto forEachTriangle = [&](auto&& filter, auto&& function)
+			{
+				auto drawCall = m_DrawCalls.cbegin();
+				for (uint32_t bin{ m_TileBinStart[tile] }; bin < m_TileBinStart[tile + 1]; ++bin)
+				{
+					const uint32_t index = m_TileBins[bin];
+					while (index >= drawCall->firstTriangle + drawCall->triangles.size())
+						++drawCall;
+
+					if (filter(*drawCall))
+						function(*drawCall, drawCall->triangles[index - drawCall->firstTriangle], index - drawCall->firstTriangle);
+				}
+			};
+
+		uint64_t numPixels{};
+		auto rasterize = [&](const DrawCall& drawCall, const Triangle& triangle, uint32_t)
+			{
+				numPixels += RasterizeTriangle(drawCall, triangle,
+					std::max(minX, triangle.minX), std::max(minY, triangle.minY),
+					std::min(maxX, triangle.maxX), std::min(maxY, triangle.maxY));
+			};
+		if (!isVisibilityBuffer)
+		{
+			forEachTriangle([](const DrawCall&) { return true; }, rasterize);
+			if (isWeightedBlended)
+				ResolveWeightedBlended(minX, minY, maxX, maxY);
+			return numPixels;
+		}
+
+		// 1. IDs and depth of the deferred draws, 2. shade what is left visible, 3. blended draws on top
+		forEachTriangle([](const DrawCall& drawCall) { return drawCall.isDeferred; }, [&](const DrawCall& drawCall, const Triangle& triangle, uint32_t index)
+			{
+				const VisibilitySample sample{ static_cast<uint32_t>(&drawCall - m_DrawCalls.data()), index };
+				RasterizeVisibility(triangle, sample,
+					std::max(minX, triangle.minX), std::max(minY, triangle.minY),
+					std::min(maxX, triangle.maxX), std::min(maxY, triangle.maxY));
+			});
+		numPixels += ShadeVisibilityBuffer(minX, minY, maxX, maxY);
+		forEachTriangle([](const DrawCall& drawCall) { return !drawCall.isDeferred; }, rasterize);
+		if (isWeightedBlended)
+			ResolveWeightedBlended(minX, minY, maxX, maxY);
+		return numPixels;
+	}
+
+	// PS_Point/PS_Linear/PS_Anisotropic of PosCol3D.fx
+	static ColorRGB ShadeDefault(const SoftwareMesh& mesh, FilteringMethod filteringMethod, const Vector3& cameraPos,
+		const Vector3& worldPosition, const Vector2& uv, const Vector2& ddx, const Vector2& ddy, const Vector3& normal, const Vector3& tangent)
+	{
+		Vector3 worldNormal = normal.Normalized();
+		if (mesh.pNormalTexture)
+		{
+			// Tangent space to world without a stored binormal, the normal map is always sampled with samPoint (mip point)
+			const Vector3 binormal = Vector3::Cross(normal, tangent).Normalized();
+			const Vector4 sample = mesh.pNormalTexture->Sample(uv, ddx, ddy, FilteringMethod::Point);
+			worldNormal = (tangent.Normalized() * (sample.x * 2.f - 1.f) + binormal * (sample.y * 2.f - 1.f) + worldNormal * (sample.z * 2.f - 1.f)).Normalized();
+		}
+
+		// Lambert cosine
+		const float lambertCos = Saturate(Vector3::Dot(worldNormal, s_LightDirection));
+		if (lambertCos <= 0.f)
+			return {};
+
+		// Lambert diffuse
+		const ColorRGB diffuse = mesh.pDiffuseTexture ? ToColor(mesh.pDiffuseTexture->Sample(uv, ddx, ddy, filteringMethod)) : colors::White;
+		ColorRGB color = diffuse * (lambertCos * s_LightIntensity / PI);
+
+		// Phong specular, the maps are grey scale so only red is used
+		const float specular = mesh.pSpecularTexture ? mesh.pSpecularTexture->Sample(uv, ddx, ddy, filteringMethod).x : 0.f;
+		if (specular > 0.f)
+		{
+			const float phongExponent = (mesh.pGlossinessTexture ? mesh.pGlossinessTexture->Sample(uv, ddx, ddy, filteringMethod).x : 1.f) * s_Shininess;
+			const Vector3 invViewDirection = (cameraPos - worldPosition).Normalized();
+			const Vector3 reflected = (s_LightDirection - worldNormal * (2.f * Vector3::Dot(worldNormal, s_LightDirection))).Normalized();
+			const float cosAlpha = std::max(Vector3::Dot(reflected, -invViewDirection), 0.f);
+			const float phong = specular * powf(cosAlpha, phongExponent);
+			color += ColorRGB{ phong, phong, phong };
+		}
+
+		// Ambient
+		return color + s_Ambient;
+	}
+
+	// uv = A / B with A = sum(weight * invW * uv) and B = sum(weight * invW), both linear in screen space,
+	// so the uv derivatives for the mip level are (dA - uv * dB) / B with per triangle dA and dB
+	struct UvGradients
+	{
+		Vector2 dAdx{}, dAdy{};
+		float dBdx{}, dBdy{};
+
+		Vector2 GetDdx(const Vector2& uv, float invSum) const { return (dAdx - uv * dBdx) * invSum; }
+		Vector2 GetDdy(const Vector2& uv, float invSum) const { return (dAdy - uv * dBdy) * invSum; }
+	};
+
+	static UvGradients ComputeUvGradients(const RasterKernels::EdgeSetup& setup, const float invW[3], const Vector2& uv0, const Vector2& uv1, const Vector2& uv2)
+	{
+		UvGradients gradients{};
+		const Vector2* pUvs[3]{ &uv0, &uv1, &uv2 };
+		for (int k{ 0 }; k < 3; ++k)
+		{
+			const float stepX = float(setup.stepX[k]) * setup.invDoubleArea * invW[k];
+			const float stepY = float(setup.stepY[k]) * setup.invDoubleArea * invW[k];
+			gradients.dAdx += *pUvs[k] * stepX;
+			gradients.dAdy += *pUvs[k] * stepY;
+			gradients.dBdx += stepX;
+			gradients.dBdy += stepY;
+		}
+		return gradients;
+	}
+
+	uint64_t SoftwareRenderer::RasterizeTriangle(const DrawCall& drawCall, const Triangle& triangle, int minX, int minY, int maxX, int maxY)
+	{
+		using namespace RasterKernels;
+
+		// Coverage, depth range and early depth test for SpanWidth pixels at a time, only the survivors are shaded
+		const EdgeSetup setup = SetupEdges(triangle.x, triangle.y, triangle.z, triangle.doubleArea, minX, minY);
+		int64_t rowEdge[3]{ setup.edge[0], setup.edge[1], setup.edge[2] };
+		int64_t stepSpan[3]{};
+		for (int k{ 0 }; k < 3; ++k)
+			stepSpan[k] = setup.stepX[k] * SpanWidth;
+
+		const SoftwareMesh& mesh = drawCall.mesh;
+		const VertexOut& v0 = *triangle.pVertices[0];
+		const VertexOut& v1 = *triangle.pVertices[1];
+		const VertexOut& v2 = *triangle.pVertices[2];
+
+		const UvGradients gradients = ComputeUvGradients(setup, triangle.invW, v0.uv, v1.uv, v2.uv);
+
+		SpanOutput span{};
+		uint64_t numPixels{};
+		for (int y{ minY }; y <= maxY; ++y)
+		{
+			int64_t edge[3]{ rowEdge[0], rowEdge[1], rowEdge[2] };
+			for (int x{ minX }; x <= maxX; x += SpanWidth)
+			{
+				const size_t spanStart = size_t(y) * m_Width + x;
+				uint32_t passed = RasterizeSpan(setup, edge, std::min(SpanWidth, maxX - x + 1), &m_DepthBuffer[spanStart], span);
+				for (; passed != 0; passed &= passed - 1)
+				{
+					const int i = std::countr_zero(passed);
+					const size_t pixel = spanStart + i;
+					++numPixels;
+
+					// Perspective correct weights
+					const float p0 = span.weights[0][i] * triangle.invW[0];
+					const float p1 = span.weights[1][i] * triangle.invW[1];
+					const float p2 = span.weights[2][i] * triangle.invW[2];
+					const float invSum = 1.f / (p0 + p1 + p2);
+					const float b0 = p0 * invSum;
+					const float b1 = p1 * invSum;
+					const float b2 = p2 * invSum;
+
+					const Vector2 uv = v0.uv * b0 + v1.uv * b1 + v2.uv * b2;
+					ColorRGB& target = m_ColorBuffer[pixel];
+
+					if (mesh.isPartialCoverage)
+					{
+						// src_alpha / inv_src_alpha, depth test without depth write. samPoint, mip point like the GPU
+						const Vector4 sample = mesh.pDiffuseTexture
+							? mesh.pDiffuseTexture->Sample(uv, gradients.GetDdx(uv, invSum), gradients.GetDdy(uv, invSum), FilteringMethod::Point)
+							: Vector4{ 1.f, 1.f, 1.f, 1.f };
+						const ColorRGB source{ Saturate(sample.x), Saturate(sample.y), Saturate(sample.z) };
+						if (m_TransparencyMode == TransparencyMode::Ordered)
+						{
+							target = source * sample.w + target * (1.f - sample.w);
+						}
+						else
+						{
+							// Eq. 8 of the paper, (z/10)^3 and (z/200)^6 of the view depth (invSum, the interpolated clip w): nearer layers weigh more
+							const float z10 = invSum * (1.f / 10.f);
+							const float z200 = invSum * (1.f / 200.f);
+							const float z200Cubed = z200 * z200 * z200;
+							const float depthWeight = std::clamp(10.f / (1e-5f + z10 * z10 * z10 + z200Cubed * z200Cubed), 1e-2f, 3e3f);
+							const float weight = sample.w * depthWeight;
+							m_AccumulationBuffer[pixel] += Vector4{ source.r * weight, source.g * weight, source.b * weight, weight };
+							m_RevealageBuffer[pixel] *= 1.f - sample.w;
+						}
+					}
+					else
+					{
+						const ColorRGB color = ShadeDefault(mesh, drawCall.filteringMethod, drawCall.cameraPos,
+							v0.worldPosition * b0 + v1.worldPosition * b1 + v2.worldPosition * b2,
+							uv, gradients.GetDdx(uv, invSum), gradients.GetDdy(uv, invSum),
+							v0.normal * b0 + v1.normal * b1 + v2.normal * b2,
+							v0.tangent * b0 + v1.tangent * b1 + v2.tangent * b2);
+
+						// UNORM render target
+						target = { Saturate(color.r), Saturate(color.g), Saturate(color.b) };
+						m_DepthBuffer[pixel] = span.depth[i];
+					}
+				}
+
+				edge[0] += stepSpan[0];
+				edge[1] += stepSpan[1];
+				edge[2] += stepSpan[2];
+			}
+
+			rowEdge[0] += setup.stepY[0];
+			rowEdge[1] += setup.stepY[1];
+			rowEdge[2] += setup.stepY[2];
+		}
+		return numPixels;
+	}
+
+	void SoftwareRenderer::RasterizeVisibility(const Triangle& triangle, VisibilitySample sample, int minX, int minY, int maxX, int maxY)
+	{
+		using namespace RasterKernels;
+
+		// Depth test and write plus the ID, nothing is interpolated
+		const EdgeSetup setup = SetupEdges(triangle.x, triangle.y, triangle.z, triangle.doubleArea, minX, minY);
+		int64_t rowEdge[3]{ setup.edge[0], setup.edge[1], setup.edge[2] };
+		int64_t stepSpan[3]{};
+		for (int k{ 0 }; k < 3; ++k)
+			stepSpan[k] = setup.stepX[k] * SpanWidth;
+
+		SpanOutput span{};
+		for (int y{ minY }; y <= maxY; ++y)
+		{
+			int64_t edge[3]{ rowEdge[0], rowEdge[1], rowEdge[2] };
+			for (int x{ minX }; x <= maxX; x += SpanWidth)
+			{
+				const size_t spanStart = size_t(y) * m_Width + x;
+				uint32_t passed = RasterizeSpan(setup, edge, std::min(SpanWidth, maxX - x + 1), &m_DepthBuffer[spanStart], span);
+				for (; passed != 0; passed &= passed - 1)
+				{
+					const int i = std::countr_zero(passed);
+					m_DepthBuffer[spanStart + i] = span.depth[i];
+					m_VisibilityBuffer[spanStart + i] = sample;
+				}
+
+				edge[0] += stepSpan[0];
+				edge[1] += stepSpan[1];
+				edge[2] += stepSpan[2];
+			}
+
+			rowEdge[0] += setup.stepY[0];
+			rowEdge[1] += setup.stepY[1];
+			rowEdge[2] += setup.stepY[2];
+		}
+	}
+
+	uint64_t SoftwareRenderer::ShadeVisibilityBuffer(int minX, int minY, int maxX, int maxY)
+	{
+		using namespace RasterKernels;
+
+		// Neighbouring pixels mostly share a triangle, its setup is only redone when the ID changes
+		VisibilitySample current{};
+		const DrawCall* pDrawCall{ nullptr };
+		const Triangle* pTriangle{ nullptr };
+		EdgeSetup setup{};
+		UvGradients gradients{};
+
+		uint64_t numPixels{};
+		for (int y{ minY }; y <= maxY; ++y)
+		{
+			for (int x{ minX }; x <= maxX; ++x)
+			{
+				const size_t pixel = size_t(y) * m_Width + x;
+				const VisibilitySample sample = m_VisibilityBuffer[pixel];
+				if (sample.instanceId == VisibilitySample::InvalidId)
+					continue;
+
+				if (sample.instanceId != current.instanceId || sample.triangleId != current.triangleId)
+				{
+					current = sample;
+					pDrawCall = &m_DrawCalls[sample.instanceId];
+					pTriangle = &pDrawCall->triangles[sample.triangleId];
+					setup = SetupEdges(pTriangle->x, pTriangle->y, pTriangle->z, pTriangle->doubleArea, pTriangle->minX, pTriangle->minY);
+					gradients = ComputeUvGradients(setup, pTriangle->invW, pTriangle->pInputs[0]->uv, pTriangle->pInputs[1]->uv, pTriangle->pInputs[2]->uv);
+				}
+				++numPixels;
+
+				// Barycentrics from the edge functions at the pixel center, exactly the rasterizer's weights
+				const Triangle& triangle = *pTriangle;
+				const int64_t dx = x - triangle.minX;
+				const int64_t dy = y - triangle.minY;
+				float weights[3]{};
+				for (int k{ 0 }; k < 3; ++k)
+					weights[k] = float(setup.edge[k] + setup.bias[k] + setup.stepX[k] * dx + setup.stepY[k] * dy) * setup.invDoubleArea;
+
+				// Perspective correct weights
+				const float p0 = weights[0] * triangle.invW[0];
+				const float p1 = weights[1] * triangle.invW[1];
+				const float p2 = weights[2] * triangle.invW[2];
+				const float invSum = 1.f / (p0 + p1 + p2);
+				const float b0 = p0 * invSum;
+				const float b1 = p1 * invSum;
+				const float b2 = p2 * invSum;
+
+				// Vertex_In interpolated first, then the vertex shader's (linear) transforms once per pixel
+				const Vertex_In& v0 = *triangle.pInputs[0];
+				const Vertex_In& v1 = *triangle.pInputs[1];
+				const Vertex_In& v2 = *triangle.pInputs[2];
+				const Matrix& world = pDrawCall->worldMatrix;
+				const Vector2 uv = v0.uv * b0 + v1.uv * b1 + v2.uv * b2;
+				const ColorRGB color = ShadeDefault(pDrawCall->mesh, pDrawCall->filteringMethod, pDrawCall->cameraPos,
+					world.TransformPoint(v0.position * b0 + v1.position * b1 + v2.position * b2),
+					uv, gradients.GetDdx(uv, invSum), gradients.GetDdy(uv, invSum),
+					world.TransformVector(v0.normal * b0 + v1.normal * b1 + v2.normal * b2),
+					world.TransformVector(v0.tangent * b0 + v1.tangent * b1 + v2.tangent * b2));
+
+				// UNORM render target
+				m_ColorBuffer[pixel] = { Saturate(color.r), Saturate(color.g), Saturate(color.b) };
+			}
+		}
+		return numPixels;
+	}
+
+	void SoftwareRenderer::ResolveWeightedBlended(int minX, int minY, int maxX, int maxY)
+	{
+		// Weighted average color over everything blended into the pixel, covering 1 - revealage of what is behind
+		for (int y{ minY }; y <= maxY; ++y)
+		{
+			for (int x{ minX }; x <= maxX; ++x)
+			{
+				const size_t pixel = size_t(y) * m_Width + x;
+				const float revealage = m_RevealageBuffer[pixel];
+				if (revealage == 1.f)
+					continue;
+
+				const Vector4& accumulation = m_AccumulationBuffer[pixel];
+				const float invWeight = 1.f / std::max(accumulation.w, 1e-5f);
+				const ColorRGB average{ accumulation.x * invWeight, accumulation.y * invWeight, accumulation.z * invWeight };
+				ColorRGB& target = m_ColorBuffer[pixel];
+				target = average * (1.f - revealage) + target * revealage;
+			}
+		}
+	}
+
+	template<typename Function>
+	void SoftwareRenderer::ParallelFor(size_t count, size_t grainSize, Function&& function) const
+	{
+		// At most m_NumThreads jobs, so the thread count set on the renderer still caps the parallelism
+		JobSystem::GetShared().ParallelFor(count, grainSize, std::forward<Function>(function), m_NumThreads);
+	}
+}
@@ -0,0 +1,196 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Math.h"
+#include "LinearArena.h"
+#include "ClipKernels.h"
+#include "Vertex.h"
+#include "SoftwareTexture.h"
+
+namespace dae
+{
+	// What Mesh binds for a draw: the Vertex_In/index data plus the effect textures.
+	// isPartialCoverage selects PosCol3D_PartialCoverage.fx (blended, depth test without write, no culling)
+	struct SoftwareMesh
+	{
+		std::span<const Vertex_In> vertices{};
+		std::span<const uint32_t> indices{};
+		bool isPartialCoverage{ false };
+
+		const SoftwareTexture* pDiffuseTexture{ nullptr };
+		const SoftwareTexture* pNormalTexture{ nullptr };
+		const SoftwareTexture* pSpecularTexture{ nullptr };
+		const SoftwareTexture* pGlossinessTexture{ nullptr };
+	};
+
+	// Headless CPU backend for the PosCol3D effects, renders into an offscreen framebuffer.
+	// Frame: BeginFrame -> Draw... -> EndFrame, sort-middle:
+	// 1. vertices and triangle setup are split over the threads, the few triangles crossing the near/far planes
+	//    (or leaving the guard band) are clipped afterwards
+	// 2. triangle references are binned into 64x64 tiles (per chunk of triangles, so without locks)
+	// 3. every thread takes tiles and runs their bins in submission order,
+	//    so tiles never share framebuffer memory and blending stays in order
+	//    (or, with TransparencyMode::WeightedBlended, is accumulated and resolved at the end of the tile)
+	// With ShadingMode::VisibilityBuffer, opaque draws only write depth and triangle/instance IDs in step 3,
+	// then every visible pixel of the tile is shaded once and the blended draws are applied on top
+	// All per-frame geometry and the bins live in a frame arena, steady state frames don't allocate
+	class SoftwareRenderer final
+	{
+	public:
+		enum class ShadingMode
+		{
+			Forward,			// shade every fragment that passes the depth test
+			VisibilityBuffer	// shade the visible pixels once, from the triangle/instance ID they ended up with
+		};
+
+		// How PartialCoverage (blended) draws combine, they always depth test without writing depth
+		enum class TransparencyMode
+		{
+			Ordered,			// src_alpha / inv_src_alpha in submission order, exactly what the effect does
+			WeightedBlended		// order independent approximation (McGuire & Bavoil 2013), accumulated per pixel and resolved per tile
+		};
+
+		// What a pixel of the visibility buffer holds: the draw (instance) and its triangle
+		struct VisibilitySample
+		{
+			static constexpr uint32_t InvalidId{ ~0u };
+
+			uint32_t instanceId{ InvalidId };	// draw index in the frame
+			uint32_t triangleId{ InvalidId };	// index in the draw's triangles (after clipping)
+		};
+
+		struct FrameStats
+		{
+			float frameMs{};			// EndFrame wall time
+			float geometryMs{};			// vertex shading + triangle setup
+			float binningMs{};
+			float rasterMs{};			// tiles
+			uint32_t numDraws{};
+			uint32_t numTriangles{};	// submitted
+			uint32_t numClipped{};		// submitted triangles that crossed a clip plane
+			uint32_t numRasterized{};	// after culling
+			uint32_t numBinned{};		// triangle references over all tiles
+			uint64_t numPixelsShaded{};	// Forward: passed the depth test, VisibilityBuffer: visible + blended
+		};
+
+		static constexpr int TileSize{ 64 };
+		static constexpr uint32_t BinChunkSize{ 4096 };	// triangles binned per task
+
+		SoftwareRenderer(int width, int height, uint32_t numThreads = 0);	// 0 = hardware threads
+		~SoftwareRenderer() = default;
+
+		SoftwareRenderer(const SoftwareRenderer&) = delete;
+		SoftwareRenderer(SoftwareRenderer&&) noexcept = delete;
+		SoftwareRenderer& operator=(const SoftwareRenderer&) = delete;
+		SoftwareRenderer& operator=(SoftwareRenderer&&) noexcept = delete;
+
+		void BeginFrame(const ColorRGB& clearColor);
+		// Same inputs as Mesh::Render. The mesh data has to stay alive until EndFrame
+		void Draw(const SoftwareMesh& mesh, const Matrix& worldMatrix, const Matrix& worldViewProjectionMatrix, const Vector3& cameraPos, FilteringMethod filteringMethod);
+		const FrameStats& EndFrame();
+
+		// Takes effect at the next EndFrame. The visibility buffer is allocated the first time it is turned on
+		void SetShadingMode(ShadingMode shadingMode);
+		ShadingMode GetShadingMode() const { return m_ShadingMode; }
+		// Same, the accumulation buffers are allocated the first time WeightedBlended is turned on
+		void SetTransparencyMode(TransparencyMode transparencyMode);
+		TransparencyMode GetTransparencyMode() const { return m_TransparencyMode; }
+
+		// RGBA8 like the R8G8B8A8_UNORM swap chain (no sRGB encode)
+		void Resolve(std::span<uint32_t> pixels) const;
+
+		int GetWidth() const { return m_Width; }
+		int GetHeight() const { return m_Height; }
+		uint32_t GetNumThreads() const { return m_NumThreads; }
+		const std::vector<ColorRGB>& GetColorBuffer() const { return m_ColorBuffer; }
+		const std::vector<float>& GetDepthBuffer() const { return m_DepthBuffer; }
+		const std::vector<VisibilitySample>& GetVisibilityBuffer() const { return m_VisibilityBuffer; }	// empty until used
+		const FrameStats& GetFrameStats() const { return m_FrameStats; }
+
+	private:
+		// VS_OUTPUT of PosCol3D.fx, without the clip space position (DrawCall::positions)
+		struct VertexOut
+		{
+			Vector3 worldPosition{};
+			Vector2 uv{};
+			Vector3 normal{};
+			Vector3 tangent{};
+		};
+
+		// Screen space triangle, vertices in 24.8 fixed point with a positive (clockwise) area
+		struct Triangle
+		{
+			int32_t x[3]{}, y[3]{};
+			float z[3]{};
+			float invW[3]{};
+			union
+			{
+				const VertexOut* pVertices[3]{};	// shaded during rasterization
+				const Vertex_In* pInputs[3];		// DrawCall::isDeferred: the attributes are fetched again when shading
+			};
+			int minX{}, minY{}, maxX{}, maxY{};	// pixel bounds, inclusive
+			int64_t doubleArea{};
+			bool isVisible{ false };
+		};
+
+		struct DrawCall
+		{
+			SoftwareMesh mesh{};
+			Matrix worldMatrix{};
+			Matrix worldViewProjectionMatrix{};
+			Vector3 cameraPos{};
+			FilteringMethod filteringMethod{};
+			bool isDeferred{ false };	// goes through the visibility buffer: no VertexOut, Triangle::pInputs
+
+			// Frame arena
+			std::span<Vector4> positions{};		// clip space, apart from the other outputs for the clip tests
+			std::span<VertexOut> vertices{};	// empty when deferred
+			std::span<ClipKernels::ClipCodes> clipCodes{};	// per submitted triangle
+			std::span<Triangle> triangles{};	// clipped pieces follow the triangle they came from
+			uint32_t firstTriangle{};	// index of triangles[0] in the frame
+		};
+
+		int m_Width;
+		int m_Height;
+		int m_NumTilesX;
+		int m_NumTilesY;
+		uint32_t m_NumThreads;
+
+		std::vector<ColorRGB> m_ColorBuffer;
+		std::vector<float> m_DepthBuffer;
+		std::vector<VisibilitySample> m_VisibilityBuffer{};
+		ColorRGB m_ClearColor{};
+		ShadingMode m_ShadingMode{ ShadingMode::Forward };
+
+		// WeightedBlended: sum of weighted premultiplied color (rgb) and weighted alpha (a), product of (1 - alpha)
+		std::vector<Vector4> m_AccumulationBuffer{};
+		std::vector<float> m_RevealageBuffer{};
+		TransparencyMode m_TransparencyMode{ TransparencyMode::Ordered };
+
+		std::vector<DrawCall> m_DrawCalls{};
+		FrameStats m_FrameStats{};
+
+		// Bins: the frame indices of the triangles touching tile t are m_TileBins[m_TileBinStart[t], m_TileBinStart[t + 1])
+		LinearArena m_FrameArena{};
+		std::span<uint32_t> m_TileBinStart{};
+		std::span<uint32_t> m_TileBins{};
+
+		void TransformVertices(DrawCall& drawCall, size_t begin, size_t end) const;
+		void SetupTriangles(DrawCall& drawCall, size_t begin, size_t end) const;
+		void ClipTriangles(DrawCall& drawCall, uint32_t numToClip);
+		bool SetupTriangle(Triangle& triangle, const Vector4* pPositions[3], bool isTwoSided) const;
+		void BinTriangles(uint32_t numTriangles);
+		template<typename Function>
+		void ForEachVisibleTriangle(uint32_t begin, uint32_t end, Function&& function) const;
+		uint64_t RenderTile(int tileX, int tileY);
+		uint64_t RasterizeTriangle(const DrawCall& drawCall, const Triangle& triangle, int minX, int minY, int maxX, int maxY);
+		void RasterizeVisibility(const Triangle& triangle, VisibilitySample sample, int minX, int minY, int maxX, int maxY);
+		uint64_t ShadeVisibilityBuffer(int minX, int minY, int maxX, int maxY);
+		void ResolveWeightedBlended(int minX, int minY, int maxX, int maxY);
+
+		// Runs function(begin, end) over [0, count) in chunks of grainSize, as at most m_NumThreads jobs on the shared JobSystem
+		template<typename Function>
+		void ParallelFor(size_t count, size_t grainSize, Function&& function) const;
+	};
+}
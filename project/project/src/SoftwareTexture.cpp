@@ -0,0 +1,271 @@
+#include "SoftwareTexture.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+namespace dae
+{
+	// x's bits spread to the even bit positions
+	static uint32_t SpreadBits(uint32_t x)
+	{
+		x &= 0xFFFF;
+		x = (x | (x << 8)) & 0x00FF00FF;
+		x = (x | (x << 4)) & 0x0F0F0F0F;
+		x = (x | (x << 2)) & 0x33333333;
+		x = (x | (x << 1)) & 0x55555555;
+		return x;
+	}
+
+	static int Wrap(int x, int size)
+	{
+		if ((size & (size - 1)) == 0)
+			return x & (size - 1);
+
+		x %= size;
+		return x < 0 ? x + size : x;
+	}
+
+	static uint32_t Average(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+	{
+		uint32_t result{};
+		for (int shift{ 0 }; shift < 32; shift += 8)
+		{
+			const uint32_t sum = ((a >> shift) & 0xFF) + ((b >> shift) & 0xFF) + ((c >> shift) & 0xFF) + ((d >> shift) & 0xFF);
+			result |= ((sum + 2) / 4) << shift;
+		}
+		return result;
+	}
+
+	SoftwareTexture::SoftwareTexture(int width, int height, std::vector<uint32_t> texels, Layout layout)
+		: m_Layout{ layout }
+	{
+		assert(width > 0 && height > 0 && texels.size() == size_t(width) * size_t(height));
+
+		if (!std::has_single_bit(unsigned(width)) || !std::has_single_bit(unsigned(height)))
+			m_Layout = Layout::Linear;
+
+		// Halve down to 1x1 like D3D (odd sizes round down)
+		uint32_t numTexels{};
+		for (int levelWidth{ width }, levelHeight{ height };; levelWidth = std::max(1, levelWidth / 2), levelHeight = std::max(1, levelHeight / 2))
+		{
+			const int interleavedBits = std::min(std::countr_zero(unsigned(levelWidth)), std::countr_zero(unsigned(levelHeight)));
+			m_Levels.push_back({ levelWidth, levelHeight, numTexels, interleavedBits });
+			numTexels += uint32_t(levelWidth) * uint32_t(levelHeight);
+			if (levelWidth == 1 && levelHeight == 1)
+				break;
+		}
+
+		// Box filtered chain in row major order, each level from the one above
+		std::vector<uint32_t> rowMajor{ std::move(texels) };
+		rowMajor.resize(numTexels);
+		for (size_t i{ 1 }; i < m_Levels.size(); ++i)
+		{
+			const Level& source = m_Levels[i - 1];
+			const Level& target = m_Levels[i];
+			const uint32_t* pSource = rowMajor.data() + source.offset;
+			uint32_t* pTarget = rowMajor.data() + target.offset;
+			for (int y{ 0 }; y < target.height; ++y)
+			{
+				const int y0 = std::min(2 * y, source.height - 1);
+				const int y1 = std::min(2 * y + 1, source.height - 1);
+				for (int x{ 0 }; x < target.width; ++x)
+				{
+					const int x0 = std::min(2 * x, source.width - 1);
+					const int x1 = std::min(2 * x + 1, source.width - 1);
+					pTarget[size_t(y) * target.width + x] = Average(
+						pSource[size_t(y0) * source.width + x0], pSource[size_t(y0) * source.width + x1],
+						pSource[size_t(y1) * source.width + x0], pSource[size_t(y1) * source.width + x1]);
+				}
+			}
+		}
+
+		if (m_Layout == Layout::Linear)
+		{
+			m_Texels = std::move(rowMajor);
+			return;
+		}
+
+		m_Texels.resize(numTexels);
+		for (int level{ 0 }; level < GetLevelCount(); ++level)
+		{
+			const Level& info = m_Levels[level];
+			for (int y{ 0 }; y < info.height; ++y)
+				for (int x{ 0 }; x < info.width; ++x)
+					m_Texels[GetTexelIndex(level, x, y)] = rowMajor[info.offset + size_t(y) * info.width + x];
+		}
+	}
+
+	uint32_t SoftwareTexture::GetTexelIndex(int level, int x, int y) const
+	{
+		const Level& info = m_Levels[level];
+		return GetTexelIndex(info, Wrap(x, info.width), Wrap(y, info.height));
+	}
+
+	uint32_t SoftwareTexture::GetTexelIndex(const Level& level, int x, int y) const
+	{
+		if (m_Layout == Layout::Linear)
+			return level.offset + uint32_t(y) * level.width + x;
+
+		// One of the shifted coordinates is 0, the longer side's remaining bits sit above the interleaved ones
+		const uint32_t mask = (1u << level.interleavedBits) - 1;
+		const uint32_t interleaved = SpreadBits(x & mask) | (SpreadBits(y & mask) << 1);
+		const uint32_t rest = (uint32_t(x) >> level.interleavedBits) | (uint32_t(y) >> level.interleavedBits);
+		return level.offset + (interleaved | (rest << (2 * level.interleavedBits)));
+	}
+
+	Vector4 SoftwareTexture::Sample(const Vector2& uv, FilteringMethod filteringMethod) const
+	{
+		if (filteringMethod == FilteringMethod::Point)
+			return SamplePoint(uv);
+		return SampleLinear(uv);
+	}
+
+	Vector4 SoftwareTexture::Sample(const Vector2& uv, const Vector2& ddx, const Vector2& ddy, FilteringMethod filteringMethod) const
+	{
+		return Sample(uv, ComputeFootprint(ddx, ddy, filteringMethod));
+	}
+
+	void SoftwareTexture::Sample(std::span<const Vector2> uvs, const Vector2& ddx, const Vector2& ddy, FilteringMethod filteringMethod, std::span<Vector4> output) const
+	{
+		assert(output.size() >= uvs.size());
+
+		const Footprint footprint = ComputeFootprint(ddx, ddy, filteringMethod);
+		for (size_t i{ 0 }; i < uvs.size(); ++i)
+			output[i] = Sample(uvs[i], footprint);
+	}
+
+	Vector4 SoftwareTexture::SamplePoint(const Vector2& uv, int level) const
+	{
+		const Level& info = m_Levels[level];
+		return Fetch(level, static_cast<int>(std::floor(uv.x * info.width)), static_cast<int>(std::floor(uv.y * info.height)));
+	}
+
+	Vector4 SoftwareTexture::SampleLinear(const Vector2& uv, int level) const
+	{
+		// Texel centers sit at half coordinates
+		const Level& info = m_Levels[level];
+		const float x = uv.x * info.width - 0.5f;
+		const float y = uv.y * info.height - 0.5f;
+		const float x0 = std::floor(x);
+		const float y0 = std::floor(y);
+		const float fx = x - x0;
+		const float fy = y - y0;
+		const int ix = Wrap(static_cast<int>(x0), info.width);
+		const int iy = Wrap(static_cast<int>(y0), info.height);
+		const int ix1 = ix + 1 < info.width ? ix + 1 : 0;
+		const int iy1 = iy + 1 < info.height ? iy + 1 : 0;
+
+		// Wrapped once, blended per channel on the bytes
+		const uint32_t texels[4]{
+			m_Texels[GetTexelIndex(info, ix, iy)], m_Texels[GetTexelIndex(info, ix1, iy)],
+			m_Texels[GetTexelIndex(info, ix, iy1)], m_Texels[GetTexelIndex(info, ix1, iy1)] };
+		const float weights[4]{ (1.f - fx) * (1.f - fy), fx * (1.f - fy), (1.f - fx) * fy, fx * fy };
+
+		float channels[4]{};
+		for (int c{ 0 }; c < 4; ++c)
+		{
+			const int shift = c * 8;
+			channels[c] = (float((texels[0] >> shift) & 0xFF) * weights[0] + float((texels[1] >> shift) & 0xFF) * weights[1]
+				+ float((texels[2] >> shift) & 0xFF) * weights[2] + float((texels[3] >> shift) & 0xFF) * weights[3]) * (1.f / 255.f);
+		}
+		return { channels[0], channels[1], channels[2], channels[3] };
+	}
+
+	Vector4 SoftwareTexture::SampleTrilinear(const Vector2& uv, float lod) const
+	{
+		const int lastLevel = GetLevelCount() - 1;
+		if (!(lod > 0.f))	// magnified (or NaN)
+			return SampleLinear(uv, 0);
+		if (lod >= float(lastLevel))
+			return SampleLinear(uv, lastLevel);
+
+		const float level0 = std::floor(lod);
+		const float fraction = lod - level0;
+		const int level = static_cast<int>(level0);
+		if (fraction == 0.f)
+			return SampleLinear(uv, level);
+		return SampleLinear(uv, level) * (1.f - fraction) + SampleLinear(uv, level + 1) * fraction;
+	}
+
+	Vector4 SoftwareTexture::SampleAnisotropic(const Vector2& uv, const Vector2& ddx, const Vector2& ddy) const
+	{
+		return Sample(uv, ComputeFootprint(ddx, ddy, FilteringMethod::Anisotropic));
+	}
+
+	float SoftwareTexture::ComputeLod(const Vector2& ddx, const Vector2& ddy) const
+	{
+		const float width = float(m_Levels[0].width);
+		const float height = float(m_Levels[0].height);
+		const float lengthX = Vector2{ ddx.x * width, ddx.y * height }.SqrMagnitude();
+		const float lengthY = Vector2{ ddy.x * width, ddy.y * height }.SqrMagnitude();
+		return 0.5f * std::log2(std::max(lengthX, lengthY));
+	}
+
+	SoftwareTexture::Footprint SoftwareTexture::ComputeFootprint(const Vector2& ddx, const Vector2& ddy, FilteringMethod filteringMethod) const
+	{
+		Footprint footprint{ filteringMethod };
+		if (filteringMethod != FilteringMethod::Anisotropic)
+		{
+			footprint.lod = ComputeLod(ddx, ddy);
+			return footprint;
+		}
+
+		// The short axis picks the level, taps along the long axis cover the rest (EXT_texture_filter_anisotropic)
+		const float width = float(m_Levels[0].width);
+		const float height = float(m_Levels[0].height);
+		const float lengthX = Vector2{ ddx.x * width, ddx.y * height }.Magnitude();
+		const float lengthY = Vector2{ ddy.x * width, ddy.y * height }.Magnitude();
+		const float lengthMax = std::max(lengthX, lengthY);
+		const float lengthMin = std::min(lengthX, lengthY);
+		if (lengthMax <= 1.f || !(lengthMin > 0.f))
+		{
+			// Magnified or degenerate: a single trilinear tap
+			footprint.lod = std::log2(lengthMax);
+			return footprint;
+		}
+
+		footprint.numTaps = std::min(static_cast<int>(std::ceil(lengthMax / lengthMin - 1e-3f)), MaxAnisotropy);
+		footprint.lod = std::log2(lengthMax / footprint.numTaps);
+		footprint.step = (lengthX >= lengthY ? ddx : ddy) / float(footprint.numTaps);
+		return footprint;
+	}
+
+	Vector4 SoftwareTexture::Sample(const Vector2& uv, const Footprint& footprint) const
+	{
+		switch (footprint.filteringMethod)
+		{
+		case FilteringMethod::Point:
+		{
+			// Nearest level, the top one when magnified
+			const int level = footprint.lod > 0.5f ? std::min(static_cast<int>(footprint.lod + 0.5f), GetLevelCount() - 1) : 0;
+			return SamplePoint(uv, level);
+		}
+		case FilteringMethod::Anisotropic:
+			if (footprint.numTaps > 1)
+			{
+				// Evenly spread over the long axis, centered on uv
+				Vector4 sum{};
+				Vector2 tap = uv - footprint.step * (0.5f * (footprint.numTaps - 1));
+				for (int i{ 0 }; i < footprint.numTaps; ++i, tap += footprint.step)
+					sum += SampleTrilinear(tap, footprint.lod);
+				return sum * (1.f / footprint.numTaps);
+			}
+			return SampleTrilinear(uv, footprint.lod);
+		default:
+			return SampleTrilinear(uv, footprint.lod);
+		}
+	}
+
+	Vector4 SoftwareTexture::Fetch(int level, int x, int y) const
+	{
+		const uint32_t texel = GetTexel(level, x, y);
+		constexpr float toUnit{ 1.f / 255.f };
+		return {
+			float(texel & 0xFF) * toUnit,
+			float((texel >> 8) & 0xFF) * toUnit,
+			float((texel >> 16) & 0xFF) * toUnit,
+			float(texel >> 24) * toUnit };
+	}
+}
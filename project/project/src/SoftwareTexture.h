@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Math.h"
+#include "FilteringMethod.h"
+
+namespace dae
+{
+	// CPU side counterpart of Texture: RGBA8 texels (R in the lowest byte, like DXGI_FORMAT_R8G8B8A8_UNORM)
+	// with a box filtered mip chain, sampled with wrap addressing the way the .fx samplers do.
+	// All levels share one buffer of 32 bit texels, so a texel is a single index (gather friendly)
+	class SoftwareTexture final
+	{
+	public:
+		// Texel order within a level. Morton interleaves the x and y bits, so a bilinear or anisotropic footprint
+		// stays within a few cache lines whatever its direction. Only for power of two sizes, others stay Linear
+		enum class Layout
+		{
+			Linear,
+			Morton
+		};
+
+		static constexpr int MaxAnisotropy{ 16 };	// D3D11_REQ_MAXANISOTROPY, the sampler default
+
+		// texels: width * height, row major
+		SoftwareTexture(int width, int height, std::vector<uint32_t> texels, Layout layout = Layout::Linear);
+		~SoftwareTexture() = default;
+
+		SoftwareTexture(const SoftwareTexture&) = delete;
+		SoftwareTexture(SoftwareTexture&&) noexcept = delete;
+		SoftwareTexture& operator=(const SoftwareTexture&) = delete;
+		SoftwareTexture& operator=(SoftwareTexture&&) noexcept = delete;
+
+		// rgba in [0, 1]. Without uv derivatives there is no footprint: the top level is sampled and Anisotropic filters like Linear
+		Vector4 Sample(const Vector2& uv, FilteringMethod filteringMethod) const;
+		// ddx/ddy: change of uv one pixel right/down. Point = MIN_MAG_MIP_POINT, Linear = MIN_MAG_MIP_LINEAR, Anisotropic = ANISOTROPIC
+		Vector4 Sample(const Vector2& uv, const Vector2& ddx, const Vector2& ddy, FilteringMethod filteringMethod) const;
+		// Many samples sharing one footprint (e.g. a span of pixels), the lod and anisotropy are worked out once
+		void Sample(std::span<const Vector2> uvs, const Vector2& ddx, const Vector2& ddy, FilteringMethod filteringMethod, std::span<Vector4> output) const;
+
+		Vector4 SamplePoint(const Vector2& uv, int level = 0) const;
+		Vector4 SampleLinear(const Vector2& uv, int level = 0) const;	// bilinear
+		Vector4 SampleTrilinear(const Vector2& uv, float lod) const;
+		Vector4 SampleAnisotropic(const Vector2& uv, const Vector2& ddx, const Vector2& ddy) const;
+
+		// log2 of the footprint size in top level texels, negative when magnified
+		float ComputeLod(const Vector2& ddx, const Vector2& ddy) const;
+
+		int GetWidth(int level = 0) const { return m_Levels[level].width; }
+		int GetHeight(int level = 0) const { return m_Levels[level].height; }
+		int GetLevelCount() const { return static_cast<int>(m_Levels.size()); }
+		Layout GetLayout() const { return m_Layout; }
+
+		// Every level back to back, top level first, texels of a level in GetLayout() order
+		const std::vector<uint32_t>& GetTexels() const { return m_Texels; }
+		uint32_t GetTexel(int level, int x, int y) const { return m_Texels[GetTexelIndex(level, x, y)]; }	// wrapped
+		uint32_t GetTexelIndex(int level, int x, int y) const;
+
+	private:
+		struct Level
+		{
+			int width{};
+			int height{};
+			uint32_t offset{};			// first texel in m_Texels
+			int interleavedBits{};		// Morton: low bits of x and y that are interleaved, the rest of the longer side goes on top
+		};
+
+		// What one sample covers: the filter, its level of detail and the taps along the major axis
+		struct Footprint
+		{
+			FilteringMethod filteringMethod{};
+			float lod{};
+			Vector2 step{};				// uv between anisotropic taps
+			int numTaps{ 1 };
+		};
+
+		std::vector<Level> m_Levels;
+		std::vector<uint32_t> m_Texels;
+		Layout m_Layout;
+
+		Footprint ComputeFootprint(const Vector2& ddx, const Vector2& ddy, FilteringMethod filteringMethod) const;
+		Vector4 Sample(const Vector2& uv, const Footprint& footprint) const;
+		uint32_t GetTexelIndex(const Level& level, int x, int y) const;	// x, y already wrapped
+		Vector4 Fetch(int level, int x, int y) const;
+	};
+}
@@ -0,0 +1,223 @@
+#include "StateCache.h"
+
+#include <cstring>
+
+namespace dae
+{
+	StateCache::StateCache(ICommandContext& context)
+		: m_Context{ context }
+	{
+	}
+
+	void StateCache::Invalidate()
+	{
+		m_IsTopologyKnown = false;
+		m_IsInputLayoutKnown = false;
+		m_VertexBuffers = {};
+		m_IsIndexBufferKnown = false;
+		m_ConstantBuffers = {};
+		m_EffectVariables.clear();
+		m_AppliedTechnique = {};
+		m_IsEffectDirty = true;
+	}
+
+	// Output merger
+	//--------------
+
+	void StateCache::SetRenderTargets(std::span<const TextureHandle> colorTargets, TextureHandle depthStencil)
+	{
+		m_IsEffectDirty = true;
+		m_Context.SetRenderTargets(colorTargets, depthStencil);
+	}
+
+	void StateCache::Transition(TextureHandle texture, ResourceState before, ResourceState after)
+	{
+		m_IsEffectDirty = true;
+		m_Context.Transition(texture, before, after);
+	}
+
+	// Input assembler
+	//--------------
+
+	void StateCache::SetPrimitiveTopology(PrimitiveTopology topology)
+	{
+		++m_CurrentFrameStats.numStateCalls;
+		if (m_IsTopologyKnown && m_Topology == topology)
+		{
+			++m_CurrentFrameStats.numSkippedInputAssembler;
+			return;
+		}
+
+		m_IsTopologyKnown = true;
+		m_Topology = topology;
+		m_Context.SetPrimitiveTopology(topology);
+	}
+
+	void StateCache::SetInputLayout(InputLayoutHandle inputLayout)
+	{
+		++m_CurrentFrameStats.numStateCalls;
+		if (m_IsInputLayoutKnown && m_InputLayout == inputLayout)
+		{
+			++m_CurrentFrameStats.numSkippedInputAssembler;
+			return;
+		}
+
+		m_IsInputLayoutKnown = true;
+		m_InputLayout = inputLayout;
+		m_Context.SetInputLayout(inputLayout);
+	}
+
+	void StateCache::SetVertexBuffer(uint32_t slot, BufferHandle buffer, uint32_t stride, uint32_t offset)
+	{
+		++m_CurrentFrameStats.numStateCalls;
+		if (slot >= s_MaxVertexBufferSlots)
+		{
+			m_Context.SetVertexBuffer(slot, buffer, stride, offset);
+			return;
+		}
+
+		VertexBufferBinding& binding = m_VertexBuffers[slot];
+		if (binding.isKnown && binding.buffer == buffer && binding.stride == stride && binding.offset == offset)
+		{
+			++m_CurrentFrameStats.numSkippedInputAssembler;
+			return;
+		}
+
+		binding = { buffer, stride, offset, true };
+		m_Context.SetVertexBuffer(slot, buffer, stride, offset);
+	}
+
+	void StateCache::SetIndexBuffer(BufferHandle buffer, Format format, uint32_t offset)
+	{
+		++m_CurrentFrameStats.numStateCalls;
+		if (m_IsIndexBufferKnown && m_IndexBuffer == buffer && m_IndexFormat == format && m_IndexOffset == offset)
+		{
+			++m_CurrentFrameStats.numSkippedInputAssembler;
+			return;
+		}
+
+		m_IsIndexBufferKnown = true;
+		m_IndexBuffer = buffer;
+		m_IndexFormat = format;
+		m_IndexOffset = offset;
+		m_Context.SetIndexBuffer(buffer, format, offset);
+	}
+
+	// Constant buffers
+	//--------------
+
+	void StateCache::SetConstantBuffer(uint32_t slot, BufferHandle buffer, uint32_t byteOffset, uint32_t byteSize)
+	{
+		++m_CurrentFrameStats.numStateCalls;
+		if (slot >= s_MaxConstantBufferSlots)
+		{
+			m_Context.SetConstantBuffer(slot, buffer, byteOffset, byteSize);
+			return;
+		}
+
+		ConstantBufferBinding& binding = m_ConstantBuffers[slot];
+		if (binding.isKnown && binding.buffer == buffer && binding.byteOffset == byteOffset && binding.byteSize == byteSize)
+		{
+			++m_CurrentFrameStats.numSkippedConstantBuffers;
+			return;
+		}
+
+		// A released slot goes back to the effect's own buffer on the next apply, which can't be skipped then
+		if (!buffer.IsValid())
+			m_IsEffectDirty = true;
+		binding = { buffer, byteOffset, byteSize, true };
+		m_Context.SetConstantBuffer(slot, buffer, byteOffset, byteSize);
+	}
+
+	// Effect
+	//--------------
+
+	StateCache::EffectVariableValue* StateCache::GetVariableValue(EffectVariableHandle variable)
+	{
+		if (!variable.IsValid())
+			return nullptr;
+		if (variable.id > m_EffectVariables.size())
+			m_EffectVariables.resize(variable.id);
+		return &m_EffectVariables[variable.id - 1];
+	}
+
+	// Values are compared bitwise: -0/+0 and NaNs count as changes, which only costs a forwarded call
+	void StateCache::SetEffectMatrix(EffectVariableHandle variable, const Matrix& matrix)
+	{
+		++m_CurrentFrameStats.numStateCalls;
+		EffectVariableValue* pValue = GetVariableValue(variable);
+		if (pValue && pValue->kind == EffectVariableValue::Kind::Matrix && std::memcmp(&pValue->matrix, &matrix, sizeof(Matrix)) == 0)
+		{
+			++m_CurrentFrameStats.numSkippedEffectVariables;
+			return;
+		}
+
+		if (pValue)
+		{
+			pValue->kind = EffectVariableValue::Kind::Matrix;
+			pValue->matrix = matrix;
+		}
+		m_IsEffectDirty = true;
+		m_Context.SetEffectMatrix(variable, matrix);
+	}
+
+	void StateCache::SetEffectVector(EffectVariableHandle variable, const Vector3& vector)
+	{
+		++m_CurrentFrameStats.numStateCalls;
+		EffectVariableValue* pValue = GetVariableValue(variable);
+		if (pValue && pValue->kind == EffectVariableValue::Kind::Vector && std::memcmp(&pValue->vector, &vector, sizeof(Vector3)) == 0)
+		{
+			++m_CurrentFrameStats.numSkippedEffectVariables;
+			return;
+		}
+
+		if (pValue)
+		{
+			pValue->kind = EffectVariableValue::Kind::Vector;
+			pValue->vector = vector;
+		}
+		m_IsEffectDirty = true;
+		m_Context.SetEffectVector(variable, vector);
+	}
+
+	void StateCache::SetEffectTexture(EffectVariableHandle variable, TextureHandle texture)
+	{
+		++m_CurrentFrameStats.numStateCalls;
+		EffectVariableValue* pValue = GetVariableValue(variable);
+		if (pValue && pValue->kind == EffectVariableValue::Kind::Texture && pValue->texture == texture)
+		{
+			++m_CurrentFrameStats.numSkippedEffectVariables;
+			return;
+		}
+
+		if (pValue)
+		{
+			pValue->kind = EffectVariableValue::Kind::Texture;
+			pValue->texture = texture;
+		}
+		m_IsEffectDirty = true;
+		m_Context.SetEffectTexture(variable, texture);
+	}
+
+	void StateCache::ApplyTechnique(TechniqueHandle technique, uint32_t passIndex)
+	{
+		++m_CurrentFrameStats.numStateCalls;
+		if (!m_IsEffectDirty && technique.IsValid() && m_AppliedTechnique == technique && m_AppliedPass == passIndex)
+		{
+			++m_CurrentFrameStats.numSkippedTechniques;
+			return;
+		}
+
+		m_AppliedTechnique = technique;
+		m_AppliedPass = passIndex;
+		m_IsEffectDirty = false;
+		m_Context.ApplyTechnique(technique, passIndex);
+	}
+
+	void StateCache::Present()
+	{
+		m_Context.Present();
+		m_LastFrameStats = m_CurrentFrameStats;
+		m_CurrentFrameStats = {};
+	}
+}
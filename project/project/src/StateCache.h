@@ -0,0 +1,131 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "RenderDevice.h"
+
+namespace dae
+{
+	// Command context in front of another one that drops calls setting state that is already bound:
+	// input assembler bindings, constant buffer ranges, effect variable values and the applied technique pass.
+	// Assumes every state change goes through it (call Invalidate otherwise) and that handle ids are never reused,
+	// which holds for both backends
+	class StateCache final : public ICommandContext
+	{
+	public:
+		// Calls of one frame, from Present to Present
+		struct FrameStats
+		{
+			uint32_t numStateCalls{};	// Set*/ApplyTechnique calls received
+			uint32_t numSkippedInputAssembler{};
+			uint32_t numSkippedConstantBuffers{};
+			uint32_t numSkippedEffectVariables{};
+			uint32_t numSkippedTechniques{};
+
+			uint32_t GetSkippedCount() const { return numSkippedInputAssembler + numSkippedConstantBuffers + numSkippedEffectVariables + numSkippedTechniques; }
+		};
+
+		explicit StateCache(ICommandContext& context);
+		~StateCache() override = default;
+
+		StateCache(const StateCache&) = delete;
+		StateCache(StateCache&&) noexcept = delete;
+		StateCache& operator=(const StateCache&) = delete;
+		StateCache& operator=(StateCache&&) noexcept = delete;
+
+		// Forget what is bound, the next call of every kind is forwarded
+		void Invalidate();
+
+		const FrameStats& GetFrameStats() const { return m_CurrentFrameStats; }		// frame being recorded
+		const FrameStats& GetLastFrameStats() const { return m_LastFrameStats; }	// up to the last Present
+
+		// ICommandContext
+		// ------
+		void ClearRenderTarget(const ColorRGB& color) override { m_Context.ClearRenderTarget(color); }
+		void ClearDepthStencil(float depth, uint8_t stencil) override { m_Context.ClearDepthStencil(depth, stencil); }
+
+		// Both may unbind shader resources the applied pass bound, the next ApplyTechnique is forwarded
+		void SetRenderTargets(std::span<const TextureHandle> colorTargets, TextureHandle depthStencil) override;
+		void Transition(TextureHandle texture, ResourceState before, ResourceState after) override;
+
+		void SetPrimitiveTopology(PrimitiveTopology topology) override;
+		void SetInputLayout(InputLayoutHandle inputLayout) override;
+		void SetVertexBuffer(uint32_t slot, BufferHandle buffer, uint32_t stride, uint32_t offset) override;
+		void SetIndexBuffer(BufferHandle buffer, Format format, uint32_t offset) override;
+
+		void SetEffectMatrix(EffectVariableHandle variable, const Matrix& matrix) override;
+		void SetEffectVector(EffectVariableHandle variable, const Vector3& vector) override;
+		void SetEffectTexture(EffectVariableHandle variable, TextureHandle texture) override;
+		void ApplyTechnique(TechniqueHandle technique, uint32_t passIndex) override;
+
+		void UpdateBuffer(BufferHandle buffer, const void* pData, uint32_t byteSize) override { m_Context.UpdateBuffer(buffer, pData, byteSize); }
+		void WriteBuffer(BufferHandle buffer, uint32_t byteOffset, const void* pData, uint32_t byteSize) override { m_Context.WriteBuffer(buffer, byteOffset, pData, byteSize); }
+		void SetConstantBuffer(uint32_t slot, BufferHandle buffer, uint32_t byteOffset, uint32_t byteSize) override;
+
+		void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override { m_Context.DrawIndexed(indexCount, startIndex, baseVertex); }
+		void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) override
+		{
+			m_Context.DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+		}
+
+		void Present() override;
+
+		uint64_t SignalFence() override { return m_Context.SignalFence(); }
+
+	private:
+		static constexpr uint32_t s_MaxVertexBufferSlots{ 32 };	// D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT
+		static constexpr uint32_t s_MaxConstantBufferSlots{ 14 };	// D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT
+
+		struct VertexBufferBinding
+		{
+			BufferHandle buffer{};
+			uint32_t stride{};
+			uint32_t offset{};
+			bool isKnown{ false };
+		};
+
+		struct ConstantBufferBinding
+		{
+			BufferHandle buffer{};
+			uint32_t byteOffset{};
+			uint32_t byteSize{};
+			bool isKnown{ false };
+		};
+
+		// Last value set per effect variable, indexed by handle id. A variable only ever holds one kind of value
+		struct EffectVariableValue
+		{
+			enum class Kind : uint8_t { Unknown = 0, Matrix, Vector, Texture };
+
+			Kind kind{ Kind::Unknown };
+			Matrix matrix{};
+			Vector3 vector{};
+			TextureHandle texture{};
+		};
+
+		ICommandContext& m_Context;
+
+		bool m_IsTopologyKnown{ false };
+		PrimitiveTopology m_Topology{};
+		bool m_IsInputLayoutKnown{ false };
+		InputLayoutHandle m_InputLayout{};
+		std::array<VertexBufferBinding, s_MaxVertexBufferSlots> m_VertexBuffers{};
+		bool m_IsIndexBufferKnown{ false };
+		BufferHandle m_IndexBuffer{};
+		Format m_IndexFormat{};
+		uint32_t m_IndexOffset{};
+
+		std::array<ConstantBufferBinding, s_MaxConstantBufferSlots> m_ConstantBuffers{};
+
+		std::vector<EffectVariableValue> m_EffectVariables{};
+
+		// The pass applied last, re-applying it is redundant until an effect variable changes
+		TechniqueHandle m_AppliedTechnique{};
+		uint32_t m_AppliedPass{};
+		bool m_IsEffectDirty{ true };
+
+		FrameStats m_CurrentFrameStats{};
+		FrameStats m_LastFrameStats{};
+
+		EffectVariableValue* GetVariableValue(EffectVariableHandle variable);
+	};
+}
@@ -1,14 +1,21 @@
 #pragma once
 
 //includes
-#include "pch.h"
+#include <string>
+#include "RenderDevice.h"
 
 namespace dae {
+	class SoftwareTexture;
+
 	class Texture
 	{
 	public:
 		// Constructor + Destructor
 		// ------
+		// RGBA8 texels, rowPitch in bytes. Gets SoftwareTexture's box filtered mip chain, so the GPU minifies like the software renderer
+		Texture(IRenderDevice& device, uint32_t width, uint32_t height, const void* pTexels, uint32_t rowPitch);
+		// Every level of texture, which has to be in Linear layout
+		Texture(IRenderDevice& device, const SoftwareTexture& texture);
 		~Texture();
 
 		// Rule of 5
@@ -22,15 +29,14 @@ namespace dae {
 		// Member Functions
 		// ------
 
-		static Texture* LoadFromFile(const std::string& path, ID3D11Device* pDevice);
+		// SDL_image decode, lives in TextureLoader.cpp so headless builds don't need SDL
+		static Texture* LoadFromFile(const std::string& path, IRenderDevice& device);
 
 		// Getter func
-		ID3D11ShaderResourceView* GetSRV();
+		TextureHandle GetHandle() const { return m_Handle; }
 
 	private:
-		Texture(ID3D11Device* pDevice, SDL_Surface* pSurface);
-
-		ID3D11Texture2D* m_pResource = nullptr;
-		ID3D11ShaderResourceView* m_pSRV = nullptr;
+		IRenderDevice& m_Device;
+		TextureHandle m_Handle{};
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,22 @@
+//includes
+#include "pch.h"
+#include "Texture.h"
+
+namespace dae {
+
+	Texture* Texture::LoadFromFile(const std::string& path, IRenderDevice& device)
+	{
+		//Load SDL_Surface using IMG_LOAD
+		SDL_Surface* pSurface = IMG_Load(path.c_str());
+		if (!pSurface)
+		{
+			std::cerr << "Failed to load " << path << ": " << IMG_GetError() << std::endl;
+			return nullptr;
+		}
+
+		Texture* pTex = new Texture(device, pSurface->w, pSurface->h, pSurface->pixels, static_cast<uint32_t>(pSurface->pitch));
+
+		SDL_FreeSurface(pSurface);
+		return pTex;
+	}
+}
@@ -0,0 +1,192 @@
+#include "TransformStore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+#include "JobSystem.h"
+
+namespace dae
+{
+	// Fewer entities than this per job are not worth queuing one
+	static constexpr uint32_t s_MinEntitiesPerJob{ 4096 };
+
+	// Both affine (last column 0 0 0 1): 3 rows of 3 multiply-adds plus the translation row
+	static Matrix MultiplyAffine(const Matrix& a, const Matrix& b)
+	{
+		const Vector4 b0 = b[0], b1 = b[1], b2 = b[2], b3 = b[3];
+		Matrix result{};
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			const Vector4 row = a[r];
+			result[r] = b0 * row.x + b1 * row.y + b2 * row.z + (r == 3 ? b3 : Vector4{});
+		}
+		return result;
+	}
+
+	void TransformStore::Reserve(uint32_t count)
+	{
+		for (std::vector<float>* pComponent : { &m_PositionX, &m_PositionY, &m_PositionZ, &m_RotationX, &m_RotationY, &m_RotationZ, &m_RotationW, &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+			pComponent->reserve(count);
+		m_Parents.reserve(count);
+		m_Depths.reserve(count);
+		m_LocalDirty.reserve(count);
+		m_WorldChanged.reserve(count);
+		m_WorldMatrices.reserve(count);
+	}
+
+	TransformStore::EntityId TransformStore::Create(EntityId parent, const Vector3& position, const Quaternion& rotation, const Vector3& scale)
+	{
+		assert((parent == InvalidEntity || parent < GetCount()) && "Parents have to exist before their children");
+
+		const EntityId entity = GetCount();
+		m_PositionX.push_back(position.x);
+		m_PositionY.push_back(position.y);
+		m_PositionZ.push_back(position.z);
+		m_RotationX.push_back(rotation.x);
+		m_RotationY.push_back(rotation.y);
+		m_RotationZ.push_back(rotation.z);
+		m_RotationW.push_back(rotation.w);
+		m_ScaleX.push_back(scale.x);
+		m_ScaleY.push_back(scale.y);
+		m_ScaleZ.push_back(scale.z);
+
+		m_Parents.push_back(parent);
+		m_Depths.push_back(parent == InvalidEntity ? 0 : m_Depths[parent] + 1);
+		m_LocalDirty.push_back(1);
+		m_WorldChanged.push_back(0);
+		m_WorldMatrices.emplace_back();
+		m_IsDepthOrderValid = false;
+		return entity;
+	}
+
+	void TransformStore::Clear()
+	{
+		for (std::vector<float>* pComponent : { &m_PositionX, &m_PositionY, &m_PositionZ, &m_RotationX, &m_RotationY, &m_RotationZ, &m_RotationW, &m_ScaleX, &m_ScaleY, &m_ScaleZ })
+			pComponent->clear();
+		m_Parents.clear();
+		m_Depths.clear();
+		m_LocalDirty.clear();
+		m_WorldChanged.clear();
+		m_WorldMatrices.clear();
+		m_IsDepthOrderValid = false;
+	}
+
+	void TransformStore::SetPosition(EntityId entity, const Vector3& position)
+	{
+		m_PositionX[entity] = position.x;
+		m_PositionY[entity] = position.y;
+		m_PositionZ[entity] = position.z;
+		m_LocalDirty[entity] = 1;
+	}
+
+	void TransformStore::SetRotation(EntityId entity, const Quaternion& rotation)
+	{
+		m_RotationX[entity] = rotation.x;
+		m_RotationY[entity] = rotation.y;
+		m_RotationZ[entity] = rotation.z;
+		m_RotationW[entity] = rotation.w;
+		m_LocalDirty[entity] = 1;
+	}
+
+	void TransformStore::SetScale(EntityId entity, const Vector3& scale)
+	{
+		m_ScaleX[entity] = scale.x;
+		m_ScaleY[entity] = scale.y;
+		m_ScaleZ[entity] = scale.z;
+		m_LocalDirty[entity] = 1;
+	}
+
+	// Counting sort on depth, stable so every depth stays in id order
+	void TransformStore::BuildDepthOrder()
+	{
+		const uint32_t count = GetCount();
+		const uint32_t numDepths = count > 0 ? *std::max_element(m_Depths.begin(), m_Depths.end()) + 1 : 0;
+
+		m_DepthStarts.assign(numDepths + 1, 0);
+		for (const uint32_t depth : m_Depths)
+			++m_DepthStarts[depth + 1];
+		for (uint32_t depth{ 0 }; depth < numDepths; ++depth)
+			m_DepthStarts[depth + 1] += m_DepthStarts[depth];
+
+		std::vector<uint32_t> offsets(m_DepthStarts.begin(), m_DepthStarts.end() - 1);
+		m_DepthOrder.resize(count);
+		for (EntityId entity{ 0 }; entity < count; ++entity)
+			m_DepthOrder[offsets[m_Depths[entity]]++] = entity;
+
+		m_IsDepthOrderValid = true;
+	}
+
+	bool TransformStore::UpdateEntity(EntityId entity)
+	{
+		const EntityId parent = m_Parents[entity];
+		const bool isParentChanged = parent != InvalidEntity && m_WorldChanged[parent];
+		if (!m_LocalDirty[entity] && !isParentChanged)
+		{
+			m_WorldChanged[entity] = 0;
+			return false;
+		}
+
+		// Rotation rows (see Matrix::CreateRotation(Quaternion)) scaled per axis, translation in the last row
+		const float qx = m_RotationX[entity], qy = m_RotationY[entity], qz = m_RotationZ[entity], qw = m_RotationW[entity];
+		const float xx = qx * qx, yy = qy * qy, zz = qz * qz;
+		const float xy = qx * qy, xz = qx * qz, yz = qy * qz;
+		const float wx = qw * qx, wy = qw * qy, wz = qw * qz;
+		const float sx = m_ScaleX[entity], sy = m_ScaleY[entity], sz = m_ScaleZ[entity];
+		const Matrix local{
+			Vector4{ (1 - 2 * (yy + zz)) * sx, 2 * (xy + wz) * sx, 2 * (xz - wy) * sx, 0.f },
+			Vector4{ 2 * (xy - wz) * sy, (1 - 2 * (xx + zz)) * sy, 2 * (yz + wx) * sy, 0.f },
+			Vector4{ 2 * (xz + wy) * sz, 2 * (yz - wx) * sz, (1 - 2 * (xx + yy)) * sz, 0.f },
+			Vector4{ m_PositionX[entity], m_PositionY[entity], m_PositionZ[entity], 1.f } };
+
+		m_WorldMatrices[entity] = parent == InvalidEntity ? local : MultiplyAffine(local, m_WorldMatrices[parent]);
+		m_LocalDirty[entity] = 0;
+		m_WorldChanged[entity] = 1;
+		return true;
+	}
+
+	uint32_t TransformStore::UpdateRange(uint32_t begin, uint32_t end)
+	{
+		uint32_t numChanged{};
+		for (uint32_t i{ begin }; i < end; ++i)
+			numChanged += UpdateEntity(m_DepthOrder[i]);
+		return numChanged;
+	}
+
+	uint32_t TransformStore::Update(uint32_t numThreads)
+	{
+		if (!m_IsDepthOrderValid)
+			BuildDepthOrder();
+
+		const uint32_t count = GetCount();
+		if (numThreads == 0)
+			numThreads = JobSystem::GetShared().GetNumThreads();
+		numThreads = std::min(numThreads, std::max(1u, count / s_MinEntitiesPerJob));
+
+		const uint32_t numDepths = static_cast<uint32_t>(m_DepthStarts.size()) - 1;
+		if (numThreads <= 1)
+		{
+			// Ids are already topological, so one thread walks them in order and reads the arrays front to back
+			uint32_t numChanged{};
+			for (EntityId entity{ 0 }; entity < count; ++entity)
+				numChanged += UpdateEntity(entity);
+			return numChanged;
+		}
+
+		// One depth after the other, children read their parent's result. Every depth is split in equal slices,
+		// the small ones stay on this thread
+		JobSystem& jobSystem = JobSystem::GetShared();
+		std::atomic<uint32_t> numChanged{ 0 };
+		for (uint32_t depth{ 0 }; depth < numDepths; ++depth)
+		{
+			const uint32_t depthBegin = m_DepthStarts[depth];
+			const uint32_t depthSize = m_DepthStarts[depth + 1] - depthBegin;
+			const size_t sliceSize = std::max((depthSize + numThreads - 1) / numThreads, s_MinEntitiesPerJob);
+			jobSystem.ParallelFor(depthSize, sliceSize, [&](size_t begin, size_t end)
+				{
+					numChanged += UpdateRange(depthBegin + static_cast<uint32_t>(begin), depthBegin + static_cast<uint32_t>(end));
+				}, numThreads);
+		}
+		return numChanged;
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Math.h"
+
+namespace dae
+{
+	// Entity transforms as structure of arrays: local position/rotation/scale per component, world matrices dense by entity id.
+	// Parents are set at creation and always created first, so ids are already in topological order; Update walks the
+	// hierarchy depth by depth (roots, their children, ...) and every depth is split into jobs on the shared JobSystem.
+	// Only entities whose local transform changed, or whose parent's world matrix changed, are recomputed
+	class TransformStore final
+	{
+	public:
+		using EntityId = uint32_t;
+		static constexpr EntityId InvalidEntity{ ~0u };
+
+		TransformStore() = default;
+		~TransformStore() = default;
+
+		TransformStore(const TransformStore&) = delete;
+		TransformStore(TransformStore&&) noexcept = delete;
+		TransformStore& operator=(const TransformStore&) = delete;
+		TransformStore& operator=(TransformStore&&) noexcept = delete;
+
+		void Reserve(uint32_t count);
+		EntityId Create(EntityId parent = InvalidEntity, const Vector3& position = {}, const Quaternion& rotation = {}, const Vector3& scale = { 1.f, 1.f, 1.f });
+		void Clear();
+
+		void SetPosition(EntityId entity, const Vector3& position);
+		void SetRotation(EntityId entity, const Quaternion& rotation);
+		void SetScale(EntityId entity, const Vector3& scale);
+
+		Vector3 GetPosition(EntityId entity) const { return { m_PositionX[entity], m_PositionY[entity], m_PositionZ[entity] }; }
+		Quaternion GetRotation(EntityId entity) const { return { m_RotationX[entity], m_RotationY[entity], m_RotationZ[entity], m_RotationW[entity] }; }
+		Vector3 GetScale(EntityId entity) const { return { m_ScaleX[entity], m_ScaleY[entity], m_ScaleZ[entity] }; }
+		EntityId GetParent(EntityId entity) const { return m_Parents[entity]; }
+
+		// Recomputes the dirty world matrices split into numThreads jobs (0 = one per pool thread), returns how many changed
+		uint32_t Update(uint32_t numThreads = 0);
+
+		// Valid after Update. scale * rotation * translation * parent world, row vectors like the rest of Math
+		const Matrix& GetWorldMatrix(EntityId entity) const { return m_WorldMatrices[entity]; }
+		std::span<const Matrix> GetWorldMatrices() const { return m_WorldMatrices; }
+		// Whether the last Update recomputed the entity's world matrix
+		bool HasWorldChanged(EntityId entity) const { return m_WorldChanged[entity] != 0; }
+
+		uint32_t GetCount() const { return static_cast<uint32_t>(m_Parents.size()); }
+
+	private:
+		// Local transform, one array per component
+		std::vector<float> m_PositionX{};
+		std::vector<float> m_PositionY{};
+		std::vector<float> m_PositionZ{};
+		std::vector<float> m_RotationX{};
+		std::vector<float> m_RotationY{};
+		std::vector<float> m_RotationZ{};
+		std::vector<float> m_RotationW{};
+		std::vector<float> m_ScaleX{};
+		std::vector<float> m_ScaleY{};
+		std::vector<float> m_ScaleZ{};
+
+		std::vector<EntityId> m_Parents{};
+		std::vector<uint32_t> m_Depths{};
+		std::vector<uint8_t> m_LocalDirty{};
+		std::vector<uint8_t> m_WorldChanged{};
+		std::vector<Matrix> m_WorldMatrices{};
+
+		// Entities sorted by depth, m_DepthStarts[d] is where depth d begins (one past the end at the back).
+		// Rebuilt lazily when entities were created
+		std::vector<EntityId> m_DepthOrder{};
+		std::vector<uint32_t> m_DepthStarts{};
+		bool m_IsDepthOrderValid{ true };
+
+		void BuildDepthOrder();
+		// Recomputes the entity's world matrix if it or its parent changed, returns whether it did
+		bool UpdateEntity(EntityId entity);
+		// Updates m_DepthOrder[begin, end), all at the same depth. Returns how many changed
+		uint32_t UpdateRange(uint32_t begin, uint32_t end);
+	};
+}
@@ -0,0 +1,128 @@
+#include "TransparencySorter.h"
+
+#include <bit>
+
+#include "RadixSort.h"
+
+namespace dae
+{
+	// Third column of the view matrix (row vectors), all the view space z of a point needs
+	struct DepthAxis
+	{
+		explicit DepthAxis(const Matrix& viewMatrix)
+			: x{ viewMatrix[0].z }, y{ viewMatrix[1].z }, z{ viewMatrix[2].z }, offset{ viewMatrix[3].z }
+		{
+		}
+
+		float GetDepth(const Vector3& point) const { return point.x * x + point.y * y + point.z * z + offset; }
+
+		float x, y, z, offset;
+	};
+
+	std::span<const uint32_t> TransparencySorter::Sort(std::span<const AABB> worldBounds, const Matrix& viewMatrix)
+	{
+		const DepthAxis axis{ viewMatrix };
+		m_Keys.resize(worldBounds.size());
+		for (size_t i{ 0 }; i < worldBounds.size(); ++i)
+			m_Keys[i] = MakeKey(axis.GetDepth(worldBounds[i].center));
+		return SortKeys();
+	}
+
+	std::span<const uint32_t> TransparencySorter::Sort(const AABB& localBounds, std::span<const Matrix> worldMatrices, const Matrix& viewMatrix)
+	{
+		const DepthAxis axis{ viewMatrix };
+		m_Keys.resize(worldMatrices.size());
+		for (size_t i{ 0 }; i < worldMatrices.size(); ++i)
+			m_Keys[i] = MakeKey(axis.GetDepth(worldMatrices[i].TransformPoint(localBounds.center)));
+		return SortKeys();
+	}
+
+	std::span<const uint32_t> TransparencySorter::SortKeys()
+	{
+		const uint32_t count = static_cast<uint32_t>(m_Keys.size());
+		m_WasIncremental = false;
+		const bool isSameObjects = m_HasOrder && m_Items.size() == count;
+		if (isSameObjects && m_NumFramesUntilRetry == 0)
+		{
+			// Last frame's order with this frame's keys: nearly sorted when the camera and objects moved a bit
+			for (SortItem& item : m_Items)
+				item.key = m_Keys[item.index];
+
+			m_WasIncremental = InsertionSort(m_Items, count * s_MaxMovesPerItem);
+			if (m_WasIncremental)
+				++m_Stats.numInsertionSorts;
+			else
+			{
+				// Wasted moves: the scene changes too much per frame for a while, so skip a few frames before trying again
+				++m_Stats.numFallbacks;
+				m_NumFramesUntilRetry = s_NumFramesBetweenRetries;
+			}
+		}
+		else
+		{
+			// From scratch: this frame's keys in object order, also while waiting to retry the insertion sort
+			if (isSameObjects)
+				--m_NumFramesUntilRetry;
+			m_Items.resize(count);
+			for (uint32_t index{ 0 }; index < count; ++index)
+				m_Items[index] = { m_Keys[index], index };
+		}
+
+		if (!m_WasIncremental)
+		{
+			RadixSort(m_Items, m_Scratch);
+			++m_Stats.numRadixSorts;
+		}
+
+		m_Order.resize(count);
+		for (uint32_t i{ 0 }; i < count; ++i)
+			m_Order[i] = m_Items[i].index;
+		m_HasOrder = true;
+		return m_Order;
+	}
+
+	void TransparencySorter::Invalidate()
+	{
+		m_HasOrder = false;
+		m_NumFramesUntilRetry = 0;
+	}
+
+	uint32_t TransparencySorter::MakeKey(float viewDepth)
+	{
+		// Float bits as an unsigned integer that orders like the float: negatives flipped entirely, positives above them.
+		// Then inverted, so the farthest object gets the smallest key
+		const uint32_t bits = std::bit_cast<uint32_t>(viewDepth);
+		const uint32_t ascending = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+		return ~ascending;
+	}
+
+	void TransparencySorter::RadixSort(std::span<SortItem> items, std::vector<SortItem>& scratch)
+	{
+		LsdRadixSort<11>(items, scratch, [](const SortItem& item) { return item.key; });
+	}
+
+	bool TransparencySorter::InsertionSort(std::span<SortItem> items, size_t maxMoves)
+	{
+		size_t numMoves{ 0 };
+		for (size_t i{ 1 }; i < items.size(); ++i)
+		{
+			if (items[i - 1].key <= items[i].key)
+				continue;
+
+			// Only strictly larger keys move, so equal keys keep last frame's order
+			const SortItem item = items[i];
+			size_t j{ i };
+			do
+			{
+				items[j] = items[j - 1];
+				--j;
+				++numMoves;
+			} while (j > 0 && items[j - 1].key > item.key);
+			items[j] = item;
+
+			if (numMoves > maxMoves)
+				return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Math.h"
+#include "Bounds.h"
+
+namespace dae
+{
+	// Back to front order of blended objects (the order blending needs) by the view space depth of their bounds' centers.
+	// Depths become 32 bit keys sorted with a 3 pass (11/11/10 bits) LSD radix sort. Objects barely move between frames,
+	// so when there are as many objects as last frame, last frame's order is re-keyed and fixed up with an insertion sort
+	// instead, which falls back to the radix sort when the order changed too much (more than s_MaxMovesPerItem shifts
+	// per object) and is not tried again for s_NumFramesBetweenRetries frames after that. Object i has to be last frame's
+	// object i for that to pay off.
+	// Buffers are kept across frames, so steady state sorts don't allocate
+	class TransparencySorter final
+	{
+	public:
+		// Depth key plus the object it belongs to, this is what gets sorted
+		struct SortItem
+		{
+			uint32_t key{};
+			uint32_t index{};
+		};
+
+		struct Stats
+		{
+			uint32_t numRadixSorts{};
+			uint32_t numInsertionSorts{};
+			uint32_t numFallbacks{};	// insertion sorts that gave up, counted in numRadixSorts as well
+		};
+
+		TransparencySorter() = default;
+		~TransparencySorter() = default;
+
+		TransparencySorter(const TransparencySorter&) = delete;
+		TransparencySorter(TransparencySorter&&) noexcept = delete;
+		TransparencySorter& operator=(const TransparencySorter&) = delete;
+		TransparencySorter& operator=(TransparencySorter&&) noexcept = delete;
+
+		// Indices into worldBounds, farthest first
+		std::span<const uint32_t> Sort(std::span<const AABB> worldBounds, const Matrix& viewMatrix);
+		// Same for the instances of one mesh: localBounds placed by every world matrix
+		std::span<const uint32_t> Sort(const AABB& localBounds, std::span<const Matrix> worldMatrices, const Matrix& viewMatrix);
+
+		std::span<const uint32_t> GetOrder() const { return m_Order; }
+		// Whether the last Sort got away with the insertion sort
+		bool WasIncremental() const { return m_WasIncremental; }
+		const Stats& GetStats() const { return m_Stats; }
+		// Next Sort starts from scratch, for when the objects behind the indices changed
+		void Invalidate();
+
+		// Larger depths give smaller keys, so ascending keys are back to front. Order preserving for all floats
+		static uint32_t MakeKey(float viewDepth);
+		// Stable, ascending keys: LsdRadixSort with 11 bit digits. scratch is resized to items.size()
+		static void RadixSort(std::span<SortItem> items, std::vector<SortItem>& scratch);
+		// Stable, ascending keys. Gives up (false, items partly sorted) once it shifted more than maxMoves items
+		static bool InsertionSort(std::span<SortItem> items, size_t maxMoves);
+
+	private:
+		static constexpr size_t s_MaxMovesPerItem{ 1 };
+		static constexpr uint32_t s_NumFramesBetweenRetries{ 15 };
+
+		std::vector<uint32_t> m_Keys{};	// per object, in object order
+		std::vector<SortItem> m_Items{};
+		std::vector<SortItem> m_Scratch{};
+		std::vector<uint32_t> m_Order{};
+		bool m_HasOrder{ false };
+		bool m_WasIncremental{ false };
+		uint32_t m_NumFramesUntilRetry{ 0 };
+		Stats m_Stats{};
+
+		// Sorts the objects by m_Keys, from last frame's order when there is one
+		std::span<const uint32_t> SortKeys();
+	};
+}
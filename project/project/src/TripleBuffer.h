@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace dae
+{
+	// One writer thread and one reader thread handing over whole values without locks or copies.
+	// The writer fills GetWriteBuffer() and publishes it, the reader acquires the latest published one and reads it
+	// as long as it likes: the third buffer is always free for the writer, so neither side ever waits. Values the
+	// reader never acquired are overwritten, the reader only sees the newest
+	template<typename T>
+	class TripleBuffer final
+	{
+	public:
+		TripleBuffer() = default;
+		~TripleBuffer() = default;
+
+		TripleBuffer(const TripleBuffer&) = delete;
+		TripleBuffer(TripleBuffer&&) noexcept = delete;
+		TripleBuffer& operator=(const TripleBuffer&) = delete;
+		TripleBuffer& operator=(TripleBuffer&&) noexcept = delete;
+
+		// Writer thread: the buffer to fill, still holds whatever was written to it three publishes ago
+		T& GetWriteBuffer() { return m_Buffers[m_WriteIndex]; }
+		// Writer thread: hands the write buffer over and takes the free one
+		void Publish()
+		{
+			const uint8_t previous = m_Shared.exchange(m_WriteIndex | s_NewBit, std::memory_order_acq_rel);
+			m_WriteIndex = previous & s_IndexMask;
+		}
+
+		// Reader thread: swaps in the newest published buffer, false when nothing was published since the last call
+		bool Acquire()
+		{
+			if ((m_Shared.load(std::memory_order_relaxed) & s_NewBit) == 0)
+				return false;
+
+			const uint8_t previous = m_Shared.exchange(m_ReadIndex, std::memory_order_acq_rel);
+			m_ReadIndex = previous & s_IndexMask;
+			return true;
+		}
+		// Reader thread: the last acquired buffer (a default constructed T before the first)
+		const T& GetReadBuffer() const { return m_Buffers[m_ReadIndex]; }
+
+	private:
+		static constexpr uint8_t s_IndexMask{ 0x3 };
+		static constexpr uint8_t s_NewBit{ 0x4 };
+
+		std::array<T, 3> m_Buffers{};
+
+		// Each index is only touched by its own thread, the shared one holds the buffer in between
+		alignas(64) uint8_t m_WriteIndex{ 0 };
+		alignas(64) std::atomic<uint8_t> m_Shared{ 1 };
+		alignas(64) uint8_t m_ReadIndex{ 2 };
+	};
+}
@@ -1,15 +1,65 @@
 #pragma once
+#include <cstdint>
 #include <fstream>
+#include <string>
+#include <vector>
 #include "Math.h"
+#include "Vertex.h"
 
 namespace dae
 {
 	namespace Utils
 	{
-		//Just parses vertices and indices
 #pragma warning(push)
 #pragma warning(disable : 4505) //Warning unreferenced local function
-		static bool ParseOBJ(const std::string& filename, std::vector<Vertex_In>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true)
+		//Cheap per-face tangents, summed per vertex and made orthogonal to the normal
+		static void ComputeTangents(std::vector<Vertex_In>& vertices, const std::vector<uint32_t>& indices, MathPrecision precision = MathPrecision::Exact)
+		{
+			const bool fast = precision == MathPrecision::Fast;
+
+			for (uint32_t i = 0; i < indices.size(); i += 3)
+			{
+				uint32_t index0 = indices[i];
+				uint32_t index1 = indices[size_t(i) + 1];
+				uint32_t index2 = indices[size_t(i) + 2];
+
+				const Vector3& p0 = vertices[index0].position;
+				const Vector3& p1 = vertices[index1].position;
+				const Vector3& p2 = vertices[index2].position;
+				const Vector2& uv0 = vertices[index0].uv;
+				const Vector2& uv1 = vertices[index1].uv;
+				const Vector2& uv2 = vertices[index2].uv;
+
+				const Vector3 edge0 = p1 - p0;
+				const Vector3 edge1 = p2 - p0;
+				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
+				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
+				const float cross = Vector2::Cross(diffX, diffY);
+				float r = fast ? FastMath::Rcp(cross) : 1.f / cross;
+
+				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
+				vertices[index0].tangent += tangent;
+				vertices[index1].tangent += tangent;
+				vertices[index2].tangent += tangent;
+			}
+
+			//Create the Tangents (reject)
+			for (auto& v : vertices)
+			{
+				if (fast)
+				{
+					const float invSqrNormal = FastMath::Rcp(Vector3::Dot(v.normal, v.normal));
+					v.tangent = (v.tangent - v.normal * (Vector3::Dot(v.tangent, v.normal) * invSqrNormal)).NormalizedFast();
+				}
+				else
+				{
+					v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
+				}
+			}
+		}
+
+		//Just parses vertices and indices
+		static bool ParseOBJ(const std::string& filename, std::vector<Vertex_In>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true, MathPrecision precision = MathPrecision::Exact)
 		{
 			std::ifstream file(filename);
 			if (!file)
@@ -117,43 +167,16 @@ namespace dae
 			}
 
 			//Cheap Tangent Calculations
-			for (uint32_t i = 0; i < indices.size(); i += 3)
-			{
-				uint32_t index0 = indices[i];
-				uint32_t index1 = indices[size_t(i) + 1];
-				uint32_t index2 = indices[size_t(i) + 2];
-
-				const Vector3& p0 = vertices[index0].position;
-				const Vector3& p1 = vertices[index1].position;
-				const Vector3& p2 = vertices[index2].position;
-				const Vector2& uv0 = vertices[index0].uv;
-				const Vector2& uv1 = vertices[index1].uv;
-				const Vector2& uv2 = vertices[index2].uv;
-
-				const Vector3 edge0 = p1 - p0;
-				const Vector3 edge1 = p2 - p0;
-				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
-				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
-				float r = 1.f / Vector2::Cross(diffX, diffY);
-
-				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
-				vertices[index0].tangent += tangent;
-				vertices[index1].tangent += tangent;
-				vertices[index2].tangent += tangent;
-			}
+			ComputeTangents(vertices, indices, precision);
 
-			//Create the Tangents (reject)
-			for (auto& v : vertices)
+			if (flipAxisAndWinding)
 			{
-				v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
-
-				if(flipAxisAndWinding)
+				for (auto& v : vertices)
 				{
 					v.position.z *= -1.f;
 					v.normal.z *= -1.f;
 					v.tangent.z *= -1.f;
 				}
-
 			}
 
 			return true;
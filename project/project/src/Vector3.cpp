@@ -1,8 +1,7 @@
-#include "pch.h"
-
 #include "Vector3.h"
 
 #include <cassert>
+#include <cmath>
 
 #include "Vector4.h"
 #include "Vector2.h"
@@ -45,6 +44,77 @@ namespace dae {
 		return { x / m, y / m, z / m };
 	}
 
+	void Vector3::NormalizeFast()
+	{
+		const float invM = FastMath::RSqrt(SqrMagnitude());
+		x *= invM;
+		y *= invM;
+		z *= invM;
+	}
+
+	Vector3 Vector3::NormalizedFast() const
+	{
+		const float invM = FastMath::RSqrt(SqrMagnitude());
+		return { x * invM, y * invM, z * invM };
+	}
+
+	Vector3 Vector3::Normalized(MathPrecision precision) const
+	{
+		return precision == MathPrecision::Fast ? NormalizedFast() : Normalized();
+	}
+
+	void Vector3::Normalize(Vector3* pVectors, size_t count, MathPrecision precision)
+	{
+		float* pData = &pVectors[0].x;
+
+		size_t i{ 0 };
+		for (; i + 4 <= count; i += 4, pData += 12)
+		{
+			// a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+			__m128 a = _mm_loadu_ps(pData);
+			__m128 b = _mm_loadu_ps(pData + 4);
+			__m128 c = _mm_loadu_ps(pData + 8);
+
+			// Transpose to x0..x3, y0..y3, z0..z3
+			const __m128 xs = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+			const __m128 ys = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+			const __m128 zs = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+			const __m128 sqrMagnitude = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, xs), _mm_mul_ps(ys, ys)), _mm_mul_ps(zs, zs));
+
+			// Spread the per vector factor back over the x y z layout
+			const __m128 s = precision == MathPrecision::Fast ? FastMath::RSqrt(sqrMagnitude) : _mm_sqrt_ps(sqrMagnitude);
+			const __m128 sa = _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 0, 0));
+			const __m128 sb = _mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 2, 1, 1));
+			const __m128 sc = _mm_shuffle_ps(s, s, _MM_SHUFFLE(3, 3, 3, 2));
+
+			if (precision == MathPrecision::Fast)
+			{
+				a = _mm_mul_ps(a, sa);
+				b = _mm_mul_ps(b, sb);
+				c = _mm_mul_ps(c, sc);
+			}
+			else
+			{
+				a = _mm_div_ps(a, sa);
+				b = _mm_div_ps(b, sb);
+				c = _mm_div_ps(c, sc);
+			}
+
+			_mm_storeu_ps(pData, a);
+			_mm_storeu_ps(pData + 4, b);
+			_mm_storeu_ps(pData + 8, c);
+		}
+
+		for (; i < count; ++i)
+		{
+			if (precision == MathPrecision::Fast)
+				pVectors[i].NormalizeFast();
+			else
+				pVectors[i].Normalize();
+		}
+	}
+
 	float Vector3::Dot(const Vector3& v1, const Vector3& v2)
 	{
 		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
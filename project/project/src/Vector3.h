@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include "FastMath.h"
 
 namespace dae
 {
@@ -20,6 +22,14 @@ namespace dae
 		float Normalize();
 		Vector3 Normalized() const;
 
+		// FastMath::RSqrt instead of sqrt + divide (see FastMath.h for the error bound)
+		void NormalizeFast();
+		Vector3 NormalizedFast() const;
+		Vector3 Normalized(MathPrecision precision) const;
+
+		// Normalizes 4 vectors per iteration, Exact gives the same results as Normalized()
+		static void Normalize(Vector3* pVectors, size_t count, MathPrecision precision = MathPrecision::Exact);
+
 		static float Dot(const Vector3& v1, const Vector3& v2);
 		static Vector3 Cross(const Vector3& v1, const Vector3& v2);
 		static Vector3 Project(const Vector3& v1, const Vector3& v2);
@@ -1,8 +1,7 @@
-#include "pch.h"
-
 #include "Vector4.h"
 
 #include <cassert>
+#include <cmath>
 
 #include "Vector2.h"
 #include "Vector3.h"
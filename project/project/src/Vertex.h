@@ -0,0 +1,25 @@
+#pragma once
+#include "Vector2.h"
+#include "Vector3.h"
+
+namespace dae
+{
+	struct Vertex
+	{
+		Vector3 position{};
+		//Vector3 worldPosition{};
+		Vector2 uv{};
+		Vector3 normal{}; 
+		Vector3 tangent{};
+		//Vector3 viewDirection{}; 
+	};
+
+	struct Vertex_In
+	{
+		Vector3 position{};
+		Vector2 uv{};
+		Vector3 normal{};
+		Vector3 tangent{};
+		//Vector3 viewDirection{};
+	};
+}
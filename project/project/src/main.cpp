@@ -4,11 +4,24 @@
 #include "vld.h"
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
 #undef main
 #include "Renderer.h"
 
 using namespace dae;
 
+void PrintLatency(const char* pLabel, const FrameLatencyStats& stats)
+{
+	std::ostringstream line{};
+	line << pLabel << "input to submit " << stats.GetAverageMs() << " ms avg, " << stats.maxMs << " ms max ("
+		<< stats.numFrames << " frames, " << stats.numRepeatedFrames << " repeated, " << stats.numSkippedSnapshots << " snapshots skipped)\n";
+	std::cout << line.str();
+}
+
 void ShutDown(SDL_Window* pWindow)
 {
 	SDL_DestroyWindow(pWindow);
@@ -17,9 +30,12 @@ void ShutDown(SDL_Window* pWindow)
 
 int main(int argc, char* args[])
 {
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
+	//Simulation and rendering on their own threads (--threaded): the render thread submits the newest snapshot
+	//the simulation published, so camera and scene updates overlap with submission
+	bool isThreaded = false;
+	for (int i = 1; i < argc; ++i)
+		if (std::strcmp(args[i], "--threaded") == 0)
+			isThreaded = true;
 
 	//Create window + surfaces
 	SDL_Init(SDL_INIT_VIDEO);
@@ -40,6 +56,32 @@ int main(int argc, char* args[])
 	const auto pTimer = new Timer();
 	const auto pRenderer = new Renderer(pWindow);
 
+	//Render thread, prints its own frame rate and latency once a second
+	std::atomic<bool> isRendering{ isThreaded };
+	std::thread renderThread{};
+	if (isThreaded)
+	{
+		renderThread = std::thread([pRenderer, &isRendering]
+			{
+				uint32_t numFrames = 0;
+				auto printTime = std::chrono::steady_clock::now();
+				while (isRendering)
+				{
+					pRenderer->Render();
+					++numFrames;
+
+					const auto now = std::chrono::steady_clock::now();
+					if (now - printTime >= std::chrono::seconds{ 1 })
+					{
+						printTime = now;
+						PrintLatency(("render FPS: " + std::to_string(numFrames) + ", ").c_str(), pRenderer->GetLatencyStats());
+						pRenderer->ResetLatencyStats();
+						numFrames = 0;
+					}
+				}
+			});
+	}
+
 	//Start loop
 	pTimer->Start();
 	float printTimer = 0.f;
@@ -60,6 +102,8 @@ int main(int argc, char* args[])
 					pRenderer->SwitchFilterMode();
 				if (e.key.keysym.scancode == SDL_SCANCODE_F5)	// Toggle Rotation (Rotate/Idle) (F5)
 					pRenderer->ToggleRotation();
+				if (e.key.keysym.scancode == SDL_SCANCODE_F3)	// Toggle the instanced parking lot (F3)
+					pRenderer->ToggleParkingLot();
 				break;
 			default: ;
 			}
@@ -69,7 +113,8 @@ int main(int argc, char* args[])
 		pRenderer->Update(pTimer);
 
 		//--------- Render ---------
-		pRenderer->Render();
+		if (!isThreaded)
+			pRenderer->Render();
 
 		//--------- Timer ---------
 		pTimer->Update();
@@ -78,10 +123,19 @@ int main(int argc, char* args[])
 		{
 			printTimer = 0.f;
 			std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
+			if (!isThreaded)
+			{
+				PrintLatency("", pRenderer->GetLatencyStats());
+				pRenderer->ResetLatencyStats();
+			}
 		}
 	}
 	pTimer->Stop();
 
+	isRendering = false;
+	if (renderThread.joinable())
+		renderThread.join();
+
 	//Shutdown "framework"
 	delete pRenderer;
 	delete pTimer;
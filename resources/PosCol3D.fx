@@ -1,7 +1,19 @@
 //----------------------------------------
 //  Global variable
 //----------------------------------------
-float4x4 gWorldViewProjection : WorldViewProjection;
+// Per frame (b0) and per object (b1) constants, mirrored by PerFrameConstants/PerObjectConstants in Effect.h.
+// The renderer writes them into one ring buffer and binds ranges of it, the effect variables are the fallback
+cbuffer cbPerFrame : register(b0)
+{
+    row_major float4x4 gViewProjection : ViewProjection; // instanced techniques, the world matrix comes per instance
+    float3 gCameraPosition : CAMERA;
+};
+
+cbuffer cbPerObject : register(b1)
+{
+    row_major float4x4 gWorldViewProjection : WorldViewProjection;
+    row_major float4x4 gWorldMatrix : WORLD;
+};
 
 Texture2D gDiffuseMap : DiffuseMap;
 Texture2D gNormalMap : NormalMap;
@@ -9,8 +21,6 @@ Texture2D gSpecularMap : SpecularMap;
 Texture2D gGlossinessMap : GlossinessMap;
 
 const float3 gLightDirection = -float3(.577f, -.577f, .577f);
-float4x4 gWorldMatrix : WORLD;
-float3 gCameraPosition : CAMERA;
 
 const float gPI = 3.14159265358979323846264338327950288f;
 
@@ -58,6 +68,20 @@ struct VS_INPUT
     float3 tangent : TANGENT;
 };
 
+// Vertex plus the instance it is drawn for, from the per instance buffer in slot 1
+struct VS_INSTANCED_INPUT
+{
+    float3 position : POSITION;
+    float2 uv : TEXCOORD;
+    float3 normal : NORMAL;
+    float3 tangent : TANGENT;
+    float4 worldRow0 : INSTANCEWORLD0;
+    float4 worldRow1 : INSTANCEWORLD1;
+    float4 worldRow2 : INSTANCEWORLD2;
+    float4 worldRow3 : INSTANCEWORLD3;
+    float4 tint : INSTANCETINT;
+};
+
 struct VS_OUTPUT
 {
     float4 position : SV_POSITION0;
@@ -65,6 +89,7 @@ struct VS_OUTPUT
     float2 uv : TEXCOORD;
     float3 normal : NORMAL;
     float3 tangent : TANGENT;
+    float4 tint : COLOR;
 };
 
 
@@ -158,6 +183,24 @@ VS_OUTPUT VS(VS_INPUT input)
     output.normal = mul(float4(input.normal, 0.0f), gWorldMatrix).xyz; // World-space normal
     output.tangent = mul(float4(input.tangent, 0.0f), gWorldMatrix).xyz; // World-space tangent
 
+    output.tint = float4(1.f, 1.f, 1.f, 1.f);
+
+    return output;
+}
+
+VS_OUTPUT VS_Instanced(VS_INSTANCED_INPUT input)
+{
+    VS_OUTPUT output = (VS_OUTPUT) 0;
+
+    float4x4 world = float4x4(input.worldRow0, input.worldRow1, input.worldRow2, input.worldRow3);
+
+    output.worldPosition = mul(float4(input.position, 1.0f), world);
+    output.position = mul(output.worldPosition, gViewProjection);
+    output.uv = input.uv;
+    output.normal = mul(float4(input.normal, 0.0f), world).xyz;
+    output.tangent = mul(float4(input.tangent, 0.0f), world).xyz;
+    output.tint = input.tint;
+
     return output;
 }
 
@@ -192,7 +235,7 @@ float4 PS_Point(VS_OUTPUT input) : SV_Target
               worldNormal);
     }
     
-    return finalColor;
+    return float4(finalColor.rgb * input.tint.rgb, finalColor.a);
 }
 
 float4 PS_Linear(VS_OUTPUT input) : SV_Target
@@ -223,7 +266,7 @@ float4 PS_Linear(VS_OUTPUT input) : SV_Target
               worldNormal);
     }
     
-    return finalColor;
+    return float4(finalColor.rgb * input.tint.rgb, finalColor.a);
 }
 
 float4 PS_Anisotropic(VS_OUTPUT input) : SV_Target
@@ -255,7 +298,7 @@ float4 PS_Anisotropic(VS_OUTPUT input) : SV_Target
               worldNormal);
     }
     
-    return finalColor;
+    return float4(finalColor.rgb * input.tint.rgb, finalColor.a);
 }
 
 
@@ -296,4 +339,37 @@ technique11 AnisotropicTechnique
         SetGeometryShader(NULL);
         SetPixelShader(CompileShader(ps_5_0, PS_Anisotropic()));
     }
+}
+technique11 PointInstancedTechnique
+{
+    pass P0
+    {
+        SetDepthStencilState(gDepthStencilState, 0);
+        SetBlendState(gBlendState, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetVertexShader(CompileShader(vs_5_0, VS_Instanced()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, PS_Point()));
+    }
+}
+technique11 LinearInstancedTechnique
+{
+    pass P0
+    {
+        SetDepthStencilState(gDepthStencilState, 0);
+        SetBlendState(gBlendState, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetVertexShader(CompileShader(vs_5_0, VS_Instanced()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, PS_Linear()));
+    }
+}
+technique11 AnisotropicInstancedTechnique
+{
+    pass P0
+    {
+        SetDepthStencilState(gDepthStencilState, 0);
+        SetBlendState(gBlendState, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetVertexShader(CompileShader(vs_5_0, VS_Instanced()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, PS_Anisotropic()));
+    }
 }
\ No newline at end of file
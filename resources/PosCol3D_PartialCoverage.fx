@@ -1,12 +1,20 @@
 //----------------------------------------
 //  Global variable
 //----------------------------------------
-float4x4 gWorldViewProjection : WorldViewProjection;
+// Same layout as PosCol3D.fx, so both effects read the ranges bound for a frame
+cbuffer cbPerFrame : register(b0)
+{
+    row_major float4x4 gViewProjection : ViewProjection;
+    float3 gCameraPosition : CAMERA;
+};
 
-Texture2D gDiffuseMap : DiffuseMap;
+cbuffer cbPerObject : register(b1)
+{
+    row_major float4x4 gWorldViewProjection : WorldViewProjection;
+    row_major float4x4 gWorldMatrix : WORLD;
+};
 
-float4x4 gWorldMatrix : WORLD;
-float3 gCameraPosition : CAMERA;
+Texture2D gDiffuseMap : DiffuseMap;
 
 SamplerState samPoint
 {
@@ -73,6 +81,20 @@ struct VS_INPUT
     float3 tangent : TANGENT;
 };
 
+// Vertex plus the instance it is drawn for, from the per instance buffer in slot 1 (same as PosCol3D.fx)
+struct VS_INSTANCED_INPUT
+{
+    float3 position : POSITION;
+    float2 uv : TEXCOORD;
+    float3 normal : NORMAL;
+    float3 tangent : TANGENT;
+    float4 worldRow0 : INSTANCEWORLD0;
+    float4 worldRow1 : INSTANCEWORLD1;
+    float4 worldRow2 : INSTANCEWORLD2;
+    float4 worldRow3 : INSTANCEWORLD3;
+    float4 tint : INSTANCETINT;
+};
+
 struct VS_OUTPUT
 {
     float4 position : SV_POSITION0;
@@ -118,6 +140,21 @@ VS_OUTPUT VS(VS_INPUT input)
     return output;
 }
 
+VS_OUTPUT VS_Instanced(VS_INSTANCED_INPUT input)
+{
+    VS_OUTPUT output = (VS_OUTPUT) 0;
+
+    float4x4 world = float4x4(input.worldRow0, input.worldRow1, input.worldRow2, input.worldRow3);
+
+    output.worldPosition = mul(float4(input.position, 1.0f), world);
+    output.position = mul(output.worldPosition, gViewProjection);
+    output.uv = input.uv;
+    output.normal = mul(float4(input.normal, 0.0f), world).xyz;
+    output.tangent = mul(float4(input.tangent, 0.0f), world).xyz;
+
+    return output;
+}
+
 //----------------------------------------
 //  Pixel Shader
 //----------------------------------------
@@ -143,3 +180,15 @@ technique11 DefaultTechnique
         SetPixelShader(CompileShader(ps_5_0, PS()));
     }
 }
+technique11 InstancedTechnique
+{
+    pass P0
+    {
+        SetRasterizerState(gRasterizerState);
+        SetDepthStencilState(gDepthStencilState, 0);
+        SetBlendState(gBlendState, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+        SetVertexShader(CompileShader(vs_5_0, VS_Instanced()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, PS()));
+    }
+}